@@ -12,6 +12,16 @@
 	cp ../../src/boot/ksdk1.1.0/warp-kl03-ksdk1.1-boot.c		work/demos/Warp/src/
 	cp ../../src/boot/ksdk1.1.0/warp-kl03-ksdk1.1-powermodes.c	work/demos/Warp/src/
 	cp ../../src/boot/ksdk1.1.0/warp.h				work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-log*.h			work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-ahrs.*			work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-pedometer.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-activity.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-register-map.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-scheduler.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-event-loop.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-energy.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-capture.*		work/demos/Warp/src/
+	cp ../../src/boot/ksdk1.1.0/warp-i2c-tuning.*		work/demos/Warp/src/
 	cp ../../src/boot/ksdk1.1.0/devBMX055.*				work/demos/Warp/src/
 	cp ../../src/boot/ksdk1.1.0/devADXL362.*			work/demos/Warp/src/
 	cp ../../src/boot/ksdk1.1.0/devMMA8451Q.*			work/demos/Warp/src/
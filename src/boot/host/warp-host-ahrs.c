@@ -0,0 +1,356 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "warp-ahrs.h"
+#include "warp-host.h"
+
+
+/*
+ *	Accuracy and cost harness for the fixed-point orientation filter in
+ *	warp-ahrs.c. A synthetic trajectory (known attitude, tumbling at a
+ *	few tens of degrees per second) is turned into BMX055-like raw counts
+ *	with noise and a gyro bias; the same counts go through warpAhrsUpdate()
+ *	and through the same Mahony filter in double precision. The report
+ *	is the angle between the two estimates, and between each and the
+ *	true attitude once the filters have converged.
+ *
+ *	Host time per update only compares the two implementations; the
+ *	target cost comes from menu 'Q' on the KL03.
+ */
+enum
+{
+	kWarpHostAhrsSampleRateHz	= 200,
+	kWarpHostAhrsSeconds		= 60,
+	kWarpHostAhrsSettleSeconds	= 10,
+	kWarpHostAhrsUpdates		= kWarpHostAhrsSampleRateHz * kWarpHostAhrsSeconds,
+	kWarpHostAhrsAccelCountsPerG	= 1024,		/*	+-2g, 12 bit		*/
+	kWarpHostAhrsMagCounts		= 160,		/*	~50uT at 0.3uT/LSB	*/
+	kWarpHostAhrsNoiseCounts	= 2,
+};
+
+static const double	kWarpHostAhrsGyroCountsPerRadian	= 262.4 * 180.0 / M_PI;	/*	+-125 deg/s	*/
+static const double	kWarpHostAhrsTwoKp			= 4.0;
+static const double	kWarpHostAhrsTwoKi			= 1.0;
+
+typedef struct
+{
+	double		quaternion[4];
+	double		integralFeedback[3];
+} WarpHostAhrsReference;
+
+typedef struct
+{
+	int16_t		gyro[3];
+	int16_t		accel[3];
+	int16_t		mag[3];
+} WarpHostAhrsSample;
+
+static uint32_t		noiseState = 1;
+
+
+
+static int
+noise(void)
+{
+	noiseState = noiseState * 1664525u + 1013904223u;
+
+	return (int)((noiseState >> 16) % (2 * kWarpHostAhrsNoiseCounts + 1)) - kWarpHostAhrsNoiseCounts;
+}
+
+static void
+multiplyQuaternions(const double *  a, const double *  b, double *  product)
+{
+	double	p[4];
+
+	p[0] = a[0]*b[0] - a[1]*b[1] - a[2]*b[2] - a[3]*b[3];
+	p[1] = a[0]*b[1] + a[1]*b[0] + a[2]*b[3] - a[3]*b[2];
+	p[2] = a[0]*b[2] - a[1]*b[3] + a[2]*b[0] + a[3]*b[1];
+	p[3] = a[0]*b[3] + a[1]*b[2] - a[2]*b[1] + a[3]*b[0];
+	memcpy(product, p, sizeof(p));
+}
+
+/*
+ *	Earth-frame vector into the sensor frame: conj(q) * v * q.
+ */
+static void
+earthToSensor(const double *  q, const double *  earth, double *  sensor)
+{
+	double	v[4] = {0, earth[0], earth[1], earth[2]};
+	double	conjugate[4] = {q[0], -q[1], -q[2], -q[3]};
+
+	multiplyQuaternions(conjugate, v, v);
+	multiplyQuaternions(v, q, v);
+	memcpy(sensor, &v[1], 3 * sizeof(double));
+}
+
+static int16_t
+toCounts(double value)
+{
+	return (int16_t)(lround(value) + noise());
+}
+
+static void
+referenceUpdate(WarpHostAhrsReference *  state, const WarpHostAhrsSample *  sample, double gyroScale)
+{
+	double *	q = state->quaternion;
+	double		g[3], a[3], m[3], halfError[3] = {0, 0, 0};
+	double		norm, hx, hy, bx, bz, halfV[3], halfW[3], qa, qb, qc;
+	double		halfPeriod = 0.5 / kWarpHostAhrsSampleRateHz;
+
+	for (int i = 0; i < 3; i++)
+	{
+		g[i] = sample->gyro[i] * gyroScale;
+		a[i] = sample->accel[i];
+		m[i] = sample->mag[i];
+	}
+
+	norm = sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+	if (norm != 0)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			a[i] /= norm;
+		}
+
+		halfV[0] = q[1]*q[3] - q[0]*q[2];
+		halfV[1] = q[0]*q[1] + q[2]*q[3];
+		halfV[2] = q[0]*q[0] - 0.5 + q[3]*q[3];
+
+		halfError[0] = a[1]*halfV[2] - a[2]*halfV[1];
+		halfError[1] = a[2]*halfV[0] - a[0]*halfV[2];
+		halfError[2] = a[0]*halfV[1] - a[1]*halfV[0];
+
+		norm = sqrt(m[0]*m[0] + m[1]*m[1] + m[2]*m[2]);
+		if (norm != 0)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				m[i] /= norm;
+			}
+
+			hx = 2*(m[0]*(0.5 - q[2]*q[2] - q[3]*q[3]) + m[1]*(q[1]*q[2] - q[0]*q[3]) + m[2]*(q[1]*q[3] + q[0]*q[2]));
+			hy = 2*(m[0]*(q[1]*q[2] + q[0]*q[3]) + m[1]*(0.5 - q[1]*q[1] - q[3]*q[3]) + m[2]*(q[2]*q[3] - q[0]*q[1]));
+			bz = 2*(m[0]*(q[1]*q[3] - q[0]*q[2]) + m[1]*(q[2]*q[3] + q[0]*q[1]) + m[2]*(0.5 - q[1]*q[1] - q[2]*q[2]));
+			bx = sqrt(hx*hx + hy*hy);
+
+			halfW[0] = bx*(0.5 - q[2]*q[2] - q[3]*q[3]) + bz*(q[1]*q[3] - q[0]*q[2]);
+			halfW[1] = bx*(q[1]*q[2] - q[0]*q[3]) + bz*(q[0]*q[1] + q[2]*q[3]);
+			halfW[2] = bx*(q[0]*q[2] + q[1]*q[3]) + bz*(0.5 - q[1]*q[1] - q[2]*q[2]);
+
+			halfError[0] += m[1]*halfW[2] - m[2]*halfW[1];
+			halfError[1] += m[2]*halfW[0] - m[0]*halfW[2];
+			halfError[2] += m[0]*halfW[1] - m[1]*halfW[0];
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			state->integralFeedback[i] += kWarpHostAhrsTwoKi * halfError[i] / kWarpHostAhrsSampleRateHz;
+			g[i] += state->integralFeedback[i] + kWarpHostAhrsTwoKp * halfError[i];
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		g[i] *= halfPeriod;
+	}
+
+	qa = q[0];
+	qb = q[1];
+	qc = q[2];
+	q[0] += -qb*g[0] - qc*g[1] - q[3]*g[2];
+	q[1] += qa*g[0] + qc*g[2] - q[3]*g[1];
+	q[2] += qa*g[1] - qb*g[2] + q[3]*g[0];
+	q[3] += qa*g[2] + qb*g[1] - qc*g[0];
+
+	norm = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+	for (int i = 0; i < 4; i++)
+	{
+		q[i] /= norm;
+	}
+}
+
+/*
+ *	Rotation angle between two attitudes, in degrees.
+ */
+static double
+attitudeErrorDegrees(const double *  a, const double *  b)
+{
+	double	dot = fabs(a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3]);
+
+	return 2.0 * acos(dot > 1.0 ? 1.0 : dot) * 180.0 / M_PI;
+}
+
+static uint64_t
+hostNanoseconds(void)
+{
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+static void
+reportError(FILE *  out, const char *  label, const double *  a, const double *  b)
+{
+	double	error, maximum = 0, sumOfSquares = 0;
+	int	count = 0;
+
+	for (int i = kWarpHostAhrsSettleSeconds * kWarpHostAhrsSampleRateHz; i < kWarpHostAhrsUpdates; i++)
+	{
+		error = attitudeErrorDegrees(&a[4*i], &b[4*i]);
+		maximum = (error > maximum) ? error : maximum;
+		sumOfSquares += error * error;
+		count++;
+	}
+
+	fprintf(out, "warp-host ahrs: %-16s max %8.4f deg, rms %8.4f deg\n", label, maximum, sqrt(sumOfSquares / count));
+}
+
+uint32_t
+warpHostRunAhrsHarness(FILE *  out)
+{
+	static WarpHostAhrsSample	samples[kWarpHostAhrsUpdates];
+	static double			truth[4 * kWarpHostAhrsUpdates];
+	static double			fixed[4 * kWarpHostAhrsUpdates];
+	static double			reference[4 * kWarpHostAhrsUpdates];
+	const double			gravity[3] = {0, 0, 1};
+	const double			field[3] = {cos(60 * M_PI / 180), 0, -sin(60 * M_PI / 180)};
+	const double			gyroBias[3] = {0.01, -0.02, 0.015};
+	double				q[4] = {0.8924, 0.2391, 0.1893, 0.3320};
+	double				step[4], omega[3], sensor[3], norm, t;
+	WarpAhrsState			state;
+	WarpHostAhrsReference		referenceState = {{1, 0, 0, 0}, {0, 0, 0}};
+	int16_t				quaternionQ15[4];
+	uint64_t			start, fixedNanoseconds, referenceNanoseconds;
+	int32_t				gyroScale = (int32_t)lround((1 << kWarpAhrsFractionBits) / kWarpHostAhrsGyroCountsPerRadian);
+
+	norm = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+	for (int j = 0; j < 4; j++)
+	{
+		q[j] /= norm;
+	}
+
+	/*
+	 *	The true attitude starts away from the filters' identity, and
+	 *	tumbles about all three axes.
+	 */
+	for (int i = 0; i < kWarpHostAhrsUpdates; i++)
+	{
+		t = (double)i / kWarpHostAhrsSampleRateHz;
+		omega[0] = 0.6 * sin(0.7 * t);
+		omega[1] = 0.4 * cos(0.3 * t);
+		omega[2] = 0.5 * sin(0.11 * t + 1.0);
+
+		for (int j = 0; j < 3; j++)
+		{
+			samples[i].gyro[j] = toCounts((omega[j] + gyroBias[j]) * kWarpHostAhrsGyroCountsPerRadian);
+		}
+		earthToSensor(q, gravity, sensor);
+		for (int j = 0; j < 3; j++)
+		{
+			samples[i].accel[j] = toCounts(sensor[j] * kWarpHostAhrsAccelCountsPerG);
+		}
+		earthToSensor(q, field, sensor);
+		for (int j = 0; j < 3; j++)
+		{
+			samples[i].mag[j] = toCounts(sensor[j] * kWarpHostAhrsMagCounts);
+		}
+
+		/*
+		 *	Advance the truth by the exact rotation over one period.
+		 */
+		norm = sqrt(omega[0]*omega[0] + omega[1]*omega[1] + omega[2]*omega[2]);
+		step[0] = cos(0.5 * norm / kWarpHostAhrsSampleRateHz);
+		for (int j = 0; j < 3; j++)
+		{
+			step[j + 1] = (norm == 0) ? 0 : omega[j] / norm * sin(0.5 * norm / kWarpHostAhrsSampleRateHz);
+		}
+		memcpy(&truth[4*i], q, sizeof(q));
+		multiplyQuaternions(q, step, q);
+	}
+
+	warpAhrsInit(&state, kWarpHostAhrsSampleRateHz, gyroScale,
+			(int32_t)(kWarpHostAhrsTwoKp * (1 << kWarpAhrsGainFractionBits)),
+			(int32_t)(kWarpHostAhrsTwoKi * (1 << kWarpAhrsGainFractionBits)));
+
+	/*
+	 *	Sample i is the attitude at the start of period i, so compare
+	 *	each estimate against the truth one period later.
+	 */
+	start = hostNanoseconds();
+	for (int i = 0; i < kWarpHostAhrsUpdates; i++)
+	{
+		warpAhrsUpdate(&state, samples[i].gyro, samples[i].accel, samples[i].mag);
+		for (int j = 0; j < 4; j++)
+		{
+			fixed[4*i + j] = (double)state.quaternion[j] / (1 << kWarpAhrsFractionBits);
+		}
+	}
+	fixedNanoseconds = hostNanoseconds() - start;
+
+	start = hostNanoseconds();
+	for (int i = 0; i < kWarpHostAhrsUpdates; i++)
+	{
+		referenceUpdate(&referenceState, &samples[i], (double)gyroScale / (1 << kWarpAhrsFractionBits));
+		memcpy(&reference[4*i], referenceState.quaternion, sizeof(referenceState.quaternion));
+	}
+	referenceNanoseconds = hostNanoseconds() - start;
+
+	memmove(truth, &truth[4], sizeof(truth) - 4 * sizeof(double));
+	memcpy(&truth[4 * (kWarpHostAhrsUpdates - 1)], q, sizeof(q));
+
+	warpAhrsQuaternionQ15(&state, quaternionQ15);
+	fprintf(out, "warp-host ahrs: %d updates at %d Hz, errors after %d s\n",
+		kWarpHostAhrsUpdates, kWarpHostAhrsSampleRateHz, kWarpHostAhrsSettleSeconds);
+	reportError(out, "fixed vs double", fixed, reference);
+	reportError(out, "double vs truth", reference, truth);
+	reportError(out, "fixed vs truth", fixed, truth);
+	fprintf(out, "warp-host ahrs: final Q15 quaternion %d, %d, %d, %d\n",
+		quaternionQ15[0], quaternionQ15[1], quaternionQ15[2], quaternionQ15[3]);
+	fprintf(out, "warp-host ahrs: host time per update: fixed %.0f ns, double %.0f ns\n",
+		(double)fixedNanoseconds / kWarpHostAhrsUpdates, (double)referenceNanoseconds / kWarpHostAhrsUpdates);
+
+	return kWarpHostAhrsUpdates;
+}
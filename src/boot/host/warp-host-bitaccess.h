@@ -0,0 +1,91 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Force-included ahead of every host translation unit (see
+ *	build/host/CMakeLists.txt). The KL03 HAL accesses peripherals through
+ *	the Bit Manipulation Engine, whose decorated aliases (0x44000000 and
+ *	up) encode the operation in the address. The host has no BME, so the
+ *	BME_* macros are redefined as the equivalent read-modify-write on the
+ *	plain (mapped) peripheral address.
+ */
+#include "MKL03Z4/fsl_bitaccess.h"
+
+#undef BME_AND8
+#undef BME_AND16
+#undef BME_AND32
+#undef BME_OR8
+#undef BME_OR16
+#undef BME_OR32
+#undef BME_XOR8
+#undef BME_XOR16
+#undef BME_XOR32
+#undef BME_BFI8
+#undef BME_BFI16
+#undef BME_BFI32
+#undef BME_UBFX8
+#undef BME_UBFX16
+#undef BME_UBFX32
+
+#define WARP_HOST_REG(type, addr)			(*(volatile type *)(uintptr_t)(addr))
+#define WARP_HOST_FIELD(bit, width)			((uint32_t)(((1ULL << (width)) - 1) << (bit)))
+
+#define BME_AND8(addr, wdata)				(WARP_HOST_REG(uint8_t, addr) &= (wdata))
+#define BME_AND16(addr, wdata)				(WARP_HOST_REG(uint16_t, addr) &= (wdata))
+#define BME_AND32(addr, wdata)				(WARP_HOST_REG(uint32_t, addr) &= (wdata))
+
+#define BME_OR8(addr, wdata)				(WARP_HOST_REG(uint8_t, addr) |= (wdata))
+#define BME_OR16(addr, wdata)				(WARP_HOST_REG(uint16_t, addr) |= (wdata))
+#define BME_OR32(addr, wdata)				(WARP_HOST_REG(uint32_t, addr) |= (wdata))
+
+#define BME_XOR8(addr, wdata)				(WARP_HOST_REG(uint8_t, addr) ^= (wdata))
+#define BME_XOR16(addr, wdata)				(WARP_HOST_REG(uint16_t, addr) ^= (wdata))
+#define BME_XOR32(addr, wdata)				(WARP_HOST_REG(uint32_t, addr) ^= (wdata))
+
+#define BME_BFI8(addr, wdata, bit, width)		(WARP_HOST_REG(uint8_t, addr) =		\
+								(WARP_HOST_REG(uint8_t, addr) & ~WARP_HOST_FIELD(bit, width)) |	\
+								((wdata) & WARP_HOST_FIELD(bit, width)))
+#define BME_BFI16(addr, wdata, bit, width)		(WARP_HOST_REG(uint16_t, addr) =	\
+								(WARP_HOST_REG(uint16_t, addr) & ~WARP_HOST_FIELD(bit, width)) |	\
+								((wdata) & WARP_HOST_FIELD(bit, width)))
+#define BME_BFI32(addr, wdata, bit, width)		(WARP_HOST_REG(uint32_t, addr) =	\
+								(WARP_HOST_REG(uint32_t, addr) & ~WARP_HOST_FIELD(bit, width)) |	\
+								((wdata) & WARP_HOST_FIELD(bit, width)))
+
+#define BME_UBFX8(addr, bit, width)			((WARP_HOST_REG(uint8_t, addr) & WARP_HOST_FIELD(bit, width)) >> (bit))
+#define BME_UBFX16(addr, bit, width)			((WARP_HOST_REG(uint16_t, addr) & WARP_HOST_FIELD(bit, width)) >> (bit))
+#define BME_UBFX32(addr, bit, width)			((WARP_HOST_REG(uint32_t, addr) & WARP_HOST_FIELD(bit, width)) >> (bit))
@@ -0,0 +1,291 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "fsl_device_registers.h"
+
+#include "warp.h"
+#include "devBME680.h"
+#include "warp-host.h"
+
+
+/*
+ *	Harness for the BME680 integer compensation in devBME680.c. Each
+ *	vector is a calibration dump in the layout configureAllSensors()
+ *	prints (register 0x89 up, then 0xE1 up) together with the parameters
+ *	it encodes. decodeCalibrationBME680() must recover the parameters
+ *	exactly; the compensated outputs are then compared against the
+ *	floating-point formulas of the BME680 datasheet (section 3.3) over a
+ *	sweep of raw ADC values, keeping only the points whose reference
+ *	result is inside the sensor's operating range.
+ */
+enum
+{
+	kWarpHostBme680TemperatureAdcFirst	= 300000,
+	kWarpHostBme680TemperatureAdcLast	= 700000,
+	kWarpHostBme680TemperatureAdcStep	= 2500,
+	kWarpHostBme680PressureAdcFirst		= 100000,
+	kWarpHostBme680PressureAdcLast		= 700000,
+	kWarpHostBme680PressureAdcStep		= 2500,
+	kWarpHostBme680HumidityAdcFirst		= 5000,
+	kWarpHostBme680HumidityAdcLast		= 60000,
+	kWarpHostBme680HumidityAdcStep		= 250,
+};
+
+/*
+ *	Operating range (datasheet Table 1) and the largest difference from
+ *	the reference accepted, in the units of the integer outputs. The
+ *	Bosch integer formulas themselves differ from the floating-point ones
+ *	by up to about 9 Pa and 60 milli-%RH, well inside the sensor's
+ *	absolute accuracy.
+ */
+static const double	kWarpHostBme680MinCelsius		= -40.0;
+static const double	kWarpHostBme680MaxCelsius		= 85.0;
+static const double	kWarpHostBme680MinPascals		= 30000.0;
+static const double	kWarpHostBme680MaxPascals		= 110000.0;
+static const double	kWarpHostBme680MaxTemperatureError	= 1.0;		/*	centi-degC	*/
+static const double	kWarpHostBme680MaxPressureError		= 12.0;		/*	Pa		*/
+static const double	kWarpHostBme680MaxHumidityError		= 100.0;		/*	milli-%RH	*/
+
+typedef struct
+{
+	const char *		name;
+	uint8_t			calibrationValues[kWarpSizesBME680CalibrationValuesCount];
+	WarpBME680Calibration	calibration;
+} WarpHostBme680Vector;
+
+static const WarpHostBme680Vector	vectors[] =
+{
+	{
+		"typical",
+		{
+			0x00, 0xae, 0x66, 0x03, 0x00, 0x4e, 0x8d, 0x17, 0xd7, 0x58, 0x00, 0xf0, 0x1a, 0xc2,
+			0xff, 0x23, 0x1e, 0x00, 0x00, 0x3c, 0xf4, 0xaa, 0xf7, 0x1e, 0x00, 0x3e, 0xb8, 0x30,
+			0x00, 0x2d, 0x14, 0x78, 0x9c, 0x7e, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		},
+		{
+			.parT1 = 26238, .parT2 = 26286, .parT3 = 3,
+			.parP1 = 36174, .parP2 = -10473, .parP3 = 88, .parP4 = 6896, .parP5 = -62,
+			.parP6 = 30, .parP7 = 35, .parP8 = -3012, .parP9 = -2134, .parP10 = 30,
+			.parH1 = 776, .parH2 = 1003, .parH3 = 0, .parH4 = 45, .parH5 = 20, .parH6 = 120, .parH7 = -100,
+		},
+	},
+	{
+		"second part",
+		{
+			0x00, 0xb9, 0x67, 0x03, 0x00, 0x39, 0x8c, 0xb8, 0xd7, 0x58, 0x00, 0x72, 0x1c, 0xa9,
+			0xff, 0x28, 0x1e, 0x00, 0x00, 0x0c, 0xf6, 0x35, 0xf3, 0x1e, 0x00, 0x40, 0xcc, 0x32,
+			0x00, 0x2d, 0x14, 0x78, 0x9c, 0x76, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		},
+		{
+			.parT1 = 25974, .parT2 = 26553, .parT3 = 3,
+			.parP1 = 35897, .parP2 = -10312, .parP3 = 88, .parP4 = 7282, .parP5 = -87,
+			.parP6 = 30, .parP7 = 40, .parP8 = -2548, .parP9 = -3275, .parP10 = 30,
+			.parH1 = 812, .parH2 = 1036, .parH3 = 0, .parH4 = 45, .parH5 = 20, .parH6 = 120, .parH7 = -100,
+		},
+	},
+	{
+		/*
+		 *	Negative values in every signed byte and a shared 0xE2
+		 *	nibble pair that differs from the others.
+		 */
+		"signed",
+		{
+			0x00, 0x8d, 0x64, 0xfc, 0x00, 0xee, 0x90, 0x22, 0xd9, 0xf4, 0x00, 0x05, 0x19, 0x0f,
+			0xff, 0xea, 0xee, 0x00, 0x00, 0x4a, 0xf2, 0xac, 0xf9, 0x0e, 0x00, 0x3c, 0x5d, 0x2b,
+			0xfd, 0x34, 0xf2, 0x60, 0xb9, 0xc1, 0x68, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		},
+		{
+			.parT1 = 26817, .parT2 = 25741, .parT3 = -4,
+			.parP1 = 37102, .parP2 = -9950, .parP3 = -12, .parP4 = 6405, .parP5 = -241,
+			.parP6 = -18, .parP7 = -22, .parP8 = -3510, .parP9 = -1620, .parP10 = 14,
+			.parH1 = 701, .parH2 = 965, .parH3 = -3, .parH4 = 52, .parH5 = -14, .parH6 = 96, .parH7 = -71,
+		},
+	},
+};
+
+
+
+static bool
+calibrationMatches(const WarpBME680Calibration *  a, const WarpBME680Calibration *  b)
+{
+	return	(a->parT1 == b->parT1) && (a->parT2 == b->parT2) && (a->parT3 == b->parT3) &&
+		(a->parP1 == b->parP1) && (a->parP2 == b->parP2) && (a->parP3 == b->parP3) &&
+		(a->parP4 == b->parP4) && (a->parP5 == b->parP5) && (a->parP6 == b->parP6) &&
+		(a->parP7 == b->parP7) && (a->parP8 == b->parP8) && (a->parP9 == b->parP9) &&
+		(a->parP10 == b->parP10) &&
+		(a->parH1 == b->parH1) && (a->parH2 == b->parH2) && (a->parH3 == b->parH3) &&
+		(a->parH4 == b->parH4) && (a->parH5 == b->parH5) && (a->parH6 == b->parH6) &&
+		(a->parH7 == b->parH7);
+}
+
+static double
+referenceTemperature(const WarpBME680Calibration *  c, uint32_t adc, double *  tFine)
+{
+	double	var1, var2;
+
+	var1 = ((double)adc / 16384.0 - (double)c->parT1 / 1024.0) * (double)c->parT2;
+	var2 = ((double)adc / 131072.0 - (double)c->parT1 / 8192.0);
+	var2 = var2 * var2 * ((double)c->parT3 * 16.0);
+	*tFine = var1 + var2;
+
+	return *tFine / 5120.0;
+}
+
+static double
+referencePressure(const WarpBME680Calibration *  c, uint32_t adc, double tFine)
+{
+	double	var1, var2, var3, pressure;
+
+	var1 = (tFine / 2.0) - 64000.0;
+	var2 = var1 * var1 * ((double)c->parP6 / 131072.0);
+	var2 = var2 + (var1 * (double)c->parP5 * 2.0);
+	var2 = (var2 / 4.0) + ((double)c->parP4 * 65536.0);
+	var1 = ((((double)c->parP3 * var1 * var1) / 16384.0) + ((double)c->parP2 * var1)) / 524288.0;
+	var1 = (1.0 + (var1 / 32768.0)) * (double)c->parP1;
+	pressure = 1048576.0 - (double)adc;
+	pressure = ((pressure - (var2 / 4096.0)) * 6250.0) / var1;
+	var1 = ((double)c->parP9 * pressure * pressure) / 2147483648.0;
+	var2 = pressure * ((double)c->parP8 / 32768.0);
+	var3 = (pressure / 256.0) * (pressure / 256.0) * (pressure / 256.0) * ((double)c->parP10 / 131072.0);
+
+	return pressure + (var1 + var2 + var3 + ((double)c->parP7 * 128.0)) / 16.0;
+}
+
+static double
+referenceHumidity(const WarpBME680Calibration *  c, uint16_t adc, double celsius)
+{
+	double	var1, var2, var3, var4;
+
+	var1 = (double)adc - (((double)c->parH1 * 16.0) + (((double)c->parH3 / 2.0) * celsius));
+	var2 = var1 * (((double)c->parH2 / 262144.0) * (1.0 + (((double)c->parH4 / 16384.0) * celsius) +
+		(((double)c->parH5 / 1048576.0) * celsius * celsius)));
+	var3 = (double)c->parH6 / 16384.0;
+	var4 = (double)c->parH7 / 2097152.0;
+
+	return var2 + ((var3 + (var4 * celsius)) * var2 * var2);
+}
+
+uint32_t
+warpHostRunBme680Harness(FILE *  out)
+{
+	WarpBME680Calibration	calibration;
+	uint32_t		points = 0, failures = 0;
+
+	for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++)
+	{
+		double		maxTemperatureError = 0, maxPressureError = 0, maxHumidityError = 0;
+		uint32_t	vectorPoints = 0;
+
+		memset(&calibration, 0, sizeof(calibration));
+		decodeCalibrationBME680(vectors[v].calibrationValues, &calibration);
+		if (!calibrationMatches(&calibration, &vectors[v].calibration))
+		{
+			fprintf(out, "warp-host bme680: %-12s calibration decode FAILED\n", vectors[v].name);
+			failures++;
+			continue;
+		}
+
+		for (uint32_t temperatureAdc = kWarpHostBme680TemperatureAdcFirst;
+			temperatureAdc <= kWarpHostBme680TemperatureAdcLast;
+			temperatureAdc += kWarpHostBme680TemperatureAdcStep)
+		{
+			double	referenceFine, celsius, reference;
+			int32_t	tFine, centiCelsius;
+
+			celsius = referenceTemperature(&calibration, temperatureAdc, &referenceFine);
+			if ((celsius < kWarpHostBme680MinCelsius) || (celsius > kWarpHostBme680MaxCelsius))
+			{
+				continue;
+			}
+
+			centiCelsius = compensateTemperatureBME680(&calibration, temperatureAdc, &tFine);
+			maxTemperatureError = fmax(maxTemperatureError, fabs(centiCelsius - celsius * 100.0));
+			vectorPoints++;
+
+			for (uint32_t pressureAdc = kWarpHostBme680PressureAdcFirst;
+				pressureAdc <= kWarpHostBme680PressureAdcLast;
+				pressureAdc += kWarpHostBme680PressureAdcStep)
+			{
+				reference = referencePressure(&calibration, pressureAdc, referenceFine);
+				if ((reference < kWarpHostBme680MinPascals) || (reference > kWarpHostBme680MaxPascals))
+				{
+					continue;
+				}
+
+				maxPressureError = fmax(maxPressureError,
+					fabs(compensatePressureBME680(&calibration, pressureAdc, tFine) - reference));
+				vectorPoints++;
+			}
+
+			for (uint32_t humidityAdc = kWarpHostBme680HumidityAdcFirst;
+				humidityAdc <= kWarpHostBme680HumidityAdcLast;
+				humidityAdc += kWarpHostBme680HumidityAdcStep)
+			{
+				reference = referenceHumidity(&calibration, humidityAdc, celsius);
+				if ((reference < 0.0) || (reference > 100.0))
+				{
+					continue;
+				}
+
+				maxHumidityError = fmax(maxHumidityError,
+					fabs(compensateHumidityBME680(&calibration, humidityAdc, tFine) - reference * 1000.0));
+				vectorPoints++;
+			}
+		}
+
+		fprintf(out, "warp-host bme680: %-12s %6u points, max error %.2f centi-degC, %.2f Pa, %.2f milli-%%RH\n",
+			vectors[v].name, vectorPoints, maxTemperatureError, maxPressureError, maxHumidityError);
+		if ((maxTemperatureError > kWarpHostBme680MaxTemperatureError) ||
+			(maxPressureError > kWarpHostBme680MaxPressureError) ||
+			(maxHumidityError > kWarpHostBme680MaxHumidityError))
+		{
+			fprintf(out, "warp-host bme680: %-12s FAILED (limits %.0f centi-degC, %.0f Pa, %.0f milli-%%RH)\n",
+				vectors[v].name, kWarpHostBme680MaxTemperatureError, kWarpHostBme680MaxPressureError,
+				kWarpHostBme680MaxHumidityError);
+			failures++;
+		}
+		points += vectorPoints;
+	}
+
+	return (failures == 0) ? points : 0;
+}
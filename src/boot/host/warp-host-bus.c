@@ -0,0 +1,817 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+
+#include "gpio_pins.h"
+#include "warp.h"
+#include "warp-host.h"
+
+
+/*
+ *	Bits on the wire per I2C transaction: START, address byte and ACK,
+ *	(8 data + 1 ACK) per byte, a repeated START plus address for reads
+ *	with a command phase, and STOP.
+ */
+enum
+{
+	kWarpHostI2cBitsPerByte		= 9,
+	kWarpHostI2cStartStopBits	= 2,
+	kWarpHostSpiBitsPerByte		= 8,
+
+	/*
+	 *	Extra supply current while a transfer is on the bus: the I2C
+	 *	pull-ups held low about half the time, and the SSD1331 drawing
+	 *	what it is sent.
+	 */
+	kWarpHostI2cLoadMicroamps	= 400,
+	kWarpHostSpiLoadMicroamps	= 2500,
+
+	/*
+	 *	Neither the MMA8451Q nor the INA219 (without the high-speed
+	 *	mode the KSDK driver never enters) goes beyond fast mode.
+	 */
+	kWarpHostI2cFastModeKbps	= 400,
+	kWarpHostI2cMarginalPeriod	= 3,
+};
+
+/*
+ *	MMA8451Q register map subset and the synthetic walking waveform: a
+ *	1.8 Hz vertical oscillation of about +/-0.27 g about 1 g, enough to
+ *	cross the pedometer thresholds in runPedometer().
+ */
+enum
+{
+	kWarpHostMMA8451QAddress	= 0x1D,
+	kWarpHostMMA8451QStatus		= 0x00,
+	kWarpHostMMA8451QOutXMsb	= 0x01,
+	kWarpHostMMA8451QOutZLsb	= 0x06,
+	kWarpHostMMA8451QFSetup		= 0x09,
+	kWarpHostMMA8451QIntSource	= 0x0C,
+	kWarpHostMMA8451QWhoAmI		= 0x0D,
+	kWarpHostMMA8451QWhoAmIValue	= 0x1A,
+	kWarpHostMMA8451QCtrlReg1	= 0x2A,
+	kWarpHostMMA8451QCtrlReg3	= 0x2C,
+	kWarpHostMMA8451QCtrlReg4	= 0x2D,
+	kWarpHostMMA8451QCtrlReg5	= 0x2E,
+	kWarpHostMMA8451QCountsPerG	= 4096,
+	kWarpHostMMA8451QFifoDepth	= 32,
+
+	kWarpHostMMA8451QStatusZyxdr	= 0x0F,
+	kWarpHostMMA8451QStatusZyxow	= 0xF0,
+	kWarpHostMMA8451QFStatusOvf	= 0x80,
+	kWarpHostMMA8451QFStatusWmrk	= 0x40,
+	kWarpHostMMA8451QSrcFifo	= 0x40,
+	kWarpHostMMA8451QSrcDrdy	= 0x01,
+	kWarpHostMMA8451QIpol		= 0x02,
+
+	kWarpHostINA219Address		= 0x40,
+	kWarpHostINA219Registers	= 6,
+	kWarpHostINA219BusMillivolts	= 3300,
+	kWarpHostINA219ShuntMilliohms	= 100,
+	kWarpHostINA219NanovoltsPerCount	= 10000,
+	kWarpHostINA219ModeMask		= 0x7,
+	kWarpHostINA219ModeContinuous	= 0x5,
+	kWarpHostINA219SadcShift	= 3,
+	kWarpHostINA219SadcMask		= 0xF,
+	kWarpHostINA219Cnvr		= 0x2,
+};
+
+/*
+ *	Sample FIFO of the MMA8451Q model, oldest sample at head.
+ */
+typedef struct
+{
+	int16_t		samples[kWarpHostMMA8451QFifoDepth][3];
+	uint8_t		head;
+	uint8_t		count;
+	bool		overflow;
+} WarpHostMMA8451QFifo;
+
+static const double	kWarpHostWalkFrequencyHz	= 1.8;
+static const double	kWarpHostWalkAmplitudeCounts	= 1100.0;
+
+static WarpHostI2cDevice	i2cDevices[kWarpHostMaxI2cDevices];
+static int			i2cDeviceCount;
+static uint16_t			ina219Registers[kWarpHostINA219Registers];
+static uint64_t			ina219ConversionStartMicroseconds;
+static uint64_t			ina219ConversionStartPicocoulombs;
+static WarpHostMMA8451QFifo	mma8451qFifo;
+static uint32_t			spiBitsPerSecond = 1000000;
+
+
+
+/*
+ *	Plain 8-bit register file with an auto-incrementing pointer, which is
+ *	what most of the Warp sensors look like from the bus.
+ */
+void
+warpHostRegisterFileWrite(WarpHostI2cDevice *  device, const uint8_t *  bytes, uint32_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	device->pointer = bytes[0];
+	for (uint32_t i = 1; i < count; i++)
+	{
+		device->registers[device->pointer++] = bytes[i];
+	}
+}
+
+void
+warpHostRegisterFileRead(WarpHostI2cDevice *  device, uint8_t *  bytes, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		bytes[i] = device->registers[device->pointer++];
+	}
+}
+
+static WarpHostI2cDevice *
+addI2cDevice(uint8_t address, const char *  name)
+{
+	WarpHostI2cDevice *	device;
+
+	if (i2cDeviceCount >= kWarpHostMaxI2cDevices)
+	{
+		fprintf(stderr, "warp-host: too many simulated I2C devices\n");
+		exit(EXIT_FAILURE);
+	}
+
+	device = &i2cDevices[i2cDeviceCount++];
+	memset(device, 0, sizeof(*device));
+	device->address = address;
+	device->name = name;
+	device->write = warpHostRegisterFileWrite;
+	device->read = warpHostRegisterFileRead;
+	device->nextEventMicroseconds = UINT64_MAX;
+
+	return device;
+}
+
+WarpHostI2cDevice *
+warpHostI2cDeviceAt(uint8_t address)
+{
+	for (int i = 0; i < i2cDeviceCount; i++)
+	{
+		if (i2cDevices[i].address == address)
+		{
+			return &i2cDevices[i];
+		}
+	}
+
+	return NULL;
+}
+
+uint64_t
+warpHostBusNextEventMicroseconds(void)
+{
+	uint64_t	next = UINT64_MAX;
+
+	for (int i = 0; i < i2cDeviceCount; i++)
+	{
+		if (i2cDevices[i].service != NULL && i2cDevices[i].nextEventMicroseconds < next)
+		{
+			next = i2cDevices[i].nextEventMicroseconds;
+		}
+	}
+
+	return next;
+}
+
+void
+warpHostBusService(uint64_t now)
+{
+	for (int i = 0; i < i2cDeviceCount; i++)
+	{
+		if (i2cDevices[i].service != NULL && i2cDevices[i].nextEventMicroseconds <= now)
+		{
+			i2cDevices[i].service(&i2cDevices[i], now);
+		}
+	}
+}
+
+WarpHostI2cDevice *
+warpHostI2cDeviceByIndex(int index)
+{
+	if (index < 0 || index >= i2cDeviceCount)
+	{
+		return NULL;
+	}
+
+	return &i2cDevices[index];
+}
+
+
+
+/*
+ *	MMA8451Q. While ACTIVE, the model takes a sample every output data
+ *	period: into OUT_X_MSB..OUT_Z_LSB with F_MODE = 0, or into the
+ *	32-sample FIFO otherwise, where reads from OUT_X_MSB pop samples and
+ *	the address wraps from OUT_Z_LSB back to OUT_X_MSB. Data-ready and
+ *	FIFO interrupt sources drive INT1 (kWarpPinMMA8451Q_INT1).
+ */
+static uint32_t
+odrMicrosecondsMMA8451Q(WarpHostI2cDevice *  device)
+{
+	static const uint32_t	odrMicroseconds[8] = {1250, 2500, 5000, 10000, 20000, 80000, 160000, 640000};
+
+	return odrMicroseconds[(device->registers[kWarpHostMMA8451QCtrlReg1] >> 3) & 0x7];
+}
+
+static uint8_t
+fifoModeMMA8451Q(WarpHostI2cDevice *  device)
+{
+	return device->registers[kWarpHostMMA8451QFSetup] >> 6;
+}
+
+static int16_t
+clampMMA8451QCounts(double counts)
+{
+	if (counts > 8191.0)
+	{
+		return 8191;
+	}
+	else if (counts < -8192.0)
+	{
+		return -8192;
+	}
+
+	return (int16_t)counts;
+}
+
+static void
+sampleMMA8451Q(uint64_t now, int16_t  xyz[3])
+{
+	double		t = (double)now / 1e6;
+	double		phase = 2.0 * M_PI * kWarpHostWalkFrequencyHz * t;
+
+	xyz[0] = clampMMA8451QCounts(200.0 * sin(phase + 0.7));
+	xyz[1] = clampMMA8451QCounts(300.0 + 150.0 * sin(2.0 * phase));
+	xyz[2] = clampMMA8451QCounts(kWarpHostMMA8451QCountsPerG + kWarpHostWalkAmplitudeCounts * sin(phase));
+}
+
+static uint8_t
+encodeMMA8451QByte(const int16_t  xyz[3], int offset)
+{
+	int16_t		counts = xyz[offset / 2];
+
+	return (offset & 1) ? (uint8_t)((counts << 2) & 0xFC) : (uint8_t)((counts >> 6) & 0xFF);
+}
+
+static void
+updateInterruptMMA8451Q(WarpHostI2cDevice *  device)
+{
+	uint8_t		sources = device->registers[kWarpHostMMA8451QIntSource] & device->registers[kWarpHostMMA8451QCtrlReg4];
+	bool		asserted = (sources & device->registers[kWarpHostMMA8451QCtrlReg5]) != 0;
+	bool		activeHigh = (device->registers[kWarpHostMMA8451QCtrlReg3] & kWarpHostMMA8451QIpol) != 0;
+
+	warpHostSetPinInput(kWarpPinMMA8451Q_INT1, asserted == activeHigh);
+}
+
+static uint8_t
+fifoStatusMMA8451Q(WarpHostI2cDevice *  device)
+{
+	uint8_t		watermark = device->registers[kWarpHostMMA8451QFSetup] & 0x3F;
+	uint8_t		status = mma8451qFifo.count;
+
+	if (mma8451qFifo.overflow)
+	{
+		status |= kWarpHostMMA8451QFStatusOvf;
+	}
+	if (watermark != 0 && mma8451qFifo.count >= watermark)
+	{
+		status |= kWarpHostMMA8451QFStatusWmrk;
+	}
+
+	return status;
+}
+
+static void
+serviceMMA8451Q(WarpHostI2cDevice *  device, uint64_t now)
+{
+	int16_t		xyz[3];
+
+	sampleMMA8451Q(now, xyz);
+
+	if (fifoModeMMA8451Q(device) == 0)
+	{
+		for (int offset = 0; offset < 6; offset++)
+		{
+			device->registers[kWarpHostMMA8451QOutXMsb + offset] = encodeMMA8451QByte(xyz, offset);
+		}
+
+		if (device->registers[kWarpHostMMA8451QStatus] & kWarpHostMMA8451QStatusZyxdr)
+		{
+			device->registers[kWarpHostMMA8451QStatus] |= kWarpHostMMA8451QStatusZyxow;
+		}
+		device->registers[kWarpHostMMA8451QStatus] |= kWarpHostMMA8451QStatusZyxdr;
+		device->registers[kWarpHostMMA8451QIntSource] |= kWarpHostMMA8451QSrcDrdy;
+	}
+	else
+	{
+		uint8_t		slot;
+
+		if (mma8451qFifo.count == kWarpHostMMA8451QFifoDepth)
+		{
+			mma8451qFifo.overflow = true;
+
+			/*
+			 *	Circular mode discards the oldest sample; fill mode
+			 *	stops accepting new ones.
+			 */
+			if (fifoModeMMA8451Q(device) == 1)
+			{
+				mma8451qFifo.head = (mma8451qFifo.head + 1) % kWarpHostMMA8451QFifoDepth;
+				mma8451qFifo.count--;
+			}
+		}
+
+		if (mma8451qFifo.count < kWarpHostMMA8451QFifoDepth)
+		{
+			slot = (mma8451qFifo.head + mma8451qFifo.count) % kWarpHostMMA8451QFifoDepth;
+			memcpy(mma8451qFifo.samples[slot], xyz, sizeof(xyz));
+			mma8451qFifo.count++;
+		}
+
+		if (fifoStatusMMA8451Q(device) & (kWarpHostMMA8451QFStatusOvf | kWarpHostMMA8451QFStatusWmrk))
+		{
+			device->registers[kWarpHostMMA8451QIntSource] |= kWarpHostMMA8451QSrcFifo;
+		}
+	}
+
+	device->nextEventMicroseconds += odrMicrosecondsMMA8451Q(device);
+	updateInterruptMMA8451Q(device);
+}
+
+static void
+writeMMA8451Q(WarpHostI2cDevice *  device, const uint8_t *  bytes, uint32_t count)
+{
+	bool	active;
+
+	warpHostRegisterFileWrite(device, bytes, count);
+
+	active = (device->registers[kWarpHostMMA8451QCtrlReg1] & 0x01) != 0;
+	if (!active)
+	{
+		device->nextEventMicroseconds = UINT64_MAX;
+	}
+	else if (device->nextEventMicroseconds == UINT64_MAX)
+	{
+		device->nextEventMicroseconds = warpHostNowMicroseconds() + odrMicrosecondsMMA8451Q(device);
+	}
+
+	if (fifoModeMMA8451Q(device) == 0)
+	{
+		memset(&mma8451qFifo, 0, sizeof(mma8451qFifo));
+		device->registers[kWarpHostMMA8451QIntSource] &= ~kWarpHostMMA8451QSrcFifo;
+	}
+
+	updateInterruptMMA8451Q(device);
+}
+
+static void
+readMMA8451Q(WarpHostI2cDevice *  device, uint8_t *  bytes, uint32_t count)
+{
+	bool	fifo = (fifoModeMMA8451Q(device) != 0);
+
+	if (!fifo && device->pointer == kWarpHostMMA8451QOutXMsb)
+	{
+		device->samples++;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t		address = device->pointer;
+
+		if (address == kWarpHostMMA8451QStatus && fifo)
+		{
+			bytes[i] = fifoStatusMMA8451Q(device);
+			mma8451qFifo.overflow = false;
+			device->registers[kWarpHostMMA8451QIntSource] &= ~kWarpHostMMA8451QSrcFifo;
+			device->pointer++;
+		}
+		else if (address >= kWarpHostMMA8451QOutXMsb && address <= kWarpHostMMA8451QOutZLsb && fifo)
+		{
+			bytes[i] = (mma8451qFifo.count == 0) ? 0 : encodeMMA8451QByte(mma8451qFifo.samples[mma8451qFifo.head], address - kWarpHostMMA8451QOutXMsb);
+			device->pointer++;
+
+			if (address == kWarpHostMMA8451QOutZLsb)
+			{
+				if (mma8451qFifo.count != 0)
+				{
+					mma8451qFifo.head = (mma8451qFifo.head + 1) % kWarpHostMMA8451QFifoDepth;
+					mma8451qFifo.count--;
+					device->samples++;
+				}
+				device->pointer = kWarpHostMMA8451QOutXMsb;
+			}
+		}
+		else
+		{
+			if (address >= kWarpHostMMA8451QOutXMsb && address <= kWarpHostMMA8451QOutZLsb)
+			{
+				device->registers[kWarpHostMMA8451QStatus] = 0;
+				device->registers[kWarpHostMMA8451QIntSource] &= ~kWarpHostMMA8451QSrcDrdy;
+			}
+			warpHostRegisterFileRead(device, &bytes[i], 1);
+		}
+	}
+
+	updateInterruptMMA8451Q(device);
+}
+
+
+
+/*
+ *	INA219: 16-bit registers, MSB first, selected by a pointer byte. The
+ *	shunt register holds the supply current of warp-host-sim.c averaged
+ *	over a conversion. A write of a triggered mode to the configuration
+ *	register starts one conversion, which sets CNVR when its SADC window
+ *	closes. In the continuous modes a read returns the average since the
+ *	previous conversion, if a conversion time has passed since, and the
+ *	previous result otherwise. The current register is the shunt
+ *	register scaled by the calibration register, as on the part.
+ */
+static uint64_t
+sadcMicrosecondsINA219(uint16_t configuration)
+{
+	static const uint16_t	singleSampleMicroseconds[] = {84, 148, 276, 532};
+	uint8_t			code = (configuration >> kWarpHostINA219SadcShift) & kWarpHostINA219SadcMask;
+
+	if (code < 8)
+	{
+		return singleSampleMicroseconds[code & 0x3];
+	}
+
+	return (uint64_t)532 << (code - 8);
+}
+
+static void
+convertINA219(uint64_t now)
+{
+	uint64_t	elapsed = now - ina219ConversionStartMicroseconds;
+	uint64_t	microamps = (elapsed == 0) ? 0 : (warpHostChargePicocoulombs() - ina219ConversionStartPicocoulombs) / elapsed;
+
+	ina219Registers[0x01] = (uint16_t)((microamps * kWarpHostINA219ShuntMilliohms + kWarpHostINA219NanovoltsPerCount / 2) / kWarpHostINA219NanovoltsPerCount);
+	ina219Registers[0x04] = (uint16_t)(((int32_t)(int16_t)ina219Registers[0x01] * ina219Registers[0x05]) / 4096);
+	ina219ConversionStartMicroseconds = now;
+	ina219ConversionStartPicocoulombs = warpHostChargePicocoulombs();
+}
+
+static void
+serviceINA219(WarpHostI2cDevice *  device, uint64_t now)
+{
+	convertINA219(now);
+	ina219Registers[0x02] |= kWarpHostINA219Cnvr;
+	device->samples++;
+	device->nextEventMicroseconds = UINT64_MAX;
+}
+
+static void
+writeINA219(WarpHostI2cDevice *  device, const uint8_t *  bytes, uint32_t count)
+{
+	uint16_t	mode;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	device->pointer = bytes[0] % kWarpHostINA219Registers;
+	if (count >= 3)
+	{
+		ina219Registers[device->pointer] = (uint16_t)((bytes[1] << 8) | bytes[2]);
+	}
+
+	mode = ina219Registers[0x00] & kWarpHostINA219ModeMask;
+	if (count >= 3 && device->pointer == 0x00 && mode != 0)
+	{
+		ina219ConversionStartMicroseconds = warpHostNowMicroseconds();
+		ina219ConversionStartPicocoulombs = warpHostChargePicocoulombs();
+		if (mode < kWarpHostINA219ModeContinuous)
+		{
+			ina219Registers[0x02] = (uint16_t)((kWarpHostINA219BusMillivolts / 4) << 3);
+			device->nextEventMicroseconds = ina219ConversionStartMicroseconds + sadcMicrosecondsINA219(ina219Registers[0x00]);
+		}
+	}
+}
+
+static void
+readINA219(WarpHostI2cDevice *  device, uint8_t *  bytes, uint32_t count)
+{
+	uint16_t	value;
+	uint64_t	now = warpHostNowMicroseconds();
+
+	if ((ina219Registers[0x00] & kWarpHostINA219ModeMask) >= kWarpHostINA219ModeContinuous)
+	{
+		if (now - ina219ConversionStartMicroseconds >= sadcMicrosecondsINA219(ina219Registers[0x00]))
+		{
+			convertINA219(now);
+		}
+		ina219Registers[0x02] = (uint16_t)((kWarpHostINA219BusMillivolts / 4) << 3) | kWarpHostINA219Cnvr;
+	}
+
+	value = ina219Registers[device->pointer];
+	for (uint32_t i = 0; i < count; i++)
+	{
+		bytes[i] = (i & 1) ? (value & 0xFF) : (value >> 8);
+	}
+}
+
+
+
+void
+warpHostBusInit(void)
+{
+	WarpHostI2cDevice *	device;
+
+	i2cDeviceCount = 0;
+
+	device = addI2cDevice(kWarpHostMMA8451QAddress, "MMA8451Q");
+	device->write = writeMMA8451Q;
+	device->read = readMMA8451Q;
+	device->service = serviceMMA8451Q;
+	device->maximumBaudRateKbps = kWarpHostI2cFastModeKbps;
+	device->registers[kWarpHostMMA8451QWhoAmI] = kWarpHostMMA8451QWhoAmIValue;
+	memset(&mma8451qFifo, 0, sizeof(mma8451qFifo));
+	warpHostSetPinInput(kWarpPinMMA8451Q_INT1, 1);
+
+	device = addI2cDevice(kWarpHostINA219Address, "INA219");
+	device->write = writeINA219;
+	device->read = readINA219;
+	device->service = serviceINA219;
+	device->maximumBaudRateKbps = kWarpHostI2cFastModeKbps;
+	ina219Registers[0x00] = 0x399F;
+}
+
+
+
+/*
+ *	I2C master driver
+ */
+static uint32_t
+chargeI2c(WarpHostI2cDevice *  device, const i2c_device_t *  slave, uint32_t writeBytes, uint32_t readBytes)
+{
+	uint32_t	bits = kWarpHostI2cStartStopBits;
+	uint32_t	kbps = (slave->baudRate_kbps == 0) ? 1 : slave->baudRate_kbps;
+	uint32_t	microseconds;
+
+	/*
+	 *	A read with no command bytes (from the device's register pointer)
+	 *	has no write phase.
+	 */
+	if (writeBytes != 0 || readBytes == 0)
+	{
+		bits += kWarpHostI2cBitsPerByte * (1 + writeBytes);
+	}
+	if (readBytes != 0)
+	{
+		bits += 1 + kWarpHostI2cBitsPerByte * (1 + readBytes);
+	}
+
+	microseconds = (bits * 1000u + kbps - 1) / kbps;
+
+	gWarpHostBusStatistics.i2cTransactions++;
+	gWarpHostBusStatistics.i2cBytes += writeBytes + readBytes;
+	gWarpHostBusStatistics.i2cBusMicroseconds += microseconds;
+
+	if (device != NULL)
+	{
+		device->transactions++;
+		device->bytes += writeBytes + readBytes;
+		device->busMicroseconds += microseconds;
+	}
+
+	warpHostSetLoadMicroamps(kWarpHostI2cLoadMicroamps);
+	warpHostAdvanceMicroseconds(microseconds);
+	warpHostSetLoadMicroamps(0);
+
+	return microseconds;
+}
+
+/*
+ *	True if the device at this clock does not answer at all.
+ */
+static bool
+overclockedI2c(const WarpHostI2cDevice *  device, const i2c_device_t *  slave)
+{
+	return (device->maximumBaudRateKbps != 0) && (slave->baudRate_kbps > 2*device->maximumBaudRateKbps);
+}
+
+/*
+ *	Between the device's maximum clock and twice that, the read sampled
+ *	on every kWarpHostI2cMarginalPeriod-th transaction has its low bit
+ *	flipped.
+ */
+static void
+marginalI2c(const WarpHostI2cDevice *  device, const i2c_device_t *  slave, uint8_t *  rxBuff, uint32_t rxSize)
+{
+	if ((device->maximumBaudRateKbps != 0) && (slave->baudRate_kbps > device->maximumBaudRateKbps)
+		&& (rxSize != 0) && ((device->transactions % kWarpHostI2cMarginalPeriod) == 0))
+	{
+		rxBuff[0] ^= 0x01;
+	}
+}
+
+i2c_status_t
+I2C_DRV_MasterInit(uint32_t instance, i2c_master_state_t *  master)
+{
+	USED(instance);
+	USED(master);
+
+	return kStatus_I2C_Success;
+}
+
+void
+I2C_DRV_MasterDeinit(uint32_t instance)
+{
+	USED(instance);
+}
+
+void
+I2C_DRV_MasterSetBaudRate(uint32_t instance, const i2c_device_t *  device)
+{
+	USED(instance);
+	USED(device);
+}
+
+i2c_status_t
+I2C_DRV_MasterSendDataBlocking(uint32_t instance,
+				const i2c_device_t *  slave,
+				const uint8_t *  cmdBuff,
+				uint32_t cmdSize,
+				const uint8_t *  txBuff,
+				uint32_t txSize,
+				uint32_t timeout_ms)
+{
+	WarpHostI2cDevice *	device = warpHostI2cDeviceAt((uint8_t)slave->address);
+	uint8_t			bytes[kWarpHostRegisterFileBytes + 1];
+	uint32_t		count = 0;
+
+	USED(instance);
+	USED(timeout_ms);
+
+	if (device == NULL || overclockedI2c(device, slave))
+	{
+		chargeI2c(NULL, slave, 0, 0);
+		gWarpHostBusStatistics.i2cFailures++;
+
+		return kStatus_I2C_ReceivedNak;
+	}
+
+	for (uint32_t i = 0; i < cmdSize && count < sizeof(bytes); i++)
+	{
+		bytes[count++] = cmdBuff[i];
+	}
+	for (uint32_t i = 0; i < txSize && count < sizeof(bytes); i++)
+	{
+		bytes[count++] = txBuff[i];
+	}
+
+	device->write(device, bytes, count);
+	chargeI2c(device, slave, cmdSize + txSize, 0);
+
+	return kStatus_I2C_Success;
+}
+
+i2c_status_t
+I2C_DRV_MasterReceiveDataBlocking(uint32_t instance,
+				const i2c_device_t *  slave,
+				const uint8_t *  cmdBuff,
+				uint32_t cmdSize,
+				uint8_t *  rxBuff,
+				uint32_t rxSize,
+				uint32_t timeout_ms)
+{
+	WarpHostI2cDevice *	device = warpHostI2cDeviceAt((uint8_t)slave->address);
+
+	USED(instance);
+	USED(timeout_ms);
+
+	if (device == NULL || overclockedI2c(device, slave))
+	{
+		chargeI2c(NULL, slave, 0, 0);
+		gWarpHostBusStatistics.i2cFailures++;
+
+		return kStatus_I2C_ReceivedNak;
+	}
+
+	if (cmdSize != 0)
+	{
+		device->write(device, cmdBuff, cmdSize);
+	}
+	device->read(device, rxBuff, rxSize);
+	marginalI2c(device, slave, rxBuff, rxSize);
+	chargeI2c(device, slave, cmdSize, rxSize);
+
+	return kStatus_I2C_Success;
+}
+
+
+
+/*
+ *	SPI master driver. Only the SSD1331 sits on the bus and it is
+ *	write-only, so transfers are timed and counted but not decoded.
+ */
+void
+SPI_DRV_MasterInit(uint32_t instance, spi_master_state_t *  spiState)
+{
+	USED(instance);
+	USED(spiState);
+}
+
+void
+SPI_DRV_MasterDeinit(uint32_t instance)
+{
+	USED(instance);
+}
+
+void
+SPI_DRV_MasterConfigureBus(uint32_t instance, const spi_master_user_config_t *  device, uint32_t *  calculatedBaudRate)
+{
+	USED(instance);
+	if (device->bitsPerSec != 0)
+	{
+		spiBitsPerSecond = device->bitsPerSec;
+	}
+	if (calculatedBaudRate != NULL)
+	{
+		*calculatedBaudRate = spiBitsPerSecond;
+	}
+}
+
+spi_status_t
+SPI_DRV_MasterTransferBlocking(uint32_t instance,
+				const spi_master_user_config_t * restrict device,
+				const uint8_t * restrict sendBuffer,
+				uint8_t * restrict receiveBuffer,
+				size_t transferByteCount,
+				uint32_t timeout)
+{
+	uint64_t	microseconds;
+
+	USED(instance);
+	USED(device);
+	USED(sendBuffer);
+	USED(timeout);
+
+	if (receiveBuffer != NULL)
+	{
+		memset(receiveBuffer, 0, transferByteCount);
+	}
+
+	microseconds = ((uint64_t)transferByteCount * kWarpHostSpiBitsPerByte * 1000000u + spiBitsPerSecond - 1) / spiBitsPerSecond;
+
+	gWarpHostBusStatistics.spiTransactions++;
+	gWarpHostBusStatistics.spiBytes += transferByteCount;
+	gWarpHostBusStatistics.spiBusMicroseconds += microseconds;
+	warpHostSetLoadMicroamps(kWarpHostSpiLoadMicroamps);
+	warpHostAdvanceMicroseconds(microseconds);
+	warpHostSetLoadMicroamps(0);
+
+	return kStatus_SPI_Success;
+}
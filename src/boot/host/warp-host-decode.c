@@ -0,0 +1,476 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fsl_device_registers.h"
+
+#include "warp.h"
+#include "warp-log.h"
+#include "warp-capture.h"
+#include "warp-host.h"
+
+
+/*
+ *	Decoder for the binary sample frames of streamAllSensorsBinary()
+ *	(layout in WarpBinaryFrameConstants). Each frame becomes one CSV row
+ *	in the style of printAllSensors() in hex mode, with each column's
+ *	raw register bytes in the order they were read. Bytes that are not
+ *	part of a valid frame (menu text, a frame cut by a CRC error) are
+ *	skipped until the next sync.
+ *
+ *	The records of a current capture dump (layout in warp-capture.h)
+ *	share the first sync byte and are decoded in the same pass, one CSV
+ *	row per sample, timed from the trigger (or from the oldest sample
+ *	held, without one). Samples inside a block take the block's
+ *	timestamp plus the mean sample period for each step.
+ */
+typedef struct
+{
+	const char *	name;
+	uint8_t		numberOfBytes;
+} WarpHostFrameColumn;
+
+typedef struct
+{
+	const WarpHostFrameColumn *	columns;
+	int				numberOfColumns;
+} WarpHostFrameSensor;
+
+static const WarpHostFrameColumn	columnsMMA8451Q[]	= {{"MMA8451 x", 2}, {"MMA8451 y", 2}, {"MMA8451 z", 2}};
+static const WarpHostFrameColumn	columnsINA219[]		= {{"INA219 Shunt Voltage", 2}, {"INA219 Current", 2}};
+static const WarpHostFrameColumn	columnsMAG3110[]	= {{"MAG3110 x", 2}, {"MAG3110 y", 2}, {"MAG3110 z", 2}, {"MAG3110 Temp", 1}};
+static const WarpHostFrameColumn	columnsL3GD20H[]	= {{"L3GD20H x", 2}, {"L3GD20H y", 2}, {"L3GD20H z", 2}, {"L3GD20H Temp", 1}};
+static const WarpHostFrameColumn	columnsBME680[]		= {{"BME680 Press", 3}, {"BME680 Temp", 3}, {"BME680 Hum", 2}};
+static const WarpHostFrameColumn	columnsBMX055accel[]	= {{"BMX055acc x", 2}, {"BMX055acc y", 2}, {"BMX055acc z", 2}, {"BMX055acc Temp", 1}};
+static const WarpHostFrameColumn	columnsBMX055mag[]	= {{"BMX055mag x", 2}, {"BMX055mag y", 2}, {"BMX055mag z", 2}, {"BMX055mag RHALL", 2}};
+static const WarpHostFrameColumn	columnsBMX055gyro[]	= {{"BMX055gyro x", 2}, {"BMX055gyro y", 2}, {"BMX055gyro z", 2}};
+static const WarpHostFrameColumn	columnsCCS811[]		= {{"CCS811 ECO2", 2}, {"CCS811 TVOC", 2}, {"CCS811 RAW ADC value", 2},
+								{"CCS811 RAW R_REF value", 2}, {"CCS811 RAW R_NTC value", 2}};
+static const WarpHostFrameColumn	columnsHDC1000[]	= {{"HDC1000 Temp", 2}, {"HDC1000 Hum", 2}};
+
+#define SENSOR(columns)		{columns, sizeof(columns)/sizeof(columns[0])}
+
+static const WarpHostFrameSensor	frameSensors[kWarpBinaryFrameSensorCount] = {
+						[kWarpBinaryFrameSensorMMA8451Q]	= SENSOR(columnsMMA8451Q),
+						[kWarpBinaryFrameSensorINA219]		= SENSOR(columnsINA219),
+						[kWarpBinaryFrameSensorMAG3110]		= SENSOR(columnsMAG3110),
+						[kWarpBinaryFrameSensorL3GD20H]		= SENSOR(columnsL3GD20H),
+						[kWarpBinaryFrameSensorBME680]		= SENSOR(columnsBME680),
+						[kWarpBinaryFrameSensorBMX055accel]	= SENSOR(columnsBMX055accel),
+						[kWarpBinaryFrameSensorBMX055mag]	= SENSOR(columnsBMX055mag),
+						[kWarpBinaryFrameSensorBMX055gyro]	= SENSOR(columnsBMX055gyro),
+						[kWarpBinaryFrameSensorCCS811]		= SENSOR(columnsCCS811),
+						[kWarpBinaryFrameSensorHDC1000]		= SENSOR(columnsHDC1000),
+					};
+
+static uint16_t
+crc16Ccitt(const uint8_t *  bytes, size_t count)
+{
+	uint16_t	crc = 0xFFFF;
+
+	while (count-- > 0)
+	{
+		crc ^= (uint16_t)(*bytes++) << 8;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+static uint32_t
+getLittleEndian(const uint8_t *  bytes, int numberOfBytes)
+{
+	uint32_t	value = 0;
+
+	while (numberOfBytes-- > 0)
+	{
+		value = (value << 8) | bytes[numberOfBytes];
+	}
+
+	return value;
+}
+
+static int
+payloadBytesForSensors(uint16_t sensors)
+{
+	int	total = 0;
+
+	for (int sensor = 0; sensor < kWarpBinaryFrameSensorCount; sensor++)
+	{
+		if (sensors & (1u << sensor))
+		{
+			for (int column = 0; column < frameSensors[sensor].numberOfColumns; column++)
+			{
+				total += frameSensors[sensor].columns[column].numberOfBytes;
+			}
+		}
+	}
+
+	return total;
+}
+
+static void
+printHeader(FILE *  out, uint16_t sensors)
+{
+	fprintf(out, "Measurement number, RTC->TSR, RTC->TPR,");
+	for (int sensor = 0; sensor < kWarpBinaryFrameSensorCount; sensor++)
+	{
+		if (sensors & (1u << sensor))
+		{
+			for (int column = 0; column < frameSensors[sensor].numberOfColumns; column++)
+			{
+				fprintf(out, " %s,", frameSensors[sensor].columns[column].name);
+			}
+		}
+	}
+	fprintf(out, " Failed sensors\n");
+}
+
+static void
+printFrame(FILE *  out, const uint8_t *  frame)
+{
+	uint16_t	sensors = getLittleEndian(&frame[kWarpBinaryFrameOffsetSensorsPresent], 2);
+	uint16_t	failed = getLittleEndian(&frame[kWarpBinaryFrameOffsetSensorsFailed], 2);
+	const uint8_t *	payload = &frame[kWarpBinaryFrameHeaderBytes];
+
+	fprintf(out, "%u, %u, %u,",
+		getLittleEndian(&frame[kWarpBinaryFrameOffsetSequence], 4),
+		getLittleEndian(&frame[kWarpBinaryFrameOffsetTSR], 4),
+		getLittleEndian(&frame[kWarpBinaryFrameOffsetTPR], 2));
+
+	for (int sensor = 0; sensor < kWarpBinaryFrameSensorCount; sensor++)
+	{
+		if (!(sensors & (1u << sensor)))
+		{
+			continue;
+		}
+
+		for (int column = 0; column < frameSensors[sensor].numberOfColumns; column++)
+		{
+			int	numberOfBytes = frameSensors[sensor].columns[column].numberOfBytes;
+
+			if (failed & (1u << sensor))
+			{
+				fprintf(out, " ----,");
+			}
+			else
+			{
+				for (int byte = 0; byte < numberOfBytes; byte++)
+				{
+					fprintf(out, " 0x%02x", payload[byte]);
+				}
+				fprintf(out, ",");
+			}
+			payload += numberOfBytes;
+		}
+	}
+
+	fprintf(out, " 0x%04x\n", failed);
+}
+
+typedef struct
+{
+	uint32_t	firstSample;
+	uint32_t	triggerSample;
+	uint32_t	triggerMicroseconds;
+	uint16_t	periodMicroseconds;
+	uint16_t	microampsPerCount;
+	bool		summarySeen;
+} WarpHostCapture;
+
+static void
+printCaptureSample(FILE *  out, const WarpHostCapture *  capture, uint32_t sample, uint32_t microseconds, int16_t value)
+{
+	uint32_t	origin = (capture->triggerSample == UINT32_MAX) ? capture->firstSample : capture->triggerSample;
+
+	fprintf(out, "%u, %d, %d, %d, %d\n", sample, (int32_t)(sample - origin),
+		(int32_t)(microseconds - capture->triggerMicroseconds), value, value * capture->microampsPerCount);
+}
+
+/*
+ *	Returns the number of samples decoded from the record.
+ */
+static uint32_t
+decodeCaptureRecord(FILE *  out, WarpHostCapture *  capture, const uint8_t *  payload, uint8_t type)
+{
+	uint32_t	sample;
+	uint32_t	microseconds;
+	int16_t		value;
+	uint8_t		count;
+
+	if (type == kWarpCaptureDumpRecordSummary)
+	{
+		capture->firstSample		= getLittleEndian(&payload[0], 4);
+		capture->triggerSample		= getLittleEndian(&payload[4], 4);
+		capture->triggerMicroseconds	= getLittleEndian(&payload[8], 4);
+		capture->periodMicroseconds	= getLittleEndian(&payload[14], 2);
+		capture->microampsPerCount	= getLittleEndian(&payload[16], 2);
+		capture->summarySeen		= true;
+
+		fprintf(out, "Capture sample, Samples from trigger, Microseconds from trigger, INA219 Current, INA219 uA\n");
+		if (capture->triggerSample == UINT32_MAX)
+		{
+			/*
+			 *	No trigger: time from the first block instead.
+			 */
+			capture->triggerMicroseconds = 0;
+		}
+
+		return 0;
+	}
+
+	sample		= getLittleEndian(&payload[0], 4);
+	microseconds	= getLittleEndian(&payload[4], 4);
+	value		= (int16_t)getLittleEndian(&payload[8], 2);
+	count		= payload[10];
+
+	if (capture->triggerSample == UINT32_MAX && capture->triggerMicroseconds == 0)
+	{
+		capture->triggerMicroseconds = microseconds;
+	}
+
+	for (uint8_t i = 0; i < count && i <= kWarpCaptureBlockDeltas; i++)
+	{
+		if (i != 0)
+		{
+			value += (int8_t)payload[11 + i - 1];
+		}
+		printCaptureSample(out, capture, sample + i, microseconds + i*capture->periodMicroseconds, value);
+	}
+
+	return count;
+}
+
+/*
+ *	Returns the number of valid frames and capture samples. Statistics go
+ *	to stderr.
+ */
+uint32_t
+warpHostDecodeFrames(FILE *  in, FILE *  out)
+{
+	uint8_t *	stream = NULL;
+	size_t		length = 0;
+	size_t		capacity = 0;
+	size_t		offset = 0;
+	size_t		skippedBytes = 0;
+	uint32_t	frames = 0;
+	uint32_t	crcErrors = 0;
+	uint32_t	droppedFrames = 0;
+	uint32_t	expectedSequence = 0;
+	uint32_t	captureSamples = 0;
+	WarpHostCapture	capture = {.summarySeen = false};
+	uint16_t	headerSensors = 0;
+	bool		headerPrinted = false;
+	size_t		n;
+
+	do
+	{
+		if (length == capacity)
+		{
+			capacity = (capacity == 0) ? 65536 : 2*capacity;
+			stream = realloc(stream, capacity);
+			if (stream == NULL)
+			{
+				fprintf(stderr, "warp-host: decode: out of memory\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		n = fread(&stream[length], 1, capacity - length, in);
+		length += n;
+	} while (n != 0);
+
+	while (offset + kWarpBinaryFrameHeaderBytes + kWarpBinaryFrameCrcBytes <= length)
+	{
+		const uint8_t *	frame = &stream[offset];
+		uint16_t	sensors;
+		size_t		payloadBytes;
+		size_t		frameBytes;
+		uint32_t	sequence;
+
+		if (frame[0] == kWarpCaptureDumpSync0 && frame[1] == kWarpCaptureDumpSync1)
+		{
+			uint8_t	type = frame[kWarpCaptureDumpOffsetType];
+
+			payloadBytes = frame[kWarpCaptureDumpOffsetLength];
+			frameBytes = kWarpCaptureDumpHeaderBytes + payloadBytes + kWarpCaptureDumpCrcBytes;
+			if (offset + frameBytes > length)
+			{
+				break;
+			}
+
+			if (!((type == kWarpCaptureDumpRecordSummary && payloadBytes == kWarpCaptureDumpSummaryBytes)
+					|| (type == kWarpCaptureDumpRecordBlock && payloadBytes == kWarpCaptureDumpBlockBytes && capture.summarySeen))
+				|| crc16Ccitt(&frame[kWarpCaptureDumpOffsetLength], frameBytes - kWarpCaptureDumpOffsetLength - kWarpCaptureDumpCrcBytes)
+					!= getLittleEndian(&frame[frameBytes - kWarpCaptureDumpCrcBytes], 2))
+			{
+				crcErrors++;
+				offset++;
+				skippedBytes++;
+				continue;
+			}
+
+			captureSamples += decodeCaptureRecord(out, &capture, &frame[kWarpCaptureDumpHeaderBytes], type);
+			offset += frameBytes;
+			continue;
+		}
+
+		if (frame[0] != kWarpBinaryFrameSync0 || frame[1] != kWarpBinaryFrameSync1)
+		{
+			offset++;
+			skippedBytes++;
+			continue;
+		}
+
+		sensors = getLittleEndian(&frame[kWarpBinaryFrameOffsetSensorsPresent], 2);
+		payloadBytes = frame[kWarpBinaryFrameOffsetLength];
+		frameBytes = kWarpBinaryFrameHeaderBytes + payloadBytes + kWarpBinaryFrameCrcBytes;
+		if (offset + frameBytes > length)
+		{
+			break;
+		}
+
+		if ((int)payloadBytes != payloadBytesForSensors(sensors)
+			|| crc16Ccitt(&frame[kWarpBinaryFrameOffsetLength], frameBytes - kWarpBinaryFrameOffsetLength - kWarpBinaryFrameCrcBytes)
+				!= getLittleEndian(&frame[frameBytes - kWarpBinaryFrameCrcBytes], 2))
+		{
+			crcErrors++;
+			offset++;
+			skippedBytes++;
+			continue;
+		}
+
+		if (!headerPrinted || sensors != headerSensors)
+		{
+			printHeader(out, sensors);
+			headerSensors = sensors;
+			headerPrinted = true;
+		}
+
+		sequence = getLittleEndian(&frame[kWarpBinaryFrameOffsetSequence], 4);
+		if (frames != 0 && sequence != expectedSequence)
+		{
+			droppedFrames += sequence - expectedSequence;
+		}
+		expectedSequence = sequence + 1;
+
+		printFrame(out, frame);
+		frames++;
+		offset += frameBytes;
+	}
+
+	skippedBytes += length - offset;
+	free(stream);
+
+	fprintf(stderr, "warp-host: decode: %u frames, %u dropped (sequence gaps), %u capture samples, %u failed CRC or length checks, %zu bytes outside frames\n",
+		frames, droppedFrames, captureSamples, crcErrors, skippedBytes);
+
+	return frames + captureSamples;
+}
+
+
+
+/*
+ *	Renderer for the records of WARP_LOG() in deferred mode (layout in
+ *	warp-log.h), using the same message table the firmware was built
+ *	with. Every format in the table takes only integer conversions, so
+ *	the arguments can be passed as a fixed list of unsigned words.
+ */
+static const char *	logFormats[] =
+{
+#define WARP_LOG_MESSAGE(name, format)	[name] = format,
+#include "warp-log-messages.h"
+#undef WARP_LOG_MESSAGE
+};
+
+uint32_t
+warpHostRenderLog(FILE *  in, FILE *  out)
+{
+	uint32_t	records = 0, badRecords = 0, droppedRecords = 0;
+	unsigned	arguments[kWarpLogMaxArguments];
+	uint8_t		word[4];
+	int		message, argumentCount, i;
+
+	while ((message = fgetc(in)) != EOF && (argumentCount = fgetc(in)) != EOF)
+	{
+		if (message >= kWarpLogMessageCount || argumentCount > kWarpLogMaxArguments)
+		{
+			/*
+			 *	Not a record boundary (e.g. a capture that starts mid-record):
+			 *	step one byte and try again.
+			 */
+			ungetc(argumentCount, in);
+			badRecords++;
+			continue;
+		}
+
+		memset(arguments, 0, sizeof(arguments));
+		for (i = 0; i < argumentCount && fread(word, 1, sizeof(word), in) == sizeof(word); i++)
+		{
+			arguments[i] = getLittleEndian(word, 4);
+		}
+
+		if (i != argumentCount)
+		{
+			/*
+			 *	Capture ends mid-record.
+			 */
+			badRecords++;
+			break;
+		}
+
+		if (message == kWarpLogDropped)
+		{
+			droppedRecords += arguments[0];
+		}
+
+		fprintf(out, logFormats[message], arguments[0], arguments[1], arguments[2],
+			arguments[3], arguments[4], arguments[5]);
+		records++;
+	}
+
+	fprintf(stderr, "warp-host: render: %u records, %u dropped on the target, %u malformed\n",
+		records, droppedRecords, badRecords);
+
+	return records;
+}
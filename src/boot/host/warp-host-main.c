@@ -0,0 +1,416 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_os_abstraction.h"
+#include "fsl_power_manager.h"
+
+#include "SEGGER_RTT.h"
+#include "warp.h"
+#include "devMMA8451Q.h"
+#include "devINA219.h"
+#include "devSSD1331.h"
+#include "warp-log.h"
+#include "warp-capture.h"
+#include "warp-host.h"
+
+
+/*
+ *	Defined in warp-kl03-ksdk1.1-boot.c, whose main() is renamed for the
+ *	host build (see build/host/CMakeLists.txt).
+ */
+extern volatile WarpI2CDeviceState	deviceMMA8451QState;
+extern volatile WarpI2CDeviceState	deviceINA219State;
+extern volatile uint32_t		gWarpI2cBaudRateKbps;
+
+int	warpHostFirmwareMain(void);
+void	runPedometer(void);
+void	runAccelerationFifoStream(int batches);
+void	printAllSensors(bool printHeadersAndCalibration, bool hexModeFlag, int menuDelayBetweenEachRun, int i2cPullupValue);
+void	streamAllSensorsBinary(int menuDelayBetweenEachRun, int i2cPullupValue, uint32_t numberOfFrames);
+void	printScheduledSensors(bool hexModeFlag, int i2cPullupValue, uint32_t numberOfRecords);
+void	runEnergyProfiles(uint8_t runs, uint16_t menuI2cPullupValue);
+void	runCurrentCapture(WarpCaptureTrigger trigger, int16_t level, uint16_t menuI2cPullupValue);
+uint16_t	runI2cTuning(uint16_t menuI2cPullupValue);
+
+static const char *	stopReasonNames[] = {
+				[kWarpHostStopNone]		= "none",
+				[kWarpHostStopReturned]		= "returned",
+				[kWarpHostStopTimeLimit]	= "virtual time limit reached",
+				[kWarpHostStopInputClosed]	= "stdin closed",
+				[kWarpHostStopNoWakeSource]	= "low-power sleep with no wake source",
+			};
+
+/*
+ *	Same order as the powerConfigs[] table in the firmware's main(),
+ *	which warpSetLowPowerMode() indexes by WarpPowerMode.
+ */
+static const power_manager_user_config_t	hostPowerModeConfigs[] = {
+							{.mode = kPowerManagerWait},
+							{.mode = kPowerManagerStop},
+							{.mode = kPowerManagerVlpr},
+							{.mode = kPowerManagerVlpw},
+							{.mode = kPowerManagerVlps},
+							{.mode = kPowerManagerVlls0},
+							{.mode = kPowerManagerVlls1},
+							{.mode = kPowerManagerVlls3},
+							{.mode = kPowerManagerRun},
+						};
+static power_manager_user_config_t const *	hostPowerConfigs[] = {
+							&hostPowerModeConfigs[0], &hostPowerModeConfigs[1],
+							&hostPowerModeConfigs[2], &hostPowerModeConfigs[3],
+							&hostPowerModeConfigs[4], &hostPowerModeConfigs[5],
+							&hostPowerModeConfigs[6], &hostPowerModeConfigs[7],
+							&hostPowerModeConfigs[8],
+						};
+
+static int		sensorsDelayMilliseconds;
+static int		fifoBatches = 8;
+static uint32_t		binaryFrames = 100;
+static uint32_t		scheduledRecords = 1000;
+static uint8_t		energyRuns = 10;
+static int		captureLevel = -1;
+
+
+
+static void
+initHostBoard(void)
+{
+	rtc_datetime_t	bootDate = {.year = 2016U, .month = 1U, .day = 1U};
+
+	OSA_Init();
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+	warpLogInit();
+	RTC_DRV_Init(0);
+	RTC_DRV_SetDatetime(0, &bootDate);
+	POWER_SYS_Init(&hostPowerConfigs, sizeof(hostPowerConfigs)/sizeof(hostPowerConfigs[0]), NULL, 0);
+	warpSetLowPowerMode(kWarpPowerModeVLPR, 0);
+
+	initMMA8451Q(	0x1D	/* i2cAddress */,	&deviceMMA8451QState	);
+	initINA219(	0x40	/* i2cAddress */,	&deviceINA219State	);
+}
+
+static void
+runFirmwareMenu(void)
+{
+	warpHostFirmwareMain();
+}
+
+static void
+runPedometerWorkload(void)
+{
+	initHostBoard();
+	devSSD1331init();
+	runPedometer();
+}
+
+static void
+runSensorsWorkload(void)
+{
+	initHostBoard();
+	printAllSensors(true /* printHeadersAndCalibration */, false /* hexModeFlag */, sensorsDelayMilliseconds, 32768);
+}
+
+static void
+runFifoWorkload(void)
+{
+	initHostBoard();
+	runAccelerationFifoStream(fifoBatches);
+}
+
+static void
+runFramesWorkload(void)
+{
+	initHostBoard();
+	streamAllSensorsBinary(sensorsDelayMilliseconds, 32768, binaryFrames);
+}
+
+static void
+runScheduleWorkload(void)
+{
+	initHostBoard();
+	printScheduledSensors(false /* hexModeFlag */, 32768, scheduledRecords);
+}
+
+static void
+runEnergyWorkload(void)
+{
+	initHostBoard();
+	devSSD1331init();
+	runEnergyProfiles(energyRuns, 32768);
+}
+
+/*
+ *	A level of -1 selects the software trigger (a RUN/VLPR switch).
+ */
+static void
+runCaptureWorkload(void)
+{
+	initHostBoard();
+	runCurrentCapture((captureLevel < 0) ? kWarpCaptureTriggerSoftware : kWarpCaptureTriggerLevel, (int16_t)captureLevel, 32768);
+}
+
+static void
+runTuneWorkload(void)
+{
+	initHostBoard();
+	runI2cTuning(32768);
+}
+
+static void
+printStatistics(WarpHostStopReason reason, uint32_t stackBytesUsed)
+{
+	WarpHostBusStatistics *	s = &gWarpHostBusStatistics;
+	uint64_t		now = warpHostNowMicroseconds();
+	uint32_t		samples = 0;
+	WarpHostI2cDevice *	device;
+
+	fprintf(stderr, "\nwarp-host: stopped: %s\n", stopReasonNames[reason]);
+	fprintf(stderr, "warp-host: virtual time        %llu us\n", (unsigned long long)now);
+	fprintf(stderr, "warp-host: I2C                 %u transactions, %u bytes, %u failures, %llu us on the bus\n",
+		s->i2cTransactions, s->i2cBytes, s->i2cFailures, (unsigned long long)s->i2cBusMicroseconds);
+	fprintf(stderr, "warp-host: SPI                 %u transactions, %u bytes, %llu us on the bus\n",
+		s->spiTransactions, s->spiBytes, (unsigned long long)s->spiBusMicroseconds);
+	fprintf(stderr, "warp-host: OSA_TimeDelay       %llu us\n", (unsigned long long)s->delayMicroseconds);
+	fprintf(stderr, "warp-host: low-power sleep     %llu us in %u sleeps, %u interrupts\n",
+		(unsigned long long)s->sleepMicroseconds, s->sleeps, s->interrupts);
+	fprintf(stderr, "warp-host: time in mode        RUN %llu us, VLPR %llu us, VLPS %llu us\n",
+		(unsigned long long)warpHostModeMicroseconds(kPowerManagerRun),
+		(unsigned long long)warpHostModeMicroseconds(kPowerManagerVlpr),
+		(unsigned long long)warpHostModeMicroseconds(kPowerManagerVlps));
+	fprintf(stderr, "warp-host: supply charge       %.3f uC (modelled currents)\n", (double)warpHostChargePicocoulombs() / 1e6);
+
+	for (int i = 0; (device = warpHostI2cDeviceByIndex(i)) != NULL; i++)
+	{
+		fprintf(stderr, "warp-host:   %-10s 0x%02x  %u transactions, %u bytes, %u us, %u samples\n",
+			device->name, device->address, device->transactions, device->bytes, device->busMicroseconds, device->samples);
+		samples += device->samples;
+	}
+
+	if (samples != 0)
+	{
+		fprintf(stderr, "warp-host: per sample          %.2f I2C transactions, %.2f I2C bytes, %.1f us virtual time\n",
+			(double)s->i2cTransactions / samples, (double)s->i2cBytes / samples, (double)now / samples);
+	}
+
+	/*
+	 *	The stack figure is for x86-64 code (wider pointers, different
+	 *	inlining), so treat it as an upper bound against the 0x200 byte
+	 *	__stack_size__ of the KL03 link; the map file has the static RAM.
+	 */
+	fprintf(stderr, "warp-host: peak firmware stack %u bytes (host x86-64)\n", stackBytesUsed);
+}
+
+static void
+usage(const char *  program)
+{
+	fprintf(stderr, "usage: %s [menu | pedometer | sensors [delay-ms] | fifo [batches] | frames [count] | schedule [records] | energy [runs] | capture [level] | tune] [--time-limit seconds] [--quiet] [--log file]\n", program);
+	fprintf(stderr, "       %s decode < frames > frames.csv\n", program);
+	fprintf(stderr, "       %s capture 2>/dev/null | %s decode > capture.csv\n", program, program);
+	fprintf(stderr, "       %s render < log > log.txt\n", program);
+	fprintf(stderr, "       %s steps < trace.csv\n", program);
+	fprintf(stderr, "       %s stepbench\n", program);
+	fprintf(stderr, "       %s ahrs\n", program);
+	fprintf(stderr, "       %s bme680\n", program);
+	exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char *  argv[])
+{
+	void			(*workload)(void) = runFirmwareMenu;
+	uint64_t		timeLimitSeconds = 0;
+	uint32_t		stackBytesUsed = 0;
+	WarpHostStopReason	reason;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "menu") == 0)
+		{
+			workload = runFirmwareMenu;
+		}
+		else if (strcmp(argv[i], "pedometer") == 0)
+		{
+			/*
+			 *	runPedometer() now runs until a key arrives.
+			 */
+			workload = runPedometerWorkload;
+			if (timeLimitSeconds == 0)
+			{
+				timeLimitSeconds = 30;
+			}
+		}
+		else if (strcmp(argv[i], "sensors") == 0)
+		{
+			workload = runSensorsWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				sensorsDelayMilliseconds = atoi(argv[++i]);
+			}
+			if (timeLimitSeconds == 0)
+			{
+				timeLimitSeconds = 10;
+			}
+		}
+		else if (strcmp(argv[i], "frames") == 0)
+		{
+			workload = runFramesWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				binaryFrames = strtoul(argv[++i], NULL, 0);
+			}
+		}
+		else if (strcmp(argv[i], "schedule") == 0)
+		{
+			workload = runScheduleWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				scheduledRecords = strtoul(argv[++i], NULL, 0);
+			}
+		}
+		else if (strcmp(argv[i], "energy") == 0)
+		{
+			workload = runEnergyWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				energyRuns = (uint8_t)strtoul(argv[++i], NULL, 0);
+			}
+		}
+		else if (strcmp(argv[i], "tune") == 0)
+		{
+			workload = runTuneWorkload;
+		}
+		else if (strcmp(argv[i], "capture") == 0)
+		{
+			workload = runCaptureWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				captureLevel = atoi(argv[++i]);
+			}
+		}
+		else if (strcmp(argv[i], "decode") == 0)
+		{
+			/*
+			 *	Not a simulation: turn frames on stdin into CSV.
+			 */
+			return (warpHostDecodeFrames(stdin, stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "render") == 0)
+		{
+			/*
+			 *	Not a simulation: turn deferred log records on stdin into text.
+			 */
+			return (warpHostRenderLog(stdin, stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "steps") == 0)
+		{
+			/*
+			 *	Not a simulation: the step detector over a trace on stdin.
+			 */
+			return (warpHostCountSteps(stdin, stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "stepbench") == 0)
+		{
+			/*
+			 *	Not a simulation: the step detectors on labelled synthetic traces.
+			 */
+			return (warpHostRunStepBenchmark(stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "ahrs") == 0)
+		{
+			/*
+			 *	Not a simulation: the orientation filter on synthetic data.
+			 */
+			return (warpHostRunAhrsHarness(stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "bme680") == 0)
+		{
+			/*
+			 *	Not a simulation: BME680 compensation on calibration vectors.
+			 */
+			return (warpHostRunBme680Harness(stdout) != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(argv[i], "fifo") == 0)
+		{
+			workload = runFifoWorkload;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				fifoBatches = atoi(argv[++i]);
+			}
+		}
+		else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc)
+		{
+			timeLimitSeconds = strtoull(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "--quiet") == 0)
+		{
+			gWarpHostQuiet = true;
+		}
+		else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+		{
+			/*
+			 *	RTT channel 1, where WARP_LOG() records go in deferred mode.
+			 */
+			gWarpHostLogSink = fopen(argv[++i], "wb");
+			if (gWarpHostLogSink == NULL)
+			{
+				perror(argv[i]);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else
+		{
+			usage(argv[0]);
+		}
+	}
+
+	warpHostMapPeripherals();
+	warpHostBusInit();
+	warpHostSetTimeLimitMicroseconds(timeLimitSeconds * 1000000u);
+
+	reason = warpHostRun(workload, &stackBytesUsed);
+	printStatistics(reason, stackBytesUsed);
+
+	return (reason == kWarpHostStopReturned || reason == kWarpHostStopTimeLimit || reason == kWarpHostStopInputClosed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
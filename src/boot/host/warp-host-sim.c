@@ -0,0 +1,1207 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_os_abstraction.h"
+#include "fsl_gpio_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_rtc_hal.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_interrupt_manager.h"
+#include "fsl_lpuart_driver.h"
+#include "fsl_lptmr_driver.h"
+#include "fsl_port_hal.h"
+
+#include "SEGGER_RTT.h"
+#include "warp.h"
+#include "warp-log.h"
+#include "warp-host.h"
+
+
+/*
+ *	Regions of the KL03 memory map that the firmware and the inline KSDK
+ *	HAL accessors touch directly (RTC->TSR, PORTx_PCRn, SIM, NVIC, ...).
+ *	They are backed by anonymous memory at their real addresses.
+ */
+typedef struct
+{
+	uintptr_t	base;
+	size_t		size;
+} WarpHostMemoryRegion;
+
+/*
+ *	Named as in the KSDK GPIO driver, which the firmware also indexes.
+ */
+const uint32_t				g_portBaseAddr[HW_PORT_INSTANCE_COUNT] = {PORTA_BASE, PORTB_BASE};
+
+static const WarpHostMemoryRegion	peripheralRegions[] = {
+						{0x40000000u, 0x00100000u},	/*	AIPS peripherals and GPIO	*/
+						{0xE0000000u, 0x00100000u},	/*	Private peripheral bus		*/
+						{0xF8000000u, 0x00001000u},	/*	FGPIO				*/
+					};
+
+enum
+{
+	kWarpHostFirmwareStackBytes	= 256 * 1024,
+	kWarpHostStackPaint		= 0xA5,
+	kWarpHostIdlePollsBeforeBlock	= 1000,
+	kWarpHostRtcPrescalerHz		= 32768,
+	kWarpHostPowerModes		= kPowerManagerMax,
+};
+
+/*
+ *	Pin-detect vectors. The firmware defines the ones it uses.
+ */
+void					PORTA_IRQHandler(void) __attribute__((weak));
+void					PORTB_IRQHandler(void) __attribute__((weak));
+void					LPTMR0_IRQHandler(void) __attribute__((weak));
+
+/*
+ *	Supply current of the board in each mode, for the INA219 model:
+ *	roughly the KL03 datasheet figures at the clock configurations the
+ *	firmware uses, plus a few hundred uA of always-on sensors. Bus
+ *	transfers add their own load (warpHostSetLoadMicroamps()).
+ */
+static const uint32_t			modeMicroamps[kWarpHostPowerModes] = {
+						[kPowerManagerRun]	= 6500,
+						[kPowerManagerVlpr]	= 600,
+						[kPowerManagerWait]	= 3800,
+						[kPowerManagerVlpw]	= 450,
+						[kPowerManagerStop]	= 550,
+						[kPowerManagerVlps]	= 300,
+					};
+
+WarpHostBusStatistics			gWarpHostBusStatistics;
+bool					gWarpHostQuiet;
+FILE *					gWarpHostLogSink;
+
+uint32_t				g_xtal0ClkFreq;
+uint32_t				g_xtalRtcClkFreq;
+
+static uint64_t				virtualMicroseconds;
+static uint64_t				timeLimitMicroseconds;
+static uint32_t				rtcEpochSeconds;
+static uint32_t				rtcAlarmSeconds;
+static bool				rtcAlarmArmed;
+static bool				rtcAlarmInterruptEnabled;
+static uint64_t				modeMicroseconds[kWarpHostPowerModes];
+static uint64_t				chargePicocoulombs;
+static uint32_t				loadMicroamps;
+
+static power_manager_user_config_t const **	powerConfigs;
+static uint8_t				powerConfigsCount;
+static power_manager_modes_t		currentPowerMode = kPowerManagerRun;
+static uint8_t				currentClockConfiguration;
+
+static uint32_t				gpioOutputs[kWarpHostMaxGpioPorts];
+static uint32_t				gpioInputs[kWarpHostMaxGpioPorts];
+static uint32_t				gpioDirections[kWarpHostMaxGpioPorts];
+
+static bool				lptmrRunning;
+static uint32_t				lptmrPeriodMicroseconds;
+static uint64_t				lptmrStartMicroseconds;
+static uint64_t				lptmrNextMicroseconds;
+static lptmr_callback_t			lptmrCallback;
+
+static ucontext_t			hostContext;
+static ucontext_t			firmwareContext;
+static uint8_t *			firmwareStack;
+static void				(*firmwareEntry)(void);
+static bool				firmwareRunning;
+static WarpHostStopReason		stopReason;
+
+static uint32_t			portInterruptsPending[kWarpHostMaxGpioPorts];
+static uint32_t				interruptDepth;
+static uint32_t				interruptsMaskedDepth;
+
+static bool				stdinClosed;
+static uint32_t				idlePolls;
+static uint64_t				idlePollsAwakeMicroseconds;
+
+
+
+void
+warpHostMapPeripherals(void)
+{
+	for (size_t i = 0; i < sizeof(peripheralRegions)/sizeof(peripheralRegions[0]); i++)
+	{
+		void *	mapped = mmap(	(void *)peripheralRegions[i].base,
+					peripheralRegions[i].size,
+					PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+					-1,
+					0);
+
+		if (mapped != (void *)peripheralRegions[i].base)
+		{
+			fprintf(stderr, "warp-host: cannot map peripheral region 0x%08lx\n", (unsigned long)peripheralRegions[i].base);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+
+
+/*
+ *	Virtual clock
+ */
+static void
+updateRtcRegisters(void)
+{
+	RTC_TSR = rtcEpochSeconds + (uint32_t)(virtualMicroseconds / 1000000u);
+	RTC_TPR = (uint32_t)(((virtualMicroseconds % 1000000u) * kWarpHostRtcPrescalerHz) / 1000000u);
+}
+
+uint64_t
+warpHostNowMicroseconds(void)
+{
+	return virtualMicroseconds;
+}
+
+void
+warpHostSetTimeLimitMicroseconds(uint64_t microseconds)
+{
+	timeLimitMicroseconds = microseconds;
+}
+
+uint64_t
+warpHostModeMicroseconds(int mode)
+{
+	if (mode < 0 || mode >= kWarpHostPowerModes)
+	{
+		return 0;
+	}
+
+	return modeMicroseconds[mode];
+}
+
+/*
+ *	Charge drawn from the supply since the start, in pC (uA x us).
+ */
+uint64_t
+warpHostChargePicocoulombs(void)
+{
+	return chargePicocoulombs;
+}
+
+void
+warpHostSetLoadMicroamps(uint32_t microamps)
+{
+	loadMicroamps = microamps;
+}
+
+static void
+moveClockTo(uint64_t microseconds)
+{
+	if (microseconds > virtualMicroseconds)
+	{
+		modeMicroseconds[currentPowerMode] += microseconds - virtualMicroseconds;
+		chargePicocoulombs += (uint64_t)(modeMicroamps[currentPowerMode] + loadMicroamps) * (microseconds - virtualMicroseconds);
+		virtualMicroseconds = microseconds;
+		updateRtcRegisters();
+	}
+}
+
+static uint64_t
+nextLptmrMicroseconds(void)
+{
+	if (!lptmrRunning || lptmrPeriodMicroseconds == 0)
+	{
+		return UINT64_MAX;
+	}
+
+	return lptmrNextMicroseconds;
+}
+
+/*
+ *	Interrupts are delivered by calling the firmware handler from
+ *	whatever the firmware was doing when the clock crossed the event.
+ *	A handler that itself moves the clock (e.g., an I2C transfer in an
+ *	LPTMR callback) does not get preempted: anything that becomes due
+ *	meanwhile stays pending until the outermost handler returns, as
+ *	with a single NVIC priority level on the Cortex-M0+. Likewise while
+ *	the firmware has interrupts masked (INT_SYS_DisableIRQGlobal()).
+ */
+static void
+deliverPendingInterrupts(void)
+{
+	if (interruptDepth != 0 || interruptsMaskedDepth != 0)
+	{
+		return;
+	}
+
+	interruptDepth++;
+	for (;;)
+	{
+		if (nextLptmrMicroseconds() <= virtualMicroseconds)
+		{
+			lptmrNextMicroseconds += lptmrPeriodMicroseconds;
+			gWarpHostBusStatistics.interrupts++;
+			if (lptmrCallback != NULL)
+			{
+				lptmrCallback();
+			}
+
+			continue;
+		}
+
+		if (portInterruptsPending[0] != 0)
+		{
+			portInterruptsPending[0] = 0;
+			gWarpHostBusStatistics.interrupts++;
+			if (PORTA_IRQHandler != NULL)
+			{
+				PORTA_IRQHandler();
+			}
+
+			continue;
+		}
+
+		if (portInterruptsPending[1] != 0)
+		{
+			portInterruptsPending[1] = 0;
+			gWarpHostBusStatistics.interrupts++;
+			if (PORTB_IRQHandler != NULL)
+			{
+				PORTB_IRQHandler();
+			}
+
+			continue;
+		}
+
+		break;
+	}
+	interruptDepth--;
+}
+
+static bool
+maskedInterruptPending(void)
+{
+	return interruptsMaskedDepth != 0 &&
+		(portInterruptsPending[0] != 0 || portInterruptsPending[1] != 0 || nextLptmrMicroseconds() <= virtualMicroseconds);
+}
+
+void
+warpHostAdvanceMicroseconds(uint64_t microseconds)
+{
+	uint64_t	target = virtualMicroseconds + microseconds;
+
+	/*
+	 *	Step the clock through every LPTMR compare and device event
+	 *	that falls inside the interval, in order, so that each one
+	 *	sees the time at which it happens.
+	 */
+	for (;;)
+	{
+		uint64_t	next = warpHostBusNextEventMicroseconds();
+		uint64_t	lptmr = (interruptDepth == 0 && interruptsMaskedDepth == 0) ? nextLptmrMicroseconds() : UINT64_MAX;
+
+		if (lptmr < next)
+		{
+			next = lptmr;
+		}
+
+		if (next > target)
+		{
+			break;
+		}
+
+		moveClockTo(next);
+		warpHostBusService(virtualMicroseconds);
+		deliverPendingInterrupts();
+	}
+
+	moveClockTo(target);
+	deliverPendingInterrupts();
+
+	if (timeLimitMicroseconds != 0 && virtualMicroseconds >= timeLimitMicroseconds)
+	{
+		warpHostStop(kWarpHostStopTimeLimit);
+	}
+}
+
+
+
+/*
+ *	Running the firmware on its own (painted) stack lets the harness
+ *	measure peak stack use and abandon the firmware at any point.
+ */
+static void
+firmwareTrampoline(void)
+{
+	firmwareEntry();
+	warpHostStop(kWarpHostStopReturned);
+}
+
+WarpHostStopReason
+warpHostRun(void (*entry)(void), uint32_t *  stackBytesUsed)
+{
+	firmwareStack = malloc(kWarpHostFirmwareStackBytes);
+	if (firmwareStack == NULL)
+	{
+		fprintf(stderr, "warp-host: cannot allocate firmware stack\n");
+		exit(EXIT_FAILURE);
+	}
+	memset(firmwareStack, kWarpHostStackPaint, kWarpHostFirmwareStackBytes);
+
+	getcontext(&firmwareContext);
+	firmwareContext.uc_stack.ss_sp = firmwareStack;
+	firmwareContext.uc_stack.ss_size = kWarpHostFirmwareStackBytes;
+	firmwareContext.uc_link = NULL;
+	makecontext(&firmwareContext, firmwareTrampoline, 0);
+
+	firmwareEntry = entry;
+	firmwareRunning = true;
+	stopReason = kWarpHostStopNone;
+	swapcontext(&hostContext, &firmwareContext);
+	firmwareRunning = false;
+
+	if (stackBytesUsed != NULL)
+	{
+		uint32_t	untouched = 0;
+
+		while (untouched < kWarpHostFirmwareStackBytes && firmwareStack[untouched] == kWarpHostStackPaint)
+		{
+			untouched++;
+		}
+		*stackBytesUsed = kWarpHostFirmwareStackBytes - untouched;
+	}
+
+	return stopReason;
+}
+
+void
+warpHostStop(WarpHostStopReason reason)
+{
+	warpHostRttFlush();
+
+	if (!firmwareRunning)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	stopReason = reason;
+	swapcontext(&firmwareContext, &hostContext);
+}
+
+
+
+/*
+ *	SEGGER RTT: the host end of the up and down buffers. Called from
+ *	SEGGER_RTT_LOCK() (see SEGGER_RTT_Conf.h), so every RTT access by
+ *	the firmware gives the host a chance to drain and refill them.
+ */
+static void
+drainUpBuffer(unsigned bufferIndex, FILE *  sink)
+{
+	SEGGER_RTT_BUFFER_UP *	up = &_SEGGER_RTT.aUp[bufferIndex];
+
+	while (up->RdOff != up->WrOff)
+	{
+		unsigned	readOffset = up->RdOff;
+		unsigned	end = (up->WrOff > readOffset) ? up->WrOff : up->SizeOfBuffer;
+
+		if (sink != NULL)
+		{
+			fwrite(&up->pBuffer[readOffset], 1, end - readOffset, sink);
+		}
+		up->RdOff = (end == up->SizeOfBuffer) ? 0 : end;
+	}
+}
+
+static void
+fillDownBuffer(bool mayBlock)
+{
+	SEGGER_RTT_BUFFER_DOWN *	down = &_SEGGER_RTT.aDown[0];
+	fd_set				readable;
+	struct timeval			timeout = {0, mayBlock ? kWarpHostRttPollTimeoutMs * 1000 : 0};
+	char				c;
+
+	if (stdinClosed || down->pBuffer == NULL)
+	{
+		return;
+	}
+
+	while (((down->WrOff + 1) % down->SizeOfBuffer) != down->RdOff)
+	{
+		FD_ZERO(&readable);
+		FD_SET(STDIN_FILENO, &readable);
+		if (select(STDIN_FILENO + 1, &readable, NULL, NULL, &timeout) <= 0)
+		{
+			return;
+		}
+
+		if (read(STDIN_FILENO, &c, 1) != 1)
+		{
+			stdinClosed = true;
+			return;
+		}
+
+		down->pBuffer[down->WrOff] = c;
+		down->WrOff = (down->WrOff + 1) % down->SizeOfBuffer;
+		timeout.tv_usec = 0;
+	}
+}
+
+void
+warpHostRttPoll(void)
+{
+	SEGGER_RTT_BUFFER_DOWN *	down = &_SEGGER_RTT.aDown[0];
+
+	drainUpBuffer(0, gWarpHostQuiet ? NULL : stdout);
+	drainUpBuffer(kWarpLogRttChannel, gWarpHostLogSink);
+	fflush(stdout);
+
+	/*
+	 *	A firmware that keeps polling RTT without doing anything in
+	 *	between but spin or sleep (warpEventLoopWaitKey()) is waiting for
+	 *	a key: block briefly instead of spinning, and stop once stdin
+	 *	has been closed and fully consumed.
+	 */
+	uint64_t	awakeMicroseconds = virtualMicroseconds - gWarpHostBusStatistics.sleepMicroseconds;
+
+	if (awakeMicroseconds != idlePollsAwakeMicroseconds)
+	{
+		idlePollsAwakeMicroseconds = awakeMicroseconds;
+		idlePolls = 0;
+	}
+	else if (down->RdOff == down->WrOff)
+	{
+		idlePolls++;
+	}
+
+	fillDownBuffer(idlePolls > kWarpHostIdlePollsBeforeBlock);
+
+	if (stdinClosed && idlePolls > kWarpHostIdlePollsBeforeBlock && down->RdOff == down->WrOff)
+	{
+		warpHostStop(kWarpHostStopInputClosed);
+	}
+}
+
+void
+warpHostRttFlush(void)
+{
+	if (_SEGGER_RTT.acID[0] != '\0')
+	{
+		drainUpBuffer(0, gWarpHostQuiet ? NULL : stdout);
+		drainUpBuffer(kWarpLogRttChannel, gWarpHostLogSink);
+	}
+	fflush(stdout);
+	if (gWarpHostLogSink != NULL)
+	{
+		fflush(gWarpHostLogSink);
+	}
+}
+
+
+
+/*
+ *	OSA
+ */
+osa_status_t
+OSA_Init(void)
+{
+	return kStatus_OSA_Success;
+}
+
+void
+OSA_TimeDelay(uint32_t delay)
+{
+	gWarpHostBusStatistics.delayMicroseconds += (uint64_t)delay * 1000u;
+	warpHostAdvanceMicroseconds((uint64_t)delay * 1000u);
+}
+
+uint32_t
+OSA_TimeGetMsec(void)
+{
+	return (uint32_t)(virtualMicroseconds / 1000u);
+}
+
+
+
+/*
+ *	Interrupt manager: PRIMASK, nested as in fsl_interrupt_manager.c.
+ *	Whatever became pending while masked is delivered on unmasking.
+ */
+void
+INT_SYS_DisableIRQGlobal(void)
+{
+	interruptsMaskedDepth++;
+}
+
+void
+INT_SYS_EnableIRQGlobal(void)
+{
+	if (interruptsMaskedDepth > 0 && --interruptsMaskedDepth == 0)
+	{
+		deliverPendingInterrupts();
+	}
+}
+
+
+
+/*
+ *	GPIO
+ */
+static bool
+pinEdgeInterrupts(port_interrupt_config_t mode, bool level)
+{
+	switch (mode)
+	{
+		case kPortIntRisingEdge:
+		case kPortIntLogicOne:
+		{
+			return level;
+		}
+
+		case kPortIntFallingEdge:
+		case kPortIntLogicZero:
+		{
+			return !level;
+		}
+
+		case kPortIntEitherEdge:
+		{
+			return true;
+		}
+
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+/*
+ *	Drive an input pin from a device model. An edge that matches the
+ *	IRQC field of the pin's PCR (as written by the firmware through the
+ *	PORT HAL) sets the pin's ISF and pends the port interrupt.
+ */
+void
+warpHostSetPinInput(uint32_t pinName, uint32_t value)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+	bool		previous;
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	previous = (gpioInputs[port] >> pin) & 1u;
+	if (value)
+	{
+		gpioInputs[port] |= (1u << pin);
+	}
+	else
+	{
+		gpioInputs[port] &= ~(1u << pin);
+	}
+
+	if (previous == (value != 0) || PORT_HAL_GetPinIntMode(g_portBaseAddr[port], pin) == kPortIntDisabled)
+	{
+		return;
+	}
+
+	if (pinEdgeInterrupts(PORT_HAL_GetPinIntMode(g_portBaseAddr[port], pin), value != 0))
+	{
+		HW_PORT_ISFR_WR(g_portBaseAddr[port], HW_PORT_ISFR_RD(g_portBaseAddr[port]) | (1u << pin));
+		portInterruptsPending[port] |= (1u << pin);
+	}
+}
+
+bool
+warpHostPinInterruptsEnabled(void)
+{
+	for (uint32_t port = 0; port < kWarpHostMaxGpioPorts; port++)
+	{
+		for (uint32_t pin = 0; pin < kWarpHostMaxGpioPinsPerPort; pin++)
+		{
+			if (PORT_HAL_GetPinIntMode(g_portBaseAddr[port], pin) != kPortIntDisabled)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void
+GPIO_DRV_Init(const gpio_input_pin_user_config_t *  inputPins, const gpio_output_pin_user_config_t *  outputPins)
+{
+	if (inputPins != NULL)
+	{
+		for (; inputPins->pinName != GPIO_PINS_OUT_OF_RANGE; inputPins++)
+		{
+			GPIO_DRV_InputPinInit(inputPins);
+		}
+	}
+
+	if (outputPins != NULL)
+	{
+		for (; outputPins->pinName != GPIO_PINS_OUT_OF_RANGE; outputPins++)
+		{
+			GPIO_DRV_WritePinOutput(outputPins->pinName, outputPins->config.outputLogic);
+			GPIO_DRV_SetPinDir(outputPins->pinName, kGpioDigitalOutput);
+		}
+	}
+}
+
+void
+GPIO_DRV_InputPinInit(const gpio_input_pin_user_config_t *  inputPin)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(inputPin->pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(inputPin->pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	gpioDirections[port] &= ~(1u << pin);
+	PORT_HAL_SetPinIntMode(g_portBaseAddr[port], pin, inputPin->config.interrupt);
+}
+
+gpio_pin_direction_t
+GPIO_DRV_GetPinDir(uint32_t pinName)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return kGpioDigitalInput;
+	}
+
+	return (gpio_pin_direction_t)((gpioDirections[port] >> pin) & 1u);
+}
+
+void
+GPIO_DRV_SetPinDir(uint32_t pinName, gpio_pin_direction_t direction)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	if (direction == kGpioDigitalOutput)
+	{
+		gpioDirections[port] |= (1u << pin);
+	}
+	else
+	{
+		gpioDirections[port] &= ~(1u << pin);
+	}
+}
+
+void
+GPIO_DRV_WritePinOutput(uint32_t pinName, uint32_t output)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	if (output)
+	{
+		gpioOutputs[port] |= (1u << pin);
+	}
+	else
+	{
+		gpioOutputs[port] &= ~(1u << pin);
+	}
+}
+
+void
+GPIO_DRV_SetPinOutput(uint32_t pinName)
+{
+	GPIO_DRV_WritePinOutput(pinName, 1);
+}
+
+void
+GPIO_DRV_ClearPinOutput(uint32_t pinName)
+{
+	GPIO_DRV_WritePinOutput(pinName, 0);
+}
+
+void
+GPIO_DRV_TogglePinOutput(uint32_t pinName)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	gpioOutputs[port] ^= (1u << pin);
+}
+
+uint32_t
+GPIO_DRV_ReadPinInput(uint32_t pinName)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return 0;
+	}
+
+	return (gpioInputs[port] >> pin) & 1u;
+}
+
+/*
+ *	ISFR is write-one-to-clear on the KL03 but plain memory here, so
+ *	the flag is cleared explicitly.
+ */
+void
+GPIO_DRV_ClearPinIntFlag(uint32_t pinName)
+{
+	uint32_t	port = GPIO_EXTRACT_PORT(pinName);
+	uint32_t	pin = GPIO_EXTRACT_PIN(pinName);
+
+	if (port >= kWarpHostMaxGpioPorts || pin >= kWarpHostMaxGpioPinsPerPort)
+	{
+		return;
+	}
+
+	HW_PORT_ISFR_WR(g_portBaseAddr[port], HW_PORT_ISFR_RD(g_portBaseAddr[port]) & ~(1u << pin));
+	portInterruptsPending[port] &= ~(1u << pin);
+}
+
+
+
+/*
+ *	Clock manager. The configuration index is only tracked; the
+ *	simulation does not model core clock speed.
+ */
+clock_manager_error_code_t
+CLOCK_SYS_Init(clock_manager_user_config_t const *  clockConfigsPtr,
+		uint8_t configsNumber,
+		clock_manager_callback_user_config_t *  (*callbacksPtr)[],
+		uint8_t callbacksNumber)
+{
+	USED(clockConfigsPtr);
+	USED(configsNumber);
+	USED(callbacksPtr);
+	USED(callbacksNumber);
+
+	return kClockManagerSuccess;
+}
+
+clock_manager_error_code_t
+CLOCK_SYS_UpdateConfiguration(uint8_t targetConfigIndex, clock_manager_policy_t policy)
+{
+	USED(policy);
+	currentClockConfiguration = targetConfigIndex;
+
+	return kClockManagerSuccess;
+}
+
+uint8_t
+CLOCK_SYS_GetCurrentConfiguration(void)
+{
+	return currentClockConfiguration;
+}
+
+
+
+/*
+ *	RTC. TSR/TPR live in the mapped register block and are refreshed
+ *	whenever the virtual clock moves.
+ */
+void
+RTC_DRV_Init(uint32_t instance)
+{
+	USED(instance);
+	updateRtcRegisters();
+}
+
+bool
+RTC_DRV_SetDatetime(uint32_t instance, rtc_datetime_t *  datetime)
+{
+	uint32_t	seconds;
+
+	USED(instance);
+	RTC_HAL_ConvertDatetimeToSecs(datetime, &seconds);
+	rtcEpochSeconds = seconds - (uint32_t)(virtualMicroseconds / 1000000u);
+	updateRtcRegisters();
+
+	return true;
+}
+
+void
+RTC_DRV_GetDatetime(uint32_t instance, rtc_datetime_t *  datetime)
+{
+	uint32_t	seconds = RTC_TSR;
+
+	USED(instance);
+	RTC_HAL_ConvertSecsToDatetime(&seconds, datetime);
+}
+
+bool
+RTC_DRV_SetAlarm(uint32_t instance, rtc_datetime_t *  alarmTime, bool enableAlarmInterrupt)
+{
+	uint32_t	seconds;
+
+	USED(instance);
+	RTC_HAL_ConvertDatetimeToSecs(alarmTime, &seconds);
+	if (seconds <= RTC_TSR)
+	{
+		return false;
+	}
+
+	rtcAlarmSeconds = seconds;
+	rtcAlarmArmed = true;
+	rtcAlarmInterruptEnabled = enableAlarmInterrupt;
+	RTC_TAR = seconds;
+
+	return true;
+}
+
+void
+RTC_DRV_GetAlarm(uint32_t instance, rtc_datetime_t *  date)
+{
+	uint32_t	seconds = rtcAlarmSeconds;
+
+	USED(instance);
+	RTC_HAL_ConvertSecsToDatetime(&seconds, date);
+}
+
+void
+RTC_DRV_SetAlarmIntCmd(uint32_t instance, bool alarmEnable)
+{
+	USED(instance);
+	rtcAlarmInterruptEnabled = alarmEnable;
+}
+
+bool
+RTC_DRV_IsAlarmPending(uint32_t instance)
+{
+	USED(instance);
+
+	return rtcAlarmArmed && RTC_TSR >= rtcAlarmSeconds;
+}
+
+void
+RTC_DRV_SetSecsIntCmd(uint32_t instance, bool secondsEnable)
+{
+	USED(instance);
+	USED(secondsEnable);
+}
+
+
+
+/*
+ *	Power manager. Sleep modes advance the virtual clock to the next
+ *	wake source (LPTMR compare, pin interrupt or RTC alarm); a sleep with
+ *	none armed would never wake on hardware, so the run is stopped.
+ */
+
+/*
+ *	The firmware's millisecond sleeps program the LPTMR registers
+ *	directly (the OSA owns the timer, so not through LPTMR_DRV), and
+ *	enable it just before sleeping: the compare fires CMR + 1 ms after
+ *	the sleep starts. The register file is plain memory, so TCF (write
+ *	one to clear, and cleared by disabling the timer) is not looked at
+ *	here; it is set for the handler and cleared after it.
+ */
+static uint64_t
+lptmrRegisterCompareMicroseconds(uint64_t sleepStart)
+{
+	uint32_t	csr = LPTMR0_CSR;
+
+	if (!(csr & LPTMR_CSR_TEN_MASK) || !(csr & LPTMR_CSR_TIE_MASK))
+	{
+		return UINT64_MAX;
+	}
+
+	return sleepStart + ((uint64_t)(LPTMR0_CMR & 0xFFFF) + 1) * 1000u;
+}
+
+power_manager_error_code_t
+POWER_SYS_Init(power_manager_user_config_t const *  (*powerConfigsPtr)[],
+		uint8_t configsNumber,
+		power_manager_callback_user_config_t const *  (*callbacksPtr)[],
+		uint8_t callbacksNumber)
+{
+	USED(callbacksPtr);
+	USED(callbacksNumber);
+
+	powerConfigs = *powerConfigsPtr;
+	powerConfigsCount = configsNumber;
+
+	return kPowerManagerSuccess;
+}
+
+power_manager_error_code_t
+POWER_SYS_SetMode(uint8_t powerModeIndex, power_manager_policy_t policy)
+{
+	power_manager_modes_t	mode;
+	uint64_t		start = virtualMicroseconds;
+
+	USED(policy);
+
+	if (powerConfigs == NULL || powerModeIndex >= powerConfigsCount)
+	{
+		return kPowerManagerErrorOutOfRange;
+	}
+
+	mode = powerConfigs[powerModeIndex]->mode;
+	switch (mode)
+	{
+		case kPowerManagerRun:
+		case kPowerManagerVlpr:
+		{
+			currentPowerMode = mode;
+
+			return kPowerManagerSuccess;
+		}
+
+		case kPowerManagerWait:
+		case kPowerManagerVlpw:
+		case kPowerManagerStop:
+		case kPowerManagerVlps:
+		{
+			break;
+		}
+
+		default:
+		{
+			/*
+			 *	VLLSx exit through reset, which the harness does not model.
+			 */
+			return kPowerManagerErrorSwitch;
+		}
+	}
+
+	power_manager_modes_t	previousMode = currentPowerMode;
+	uint32_t		interruptsBefore = gWarpHostBusStatistics.interrupts;
+	uint64_t		lptmrCompare = lptmrRegisterCompareMicroseconds(start);
+
+	currentPowerMode = mode;
+	gWarpHostBusStatistics.sleeps++;
+
+	/*
+	 *	Sleep until an interrupt has been taken: an LPTMR compare, a
+	 *	pin-detect interrupt raised by a device model, or the RTC alarm.
+	 *	Device events only count as wake sources while some pin has
+	 *	its interrupt enabled. With interrupts masked, one that is only
+	 *	pending ends the sleep, as with WFI.
+	 */
+	while (gWarpHostBusStatistics.interrupts == interruptsBefore && !(RTC_DRV_IsAlarmPending(0) && rtcAlarmInterruptEnabled) &&
+		virtualMicroseconds < lptmrCompare && !maskedInterruptPending())
+	{
+		uint64_t	wake = min(nextLptmrMicroseconds(), lptmrCompare);
+
+		if (rtcAlarmArmed && rtcAlarmInterruptEnabled)
+		{
+			uint64_t	alarm = (uint64_t)(rtcAlarmSeconds - rtcEpochSeconds) * 1000000u;
+
+			if (alarm < wake)
+			{
+				wake = alarm;
+			}
+		}
+
+		if (warpHostPinInterruptsEnabled() && warpHostBusNextEventMicroseconds() < wake)
+		{
+			wake = warpHostBusNextEventMicroseconds();
+		}
+
+		if (wake == UINT64_MAX)
+		{
+			warpHostStop(kWarpHostStopNoWakeSource);
+		}
+
+		warpHostAdvanceMicroseconds((wake > virtualMicroseconds) ? (wake - virtualMicroseconds) : 0);
+	}
+	gWarpHostBusStatistics.sleepMicroseconds += virtualMicroseconds - start;
+
+	/*
+	 *	The debug probe goes on polling RTT while the core sleeps, so a
+	 *	key can arrive without the firmware touching RTT itself.
+	 */
+	warpHostRttPoll();
+
+	if (RTC_DRV_IsAlarmPending(0) && rtcAlarmInterruptEnabled)
+	{
+		extern void	RTC_IRQHandler(void);
+
+		RTC_IRQHandler();
+	}
+
+	if (virtualMicroseconds >= lptmrCompare)
+	{
+		LPTMR0_CSR |= LPTMR_CSR_TCF_MASK;
+		gWarpHostBusStatistics.interrupts++;
+		if (LPTMR0_IRQHandler != NULL)
+		{
+			LPTMR0_IRQHandler();
+		}
+		LPTMR0_CSR &= ~LPTMR_CSR_TCF_MASK;
+	}
+
+	/*
+	 *	Stop modes return in the run mode they were entered from.
+	 */
+	currentPowerMode = previousMode;
+
+	return kPowerManagerSuccess;
+}
+
+power_manager_modes_t
+POWER_SYS_GetCurrentMode(void)
+{
+	return currentPowerMode;
+}
+
+
+
+/*
+ *	LPTMR, in time counter mode only.
+ */
+lptmr_status_t
+LPTMR_DRV_Init(uint32_t instance, const lptmr_user_config_t *  userConfigPtr, lptmr_state_t *  userStatePtr)
+{
+	USED(instance);
+	USED(userConfigPtr);
+	USED(userStatePtr);
+	lptmrRunning = false;
+
+	return kStatus_LPTMR_Success;
+}
+
+lptmr_status_t
+LPTMR_DRV_Deinit(uint32_t instance)
+{
+	USED(instance);
+	lptmrRunning = false;
+	lptmrCallback = NULL;
+
+	return kStatus_LPTMR_Success;
+}
+
+lptmr_status_t
+LPTMR_DRV_SetTimerPeriodUs(uint32_t instance, uint32_t us)
+{
+	USED(instance);
+	lptmrPeriodMicroseconds = us;
+
+	return kStatus_LPTMR_Success;
+}
+
+lptmr_status_t
+LPTMR_DRV_Start(uint32_t instance)
+{
+	USED(instance);
+	lptmrRunning = true;
+	lptmrStartMicroseconds = virtualMicroseconds;
+	lptmrNextMicroseconds = virtualMicroseconds + lptmrPeriodMicroseconds;
+
+	return kStatus_LPTMR_Success;
+}
+
+lptmr_status_t
+LPTMR_DRV_Stop(uint32_t instance)
+{
+	USED(instance);
+	lptmrRunning = false;
+
+	return kStatus_LPTMR_Success;
+}
+
+uint32_t
+LPTMR_DRV_GetCurrentTimeUs(uint32_t instance)
+{
+	USED(instance);
+	if (!lptmrRunning || lptmrPeriodMicroseconds == 0)
+	{
+		return 0;
+	}
+
+	return (uint32_t)((virtualMicroseconds - lptmrStartMicroseconds) % lptmrPeriodMicroseconds);
+}
+
+lptmr_status_t
+LPTMR_DRV_InstallCallback(uint32_t instance, lptmr_callback_t userCallback)
+{
+	USED(instance);
+	lptmrCallback = userCallback;
+
+	return kStatus_LPTMR_Success;
+}
+
+
+
+/*
+ *	LPUART is only brought up for the PAN1326 path; nothing is modelled.
+ */
+lpuart_status_t
+LPUART_DRV_Init(uint32_t instance, lpuart_state_t *  lpuartStatePtr, const lpuart_user_config_t *  lpuartUserConfig)
+{
+	USED(instance);
+	USED(lpuartStatePtr);
+	USED(lpuartUserConfig);
+
+	return kStatus_LPUART_Success;
+}
+
+void
+LPUART_DRV_Deinit(uint32_t instance)
+{
+	USED(instance);
+}
@@ -0,0 +1,484 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+#include "warp-pedometer.h"
+#include "warp-activity.h"
+#include "warp-host.h"
+
+
+/*
+ *	Step detectors of warp-pedometer.c over accelerometer traces: one
+ *	sample per line as "x, y, z[, label]" in accelerometer counts at the
+ *	50Hz ODR, where a label of 1 marks the sample of a true step. Lines
+ *	that do not start with three integers (headers, comments) are
+ *	skipped.
+ *
+ *	A detected step matches a labelled one within kWarpHostStepTolerance
+ *	samples, each label matching at most once; precision is matched over
+ *	detected steps and recall matched over labelled steps.
+ *
+ *	The activity engine of warp-activity.c runs over the same samples;
+ *	its windows are scored against the activity of the scenario (still
+ *	during the lead-in), skipping the window that spans the change.
+ */
+enum
+{
+	kWarpHostStepSampleRateHz	= 50,
+	kWarpHostStepTolerance		= 12,
+	kWarpHostStepMaxSamples		= 50 * 600,
+	kWarpHostStepSeconds		= 60,
+	kWarpHostStepStillSeconds	= 5,
+};
+
+typedef struct
+{
+	int16_t		xyz[3];
+	bool		label;
+} WarpHostStepSample;
+
+typedef struct
+{
+	uint32_t	labelled;
+	uint32_t	detected;
+	uint32_t	matched;
+	uint64_t	nanoseconds;
+} WarpHostStepScore;
+
+typedef struct
+{
+	uint32_t	windows;
+	uint32_t	correct;
+	uint32_t	cadenceWindows;
+	uint32_t	cadenceSum;
+	uint64_t	nanoseconds;
+} WarpHostActivityScore;
+
+typedef struct
+{
+	const char *	name;
+	double		gravity[3];		/*	direction, normalised below	*/
+	double		countsPerG;
+	double		cadenceHz;
+	double		amplitudeG;
+	double		variability;		/*	relative, per step		*/
+	WarpActivity	activity;
+} WarpHostStepScenario;
+
+static const WarpHostStepScenario	scenarios[] =
+{
+	{"z up, 2g, walk",	{0, 0, 1},	4096, 1.8, 0.27, 0.0,	kWarpActivityWalk},
+	{"x up, 2g, walk",	{1, 0, 0},	4096, 1.8, 0.27, 0.0,	kWarpActivityWalk},
+	{"z down, 2g, walk",	{0, 0, -1},	4096, 1.8, 0.27, 0.0,	kWarpActivityWalk},
+	{"tilted, 2g, walk",	{1, 1, 1},	4096, 1.8, 0.27, 0.1,	kWarpActivityWalk},
+	{"tilted, 4g, walk",	{0, 1, 1},	2048, 1.6, 0.20, 0.1,	kWarpActivityWalk},
+	{"z up, 8g, run",	{0, 0, 1},	1024, 2.8, 0.80, 0.1,	kWarpActivityRun},
+	{"tilted, 2g, slow",	{1, 0, 2},	4096, 1.2, 0.15, 0.15,	kWarpActivityWalk},
+	{"z up, 2g, still",	{0, 0, 1},	4096, 0.0, 0.00, 0.0,	kWarpActivityStill},
+};
+
+static WarpHostStepSample	trace[kWarpHostStepMaxSamples];
+static uint32_t			noiseState = 1;
+
+
+
+static double
+uniform(void)
+{
+	noiseState = noiseState * 1664525u + 1013904223u;
+
+	return (double)(noiseState >> 8) / (1u << 24);
+}
+
+static int16_t
+clampCounts(double counts)
+{
+	if (counts > 8191.0)
+	{
+		return 8191;
+	}
+	else if (counts < -8192.0)
+	{
+		return -8192;
+	}
+
+	return (int16_t)lround(counts);
+}
+
+/*
+ *	Still for kWarpHostStepStillSeconds, then a vertical oscillation along
+ *	gravity of amplitudeG, one cycle per step (labelled at its peak), with
+ *	a sway across it at half the cadence and +-0.01g noise on every axis.
+ *	Each step draws its own cadence and amplitude within variability.
+ */
+static uint32_t
+synthesiseTrace(const WarpHostStepScenario *  scenario)
+{
+	double		g[3], side[3], norm, phase = 0, frequency = 0, amplitude = 0, vertical, sway;
+	uint32_t	count = kWarpHostStepSeconds * kWarpHostStepSampleRateHz;
+	bool		walking;
+
+	norm = sqrt(scenario->gravity[0]*scenario->gravity[0] + scenario->gravity[1]*scenario->gravity[1] + scenario->gravity[2]*scenario->gravity[2]);
+	for (int j = 0; j < 3; j++)
+	{
+		g[j] = scenario->gravity[j] / norm;
+	}
+
+	/*
+	 *	Any direction across gravity will do for the sway.
+	 */
+	side[0] = g[1] - g[2];
+	side[1] = g[2] - g[0];
+	side[2] = g[0] - g[1];
+	norm = sqrt(side[0]*side[0] + side[1]*side[1] + side[2]*side[2]);
+	for (int j = 0; j < 3; j++)
+	{
+		side[j] = (norm == 0) ? 0 : side[j] / norm;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		walking = (scenario->cadenceHz > 0) && (i >= kWarpHostStepStillSeconds * kWarpHostStepSampleRateHz);
+		trace[i].label = false;
+		vertical = 0;
+		sway = 0;
+
+		if (walking)
+		{
+			if (frequency == 0 || phase >= 2 * M_PI)
+			{
+				phase -= (frequency == 0) ? 0 : 2 * M_PI;
+				frequency = scenario->cadenceHz * (1 + scenario->variability * (2 * uniform() - 1));
+				amplitude = scenario->amplitudeG * (1 + scenario->variability * (2 * uniform() - 1));
+			}
+
+			vertical = amplitude * sin(phase);
+			sway = 0.3 * amplitude * sin(0.5 * phase + 0.7);
+
+			if (phase < M_PI / 2 && phase + 2 * M_PI * frequency / kWarpHostStepSampleRateHz >= M_PI / 2)
+			{
+				trace[i].label = true;
+			}
+			phase += 2 * M_PI * frequency / kWarpHostStepSampleRateHz;
+		}
+
+		for (int j = 0; j < 3; j++)
+		{
+			trace[i].xyz[j] = clampCounts(scenario->countsPerG * ((1 + vertical) * g[j] + sway * side[j] + 0.01 * (2 * uniform() - 1)));
+		}
+	}
+
+	return count;
+}
+
+static uint32_t
+readTrace(FILE *  in, bool *  labelled)
+{
+	char		line[256];
+	int		x, y, z, label;
+	uint32_t	count = 0;
+
+	*labelled = false;
+	while (count < kWarpHostStepMaxSamples && fgets(line, sizeof(line), in) != NULL)
+	{
+		switch (sscanf(line, " %d ,%d ,%d ,%d", &x, &y, &z, &label))
+		{
+			case 4:
+			{
+				*labelled = true;
+				trace[count].label = (label != 0);
+				break;
+			}
+
+			case 3:
+			{
+				trace[count].label = false;
+				break;
+			}
+
+			default:
+			{
+				continue;
+			}
+		}
+
+		trace[count].xyz[0] = (int16_t)x;
+		trace[count].xyz[1] = (int16_t)y;
+		trace[count].xyz[2] = (int16_t)z;
+		count++;
+	}
+
+	return count;
+}
+
+static uint64_t
+hostNanoseconds(void)
+{
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/*
+ *	Run one detector over the trace, recording the samples it flags, and
+ *	match them against the labels.
+ */
+static void
+scoreDetector(bool magnitude, uint32_t count, bool *  detections, WarpHostStepScore *  score, FILE *  out)
+{
+	WarpStepDetector		axisDetector;
+	WarpMagnitudeStepDetector	magnitudeDetector;
+	uint64_t			start;
+	uint32_t			next = 0;
+
+	warpStepDetectorInit(&axisDetector, kWarpStepDetectorUpperThreshold, kWarpStepDetectorLowerThreshold);
+	warpMagnitudeStepDetectorInit(&magnitudeDetector, kWarpMagnitudeStepDetectorMinimumInterval);
+
+	start = hostNanoseconds();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		detections[i] = magnitude ? warpMagnitudeStepDetectorPush(&magnitudeDetector, trace[i].xyz)
+					: warpStepDetectorPush(&axisDetector, trace[i].xyz);
+	}
+	score->nanoseconds += hostNanoseconds() - start;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		score->labelled += trace[i].label;
+		score->detected += detections[i];
+
+		if (out != NULL && detections[i])
+		{
+			fprintf(out, "%s step at sample %u\n", magnitude ? "magnitude" : "axis", i);
+		}
+	}
+
+	/*
+	 *	Greedy matching in time order: each label takes the earliest
+	 *	unmatched detection within the tolerance.
+	 */
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (!trace[i].label)
+		{
+			continue;
+		}
+
+		if (next + kWarpHostStepTolerance < i)
+		{
+			next = i - kWarpHostStepTolerance;
+		}
+		while (next < count && next <= i + kWarpHostStepTolerance && !detections[next])
+		{
+			next++;
+		}
+		if (next < count && next <= i + kWarpHostStepTolerance)
+		{
+			score->matched++;
+			next++;
+		}
+	}
+}
+
+static void
+printScore(FILE *  out, const char *  name, const char *  detector, const WarpHostStepScore *  score, uint32_t count)
+{
+	fprintf(out, "%-20s %-10s %5u labelled %5u detected   precision %6.1f%%   recall %6.1f%%   %5.1f ns/sample\n",
+		name, detector, score->labelled, score->detected,
+		(score->detected == 0) ? 100.0 : 100.0 * score->matched / score->detected,
+		(score->labelled == 0) ? 100.0 : 100.0 * score->matched / score->labelled,
+		(double)score->nanoseconds / count);
+}
+
+/*
+ *	Run the activity engine over the trace. With a scenario, score each
+ *	window that lies wholly in the lead-in or wholly after it.
+ */
+static void
+scoreActivity(const WarpHostStepScenario *  scenario, uint32_t count, WarpHostActivityScore *  score, FILE *  out)
+{
+	static uint8_t		activities[kWarpHostStepMaxSamples / (kWarpActivityWindowSamples * kWarpActivityDecimation)];
+	static uint16_t		cadences[kWarpHostStepMaxSamples / (kWarpActivityWindowSamples * kWarpActivityDecimation)];
+	WarpActivityEngine	engine;
+	WarpActivity		expected;
+	uint32_t		windows = 0, first, last;
+	uint32_t		leadIn = kWarpHostStepStillSeconds * kWarpHostStepSampleRateHz;
+	uint32_t		windowSamples = kWarpActivityWindowSamples * kWarpActivityDecimation;
+	uint64_t		start;
+
+	warpActivityEngineInit(&engine, kWarpHostStepSampleRateHz, kWarpActivityDecimation);
+
+	start = hostNanoseconds();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (warpActivityEnginePush(&engine, trace[i].xyz))
+		{
+			activities[windows] = engine.activity;
+			cadences[windows] = engine.cadence;
+			windows++;
+		}
+	}
+	score->nanoseconds += hostNanoseconds() - start;
+
+	for (uint32_t window = 0; window < windows; window++)
+	{
+		if (out != NULL)
+		{
+			fprintf(out, "activity window %u: %s, cadence %u\n", window, warpActivityName(activities[window]), cadences[window]);
+		}
+
+		first = window * windowSamples;
+		last = first + windowSamples - 1;
+		if (scenario == NULL || (first < leadIn && last >= leadIn))
+		{
+			continue;
+		}
+
+		expected = (last < leadIn) ? kWarpActivityStill : scenario->activity;
+		score->windows++;
+		score->correct += (activities[window] == expected);
+		if (expected != kWarpActivityStill && cadences[window] != 0)
+		{
+			score->cadenceWindows++;
+			score->cadenceSum += cadences[window];
+		}
+	}
+}
+
+/*
+ *	Mean cadence of the walk or run windows against the scenario's, when
+ *	there is one.
+ */
+static void
+printActivityScore(FILE *  out, const char *  name, const WarpHostActivityScore *  score, double cadence, uint32_t count)
+{
+	char	cadenceText[32] = "";
+
+	if (cadence > 0)
+	{
+		snprintf(cadenceText, sizeof(cadenceText), "cadence %5.1f of %5.1f",
+			(score->cadenceWindows == 0) ? 0.0 : (double)score->cadenceSum / score->cadenceWindows, cadence);
+	}
+
+	fprintf(out, "%-20s %-10s %5u windows  %5u correct   accuracy  %6.1f%%   %-22s   %5.1f ns/sample\n",
+		name, "activity", score->windows, score->correct,
+		(score->windows == 0) ? 100.0 : 100.0 * score->correct / score->windows,
+		cadenceText, (double)score->nanoseconds / count);
+}
+
+/*
+ *	A trace on stdin: print each detected step of both detectors and,
+ *	when the trace is labelled, their scores.
+ */
+uint32_t
+warpHostCountSteps(FILE *  in, FILE *  out)
+{
+	static bool		detections[kWarpHostStepMaxSamples];
+	WarpHostStepScore	axisScore = {0}, magnitudeScore = {0};
+	WarpHostActivityScore	activityScore = {0};
+	bool			labelled;
+	uint32_t		count = readTrace(in, &labelled);
+
+	scoreDetector(false, count, detections, &axisScore, out);
+	scoreDetector(true, count, detections, &magnitudeScore, out);
+	scoreActivity(NULL, count, &activityScore, out);
+
+	fprintf(out, "warp-host steps: %u samples, %u steps (axis), %u steps (magnitude)\n", count, axisScore.detected, magnitudeScore.detected);
+	if (labelled)
+	{
+		printScore(out, "trace", "axis", &axisScore, count);
+		printScore(out, "trace", "magnitude", &magnitudeScore, count);
+	}
+
+	return count;
+}
+
+/*
+ *	Both detectors over synthetic labelled traces in several orientations,
+ *	full-scale ranges and cadences. Host time per sample only compares
+ *	the two detectors; it is not a KL03 cycle count.
+ */
+uint32_t
+warpHostRunStepBenchmark(FILE *  out)
+{
+	static bool		detections[kWarpHostStepMaxSamples];
+	WarpHostStepScore	axisTotal = {0}, magnitudeTotal = {0};
+	WarpHostStepScore	axisScore, magnitudeScore;
+	WarpHostActivityScore	activityTotal = {0}, activityScore;
+	uint32_t		count, samples = 0;
+
+	for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		count = synthesiseTrace(&scenarios[i]);
+		memset(&axisScore, 0, sizeof(axisScore));
+		memset(&magnitudeScore, 0, sizeof(magnitudeScore));
+		scoreDetector(false, count, detections, &axisScore, NULL);
+		scoreDetector(true, count, detections, &magnitudeScore, NULL);
+		printScore(out, scenarios[i].name, "axis", &axisScore, count);
+		printScore(out, scenarios[i].name, "magnitude", &magnitudeScore, count);
+		memset(&activityScore, 0, sizeof(activityScore));
+		scoreActivity(&scenarios[i], count, &activityScore, NULL);
+		printActivityScore(out, scenarios[i].name, &activityScore, 60 * scenarios[i].cadenceHz, count);
+
+		axisTotal.labelled += axisScore.labelled;
+		axisTotal.detected += axisScore.detected;
+		axisTotal.matched += axisScore.matched;
+		axisTotal.nanoseconds += axisScore.nanoseconds;
+		magnitudeTotal.labelled += magnitudeScore.labelled;
+		magnitudeTotal.detected += magnitudeScore.detected;
+		magnitudeTotal.matched += magnitudeScore.matched;
+		magnitudeTotal.nanoseconds += magnitudeScore.nanoseconds;
+		activityTotal.windows += activityScore.windows;
+		activityTotal.correct += activityScore.correct;
+		activityTotal.nanoseconds += activityScore.nanoseconds;
+		samples += count;
+	}
+
+	printScore(out, "all", "axis", &axisTotal, samples);
+	printScore(out, "all", "magnitude", &magnitudeTotal, samples);
+	printActivityScore(out, "all", &activityTotal, 0, samples);
+
+	return samples;
+}
@@ -0,0 +1,172 @@
+/*
+	Host (x86 Linux) simulation harness for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	The host build compiles the unmodified firmware sources against the
+ *	KSDK headers, and replaces the KSDK drivers (I2C, SPI, OSA, GPIO, RTC,
+ *	power manager, LPTMR) with the simulation in warp-host-sim.c and
+ *	warp-host-bus.c. Time in the simulation is virtual: it only advances
+ *	for bus transfers, OSA_TimeDelay() and low-power sleeps.
+ */
+
+typedef enum
+{
+	kWarpHostRegisterFileBytes	= 256,
+	kWarpHostMaxI2cDevices		= 16,
+	kWarpHostMaxGpioPorts		= 2,
+	kWarpHostMaxGpioPinsPerPort	= 32,
+	kWarpHostRttPollTimeoutMs	= 10,
+} WarpHostConstants;
+
+typedef enum
+{
+	kWarpHostStopNone = 0,
+	kWarpHostStopReturned,
+	kWarpHostStopTimeLimit,
+	kWarpHostStopInputClosed,
+	kWarpHostStopNoWakeSource,
+} WarpHostStopReason;
+
+typedef struct WarpHostI2cDevice WarpHostI2cDevice;
+
+struct WarpHostI2cDevice
+{
+	uint8_t		address;
+	const char *	name;
+
+	/*
+	 *	A write transaction delivers the command bytes followed by the
+	 *	payload; a read transaction delivers the command bytes (if any)
+	 *	through write() and then asks read() for the response.
+	 */
+	void		(*write)(WarpHostI2cDevice *  device, const uint8_t *  bytes, uint32_t count);
+	void		(*read)(WarpHostI2cDevice *  device, uint8_t *  bytes, uint32_t count);
+
+	/*
+	 *	Devices that produce data on their own (sampling at an output
+	 *	data rate, raising an interrupt line) ask to be serviced when
+	 *	the virtual clock reaches nextEventMicroseconds.
+	 */
+	void		(*service)(WarpHostI2cDevice *  device, uint64_t now);
+	uint64_t	nextEventMicroseconds;
+
+	uint8_t		registers[kWarpHostRegisterFileBytes];
+	uint8_t		pointer;
+	uint32_t	samples;
+
+	/*
+	 *	Fastest I2C clock the device follows (0 for no limit). Up to
+	 *	twice that, every third read comes back with a bit wrong; beyond,
+	 *	the device NAKs its address.
+	 */
+	uint32_t	maximumBaudRateKbps;
+
+	uint32_t	transactions;
+	uint32_t	bytes;
+	uint32_t	busMicroseconds;
+};
+
+typedef struct
+{
+	uint32_t	i2cTransactions;
+	uint32_t	i2cBytes;
+	uint32_t	i2cFailures;
+	uint64_t	i2cBusMicroseconds;
+
+	uint32_t	spiTransactions;
+	uint32_t	spiBytes;
+	uint64_t	spiBusMicroseconds;
+
+	uint64_t	delayMicroseconds;
+	uint64_t	sleepMicroseconds;
+	uint32_t	sleeps;
+	uint32_t	interrupts;
+} WarpHostBusStatistics;
+
+extern WarpHostBusStatistics	gWarpHostBusStatistics;
+extern bool			gWarpHostQuiet;
+extern FILE *			gWarpHostLogSink;
+
+/*
+ *	Virtual clock (warp-host-sim.c)
+ */
+uint64_t		warpHostNowMicroseconds(void);
+void			warpHostAdvanceMicroseconds(uint64_t microseconds);
+uint64_t		warpHostModeMicroseconds(int mode);
+uint64_t		warpHostChargePicocoulombs(void);
+void			warpHostSetLoadMicroamps(uint32_t microamps);
+void			warpHostSetTimeLimitMicroseconds(uint64_t microseconds);
+void			warpHostStop(WarpHostStopReason reason);
+WarpHostStopReason	warpHostRun(void (*entry)(void), uint32_t *  stackBytesUsed);
+void			warpHostRttPoll(void);
+void			warpHostRttFlush(void);
+void			warpHostMapPeripherals(void);
+void			warpHostSetPinInput(uint32_t pinName, uint32_t value);
+bool			warpHostPinInterruptsEnabled(void);
+
+/*
+ *	Simulated buses and device models (warp-host-bus.c)
+ */
+void			warpHostBusInit(void);
+WarpHostI2cDevice *	warpHostI2cDeviceAt(uint8_t address);
+WarpHostI2cDevice *	warpHostI2cDeviceByIndex(int index);
+void			warpHostRegisterFileWrite(WarpHostI2cDevice *  device, const uint8_t *  bytes, uint32_t count);
+void			warpHostRegisterFileRead(WarpHostI2cDevice *  device, uint8_t *  bytes, uint32_t count);
+uint64_t		warpHostBusNextEventMicroseconds(void);
+void			warpHostBusService(uint64_t now);
+
+/*
+ *	Binary sample frame decoder and log record renderer (warp-host-decode.c)
+ */
+uint32_t		warpHostDecodeFrames(FILE *  in, FILE *  out);
+uint32_t		warpHostRenderLog(FILE *  in, FILE *  out);
+
+/*
+ *	Fixed-point orientation filter against a double reference (warp-host-ahrs.c)
+ */
+uint32_t		warpHostRunAhrsHarness(FILE *  out);
+
+/*
+ *	Step detectors over recorded or synthetic traces (warp-host-steps.c)
+ */
+uint32_t		warpHostCountSteps(FILE *  in, FILE *  out);
+uint32_t		warpHostRunStepBenchmark(FILE *  out);
+
+/*
+ *	BME680 integer compensation against the datasheet formulas (warp-host-bme680.c)
+ */
+uint32_t		warpHostRunBme680Harness(FILE *  out);
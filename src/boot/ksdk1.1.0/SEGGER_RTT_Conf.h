@@ -123,12 +123,23 @@ Revision: $Rev: 12489 $
 
 #define SEGGER_RTT_MAX_INTERRUPT_PRIORITY         (0x20)   // Interrupt priority to lock on SEGGER_RTT_LOCK on Cortex-M3/4 (Default: 0x20)
 
+/*********************************************************************
+*
+*       RTT lock configuration for the Warp host build: every RTT access
+*       gives the simulated debug probe a chance to move data (see
+*       src/boot/host/warp-host-sim.c)
+*/
+#if (defined WARP_BUILD_HOST)
+  void warpHostRttPoll(void);
+  #define SEGGER_RTT_LOCK()     warpHostRttPoll();
+  #define SEGGER_RTT_UNLOCK()
+
 /*********************************************************************
 *
 *       RTT lock configuration for SEGGER Embedded Studio,
 *       Rowley CrossStudio and GCC
 */
-#if (defined __SES_ARM) || (defined __CROSSWORKS_ARM) || (defined __GNUC__)
+#elif (defined __SES_ARM) || (defined __CROSSWORKS_ARM) || (defined __GNUC__)
   #if (defined __ARM_ARCH_6M__) || (defined __ARM_ARCH_8M_BASE__)
     #define SEGGER_RTT_LOCK()   {                                                                   \
                                     unsigned int LockState;                                         \
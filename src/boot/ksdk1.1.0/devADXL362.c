@@ -74,6 +74,20 @@ extern volatile uint32_t		gWarpSpiTimeoutMicroseconds;
 void
 initADXL362(WarpSPIDeviceState volatile *  deviceStatePointer)
 {
+	/*
+	 *	gpio_pins.c leaves PTB2 an input (it doubles as the FRDM-KL03
+	 *	MMA8451Q INT1); make the chip select an output, deasserted.
+	 */
+	gpio_output_pin_user_config_t	chipSelect =
+	{
+		.pinName = kWarpPinADXL362_CS,
+		.config.outputLogic = 1,
+		.config.slewRate = kPortSlowSlewRate,
+		.config.driveStrength = kPortLowDriveStrength,
+	};
+
+	GPIO_DRV_OutputPinInit(&chipSelect);
+
 	deviceStatePointer->signalType	= (	kWarpTypeMaskAccelerationX |
 						kWarpTypeMaskAccelerationY |
 						kWarpTypeMaskAccelerationZ |
@@ -118,7 +132,7 @@ writeSensorRegisterADXL362(uint8_t command, uint8_t deviceRegister, uint8_t writ
 	 *	file.
 	 */
 	enableSPIpins();
-	deviceADXL362State.ksdk_spi_status = SPI_DRV_MasterTransferBlocking(0 /* master instance */,
+	deviceADXL362State.ksdk_spi_status = warpSPIMasterTransferBlocking(0 /* master instance */,
 					NULL /* spi_master_user_config_t */,
 					(const uint8_t * restrict)deviceADXL362State.spiSourceBuffer,
 					(uint8_t * restrict)deviceADXL362State.spiSinkBuffer,
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 
@@ -57,6 +59,23 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Writable: PCTL, RST, FPSC, INTC, AVE and the interrupt levels INTHL
+ *	through IHYSH.
+ */
+static const uint8_t		writableRegistersAMG8834[] = {0xAF, 0x3F};
+
+static const WarpRegisterMap	registersAMG8834 =
+{
+	.deviceState		= &deviceAMG8834State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= writableRegistersAMG8834,
+	.lastReadableRegister	= 0xFF,
+	.lastWritableRegister	= 0x0D,
+	.registerBytes		= 1,
+	.flags			= 0,
+};
+
 
 /*
  *	AMG8834.
@@ -74,47 +93,7 @@ initAMG8834(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceState
 WarpStatus
 writeSensorRegisterAMG8834(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	returnValue;
-
-	switch (deviceRegister)
-	{
-		case 0x00: case 0x01: case 0x02: case 0x03:
-		case 0x05: case 0x07: case 0x08: case 0x09:
-		case 0x0A: case 0x0B: case 0x0C: case 0x0D:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceAMG8834State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	returnValue = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (returnValue != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersAMG8834, deviceRegister, payload);
 }
 
 WarpStatus
@@ -136,39 +115,7 @@ configureSensorAMG8834(uint8_t payloadConfigReg, uint8_t payloadFrameRateReg, ui
 WarpStatus
 readSensorRegisterAMG8834(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t 	cmdBuf[1]	= {0xFF};
-	i2c_status_t	status;
-
-
-	USED(numberOfBytes);
-	if (deviceRegister > 0xFF)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceAMG8834State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	cmdBuf[0] = deviceRegister;
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceAMG8834State.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersAMG8834, deviceRegister, numberOfBytes);
 }
 
 void
@@ -198,17 +145,17 @@ printSensorDataAMG8834(bool hexModeFlag)
 
 		if (i2cReadStatus != kWarpStatusOK)
 		{
-			SEGGER_RTT_WriteString(0, " ----,");
+			WARP_LOG(kWarpLogCsvFailed);
 		}
 		else
 		{
 			if (hexModeFlag)
 			{
-				SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+				WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 			}
 			else
 			{
-				SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+				WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 			}
 		}
 	}
@@ -230,17 +177,17 @@ printSensorDataAMG8834(bool hexModeFlag)
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 		}
 	}
 }
\ No newline at end of file
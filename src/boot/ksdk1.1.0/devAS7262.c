@@ -97,7 +97,7 @@ readSensorRegisterAS7262(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{ 
 		.address = deviceAS7262State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceAS7262State.i2cAddress)
 	};
 
 
@@ -108,7 +108,7 @@ readSensorRegisterAS7262(uint8_t deviceRegister, int numberOfBytes)
 	 *	Write transaction writes the value of the virtual register one wants to read from to the WRITE register 0x01.
 	 */
 
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_write /* The pointer to the commands to be transferred */,
@@ -128,7 +128,7 @@ readSensorRegisterAS7262(uint8_t deviceRegister, int numberOfBytes)
 	 *	The read transaction requires one to first write to the register address one wants to focus on and then read from that address.
 	 */
 
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_read /* The pointer to the commands to be transferred */,
@@ -142,7 +142,7 @@ readSensorRegisterAS7262(uint8_t deviceRegister, int numberOfBytes)
 	}
 
 
-	returnValue = I2C_DRV_MasterReceiveDataBlocking(
+	returnValue = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_read /* The pointer to the commands to be transferred */,
@@ -169,13 +169,13 @@ LedOnAS7262(void) {
 	i2c_device_t slave =
 	{ 
 		.address = deviceAS7262State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceAS7262State.i2cAddress)
 	};
 
 	/*
 	 *	The LED control register details can be found in Figure 26 of AS7262 detailed descriptions on page 26.
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDCTRL /* The pointer to the commands to be transferred */,
@@ -193,7 +193,7 @@ LedOnAS7262(void) {
 	/*
 	 *	This turns on the LED before reading the data
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDON /* The pointer to the commands to be transferred */,
@@ -220,10 +220,10 @@ LedOffAS7262(void) {
 	i2c_device_t slave =
 	{ 
 		.address = deviceAS7262State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceAS7262State.i2cAddress)
 	};
 
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 					0 /* I2C peripheral instance */,
 					&slave /* The pointer to the I2C device information structure */,
 					cmdBuf_LEDCTRL /* The pointer to the commands to be transferred */,
@@ -236,7 +236,7 @@ LedOffAS7262(void) {
 	 *	This turns off the LED after finish reading the data
 	*/
 
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDOFF /* The pointer to the commands to be transferred */,
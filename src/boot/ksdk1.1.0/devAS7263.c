@@ -97,7 +97,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{ 
 		.address = deviceAS7263State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceAS7263State.i2cAddress)
 	};
 
 
@@ -107,7 +107,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	/*
 	 *	The LED control register details can be found in Figure 27 of AS7263 detailed descriptions on page 24.
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDCTRL /* The pointer to the commands to be transferred */,
@@ -125,7 +125,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	/*
 	 *	This turns on the LED before reading the data
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDON /* The pointer to the commands to be transferred */,
@@ -144,7 +144,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	 *	See Page 8 to Page 11 of AS726X Design Considerations for writing to and reading from virtual registers.
 	 *	Write transaction writes the value of the virtual register one wants to read from to the WRITE register 0x01.
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_write /* The pointer to the commands to be transferred */,
@@ -163,7 +163,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	 *	Read transaction which reads from the READ register 0x02.
 	 *	The read transaction requires one to first write to the register address one wants to focus on and then read from that address.
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_read /* The pointer to the commands to be transferred */,
@@ -178,7 +178,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 
 
 
-	returnValue = I2C_DRV_MasterReceiveDataBlocking(
+	returnValue = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_read /* The pointer to the commands to be transferred */,
@@ -193,7 +193,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 
 
 
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDCTRL /* The pointer to the commands to be transferred */,
@@ -211,7 +211,7 @@ readSensorRegisterAS7263(uint8_t deviceRegister, int numberOfBytes)
 	/*
 	 *	This turns off the LED after finish reading the data
 	 */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
+	returnValue = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave /* The pointer to the I2C device information structure */,
 							cmdBuf_LEDOFF /* The pointer to the commands to be transferred */,
@@ -49,6 +49,9 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
+#include "devBME680.h"
 
 
 extern volatile WarpI2CDeviceState	deviceBME680State;
@@ -57,6 +60,23 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Reads stop at the end of the second calibration region.
+ *
+ *	TODO: We should eventually numerate all the valid register addresses
+ *	(configuration, control, and calibration) in a readable bitmap.
+ */
+static const WarpRegisterMap	registersBME680 =
+{
+	.deviceState		= &deviceBME680State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= NULL,
+	.lastReadableRegister	= kWarpSensorConfigurationRegisterBME680CalibrationRegion2End,
+	.lastWritableRegister	= 0xFF,
+	.registerBytes		= 1,
+	.flags			= 0,
+};
+
 
 void
 initBME680(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStatePointer)
@@ -70,89 +90,20 @@ initBME680(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStateP
 WarpStatus
 writeSensorRegisterBME680(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	if (deviceRegister > 0xFF)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBME680State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersBME680, deviceRegister, payload);
 }
 
 WarpStatus
 readSensorRegisterBME680(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status;
-
-
-	USED(numberOfBytes);
-
-	/*
-	 *	We only check to see if it is past the config registers.
-	 *
-	 *	TODO: We should eventually numerate all the valid register addresses
-	 *	(configuration, control, and calibration) here.
-	 */
-	if (deviceRegister > kWarpSensorConfigurationRegisterBME680CalibrationRegion2End)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBME680State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	cmdBuf[0] = deviceRegister;
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceBME680State.i2cBuffer,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersBME680, deviceRegister, numberOfBytes);
 }
 
 
 WarpStatus
 configureSensorBME680(uint8_t payloadCtrl_Hum, uint8_t payloadCtrl_Meas, uint8_t payloadGas_0, uint16_t menuI2cPullupValue)
 {
-	uint8_t		reg, index = 0;
-	WarpStatus	status1, status2, status3, status4 = 0;
+	WarpStatus	status1, status2, status3, status4;
 
 	status1 = writeSensorRegisterBME680(kWarpSensorConfigurationRegisterBME680Ctrl_Hum,
 							payloadCtrl_Hum,
@@ -167,118 +118,231 @@ configureSensorBME680(uint8_t payloadCtrl_Hum, uint8_t payloadCtrl_Meas, uint8_t
 							menuI2cPullupValue);
 
 	/*
-	 *	Read the calibration registers
+	 *	Read the calibration registers, one burst per region
 	 */
-	for (	reg = kWarpSensorConfigurationRegisterBME680CalibrationRegion1Start;
-		reg < kWarpSensorConfigurationRegisterBME680CalibrationRegion1End;
-		reg++)
-	{
-		status4 |= readSensorRegisterBME680(reg, 1 /* numberOfBytes */);
-		deviceBME680CalibrationValues[index++] = deviceBME680State.i2cBuffer[0];
-	}
-
-	for (	reg = kWarpSensorConfigurationRegisterBME680CalibrationRegion2Start;
-		reg < kWarpSensorConfigurationRegisterBME680CalibrationRegion2End;
-		reg++)
-	{
-		status4 |= readSensorRegisterBME680(reg, 1 /* numberOfBytes */);
-		deviceBME680CalibrationValues[index++] = deviceBME680State.i2cBuffer[0];
-	}
+	status4 = warpRegisterMapReadBlock(	&registersBME680,
+						kWarpSensorConfigurationRegisterBME680CalibrationRegion1Start,
+						(uint8_t *)&deviceBME680CalibrationValues[0],
+						kWarpBME680CalibrationRegion1Bytes);
+	status4 |= warpRegisterMapReadBlock(	&registersBME680,
+						kWarpSensorConfigurationRegisterBME680CalibrationRegion2Start,
+						(uint8_t *)&deviceBME680CalibrationValues[kWarpBME680CalibrationRegion1Bytes],
+						kWarpBME680CalibrationRegion2Bytes);
 
 	return (status1 | status2 | status3 | status4);
 }
 
 
-void
-printSensorDataBME680(bool hexModeFlag, uint16_t menuI2cPullupValue)
+/*
+ *	Start a forced-mode conversion. With the oversampling of
+ *	configureAllSensors() and the heater off, the results are ready
+ *	about 12ms later.
+ */
+WarpStatus
+triggerSensorBME680(void)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	uint16_t	readSensorRegisterValueXLSB;
-	uint32_t	unsignedRawAdcValue;
-	WarpStatus	triggerStatus, i2cReadStatusMSB, i2cReadStatusLSB, i2cReadStatusXLSB;
+	return writeSensorRegisterBME680(kWarpSensorConfigurationRegisterBME680Ctrl_Meas,
+							0b00100101 /* temperature and pressure oversampling 1x, forced mode */,
+							0 /* menuI2cPullupValue */);
+}
 
 
+/*
+ *	Byte offsets are into deviceBME680CalibrationValues, so 0 is register
+ *	0x89 and 25 is register 0xE1 (see the BME680 datasheet, Table 11-13).
+ */
+void
+decodeCalibrationBME680(const volatile uint8_t *  calibrationValues, WarpBME680Calibration *  calibration)
+{
+	const volatile uint8_t *	c = calibrationValues;
+
+	calibration->parT1	= (uint16_t)((c[34] << 8) | c[33]);
+	calibration->parT2	= (int16_t)((c[2] << 8) | c[1]);
+	calibration->parT3	= (int8_t)c[3];
+
+	calibration->parP1	= (uint16_t)((c[6] << 8) | c[5]);
+	calibration->parP2	= (int16_t)((c[8] << 8) | c[7]);
+	calibration->parP3	= (int8_t)c[9];
+	calibration->parP4	= (int16_t)((c[12] << 8) | c[11]);
+	calibration->parP5	= (int16_t)((c[14] << 8) | c[13]);
+	calibration->parP7	= (int8_t)c[15];
+	calibration->parP6	= (int8_t)c[16];
+	calibration->parP8	= (int16_t)((c[20] << 8) | c[19]);
+	calibration->parP9	= (int16_t)((c[22] << 8) | c[21]);
+	calibration->parP10	= c[23];
+
 	/*
-	 *	First, trigger a measurement
+	 *	par_h1 and par_h2 are 12 bits each and share register 0xE2
 	 */
-	triggerStatus = writeSensorRegisterBME680(kWarpSensorConfigurationRegisterBME680Ctrl_Meas,
-							0b00100101,
-							menuI2cPullupValue);
+	calibration->parH2	= (uint16_t)((c[25] << 4) | (c[26] >> 4));
+	calibration->parH1	= (uint16_t)((c[27] << 4) | (c[26] & 0x0F));
+	calibration->parH3	= (int8_t)c[28];
+	calibration->parH4	= (int8_t)c[29];
+	calibration->parH5	= (int8_t)c[30];
+	calibration->parH6	= c[31];
+	calibration->parH7	= (int8_t)c[32];
+}
+
+/*
+ *	The integer compensation of the Bosch BME680 reference driver. The
+ *	temperature is in hundredths of a degree Celsius, and tFine carries
+ *	it on to compensatePressureBME680() and compensateHumidityBME680().
+ *	Right shifts of negative values are arithmetic, as in the reference.
+ */
+int32_t
+compensateTemperatureBME680(const WarpBME680Calibration *  calibration, uint32_t temperatureAdc, int32_t *  tFine)
+{
+	int32_t	var1, var2, var3;
+
+	var1 = ((int32_t)temperatureAdc >> 3) - ((int32_t)calibration->parT1 << 1);
+	var2 = (var1 * (int32_t)calibration->parT2) >> 11;
+	var3 = ((var1 >> 1) * (var1 >> 1)) >> 12;
+	var3 = (var3 * ((int32_t)calibration->parT3 << 4)) >> 14;
+	*tFine = var2 + var3;
 
-	i2cReadStatusMSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680press_msb, 1);
-	readSensorRegisterValueMSB = deviceBME680State.i2cBuffer[0];
-	i2cReadStatusLSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680press_lsb, 1);
-	readSensorRegisterValueLSB = deviceBME680State.i2cBuffer[0];
-	i2cReadStatusXLSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680press_xlsb, 1);
-	readSensorRegisterValueXLSB = deviceBME680State.i2cBuffer[0];
-	unsignedRawAdcValue =
-			((readSensorRegisterValueMSB & 0xFF)  << 12) |
-			((readSensorRegisterValueLSB & 0xFF)  << 4)  |
-			((readSensorRegisterValueXLSB & 0xF0) >> 4);
-
-	if ((triggerStatus != kWarpStatusOK) || (i2cReadStatusMSB != kWarpStatusOK) || (i2cReadStatusLSB != kWarpStatusOK) || (i2cReadStatusXLSB != kWarpStatusOK))
+	return ((*tFine * 5) + 128) >> 8;
+}
+
+/*
+ *	Pressure in Pa.
+ */
+uint32_t
+compensatePressureBME680(const WarpBME680Calibration *  calibration, uint32_t pressureAdc, int32_t tFine)
+{
+	int32_t		var1, var2, var3, pressure;
+	uint32_t	scaled;
+
+	var1 = (tFine >> 1) - 64000;
+	var2 = ((((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)calibration->parP6) >> 2;
+	var2 = var2 + ((var1 * (int32_t)calibration->parP5) << 1);
+	var2 = (var2 >> 2) + ((int32_t)calibration->parP4 << 16);
+	var1 = (((((var1 >> 2) * (var1 >> 2)) >> 13) * ((int32_t)calibration->parP3 << 5)) >> 3) +
+		(((int32_t)calibration->parP2 * var1) >> 1);
+	var1 = var1 >> 18;
+	var1 = ((32768 + var1) * (int32_t)calibration->parP1) >> 15;
+	if (var1 <= 0)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		/*
+		 *	Only with a blank (all-zero) calibration
+		 */
+		return 0;
+	}
+
+	pressure = 1048576 - (int32_t)pressureAdc - (var2 >> 12);
+	if (pressure <= 0)
+	{
+		return 0;
+	}
+
+	/*
+	 *	The reference keeps pressure * 3125 in an int32_t, which wraps
+	 *	for cold, high-pressure readings (near -40 degC and 1100 hPa);
+	 *	as a uint32_t it cannot. Divide first when doubling would overflow.
+	 */
+	scaled = (uint32_t)pressure * 3125;
+	if (scaled >= 0x40000000)
+	{
+		pressure = (int32_t)((scaled / (uint32_t)var1) << 1);
 	}
 	else
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB, readSensorRegisterValueXLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %u,", unsignedRawAdcValue);
-		}
+		pressure = (int32_t)((scaled << 1) / (uint32_t)var1);
 	}
 
+	var1 = ((int32_t)calibration->parP9 * (int32_t)(((pressure >> 3) * (pressure >> 3)) >> 13)) >> 12;
+	var2 = ((int32_t)(pressure >> 2) * (int32_t)calibration->parP8) >> 13;
+	/*
+	 *	The reference multiplies the cube by par_p10 before the shift,
+	 *	which overflows above about 1040 hPa; shifting the cube first
+	 *	costs less than 1/16 Pa.
+	 */
+	var3 = (pressure >> 8) * (pressure >> 8) * (pressure >> 8);
+	var3 = ((var3 >> 9) * (int32_t)calibration->parP10) >> 8;
+	pressure = pressure + ((var1 + var2 + var3 + ((int32_t)calibration->parP7 << 7)) >> 4);
 
-	i2cReadStatusMSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680temp_msb, 1);
-	readSensorRegisterValueMSB = deviceBME680State.i2cBuffer[0];
-	i2cReadStatusLSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680temp_lsb, 1);
-	readSensorRegisterValueLSB = deviceBME680State.i2cBuffer[0];
-	i2cReadStatusXLSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680temp_xlsb, 1);
-	readSensorRegisterValueXLSB = deviceBME680State.i2cBuffer[0];
-	unsignedRawAdcValue =
-			((readSensorRegisterValueMSB & 0xFF)  << 12) |
-			((readSensorRegisterValueLSB & 0xFF)  << 4)  |
-			((readSensorRegisterValueXLSB & 0xF0) >> 4);
-	if ((triggerStatus != kWarpStatusOK) || (i2cReadStatusMSB != kWarpStatusOK) || (i2cReadStatusLSB != kWarpStatusOK) || (i2cReadStatusXLSB != kWarpStatusOK))
+	return (uint32_t)pressure;
+}
+
+/*
+ *	Relative humidity in thousandths of a percent, clamped to 0..100%.
+ */
+uint32_t
+compensateHumidityBME680(const WarpBME680Calibration *  calibration, uint16_t humidityAdc, int32_t tFine)
+{
+	int32_t	var1, var2, var3, var4, var5, var6, temperatureScaled, humidity;
+
+	temperatureScaled = ((tFine * 5) + 128) >> 8;
+	var1 = (int32_t)(humidityAdc - ((int32_t)calibration->parH1 * 16)) -
+		(((temperatureScaled * (int32_t)calibration->parH3) / 100) >> 1);
+	var2 = ((int32_t)calibration->parH2 *
+		(((temperatureScaled * (int32_t)calibration->parH4) / 100) +
+		(((temperatureScaled * ((temperatureScaled * (int32_t)calibration->parH5) / 100)) >> 6) / 100) +
+		(1 << 14))) >> 10;
+	var3 = var1 * var2;
+	var4 = (int32_t)calibration->parH6 << 7;
+	var4 = (var4 + ((temperatureScaled * (int32_t)calibration->parH7) / 100)) >> 4;
+	var5 = ((var3 >> 14) * (var3 >> 14)) >> 10;
+	var6 = (var4 * var5) >> 1;
+	humidity = (((var3 + var6) >> 10) * 1000) >> 12;
+
+	if (humidity > kWarpBME680HumidityMaxMilliPercent)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		humidity = kWarpBME680HumidityMaxMilliPercent;
 	}
-	else
+	else if (humidity < 0)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB, readSensorRegisterValueXLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %u,", unsignedRawAdcValue);
-		}
+		humidity = 0;
 	}
 
+	return (uint32_t)humidity;
+}
+
+/*
+ *	Print the results of the last conversion started by
+ *	triggerSensorBME680(), read in one burst from press_msb to hum_lsb.
+ *	In hex mode these are the raw register bytes; otherwise they are
+ *	compensated with the calibration read by configureSensorBME680():
+ *	pressure in Pa, temperature in hundredths of a degree Celsius and
+ *	relative humidity in thousandths of a percent.
+ */
+void
+printSensorDataBME680(bool hexModeFlag)
+{
+	volatile uint8_t *	raw = deviceBME680State.i2cBuffer;
+	WarpBME680Calibration	calibration;
+	uint32_t		pressureAdc, temperatureAdc;
+	uint16_t		humidityAdc;
+	int32_t			temperature, tFine;
+	WarpStatus		i2cReadStatus;
+
 
-	i2cReadStatusMSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680hum_msb, 1);
-	readSensorRegisterValueMSB = deviceBME680State.i2cBuffer[0];
-	i2cReadStatusLSB = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680hum_lsb, 1);
-	readSensorRegisterValueLSB = deviceBME680State.i2cBuffer[0];
-	unsignedRawAdcValue = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-	if ((triggerStatus != kWarpStatusOK) || (i2cReadStatusMSB != kWarpStatusOK) || (i2cReadStatusLSB != kWarpStatusOK))
+	i2cReadStatus = readSensorRegisterBME680(kWarpSensorOutputRegisterBME680press_msb, kWarpBME680OutputBytes);
+	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
+		WARP_LOG(kWarpLogCsvFailed);
+		WARP_LOG(kWarpLogCsvFailed);
+
+		return;
 	}
-	else
+
+	if (hexModeFlag)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %u,", unsignedRawAdcValue);
-		}
+		WARP_LOG(kWarpLogCsvHexTriple, raw[0], raw[1], raw[2]);
+		WARP_LOG(kWarpLogCsvHexTriple, raw[3], raw[4], raw[5]);
+		WARP_LOG(kWarpLogCsvHexPair, raw[6], raw[7]);
+
+		return;
 	}
+
+	pressureAdc	= ((uint32_t)raw[0] << 12) | ((uint32_t)raw[1] << 4) | (raw[2] >> 4);
+	temperatureAdc	= ((uint32_t)raw[3] << 12) | ((uint32_t)raw[4] << 4) | (raw[5] >> 4);
+	humidityAdc	= (uint16_t)((raw[6] << 8) | raw[7]);
+
+	decodeCalibrationBME680(deviceBME680CalibrationValues, &calibration);
+	temperature = compensateTemperatureBME680(&calibration, temperatureAdc, &tFine);
+
+	WARP_LOG(kWarpLogCsvUnsigned, compensatePressureBME680(&calibration, pressureAdc, tFine));
+	WARP_LOG(kWarpLogCsvDecimal, temperature);
+	WARP_LOG(kWarpLogCsvUnsigned, compensateHumidityBME680(&calibration, humidityAdc, tFine));
 }
@@ -39,6 +39,37 @@
 #define WARP_BUILD_ENABLE_DEVBME680
 #endif
 
+/*
+ *	The compensation parameters, unpacked from the 41 bytes of
+ *	deviceBME680CalibrationValues (0x89..0xA1, then 0xE1..0xF0) by
+ *	decodeCalibrationBME680(). Names follow the BME680 datasheet.
+ */
+typedef struct
+{
+	uint16_t	parT1;
+	int16_t		parT2;
+	int8_t		parT3;
+
+	uint16_t	parP1;
+	int16_t		parP2;
+	int8_t		parP3;
+	int16_t		parP4;
+	int16_t		parP5;
+	int8_t		parP6;
+	int8_t		parP7;
+	int16_t		parP8;
+	int16_t		parP9;
+	uint8_t		parP10;
+
+	uint16_t	parH1;
+	uint16_t	parH2;
+	int8_t		parH3;
+	int8_t		parH4;
+	int8_t		parH5;
+	uint8_t		parH6;
+	int8_t		parH7;
+} WarpBME680Calibration;
+
 void		initBME680(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStatePointer);
 WarpStatus	writeSensorRegisterBME680(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue);
 WarpStatus	configureSensorBME680(	uint8_t payloadCtrl_Hum,
@@ -51,4 +82,9 @@ WarpStatus	readSensorSignalBME680(WarpTypeMask signal,
 					WarpSignalAccuracy accuracy,
 					WarpSignalReliability reliability,
 					WarpSignalNoise noise);
+WarpStatus	triggerSensorBME680(void);
 void		printSensorDataBME680(bool hexModeFlag);
+void		decodeCalibrationBME680(const volatile uint8_t *  calibrationValues, WarpBME680Calibration *  calibration);
+int32_t		compensateTemperatureBME680(const WarpBME680Calibration *  calibration, uint32_t temperatureAdc, int32_t *  tFine);
+uint32_t	compensatePressureBME680(const WarpBME680Calibration *  calibration, uint32_t pressureAdc, int32_t tFine);
+uint32_t	compensateHumidityBME680(const WarpBME680Calibration *  calibration, uint16_t humidityAdc, int32_t tFine);
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceBMX055accelState;
@@ -58,6 +60,60 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	The output registers hold left-justified two's complement values,
+ *	LSB first: bits of significance, then padding (or status bits) in
+ *	the low end of the LSB. Multi-byte reads auto-increment, except at
+ *	FIFO_DATA, where a burst pops consecutive frames.
+ */
+static const WarpRegisterMap	registersBMX055accel =
+{
+	.deviceState		= &deviceBMX055accelState,
+	.readableRegisters	= NULL,
+	.writableRegisters	= NULL,
+	.lastReadableRegister	= 0x3F,
+	.lastWritableRegister	= 0x3F,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapLittleEndian | kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterBMX055accelACCD_X_LSB,
+	.sampleAxes		= 3,
+	.sampleBits		= {kWarpBMX055accelBits, kWarpBMX055accelBits, kWarpBMX055accelBits},
+};
+
+static const WarpRegisterMap	registersBMX055gyro =
+{
+	.deviceState		= &deviceBMX055gyroState,
+	.readableRegisters	= NULL,
+	.writableRegisters	= NULL,
+	.lastReadableRegister	= 0x3F,
+	.lastWritableRegister	= 0x3F,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapLittleEndian | kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterBMX055gyroRATE_X_LSB,
+	.sampleAxes		= 3,
+	.sampleBits		= {kWarpBMX055gyroBits, kWarpBMX055gyroBits, kWarpBMX055gyroBits},
+};
+
+/*
+ *	The magnetometer registers start at 0x40 (Chip ID). X and Y are
+ *	13-bit, Z is 15-bit and RHALL is 14-bit.
+ */
+static const uint8_t		registersBMX055magAllowed[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x07};
+
+static const WarpRegisterMap	registersBMX055mag =
+{
+	.deviceState		= &deviceBMX055magState,
+	.readableRegisters	= registersBMX055magAllowed,
+	.writableRegisters	= registersBMX055magAllowed,
+	.lastReadableRegister	= 0x52,
+	.lastWritableRegister	= 0x52,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapLittleEndian | kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterBMX055magX_LSB,
+	.sampleAxes		= 4,
+	.sampleBits		= {13, 13, 15, 14},
+};
+
 
 
 /*
@@ -78,36 +134,7 @@ initBMX055accel(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceS
 WarpStatus
 writeSensorRegisterBMX055accel(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	if (deviceRegister > 0x3F)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055accelState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersBMX055accel, deviceRegister, payload);
 }
 
 WarpStatus
@@ -129,38 +156,7 @@ configureSensorBMX055accel(uint8_t payloadPMU_RANGE, uint8_t payloadACCD_HBW, ui
 WarpStatus
 readSensorRegisterBMX055accel(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status;
-
-
-	if (deviceRegister > 0x3F)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055accelState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	cmdBuf[0] = deviceRegister;
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceBMX055accelState.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersBMX055accel, deviceRegister, numberOfBytes);
 }
 
 void
@@ -179,36 +175,7 @@ initBMX055mag(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceSta
 WarpStatus
 writeSensorRegisterBMX055mag(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	if (deviceRegister > 0x52 || deviceRegister < 0x40)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055magState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersBMX055mag, deviceRegister, payload);
 }
 
 WarpStatus
@@ -232,40 +199,7 @@ configureSensorBMX055mag(uint8_t payloadPowerCtrl, uint8_t payloadOpMode, uint16
 WarpStatus
 readSensorRegisterBMX055mag(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status;
-
-
-	if (deviceRegister > 0x52 || deviceRegister < 0x40)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055magState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-
-	cmdBuf[0] = deviceRegister;
-
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceBMX055magState.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersBMX055mag, deviceRegister, numberOfBytes);
 }
 
 void
@@ -283,36 +217,7 @@ initBMX055gyro(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceSt
 WarpStatus
 writeSensorRegisterBMX055gyro(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	if (deviceRegister > 0x3F)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055magState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersBMX055gyro, deviceRegister, payload);
 }
 
 WarpStatus
@@ -334,7 +239,7 @@ configureSensorBMX055gyro(uint8_t payloadRANGE, uint8_t payloadBW, uint8_t paylo
 							menuI2cPullupValue);
 
 	status4 = writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW/* register address RATE_HBW */,
-							payloadLPM1 /* payload */,
+							payloadRATE_HBW /* payload */,
 							menuI2cPullupValue);
 
 	return (status1 | status2 | status3 | status4);
@@ -343,358 +248,196 @@ configureSensorBMX055gyro(uint8_t payloadRANGE, uint8_t payloadBW, uint8_t paylo
 WarpStatus
 readSensorRegisterBMX055gyro(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status;
-
-
-	USED(numberOfBytes);
-	if (deviceRegister > 0x3F)
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceBMX055gyroState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-
-	cmdBuf[0] = deviceRegister;
-
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceBMX055gyroState.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
+	return warpRegisterMapRead(&registersBMX055gyro, deviceRegister, numberOfBytes);
+}
 
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
+/*
+ *	Stream mode keeps the newest frames, discarding the oldest. Writing
+ *	FIFO_CONFIG_1 also clears the FIFO.
+ */
+WarpStatus
+configureSensorBMX055accelFifo(bool enable, uint16_t menuI2cPullupValue)
+{
+	return writeSensorRegisterBMX055accel(kWarpSensorConfigurationRegisterBMX055accelFIFO_CONFIG_1 /* register address FIFO_CONFIG_1 */,
+							enable ? kWarpBMX055FIFO_CONFIG_1ModeStream : kWarpBMX055FIFO_CONFIG_1ModeBypass /* payload: X/Y/Z frames */,
+							menuI2cPullupValue);
+}
 
-	return kWarpStatusOK;
+WarpStatus
+configureSensorBMX055gyroFifo(bool enable, uint16_t menuI2cPullupValue)
+{
+	return writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroFIFO_CONFIG_1 /* register address FIFO_CONFIG_1 */,
+							enable ? kWarpBMX055FIFO_CONFIG_1ModeStream : kWarpBMX055FIFO_CONFIG_1ModeBypass /* payload: X/Y/Z frames */,
+							menuI2cPullupValue);
 }
 
-void
-printSensorDataBMX055accel(bool hexModeFlag)
+/*
+ *	One FIFO_STATUS read, then one FIFO_DATA burst of up to
+ *	maximumSamples frames, decoded in place into xyz (3 int16_t per
+ *	sample). Frames that do not fit stay in the FIFO for the next drain.
+ */
+static WarpStatus
+drainSensorFifoBMX055(const WarpRegisterMap *  map, uint8_t statusRegister, uint8_t dataRegister,
+			int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
 	WarpStatus	i2cReadStatus;
+	uint8_t		fifoStatus, available;
+	uint8_t *	raw = (uint8_t *)xyz;
 
 
-	i2cReadStatus = readSensorRegisterBMX055accel(kWarpSensorOutputRegisterBMX055accelACCD_X_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055accelState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055accelState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 4) | (readSensorRegisterValueLSB >> 4);
-
-	/*
-	 *	Sign extend the 12-bit value based on knowledge that upper 4 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 11)) - (1 << 11);
-
+	*samplesRead = 0;
 
+	i2cReadStatus = warpRegisterMapReadBlock(map, statusRegister, &fifoStatus, 1 /* numberOfBytes */);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		return i2cReadStatus;
 	}
-	else
+
+	if (fifoStatus & kWarpBMX055FIFO_STATUSOverrun)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		(*overruns)++;
 	}
 
-	i2cReadStatus = readSensorRegisterBMX055accel(kWarpSensorOutputRegisterBMX055accelACCD_Y_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055accelState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055accelState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 4) | (readSensorRegisterValueLSB >> 4);
-
-	/*
-	 *	Sign extend the 12-bit value based on knowledge that upper 4 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 11)) - (1 << 11);
-
-
-	if (i2cReadStatus != kWarpStatusOK)
+	available = fifoStatus & kWarpBMX055FIFO_STATUSFrameCountMask;
+	if (available > maximumSamples)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		available = maximumSamples;
 	}
-	else
+
+	if (available == 0)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return kWarpStatusOK;
 	}
 
-	i2cReadStatus = readSensorRegisterBMX055accel(kWarpSensorOutputRegisterBMX055accelACCD_Z_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055accelState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055accelState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 4) | (readSensorRegisterValueLSB >> 4);
-
-	/*
-	 *	Sign extend the 12-bit value based on knowledge that upper 4 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 11)) - (1 << 11);
-
-
+	i2cReadStatus = warpRegisterMapReadBlock(map, dataRegister, raw, available * kWarpBMX055BytesPerFifoFrame);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return i2cReadStatus;
 	}
 
-	i2cReadStatus = readSensorRegisterBMX055accel(kWarpSensorOutputRegisterBMX055accelACCD_TEMP, 1 /* numberOfBytes */);
-	readSensorRegisterValueCombined = deviceBMX055accelState.i2cBuffer[0];
+	warpRegisterMapDecode(map, raw, xyz, 3*available);
+	*samplesRead = available;
 
-	/*
-	 *	Sign extend the 8-bit value based on knowledge that upper 8 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 7)) - (1 << 7);
+	return kWarpStatusOK;
+}
 
+WarpStatus
+drainSensorFifoBMX055accel(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns)
+{
+	return drainSensorFifoBMX055(&registersBMX055accel,
+					kWarpSensorOutputRegisterBMX055accelFIFO_STATUS,
+					kWarpSensorOutputRegisterBMX055accelFIFO_DATA,
+					xyz, maximumSamples, samplesRead, overruns);
+}
 
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x,", readSensorRegisterValueCombined);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
+WarpStatus
+drainSensorFifoBMX055gyro(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns)
+{
+	return drainSensorFifoBMX055(&registersBMX055gyro,
+					kWarpSensorOutputRegisterBMX055gyroFIFO_STATUS,
+					kWarpSensorOutputRegisterBMX055gyroFIFO_DATA,
+					xyz, maximumSamples, samplesRead, overruns);
 }
 
-void
-printSensorDataBMX055gyro(bool hexModeFlag)
+/*
+ *	Decoded accel, gyro and (unless mag is NULL) magnetometer X/Y/Z in
+ *	one burst per device, for consumers such as the orientation filter.
+ *	Magnetometer values are raw: the trim-register compensation is not
+ *	applied.
+ */
+WarpStatus
+readSensorAxesBMX055(int16_t *  accel, int16_t *  gyro, int16_t *  mag)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
 	WarpStatus	i2cReadStatus;
 
 
-	i2cReadStatus = readSensorRegisterBMX055gyro(kWarpSensorOutputRegisterBMX055gyroRATE_X_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055gyroState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055gyroState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
+	i2cReadStatus = warpRegisterMapReadSample(&registersBMX055accel, accel);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return i2cReadStatus;
 	}
 
-	i2cReadStatus = readSensorRegisterBMX055gyro(kWarpSensorOutputRegisterBMX055gyroRATE_Y_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055gyroState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055gyroState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
+	i2cReadStatus = warpRegisterMapReadSample(&registersBMX055gyro, gyro);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		return i2cReadStatus;
 	}
-	else
+
+	if (mag == NULL)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return kWarpStatusOK;
 	}
 
-	i2cReadStatus = readSensorRegisterBMX055gyro(kWarpSensorOutputRegisterBMX055gyroRATE_Z_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055gyroState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055gyroState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
 	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
+	 *	X through Z only, without RHALL.
 	 */
-
+	i2cReadStatus = readSensorRegisterBMX055mag(kWarpSensorOutputRegisterBMX055magX_LSB, 6 /* numberOfBytes */);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return i2cReadStatus;
 	}
+	warpRegisterMapDecode(&registersBMX055mag, (uint8_t *)deviceBMX055magState.i2cBuffer, mag, 3);
+
+	return kWarpStatusOK;
 }
 
 void
-printSensorDataBMX055mag(bool hexModeFlag)
+printSensorDataBMX055accel(bool hexModeFlag)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
 	int16_t		readSensorRegisterValueCombined;
 	WarpStatus	i2cReadStatus;
 
 
-	i2cReadStatus = readSensorRegisterBMX055mag(kWarpSensorOutputRegisterBMX055magX_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055magState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055magState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 5) | (readSensorRegisterValueLSB >> 3);
-
 	/*
-	 *	Sign extend the 13-bit value based on knowledge that upper 3 bit are 0:
+	 *	ACCD_X_LSB through ACCD_TEMP in one burst. With shadowing enabled,
+	 *	reading each LSB locks its MSB until that is read too.
 	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 12)) - (1 << 12);
-
-
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
-
-	i2cReadStatus = readSensorRegisterBMX055mag(kWarpSensorOutputRegisterBMX055magY_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055magState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055magState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 5) | (readSensorRegisterValueLSB >> 3);
+	i2cReadStatus = readSensorRegisterBMX055accel(kWarpSensorOutputRegisterBMX055accelACCD_X_LSB, kWarpBMX055accelBurstBytes);
+	warpRegisterMapPrintSample(&registersBMX055accel, i2cReadStatus, hexModeFlag);
 
 	/*
-	 *	Sign extend the 13-bit value based on knowledge that upper 4 bit are 0:
+	 *	Sign extend the 8-bit value based on knowledge that upper 8 bit are 0:
 	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 12)) - (1 << 12);
+	readSensorRegisterValueCombined = deviceBMX055accelState.i2cBuffer[6];
+	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 7)) - (1 << 7);
 
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexByte, readSensorRegisterValueCombined);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 		}
 	}
+}
 
-	i2cReadStatus = readSensorRegisterBMX055mag(kWarpSensorOutputRegisterBMX055magZ_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055magState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055magState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 7) | (readSensorRegisterValueLSB >> 1);
+void
+printSensorDataBMX055gyro(bool hexModeFlag)
+{
+	WarpStatus	i2cReadStatus;
 
-	/*
-	 *	Sign extend the 15-bit value based on knowledge that upper 1 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 14)) - (1 << 14);
 
+	i2cReadStatus = warpRegisterMapReadSample(&registersBMX055gyro, NULL);
+	warpRegisterMapPrintSample(&registersBMX055gyro, i2cReadStatus, hexModeFlag);
+}
 
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
+void
+printSensorDataBMX055mag(bool hexModeFlag)
+{
+	WarpStatus	i2cReadStatus;
 
-	i2cReadStatus = readSensorRegisterBMX055mag(kWarpSensorOutputRegisterBMX055magRHALL_LSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceBMX055magState.i2cBuffer[0];
-	readSensorRegisterValueMSB = deviceBMX055magState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
 
 	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
+	 *	X_LSB through RHALL_MSB in one burst.
 	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
-
-
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
+	i2cReadStatus = warpRegisterMapReadSample(&registersBMX055mag, NULL);
+	warpRegisterMapPrintSample(&registersBMX055mag, i2cReadStatus, hexModeFlag);
 }
@@ -60,6 +60,13 @@ WarpStatus	configureSensorBMX055mag(uint8_t payloadPowerCtrl,
 					uint8_t payloadOpMode,
 					uint16_t menuI2cPullupValue);
 
+WarpStatus	configureSensorBMX055accelFifo(bool enable, uint16_t menuI2cPullupValue);
+WarpStatus	configureSensorBMX055gyroFifo(bool enable, uint16_t menuI2cPullupValue);
+WarpStatus	drainSensorFifoBMX055accel(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns);
+WarpStatus	drainSensorFifoBMX055gyro(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns);
+
+WarpStatus	readSensorAxesBMX055(int16_t *  accel, int16_t *  gyro, int16_t *  mag);
+
 WarpStatus	readSensorRegisterBMX055accel(uint8_t deviceRegister, int numberOfBytes);
 WarpStatus	readSensorRegisterBMX055gyro(uint8_t deviceRegister, int numberOfBytes);
 WarpStatus	readSensorRegisterBMX055mag(uint8_t deviceRegister, int numberOfBytes);
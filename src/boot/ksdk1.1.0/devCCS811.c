@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 
@@ -57,6 +59,21 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Writes carry a register-specific number of bytes, chosen in
+ *	writeSensorRegisterCCS811(), so registerBytes is unused.
+ */
+static const WarpRegisterMap	registersCCS811 =
+{
+	.deviceState		= &deviceCCS811State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= NULL,
+	.lastReadableRegister	= 0xFF,
+	.lastWritableRegister	= 0xFF,
+	.registerBytes		= 1,
+	.flags			= 0,
+};
+
 
 
 /*
@@ -77,9 +94,7 @@ initCCS811(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStateP
 WarpStatus
 writeSensorRegisterCCS811(uint8_t deviceRegister, uint8_t *payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		commandByte[1];
 	uint8_t		payloadSize;
-	i2c_status_t	status;
 
 	switch (deviceRegister)
 	{
@@ -128,43 +143,7 @@ writeSensorRegisterCCS811(uint8_t deviceRegister, uint8_t *payload, uint16_t men
 		}
 	}
 
-	i2c_device_t slave =
-	{
-		.address = deviceCCS811State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-
-	if(payloadSize)
-	{
-		status = I2C_DRV_MasterSendDataBlocking(
-								0 /* I2C instance */,
-								&slave,
-								commandByte,
-								1,
-								payload,
-								payloadSize,
-								gWarpI2cTimeoutMilliseconds);
-	}
-	else
-	{
-		status = I2C_DRV_MasterSendDataBlocking(
-						0 /* I2C instance */,
-						&slave,
-						commandByte,
-						1,
-						NULL,
-						0,
-						gWarpI2cTimeoutMilliseconds);
-	}
-
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWriteBytes(&registersCCS811, deviceRegister, payloadSize ? payload : NULL, payloadSize);
 }
 
 WarpStatus
@@ -207,40 +186,7 @@ configureSensorCCS811(uint8_t *payloadMEAS_MODE, uint16_t menuI2cPullupValue)
 WarpStatus
 readSensorRegisterCCS811(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	returnValue;
-
-
-	if ((deviceRegister > 0xFF) || (numberOfBytes > kWarpSizesI2cBufferBytes))
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceCCS811State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-
-	cmdBuf[0] = deviceRegister;
-
-
-	returnValue = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceCCS811State.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if (returnValue != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersCCS811, deviceRegister, numberOfBytes);
 }
 
 void
@@ -258,13 +204,13 @@ printSensorDataCCS811(bool hexModeFlag)
 	TVOC		= (deviceCCS811State.i2cBuffer[2] << 8) | deviceCCS811State.i2cBuffer[3];
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----, ----,");
+		WARP_LOG(kWarpLogCsvFailedPair);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x, 0x%02x 0x%02x,",
+			WARP_LOG(kWarpLogCsvHexPairPair,
 				deviceCCS811State.i2cBuffer[3],
 				deviceCCS811State.i2cBuffer[2],
 				deviceCCS811State.i2cBuffer[1],
@@ -272,7 +218,7 @@ printSensorDataCCS811(bool hexModeFlag)
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d, %d,", equivalentCO2, TVOC);
+			WARP_LOG(kWarpLogCsvDecimalPair, equivalentCO2, TVOC);
 		}
 	}
 
@@ -288,17 +234,17 @@ printSensorDataCCS811(bool hexModeFlag)
 						(readSensorRegisterValueMSB & 0xFF);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 		}
 	}
 	/*
@@ -311,17 +257,17 @@ printSensorDataCCS811(bool hexModeFlag)
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 		}
 	}
   /*
@@ -333,17 +279,17 @@ printSensorDataCCS811(bool hexModeFlag)
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValueCombined);
 		}
 	}
 }
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceHDC1000State;
@@ -56,6 +58,22 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	16-bit registers, MSB first; only Configuration (0x02) is writable.
+ */
+static const uint8_t		writableRegistersHDC1000[] = {0x04};
+
+static const WarpRegisterMap	registersHDC1000 =
+{
+	.deviceState		= &deviceHDC1000State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= writableRegistersHDC1000,
+	.lastReadableRegister	= 0xFF,
+	.lastWritableRegister	= 0x02,
+	.registerBytes		= 2,
+	.flags			= 0,
+};
+
 
 
 void
@@ -70,46 +88,7 @@ initHDC1000(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceState
 WarpStatus
 writeSensorRegisterHDC1000(uint8_t deviceRegister, uint16_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[2], commandByte[1];
-	i2c_status_t	returnValue;
-
-	switch (deviceRegister)
-	{
-		case 0x02:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceHDC1000State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = (payload>>8) & 0xFF; /* MSB first */
-	payloadByte[1] = payload & 0xFF; /* LSB */
-	returnValue = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							2,
-							1000);
-	if (returnValue != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersHDC1000, deviceRegister, payload);
 }
 
 WarpStatus
@@ -122,7 +101,7 @@ readSensorRegisterHDC1000(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{
 		.address = deviceHDC1000State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceHDC1000State.i2cAddress)
 	};
 
 	USED(numberOfBytes);
@@ -170,7 +149,7 @@ readSensorRegisterHDC1000(uint8_t deviceRegister, int numberOfBytes)
 		 */
 		cmdBuf[0] = deviceRegister;
 
-		status1 = I2C_DRV_MasterSendDataBlocking(
+		status1 = warpI2CMasterSendDataBlocking(
 								0 /* I2C peripheral instance */,
 								&slave,
 								cmdBuf,
@@ -180,14 +159,15 @@ readSensorRegisterHDC1000(uint8_t deviceRegister, int numberOfBytes)
 								gWarpI2cTimeoutMilliseconds);
 
 		/*
-		 *	Step 2: Wait for max 6.5ms for conversion completion (see Table 7.5 of HDC1000 datasheet)
+		 *	Step 2: Wait for conversion completion (see Table 7.5 of HDC1000 datasheet);
+		 *	in sequential mode, a trigger at 0x00 converts both values.
 		 */
-		OSA_TimeDelay(7);
+		OSA_TimeDelay(kWarpHDC1000ConversionMilliseconds);
 
 		/*
 		 *	Step 3: Read temp/humidity
 		 */
-		status2 = I2C_DRV_MasterReceiveDataBlocking(
+		status2 = warpI2CMasterReceiveDataBlocking(
 								0 /* I2C peripheral instance */,
 								&slave,
 								NULL,
@@ -200,29 +180,87 @@ readSensorRegisterHDC1000(uint8_t deviceRegister, int numberOfBytes)
 		{
 			return kWarpStatusDeviceCommunicationFailed;
 		}
+
+		return kWarpStatusOK;
 	}
-	else
+
+	return warpRegisterMapRead(&registersHDC1000, deviceRegister, numberOfBytes);
+}
+
+/*
+ *	Start a conversion without waiting for it. With
+ *	kWarpHDC1000ConfigurationSequential set in the Configuration register
+ *	(see configureAllSensors()), one trigger converts temperature and
+ *	then humidity, and collectSensorDataHDC1000() reads both
+ *	kWarpHDC1000ConversionMicroseconds later. The HDC1000 NAKs reads until
+ *	then, so the caller is free to do other work or sleep in between.
+ */
+WarpStatus
+triggerSensorHDC1000(void)
+{
+	uint8_t		cmdBuf[1] = {kWarpSensorOutputRegisterHDC1000Temperature};
+	i2c_status_t	status;
+
+
+	i2c_device_t slave =
 	{
-		cmdBuf[0] = deviceRegister;
+		.address = deviceHDC1000State.i2cAddress,
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceHDC1000State.i2cAddress)
+	};
 
-		status1 = I2C_DRV_MasterReceiveDataBlocking(
-								0 /* I2C peripheral instance */,
-								&slave,
-								cmdBuf,
-								1,
-								(uint8_t *)deviceHDC1000State.i2cBuffer,
-								numberOfBytes,
-								gWarpI2cTimeoutMilliseconds);
+	status = warpI2CMasterSendDataBlocking(
+							0 /* I2C peripheral instance */,
+							&slave,
+							cmdBuf,
+							1,
+							NULL,
+							0,
+							gWarpI2cTimeoutMilliseconds);
 
-		if (status1 != kStatus_I2C_Success)
-		{
-			return kWarpStatusDeviceCommunicationFailed;
-		}
+	if (status != kStatus_I2C_Success)
+	{
+		return kWarpStatusDeviceCommunicationFailed;
 	}
 
 	return kWarpStatusOK;
 }
 
+/*
+ *	Temperature then humidity, MSB first, into i2cBuffer in one 4-byte
+ *	read (no pointer write: that would start another conversion).
+ */
+WarpStatus
+collectSensorDataHDC1000(void)
+{
+	i2c_status_t	status;
+
+
+	i2c_device_t slave =
+	{
+		.address = deviceHDC1000State.i2cAddress,
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceHDC1000State.i2cAddress)
+	};
+
+	status = warpI2CMasterReceiveDataBlocking(
+							0 /* I2C peripheral instance */,
+							&slave,
+							NULL,
+							0,
+							(uint8_t *)deviceHDC1000State.i2cBuffer,
+							kWarpHDC1000ResultBytes,
+							gWarpI2cTimeoutMilliseconds);
+
+	if (status != kStatus_I2C_Success)
+	{
+		return kWarpStatusDeviceCommunicationFailed;
+	}
+
+	return kWarpStatusOK;
+}
+
+/*
+ *	Print the results of the conversion started by triggerSensorHDC1000().
+ */
 void
 printSensorDataHDC1000(bool hexModeFlag)
 {
@@ -232,7 +270,7 @@ printSensorDataHDC1000(bool hexModeFlag)
 	WarpStatus	i2cReadStatus;
 
 
-	i2cReadStatus = readSensorRegisterHDC1000(kWarpSensorOutputRegisterHDC1000Temperature, 2 /* numberOfBytes */);
+	i2cReadStatus = collectSensorDataHDC1000();
 	readSensorRegisterValueMSB = deviceHDC1000State.i2cBuffer[0];
 	readSensorRegisterValueLSB = deviceHDC1000State.i2cBuffer[1];
 	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
@@ -243,48 +281,43 @@ printSensorDataHDC1000(bool hexModeFlag)
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
 			/*
 			 *	See Section 8.6.1 of the HDC1000 manual for the conversion to temperature.
 			 */
-			SEGGER_RTT_printf(0, " %d,", (readSensorRegisterValueCombined*165 / (1u << 16)) - 40);
+			WARP_LOG(kWarpLogCsvDecimal, (readSensorRegisterValueCombined*165 / (1u << 16)) - 40);
 		}
 	}
 
-	i2cReadStatus = readSensorRegisterHDC1000(kWarpSensorOutputRegisterHDC1000Humidity, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceHDC1000State.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceHDC1000State.i2cBuffer[1];
+	readSensorRegisterValueMSB = deviceHDC1000State.i2cBuffer[2];
+	readSensorRegisterValueLSB = deviceHDC1000State.i2cBuffer[3];
 	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
 
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			WARP_LOG(kWarpLogCsvHexPair, readSensorRegisterValueMSB, readSensorRegisterValueLSB);
 		}
 		else
 		{
 			/*
 			 *	See Section 8.6.2 of the HDC1000 manual for the conversion to temperature.
 			 */
-			SEGGER_RTT_printf(0, " %d,", (readSensorRegisterValueCombined*100 / (1u << 16)));
+			WARP_LOG(kWarpLogCsvDecimal, (readSensorRegisterValueCombined*100 / (1u << 16)));
 		}
 	}
 }
\ No newline at end of file
@@ -47,4 +47,6 @@ WarpStatus	readSensorSignalHDC1000(WarpTypeMask signal,
 					WarpSignalAccuracy accuracy,
 					WarpSignalReliability reliability,
 					WarpSignalNoise noise);
+WarpStatus	triggerSensorHDC1000(void);
+WarpStatus	collectSensorDataHDC1000(void);
 void		printSensorDataHDC1000(bool hexModeFlag);
\ No newline at end of file
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceINA219State;
@@ -56,6 +58,23 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	16-bit registers, MSB first; Configuration (0x00) and Calibration
+ *	(0x05) are writable.
+ */
+static const uint8_t		writableRegistersINA219[] = {0x21};
+
+static const WarpRegisterMap	registersINA219 =
+{
+	.deviceState		= &deviceINA219State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= writableRegistersINA219,
+	.lastReadableRegister	= 0x05,
+	.lastWritableRegister	= 0x05,
+	.registerBytes		= 2,
+	.flags			= 0,
+};
+
 
 
 void
@@ -75,47 +94,7 @@ initINA219(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStateP
 WarpStatus
 writeSensorRegisterINA219(uint8_t deviceRegister, uint16_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[2], commandByte[1];
-	i2c_status_t	status;
-
-	switch (deviceRegister)
-	{
-		case 0x00: case 0x05:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceINA219State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[1] = payload & 0xFF;
-	payloadByte[0] = (payload >> 8) & 0xFF;
-	
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							2,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersINA219, deviceRegister, payload);
 }
 
 WarpStatus
@@ -132,56 +111,127 @@ configureSensorINA219(uint16_t payloadF_SETUP,  uint16_t menuI2cPullupValue)
 WarpStatus
 readSensorRegisterINA219(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	uint16_t	LSB;
-	uint16_t	MSB;
-	uint16_t	out;
-	i2c_status_t	status;
+	return warpRegisterMapRead(&registersINA219, deviceRegister, numberOfBytes);
+}
 
+/*
+ *	Start one triggered shunt conversion averaged over the SADC code
+ *	shuntAdcCode (see WarpINA219Constants). The write also clears CNVR.
+ */
+WarpStatus
+startShuntConversionINA219(uint8_t shuntAdcCode)
+{
+	return writeSensorRegisterINA219(kWarpSensorConfigurationRegisterINA219_Configuration,
+						kWarpINA219ConfigurationPga8 |
+						kWarpINA219ConfigurationBadc12Bit |
+						(shuntAdcCode << kWarpINA219ConfigurationSadcShift) |
+						kWarpINA219ConfigurationShuntTriggered,
+						0 /* menuI2cPullupValue */);
+}
+
+/*
+ *	Continuous 9-bit (84us) shunt conversions for the capture engine in
+ *	warp-capture.c, with the calibration making the current register
+ *	count in shunt register units, and the register pointer left on the
+ *	current register for readCurrentCaptureINA219().
+ */
+WarpStatus
+startCurrentCaptureINA219(void)
+{
+	WarpStatus	status;
 
-	USED(numberOfBytes);
-	switch (deviceRegister)
+
+	status = writeSensorRegisterINA219(kWarpSensorConfigurationRegisterINA219_Calibration, kWarpINA219Calibration1To1, 0 /* menuI2cPullupValue */);
+	if (status != kWarpStatusOK)
 	{
-		case 0x00: case 0x01: case 0x02: case 0x03: case 0x04: case 0x05:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
+		return status;
+	}
+
+	status = writeSensorRegisterINA219(kWarpSensorConfigurationRegisterINA219_Configuration,
+						kWarpINA219ConfigurationPga8 | kWarpINA219ConfigurationShuntContinuous,
+						0 /* menuI2cPullupValue */);
+	if (status != kWarpStatusOK)
+	{
+		return status;
 	}
 
+	return readSensorRegisterINA219(kWarpSensorOutputRegisterINA219Current, 2 /* numberOfBytes */);
+}
+
+/*
+ *	The register at the pointer (see startCurrentCaptureINA219()), read
+ *	without the pointer write of readSensorRegisterINA219(): three bytes
+ *	on the bus instead of five.
+ */
+WarpStatus
+readCurrentCaptureINA219(int16_t *  currentCounts)
+{
+	i2c_status_t	status;
+
 
 	i2c_device_t slave =
 	{
 		.address = deviceINA219State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceINA219State.i2cAddress)
 	};
 
-
-	cmdBuf[0] = deviceRegister;
-
-	status = I2C_DRV_MasterReceiveDataBlocking(
+	status = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
-							cmdBuf,
-							1,
+							NULL,
+							0,
 							(uint8_t *)deviceINA219State.i2cBuffer,
-							numberOfBytes,
+							2,
 							gWarpI2cTimeoutMilliseconds);
-
 	if (status != kStatus_I2C_Success)
 	{
 		return kWarpStatusDeviceCommunicationFailed;
 	}
-	//LSB = deviceINA219State.i2cBuffer[0];
-	//MSB = deviceINA219State.i2cBuffer[1];
-	
-	//out = ((LSB & 0xFF) << 8) | (MSB & 0xFF);
-		
+
+	*currentCounts = (int16_t)((deviceINA219State.i2cBuffer[0] << 8) | deviceINA219State.i2cBuffer[1]);
+
+	return kWarpStatusOK;
+}
+
+/*
+ *	Wait (at most gWarpI2cTimeoutMilliseconds) for CNVR, then read the
+ *	signed shunt voltage in units of kWarpINA219MicrovoltsPerShuntCount.
+ */
+WarpStatus
+readShuntConversionINA219(int16_t *  shuntCounts)
+{
+	WarpStatus	i2cReadStatus;
+	uint32_t	attempts = 0;
+
+
+	while (1)
+	{
+		i2cReadStatus = readSensorRegisterINA219(kWarpSensorOutputRegisterINA219BusVoltage, 2 /* numberOfBytes */);
+		if (i2cReadStatus != kWarpStatusOK)
+		{
+			return i2cReadStatus;
+		}
+
+		if (deviceINA219State.i2cBuffer[1] & kWarpINA219BusVoltageConversionReady)
+		{
+			break;
+		}
+
+		if (++attempts > gWarpI2cTimeoutMilliseconds)
+		{
+			return kWarpStatusDeviceCommunicationFailed;
+		}
+		OSA_TimeDelay(1);
+	}
+
+	i2cReadStatus = readSensorRegisterINA219(kWarpSensorOutputRegisterINA219ShuntVoltage, 2 /* numberOfBytes */);
+	if (i2cReadStatus != kWarpStatusOK)
+	{
+		return i2cReadStatus;
+	}
+
+	*shuntCounts = (int16_t)((deviceINA219State.i2cBuffer[0] << 8) | deviceINA219State.i2cBuffer[1]);
+
 	return kWarpStatusOK;
 }
 
@@ -238,17 +288,17 @@ printSensorDataINA219(bool hexModeFlag)
 	
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " %d", readSensorRegisterValue);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValue);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d", readSensorRegisterValue);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValue);
 		}
 		
 	}
@@ -261,17 +311,17 @@ printSensorDataINA219(bool hexModeFlag)
 	
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValue);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValue);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValue);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterValue);
 		}
 	}
 	*/	
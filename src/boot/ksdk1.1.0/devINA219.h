@@ -45,6 +45,10 @@ WarpStatus	writeSensorRegisterINA219(uint8_t deviceRegister,
 					uint16_t payload,
 					uint16_t menuI2cPullupValue);
 WarpStatus	configureSensorINA219(uint16_t payloadF_SETUP, uint16_t menuI2cPullupValue);
+WarpStatus	startShuntConversionINA219(uint8_t shuntAdcCode);
+WarpStatus	readShuntConversionINA219(int16_t *  shuntCounts);
+WarpStatus	startCurrentCaptureINA219(void);
+WarpStatus	readCurrentCaptureINA219(int16_t *  currentCounts);
 WarpStatus	readSensorSignalINA219(WarpTypeMask signal,
 					WarpSignalPrecision precision,
 					WarpSignalAccuracy accuracy,
@@ -136,7 +136,7 @@ readDeviceRegisterISL23415(uint8_t deviceRegister, int numberOfBytes)
 	 *	file.
 	 */
 	
-	deviceISL23415State.ksdk_spi_status = SPI_DRV_MasterTransferBlocking(
+	deviceISL23415State.ksdk_spi_status = warpSPIMasterTransferBlocking(
 					0 /* master instance */, 	
 					NULL /* spi_master_user_config_t */,
 					(const uint8_t * restrict)deviceISL23415State.spiSourceBuffer,
@@ -175,7 +175,7 @@ readDeviceRegisterISL23415(uint8_t deviceRegister, int numberOfBytes)
 	 *	file.
 	 */
 	
-	deviceISL23415State.ksdk_spi_status = SPI_DRV_MasterTransferBlocking(
+	deviceISL23415State.ksdk_spi_status = warpSPIMasterTransferBlocking(
 					0 /* master instance */, 	
 					NULL /* spi_master_user_config_t */,
 					(const uint8_t * restrict)deviceISL23415State.spiSourceBuffer,
@@ -246,7 +246,7 @@ writeDeviceRegisterISL23415(uint8_t deviceRegister, uint8_t writeValue[2], int n
 	 *	file.
 	 */
 	enableSPIpins();
-	deviceISL23415State.ksdk_spi_status = SPI_DRV_MasterTransferBlocking(0 /* master instance */, 	
+	deviceISL23415State.ksdk_spi_status = warpSPIMasterTransferBlocking(0 /* master instance */, 	
 					NULL /* spi_master_user_config_t */,
 					(const uint8_t * restrict)deviceISL23415State.spiSourceBuffer,
 					(uint8_t * restrict)deviceISL23415State.spiSinkBuffer,
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceL3GD20HState;
@@ -56,6 +58,32 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Writable: CTRL1 through CTRL5, FIFO_CTRL, IG_CFG, IG_THS_* through
+ *	LOW_ODR. Readable: WHO_AM_I (0x0F) through LOW_ODR.
+ */
+static const uint8_t		writableRegistersL3GD20H[] = {0x00, 0x00, 0x00, 0x00, 0x3F, 0x40, 0xFD, 0x03};
+static const uint8_t		readableRegistersL3GD20H[] = {0x00, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03};
+
+/*
+ *	OUT_X_L through OUT_Z_H: 16-bit, LSB first. Multi-byte reads set the
+ *	MSB of the sub-address so that the address auto-increments (Table 15
+ *	and Table 16 of the L3GD20H manual).
+ */
+static const WarpRegisterMap	registersL3GD20H =
+{
+	.deviceState		= &deviceL3GD20HState,
+	.readableRegisters	= readableRegistersL3GD20H,
+	.writableRegisters	= writableRegistersL3GD20H,
+	.lastReadableRegister	= 0x39,
+	.lastWritableRegister	= 0x39,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapLittleEndian | kWarpRegisterMapAutoIncrementBit | kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterL3GD20HOUT_X_L,
+	.sampleAxes		= 3,
+	.sampleBits		= {16, 16, 16},
+};
+
 
 
 void
@@ -73,48 +101,7 @@ initL3GD20H(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceState
 WarpStatus
 writeSensorRegisterL3GD20H(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	switch (deviceRegister)
-	{
-		case 0x20: case 0x21: case 0x22: case 0x23:
-		case 0x24: case 0x25: case 0x2E: case 0x30:
-		case 0x32: case 0x33: case 0x34: case 0x35:
-		case 0x36: case 0x37: case 0x38: case 0x39:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceL3GD20HState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersL3GD20H, deviceRegister, payload);
 }
 
 WarpStatus
@@ -137,172 +124,138 @@ configureSensorL3GD20H(uint8_t payloadCTRL1, uint8_t payloadCTRL2, uint8_t paylo
 	return (status1 | status2 | status3);
 }
 
+/*
+ *	Stream mode with FIFO_EN set in CTRL5: the FIFO keeps the newest 32
+ *	samples, overwriting the oldest. CTRL5 is written as just FIFO_EN,
+ *	i.e., with the high-pass filter and interrupt routing cleared.
+ */
 WarpStatus
-readSensorRegisterL3GD20H(uint8_t deviceRegister, int numberOfBytes)
+configureSensorL3GD20HFifo(uint8_t payloadCTRL1, uint8_t watermark, uint16_t menuI2cPullupValue)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status1, status2;
-
-
-	USED(numberOfBytes);
-	if ((deviceRegister < 0x0F) || (deviceRegister > 0x39))
-	{
-		return kWarpStatusBadDeviceCommand;
-	}
+	WarpStatus	status1, status2, status3;
 
-	i2c_device_t slave =
-	{
-		.address = deviceL3GD20HState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
+	status1 = writeSensorRegisterL3GD20H(kWarpSensorConfigurationRegisterL3GD20HCTRL5 /* register address CTRL5 */,
+							kWarpL3GD20HCTRL5FifoEnable /* payload */,
+							menuI2cPullupValue);
 
+	status2 = writeSensorRegisterL3GD20H(kWarpSensorConfigurationRegisterL3GD20HFIFO_CTRL /* register address FIFO_CTRL */,
+							kWarpL3GD20HFIFO_CTRLModeStream | (watermark & kWarpL3GD20HFIFO_CTRLWatermarkMask) /* payload */,
+							menuI2cPullupValue);
 
-	cmdBuf[0] = deviceRegister;
+	status3 = writeSensorRegisterL3GD20H(kWarpSensorConfigurationRegisterL3GD20HCTRL1 /* register address CTRL1 */,
+							payloadCTRL1 /* payload */,
+							menuI2cPullupValue);
 
+	return (status1 | status2 | status3);
+}
 
-	/*
-	 *	Steps (Repeated single-byte read. See STable 15 and Table 16 of L3GD20H manual.):
-	 *
-	 *	(1) Write transaction beginning with start condition, slave address, and sub address.
-	 *
-	 *	(2) Read transaction beginning with start condition, followed by slave address, and read 1 byte payload
-	 */
+WarpStatus
+readSensorRegisterL3GD20H(uint8_t deviceRegister, int numberOfBytes)
+{
+	return warpRegisterMapRead(&registersL3GD20H, deviceRegister, numberOfBytes);
+}
 
-	status1 = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							NULL,
-							0,
-							gWarpI2cTimeoutMilliseconds);
-		
-	status2 = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceL3GD20HState.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if ((status1 != kStatus_I2C_Success) || (status2 != kStatus_I2C_Success))
+/*
+ *	Pop numberOfSamples FIFO samples in one auto-increment burst, straight
+ *	into the caller's storage. With the FIFO enabled, the read address
+ *	wraps from OUT_Z_H back to OUT_X_L, and each wrap pops a sample.
+ */
+static WarpStatus
+readSensorFifoL3GD20H(uint8_t *  buffer, uint16_t numberOfSamples)
+{
+	if (numberOfSamples > kWarpL3GD20HFifoDepth)
 	{
-		return kWarpStatusDeviceCommunicationFailed;
+		return kWarpStatusBadDeviceCommand;
 	}
 
-	return kWarpStatusOK;
+	return warpRegisterMapReadBlock(&registersL3GD20H, kWarpSensorOutputRegisterL3GD20HOUT_X_L, buffer, numberOfSamples * kWarpL3GD20HBytesPerSample);
 }
 
-
-void
-printSensorDataL3GD20H(bool hexModeFlag)
+/*
+ *	Read up to maximumSamples X/Y/Z samples out of the FIFO into xyz
+ *	(3 int16_t per sample): one FIFO_SRC read, then one burst. The
+ *	little-endian register pairs are decoded in place. A full FIFO (OVRN)
+ *	holds 32 samples and has overwritten at least one, which is counted
+ *	in *overruns.
+ */
+WarpStatus
+drainSensorFifoL3GD20H(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
-	int8_t		readSensorRegisterSignedByte;
-	WarpStatus	i2cReadStatusLow, i2cReadStatusHigh;
+	WarpStatus	i2cReadStatus;
+	uint8_t		available;
+	uint8_t *	raw = (uint8_t *)xyz;
 
 
-	i2cReadStatusLow = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_X_L, 1 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceL3GD20HState.i2cBuffer[0];
-	i2cReadStatusHigh = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_X_H, 1 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceL3GD20HState.i2cBuffer[0];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
+	*samplesRead = 0;
 
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
+	i2cReadStatus = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HFIFO_SRC, 1 /* numberOfBytes */);
+	if (i2cReadStatus != kWarpStatusOK)
+	{
+		return i2cReadStatus;
+	}
 
-	if ((i2cReadStatusLow != kWarpStatusOK) || (i2cReadStatusHigh != kWarpStatusOK))
+	available = deviceL3GD20HState.i2cBuffer[0] & kWarpL3GD20HFIFO_SRCCountMask;
+	if (deviceL3GD20HState.i2cBuffer[0] & kWarpL3GD20HFIFO_SRCOverrun)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		available = kWarpL3GD20HFifoDepth;
+		(*overruns)++;
 	}
-	else
+	if (available > maximumSamples)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		available = maximumSamples;
 	}
 
-	i2cReadStatusLow = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_Y_L, 1 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceL3GD20HState.i2cBuffer[0];
-	i2cReadStatusHigh = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_Y_H, 1 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceL3GD20HState.i2cBuffer[0];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
-	if ((i2cReadStatusLow != kWarpStatusOK) || (i2cReadStatusHigh != kWarpStatusOK))
+	if (available == 0)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		return kWarpStatusOK;
 	}
-	else
+
+	i2cReadStatus = readSensorFifoL3GD20H(raw, available);
+	if (i2cReadStatus != kWarpStatusOK)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		return i2cReadStatus;
 	}
 
-	i2cReadStatusLow = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_Z_L, 1 /* numberOfBytes */);
-	readSensorRegisterValueLSB = deviceL3GD20HState.i2cBuffer[0];
-	i2cReadStatusHigh = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_Z_H, 1 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceL3GD20HState.i2cBuffer[0];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
+	warpRegisterMapDecode(&registersL3GD20H, raw, xyz, 3*available);
+	*samplesRead = available;
+
+	return kWarpStatusOK;
+}
+
+
+void
+printSensorDataL3GD20H(bool hexModeFlag)
+{
+	int8_t		readSensorRegisterSignedByte;
+	WarpStatus	i2cReadStatus;
+
 
 	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
+	 *	OUT_X_L through OUT_Z_H in one auto-increment burst.
 	 */
+	i2cReadStatus = warpRegisterMapReadSample(&registersL3GD20H, NULL);
+	warpRegisterMapPrintSample(&registersL3GD20H, i2cReadStatus, hexModeFlag);
 
-	if ((i2cReadStatusLow != kWarpStatusOK) || (i2cReadStatusHigh != kWarpStatusOK))
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
-
-	i2cReadStatusLow = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_TEMP, 1 /* numberOfBytes */);
+	i2cReadStatus = readSensorRegisterL3GD20H(kWarpSensorOutputRegisterL3GD20HOUT_TEMP, 1 /* numberOfBytes */);
 	readSensorRegisterSignedByte = deviceL3GD20HState.i2cBuffer[0];
 
 	/*
 	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int8_t
 	 */
 
-	if (i2cReadStatusLow != kWarpStatusOK)
+	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x,", deviceL3GD20HState.i2cBuffer[0]);
+			WARP_LOG(kWarpLogCsvHexByte, deviceL3GD20HState.i2cBuffer[0]);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterSignedByte);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterSignedByte);
 		}
 	}
 }
\ No newline at end of file
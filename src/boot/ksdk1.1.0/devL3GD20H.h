@@ -48,4 +48,6 @@ WarpStatus	readSensorSignalL3GD20H(WarpTypeMask signal,
 					WarpSignalNoise noise);
 WarpStatus	writeSensorRegisterL3GD20H(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue);
 WarpStatus	configureSensorL3GD20H(uint8_t payloadCTRL1, uint8_t payloadCTRL2, uint8_t payloadCTRL5, uint16_t menuI2cPullupValue);
+WarpStatus	configureSensorL3GD20HFifo(uint8_t payloadCTRL1, uint8_t watermark, uint16_t menuI2cPullupValue);
+WarpStatus	drainSensorFifoL3GD20H(int16_t *  xyz, uint8_t maximumSamples, uint8_t *  samplesRead, uint16_t *  overruns);
 void		printSensorDataL3GD20H(bool hexModeFlag);
\ No newline at end of file
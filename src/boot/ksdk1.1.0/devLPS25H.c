@@ -84,7 +84,7 @@ readSensorRegisterLPS25H(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{
 		.address = deviceLPS25HState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceLPS25HState.i2cAddress)
 	};
 
 
@@ -100,7 +100,7 @@ readSensorRegisterLPS25H(uint8_t deviceRegister, int numberOfBytes)
 	 */
 
 
-	status1 = I2C_DRV_MasterSendDataBlocking(
+	status1 = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							cmdBuf,
@@ -109,7 +109,7 @@ readSensorRegisterLPS25H(uint8_t deviceRegister, int numberOfBytes)
 							0,
 							gWarpI2cTimeoutMilliseconds);
 
-	status2 = I2C_DRV_MasterReceiveDataBlocking(
+	status2 = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							cmdBuf,
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceMAG3110State;
@@ -56,6 +58,29 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Writable: OFF_X_MSB through OFF_Z_LSB, CTRL_REG1 and CTRL_REG2.
+ */
+static const uint8_t		writableRegistersMAG3110[] = {0x00, 0x7E, 0x03};
+
+/*
+ *	OUT_X_MSB through OUT_Z_LSB: 16-bit, MSB first. The address
+ *	auto-increments unless CTRL_REG1 FR (fast read) is set.
+ */
+static const WarpRegisterMap	registersMAG3110 =
+{
+	.deviceState		= &deviceMAG3110State,
+	.readableRegisters	= NULL,
+	.writableRegisters	= writableRegistersMAG3110,
+	.lastReadableRegister	= 0x11,
+	.lastWritableRegister	= 0x11,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterMAG3110OUT_X_MSB,
+	.sampleAxes		= 3,
+	.sampleBits		= {16, 16, 16},
+};
+
 
 
 void
@@ -75,46 +100,7 @@ initMAG3110(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceState
 WarpStatus
 writeSensorRegisterMAG3110(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	returnValue;
-
-	switch (deviceRegister)
-	{
-		case 0x09: case 0x0A: case 0x0B: case 0x0C:
-		case 0x0D: case 0x0E: case 0x10: case 0x11:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceMAG3110State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	returnValue = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (returnValue != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersMAG3110, deviceRegister, payload);
 }
 
 WarpStatus
@@ -137,143 +123,28 @@ configureSensorMAG3110(uint8_t payloadCTRL_REG1, uint8_t payloadCTRL_REG2, uint1
 	return (i2cWriteStatus1 | i2cWriteStatus2 | i2cWriteStatus3);
 }
 
+/*
+ *	Register address, repeated start, then the data (Section 4.2.2 of the
+ *	MAG3110 manual).
+ */
 WarpStatus
 readSensorRegisterMAG3110(uint8_t deviceRegister, int numberOfBytes)
 {
-	uint8_t		cmdBuf[1]	= {0xFF};
-	i2c_status_t	status1, status2;
-
-
-	USED(numberOfBytes);
-	i2c_device_t slave =
-	{
-		.address = deviceMAG3110State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-
-	/*
-	 *	Steps (Repeated single-byte read. See Section 4.2.2 of MAG3110 manual.):
-	 *
-	 *	(1) Write transaction beginning with start condition, slave address, and pointer address.
-	 *
-	 *	(2) Read transaction beginning with start condition, followed by slave address, and read 1 byte payload
-	*/
-
-	cmdBuf[0] = deviceRegister;
-
-	status1 = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							NULL,
-							0,
-							gWarpI2cTimeoutMilliseconds);
-
-	status2 = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceMAG3110State.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
-
-	if ((status1 != kStatus_I2C_Success) || (status2 != kStatus_I2C_Success))
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapRead(&registersMAG3110, deviceRegister, numberOfBytes);
 }
 
 void
 printSensorDataMAG3110(bool hexModeFlag)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
 	int8_t		readSensorRegisterSignedByte;
 	WarpStatus	i2cReadStatus;
 
 
-	i2cReadStatus = readSensorRegisterMAG3110(kWarpSensorOutputRegisterMAG3110OUT_X_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMAG3110State.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMAG3110State.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
-
-
-	i2cReadStatus = readSensorRegisterMAG3110(kWarpSensorOutputRegisterMAG3110OUT_Y_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMAG3110State.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMAG3110State.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
 	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
+	 *	OUT_X_MSB through OUT_Z_LSB in one burst.
 	 */
-
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
-
-
-	i2cReadStatus = readSensorRegisterMAG3110(kWarpSensorOutputRegisterMAG3110OUT_Z_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMAG3110State.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMAG3110State.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 8) | (readSensorRegisterValueLSB & 0xFF);
-
-	/*
-	 *	NOTE: Here, we don't need to manually sign extend since we are packing directly into an int16_t
-	 */
-
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
-	}
+	i2cReadStatus = warpRegisterMapReadSample(&registersMAG3110, NULL);
+	warpRegisterMapPrintSample(&registersMAG3110, i2cReadStatus, hexModeFlag);
 
 
 	i2cReadStatus = readSensorRegisterMAG3110(kWarpSensorOutputRegisterMAG3110DIE_TEMP, 1 /* numberOfBytes */);
@@ -285,17 +156,17 @@ printSensorDataMAG3110(bool hexModeFlag)
 
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		WARP_LOG(kWarpLogCsvFailed);
 	}
 	else
 	{
 		if (hexModeFlag)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x,", deviceMAG3110State.i2cBuffer[0]);
+			WARP_LOG(kWarpLogCsvHexByte, deviceMAG3110State.i2cBuffer[0]);
 		}
 		else
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterSignedByte);
+			WARP_LOG(kWarpLogCsvDecimal, readSensorRegisterSignedByte);
 		}
 	}
 }
\ No newline at end of file
@@ -85,7 +85,7 @@ int writeCommand(uint8_t Register_Byte, uint16_t Command_Bytes, bool W_R) /* W_R
     payloadBytes[1] = Byte2;
     payloadBytes[2] = Byte3;
     
-    status = SPI_DRV_MasterTransferBlocking(0    /* master instance */,
+    status = warpSPIMasterTransferBlocking(0    /* master instance */,
                       NULL        /* spi_master_user_config_t */,
                       (const uint8_t * restrict)&payloadBytes[0],
                       (uint8_t * restrict) &inBuffer[0],
@@ -49,6 +49,8 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
 
 
 extern volatile WarpI2CDeviceState	deviceMMA8451QState;
@@ -56,6 +58,30 @@ extern volatile uint32_t		gWarpI2cBaudRateKbps;
 extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
 extern volatile uint32_t		gWarpSupplySettlingDelayMilliseconds;
 
+/*
+ *	Readable: 0x00-0x06, 0x09-0x18, 0x1D-0x31. Writable: F_SETUP, TRIG_CFG
+ *	and the configuration, interrupt and offset registers from 0x0E up.
+ */
+static const uint8_t		readableRegistersMMA8451Q[] = {0x7F, 0xFE, 0xFF, 0xE1, 0xFF, 0xFF, 0x03};
+static const uint8_t		writableRegistersMMA8451Q[] = {0x00, 0xC6, 0xBE, 0xA1, 0xFB, 0xFF, 0x03};
+
+/*
+ *	OUT_X_MSB through OUT_Z_LSB: 14-bit, left-justified, MSB first.
+ */
+static const WarpRegisterMap	registersMMA8451Q =
+{
+	.deviceState		= &deviceMMA8451QState,
+	.readableRegisters	= readableRegistersMMA8451Q,
+	.writableRegisters	= writableRegistersMMA8451Q,
+	.lastReadableRegister	= 0x31,
+	.lastWritableRegister	= 0x31,
+	.registerBytes		= 1,
+	.flags			= kWarpRegisterMapBurst,
+	.sampleRegister		= kWarpSensorOutputRegisterMMA8451QOUT_X_MSB,
+	.sampleAxes		= 3,
+	.sampleBits		= {14, 14, 14},
+};
+
 
 
 void
@@ -73,52 +99,7 @@ initMMA8451Q(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStat
 WarpStatus
 writeSensorRegisterMMA8451Q(uint8_t deviceRegister, uint8_t payload, uint16_t menuI2cPullupValue)
 {
-	uint8_t		payloadByte[1], commandByte[1];
-	i2c_status_t	status;
-
-	switch (deviceRegister)
-	{
-		case 0x09: case 0x0a: case 0x0e: case 0x0f:
-		case 0x11: case 0x12: case 0x13: case 0x14:
-		case 0x15: case 0x17: case 0x18: case 0x1d:
-		case 0x1f: case 0x20: case 0x21: case 0x23:
-		case 0x24: case 0x25: case 0x26: case 0x27:
-		case 0x28: case 0x29: case 0x2a: case 0x2b:
-		case 0x2c: case 0x2d: case 0x2e: case 0x2f:
-		case 0x30: case 0x31:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
-
-	i2c_device_t slave =
-	{
-		.address = deviceMMA8451QState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
-
-	commandByte[0] = deviceRegister;
-	payloadByte[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(
-							0 /* I2C instance */,
-							&slave,
-							commandByte,
-							1,
-							payloadByte,
-							1,
-							gWarpI2cTimeoutMilliseconds);
-	if (status != kStatus_I2C_Success)
-	{
-		return kWarpStatusDeviceCommunicationFailed;
-	}
-
-	return kWarpStatusOK;
+	return warpRegisterMapWrite(&registersMMA8451Q, deviceRegister, payload);
 }
 
 WarpStatus
@@ -137,182 +118,134 @@ configureSensorMMA8451Q(uint8_t payloadF_SETUP, uint8_t payloadCTRL_REG1, uint16
 	return (i2cWriteStatus1 | i2cWriteStatus2);
 }
 
+/*
+ *	Streaming configuration: the part is put in standby (CTRL_REG4 and
+ *	CTRL_REG5 are only writable there), F_SETUP is written, every interrupt
+ *	source enabled in payloadCTRL_REG4 is routed to INT1 as an active-low
+ *	push-pull output, and CTRL_REG1 is written last to return to ACTIVE.
+ *
+ *	configureSensorMMA8451QInterrupts(0x00, 0x00, ...) undoes it.
+ */
 WarpStatus
-readSensorRegisterMMA8451Q(uint8_t deviceRegister, int numberOfBytes)
+configureSensorMMA8451QInterrupts(uint8_t payloadF_SETUP, uint8_t payloadCTRL_REG4, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue)
 {
-	uint8_t		cmdBuf[1] = {0xFF};
-	i2c_status_t	status;
+	WarpStatus	i2cWriteStatus;
 
+	i2cWriteStatus = writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QCTRL_REG1 /* register address CTRL_REG1 */,
+							payloadCTRL_REG1 & ~kWarpMMA8451QCTRL_REG1Active /* payload: standby */,
+							menuI2cPullupValue);
 
-	USED(numberOfBytes);
-	switch (deviceRegister)
-	{
-		case 0x00: case 0x01: case 0x02: case 0x03: 
-		case 0x04: case 0x05: case 0x06: case 0x09:
-		case 0x0a: case 0x0b: case 0x0c: case 0x0d:
-		case 0x0e: case 0x0f: case 0x10: case 0x11:
-		case 0x12: case 0x13: case 0x14: case 0x15:
-		case 0x16: case 0x17: case 0x18: case 0x1d:
-		case 0x1e: case 0x1f: case 0x20: case 0x21:
-		case 0x22: case 0x23: case 0x24: case 0x25:
-		case 0x26: case 0x27: case 0x28: case 0x29:
-		case 0x2a: case 0x2b: case 0x2c: case 0x2d:
-		case 0x2e: case 0x2f: case 0x30: case 0x31:
-		{
-			/* OK */
-			break;
-		}
-		
-		default:
-		{
-			return kWarpStatusBadDeviceCommand;
-		}
-	}
+	i2cWriteStatus |= writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QF_SETUP /* register address F_SETUP */,
+							payloadF_SETUP /* payload */,
+							menuI2cPullupValue);
 
+	i2cWriteStatus |= writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QCTRL_REG3 /* register address CTRL_REG3 */,
+							0x00 /* payload: push-pull, active low */,
+							menuI2cPullupValue);
 
-	i2c_device_t slave =
-	{
-		.address = deviceMMA8451QState.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
-	};
+	i2cWriteStatus |= writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QCTRL_REG4 /* register address CTRL_REG4 */,
+							payloadCTRL_REG4 /* payload: interrupt enables */,
+							menuI2cPullupValue);
 
+	i2cWriteStatus |= writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QCTRL_REG5 /* register address CTRL_REG5 */,
+							payloadCTRL_REG4 /* payload: route enabled sources to INT1 */,
+							menuI2cPullupValue);
 
-	cmdBuf[0] = deviceRegister;
+	i2cWriteStatus |= writeSensorRegisterMMA8451Q(kWarpSensorConfigurationRegisterMMA8451QCTRL_REG1 /* register address CTRL_REG1 */,
+							payloadCTRL_REG1 /* payload */,
+							menuI2cPullupValue);
 
-	status = I2C_DRV_MasterReceiveDataBlocking(
-							0 /* I2C peripheral instance */,
-							&slave,
-							cmdBuf,
-							1,
-							(uint8_t *)deviceMMA8451QState.i2cBuffer,
-							numberOfBytes,
-							gWarpI2cTimeoutMilliseconds);
+	return i2cWriteStatus;
+}
 
-	if (status != kStatus_I2C_Success)
+WarpStatus
+readSensorRegisterMMA8451Q(uint8_t deviceRegister, int numberOfBytes)
+{
+	return warpRegisterMapRead(&registersMMA8451Q, deviceRegister, numberOfBytes);
+}
+
+/*
+ *	Burst read of whole FIFO samples straight into the caller's storage,
+ *	bypassing the 6-byte i2cBuffer. With F_MODE > 0 and F_READ clear,
+ *	the address wraps from OUT_Z_LSB back to OUT_X_MSB, so one
+ *	transaction pops numberOfSamples samples.
+ */
+static WarpStatus
+readSensorFifoMMA8451Q(uint8_t *  buffer, uint16_t numberOfSamples)
+{
+	if (numberOfSamples > kWarpMMA8451QFifoDepth)
 	{
-		return kWarpStatusDeviceCommunicationFailed;
+		return kWarpStatusBadDeviceCommand;
 	}
 
-	return kWarpStatusOK;
+	return warpRegisterMapReadBlock(&registersMMA8451Q, kWarpSensorOutputRegisterMMA8451QOUT_X_MSB, buffer, numberOfSamples * kWarpMMA8451QBytesPerSample);
 }
 
-void
-printSensorDataMMA8451Q(bool hexModeFlag)
+/*
+ *	Move everything the FIFO holds (up to the free space in the ring)
+ *	into the ring: one F_STATUS read, then one burst per contiguous run
+ *	of ring slots, i.e., two bursts at most when the ring wraps. The
+ *	samples are decoded in place; each int16_t slot is only overwritten
+ *	after its own two raw bytes have been consumed. Whatever does not
+ *	fit stays in the sensor FIFO for the next drain.
+ */
+WarpStatus
+drainSensorFifoMMA8451Q(WarpAccelerationRing *  ring, uint8_t *  samplesRead)
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
 	WarpStatus	i2cReadStatus;
+	uint16_t	available, space, index, run;
+	uint8_t *	raw;
 
 
-	/*
-	 *	From the MMA8451Q datasheet:
-	 *
-	 *		"A random read access to the LSB registers is not possible.
-	 *		Reading the MSB register and then the LSB register in sequence
-	 *		ensures that both bytes (LSB and MSB) belong to the same data
-	 *		sample, even if a new data sample arrives between reading the
-	 *		MSB and the LSB byte."
-	 *
-	 *	We therefore do 2-byte read transactions, for each of the registers.
-	 *	We could also improve things by doing a 6-byte read transaction.
-	 */
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_X_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
-
-	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
-
+	*samplesRead = 0;
 
+	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QF_STATUS, 1 /* numberOfBytes */);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		return i2cReadStatus;
 	}
-	else
+
+	if (deviceMMA8451QState.i2cBuffer[0] & kWarpMMA8451QF_STATUSOverflow)
 	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		ring->overruns++;
 	}
 
-
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_Y_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
-
-	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
-
-
-	if (i2cReadStatus != kWarpStatusOK)
+	available = deviceMMA8451QState.i2cBuffer[0] & kWarpMMA8451QF_STATUSCountMask;
+	space = ring->capacity - (uint16_t)(ring->head - ring->tail);
+	if (available > space)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
+		available = space;
 	}
-	else
+
+	while (available > 0)
 	{
-		if (hexModeFlag)
+		index = ring->head & (ring->capacity - 1);
+		run = ring->capacity - index;
+		if (run > available)
 		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
+			run = available;
 		}
-		else
+
+		raw = (uint8_t *)&ring->samples[3*index];
+		i2cReadStatus = readSensorFifoMMA8451Q(raw, run);
+		if (i2cReadStatus != kWarpStatusOK)
 		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
+			return i2cReadStatus;
 		}
-	}
-
-
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_Z_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
-
-	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
 
+		warpRegisterMapDecode(&registersMMA8451Q, raw, &ring->samples[3*index], 3*run);
 
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-		if (hexModeFlag)
-		{
-			SEGGER_RTT_printf(0, " 0x%02x 0x%02x,", readSensorRegisterValueMSB, readSensorRegisterValueLSB);
-		}
-		else
-		{
-			SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		}
+		ring->head += run;
+		available -= run;
+		*samplesRead += run;
 	}
+
+	return kWarpStatusOK;
 }
 
-uint16_t
-getSensorDataMMA8451Q(bool hexModeFlag, int xyz)
+WarpStatus
+readSensorXYZMMA8451Q(int16_t out[3])
 {
-	uint16_t	readSensorRegisterValueLSB;
-	uint16_t	readSensorRegisterValueMSB;
-	int16_t		readSensorRegisterValueCombined;
-	int16_t		xreading;
-	int16_t		yreading;
-	int16_t		zreading;
-	WarpStatus	i2cReadStatus;
-
-
 	/*
 	 *	From the MMA8451Q datasheet:
 	 *
@@ -322,98 +255,51 @@ getSensorDataMMA8451Q(bool hexModeFlag, int xyz)
 	 *		sample, even if a new data sample arrives between reading the
 	 *		MSB and the LSB byte."
 	 *
-	 *	We therefore do 2-byte read transactions, for each of the registers.
-	 *	We could also improve things by doing a 6-byte read transaction.
-	 */
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_X_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
-
-	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
+	 *	With F_READ clear, the register address auto-increments from
+	 *	OUT_X_MSB through OUT_Z_LSB, so a single 6-byte read transaction
+	 *	returns all three axes of the same sample.
 	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
-	
-	
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-	//	SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		xreading = readSensorRegisterValueCombined;
-	}
-
-
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_Y_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
+	return warpRegisterMapReadSample(&registersMMA8451Q, out);
+}
 
-	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
-	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
+void
+printSensorDataMMA8451Q(bool hexModeFlag)
+{
+	WarpStatus	i2cReadStatus;
 
 
-	if (i2cReadStatus != kWarpStatusOK)
-	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-	//	SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		yreading = readSensorRegisterValueCombined;
+	i2cReadStatus = readSensorXYZMMA8451Q(NULL);
+	warpRegisterMapPrintSample(&registersMMA8451Q, i2cReadStatus, hexModeFlag);
+}
 
-	}
+uint16_t
+getSensorDataMMA8451Q(bool hexModeFlag, int xyz)
+{
+	int16_t		readings[3];
+	WarpStatus	i2cReadStatus;
 
 
-	i2cReadStatus = readSensorRegisterMMA8451Q(kWarpSensorOutputRegisterMMA8451QOUT_Z_MSB, 2 /* numberOfBytes */);
-	readSensorRegisterValueMSB = deviceMMA8451QState.i2cBuffer[0];
-	readSensorRegisterValueLSB = deviceMMA8451QState.i2cBuffer[1];
-	readSensorRegisterValueCombined = ((readSensorRegisterValueMSB & 0xFF) << 6) | (readSensorRegisterValueLSB >> 2);
+	USED(hexModeFlag);
 
 	/*
-	 *	Sign extend the 14-bit value based on knowledge that upper 2 bit are 0:
+	 *	Kept for callers that want a single axis; prefer
+	 *	readSensorXYZMMA8451Q(), since each call here costs a full
+	 *	6-byte transaction.
 	 */
-	readSensorRegisterValueCombined = (readSensorRegisterValueCombined ^ (1 << 13)) - (1 << 13);
-
-
+	i2cReadStatus = readSensorXYZMMA8451Q(readings);
 	if (i2cReadStatus != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, " ----,");
-	}
-	else
-	{
-	//	SEGGER_RTT_printf(0, " %d,", readSensorRegisterValueCombined);
-		zreading = readSensorRegisterValueCombined;
-	}
-	int16_t		reading = 404;
-	if (xyz == 0)
-	{
-		reading = xreading;
-	//	SEGGER_RTT_WriteString(0, " xyz = 0");
-	}
-	else if (xyz == 1)
-	{
-	reading = yreading;
-	//SEGGER_RTT_WriteString(0, " xyz = 1,");	
-	}	
-		
-	else if (xyz == 2)
-	{
-	reading = zreading;
-	//SEGGER_RTT_WriteString(0, " xyz = 2,");
+		WARP_LOG(kWarpLogCsvFailed);
+
+		return 0;
 	}
-	else
+
+	if (xyz < 0 || xyz > 2)
 	{
-	reading = 404;
-	SEGGER_RTT_WriteString(0, "getting error");
+		SEGGER_RTT_WriteString(0, "getting error");
+
+		return 404;
 	}
-		
-	return reading;
-		
-}
 
+	return readings[xyz];
+}
@@ -41,10 +41,16 @@
 
 void		initMMA8451Q(const uint8_t i2cAddress, WarpI2CDeviceState volatile *  deviceStatePointer);
 WarpStatus	readSensorRegisterMMA8451Q(uint8_t deviceRegister, int numberOfBytes);
+WarpStatus	readSensorXYZMMA8451Q(int16_t out[3]);
 WarpStatus	writeSensorRegisterMMA8451Q(uint8_t deviceRegister,
 					uint8_t payloadBtye,
 					uint16_t menuI2cPullupValue);
 WarpStatus	configureSensorMMA8451Q(uint8_t payloadF_SETUP, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue);
+WarpStatus	configureSensorMMA8451QInterrupts(uint8_t payloadF_SETUP,
+					uint8_t payloadCTRL_REG4,
+					uint8_t payloadCTRL_REG1,
+					uint16_t menuI2cPullupValue);
+WarpStatus	drainSensorFifoMMA8451Q(WarpAccelerationRing *  ring, uint8_t *  samplesRead);
 WarpStatus	readSensorSignalMMA8451Q(WarpTypeMask signal,
 					WarpSignalPrecision precision,
 					WarpSignalAccuracy accuracy,
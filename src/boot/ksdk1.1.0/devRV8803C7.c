@@ -121,11 +121,11 @@ WarpStatus readRTCRegisterRV8803C7(uint8_t deviceRegister, uint8_t *receiveData)
 	
 	i2c_device_t slave = {
 		.address = deviceRV8803C7State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceRV8803C7State.i2cAddress)
 	};
 	
 	cmdBuff[0] = deviceRegister;
-	status = I2C_DRV_MasterReceiveDataBlocking(0 /* I2C instance */,
+	status = warpI2CMasterReceiveDataBlocking(0 /* I2C instance */,
 	                                           &slave,
 	                                           cmdBuff,
 	                                           1,
@@ -154,11 +154,11 @@ WarpStatus readRTCRegistersRV8803C7(uint8_t deviceStartRegister, uint8_t nRegs,
 	
 	i2c_device_t slave = {
 		.address = deviceRV8803C7State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceRV8803C7State.i2cAddress)
 	};
 	
 	cmdBuff[0] = deviceStartRegister;
-	status = I2C_DRV_MasterReceiveDataBlocking(0 /* I2C instance */,
+	status = warpI2CMasterReceiveDataBlocking(0 /* I2C instance */,
 	                                           &slave,
 	                                           cmdBuff,
 	                                           1,
@@ -186,12 +186,12 @@ WarpStatus writeRTCRegisterRV8803C7(uint8_t deviceRegister, uint8_t payload) {
 	
 	i2c_device_t slave = {
 		.address = deviceRV8803C7State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceRV8803C7State.i2cAddress)
 	};
 	
 	cmdBuff[0] = deviceRegister;
 	txBuff[0] = payload;
-	status = I2C_DRV_MasterSendDataBlocking(0 /* I2C instance */,
+	status = warpI2CMasterSendDataBlocking(0 /* I2C instance */,
 	                                        &slave,
 	                                        cmdBuff,
 	                                        1,
@@ -220,11 +220,11 @@ WarpStatus writeRTCRegistersRV8803C7(uint8_t deviceStartRegister, uint8_t nRegs,
 	
 	i2c_device_t slave = {
 		.address = deviceRV8803C7State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceRV8803C7State.i2cAddress)
 	};
 	
 	cmdBuff[0] = deviceStartRegister;
-	status = I2C_DRV_MasterSendDataBlocking(0 /* I2C instance */,
+	status = warpI2CMasterSendDataBlocking(0 /* I2C instance */,
 	                                        &slave,
 	                                        cmdBuff,
 	                                        1,
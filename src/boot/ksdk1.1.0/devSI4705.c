@@ -78,7 +78,7 @@ readSensorRegisterSI4705(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{
 		.address = deviceSI4705State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceSI4705State.i2cAddress)
 	};
 
 
@@ -97,7 +97,7 @@ readSensorRegisterSI4705(uint8_t deviceRegister, int numberOfBytes)
 	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
 
 
-	status = I2C_DRV_MasterReceiveDataBlocking(
+	status = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							cmdBuf,
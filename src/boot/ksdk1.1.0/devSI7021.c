@@ -87,7 +87,7 @@ readSensorRegisterSI7021(uint8_t deviceRegister, int numberOfBytes)
 	i2c_device_t slave =
 	{
 		.address = deviceSI7021State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceSI7021State.i2cAddress)
 	};
 
 	/*
@@ -96,7 +96,7 @@ readSensorRegisterSI7021(uint8_t deviceRegister, int numberOfBytes)
 	cmdBuf[0] = 0xFA;
 	cmdBuf[1] = 0x0F;
 
-	status1 = I2C_DRV_MasterSendDataBlocking(
+	status1 = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							NULL,
@@ -111,7 +111,7 @@ readSensorRegisterSI7021(uint8_t deviceRegister, int numberOfBytes)
 	 *	See similar thing in HDC1000 driver where we also send a NULL cmdBuf in
 	 *	I2C_DRV_MasterReceiveDataBlocking.
 	 */
-	status2 = I2C_DRV_MasterReceiveDataBlocking(
+	status2 = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							NULL,
@@ -120,7 +120,7 @@ readSensorRegisterSI7021(uint8_t deviceRegister, int numberOfBytes)
 							numberOfBytes,
 							gWarpI2cTimeoutMilliseconds);
 
-	status3 = I2C_DRV_MasterReceiveDataBlocking(
+	status3 = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							NULL,
@@ -132,7 +132,7 @@ readSensorRegisterSI7021(uint8_t deviceRegister, int numberOfBytes)
 	/*
 	 *	Now, this two-byte read should succed according to page 20 of SI7021 manual:
 	 */
-	status4 = I2C_DRV_MasterReceiveDataBlocking(
+	status4 = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							NULL,
@@ -11,6 +11,9 @@
 volatile uint8_t	inBuffer[32];
 volatile uint8_t	payloadBytes[32];
 
+static uint8_t		commandBufferLength;
+static bool		commandBufferOpen;
+
 
 /*
  *	Override Warp firmware's use of these pins and define new aliases.
@@ -24,18 +27,61 @@ enum
 	kSSD1331PinRST		= GPIO_MAKE_PIN(HW_GPIOB, 0),
 };
 
+/*
+ *	The pedometer redraws the display while the MMA8451Q INT1 sampler
+ *	runs, so the interrupt input must not be one of the lines above.
+ *	This fails to compile (negative array size) if it ever is.
+ */
+typedef char	SSD1331PinsExcludeMMA8451QInt1[((uint32_t)kSSD1331PinMOSI != (uint32_t)kWarpPinMMA8451Q_INT1 &&
+						(uint32_t)kSSD1331PinSCK != (uint32_t)kWarpPinMMA8451Q_INT1 &&
+						(uint32_t)kSSD1331PinCSn != (uint32_t)kWarpPinMMA8451Q_INT1 &&
+						(uint32_t)kSSD1331PinDC != (uint32_t)kWarpPinMMA8451Q_INT1 &&
+						(uint32_t)kSSD1331PinRST != (uint32_t)kWarpPinMMA8451Q_INT1) ? 1 : -1];
+
+/*
+ *	Command streaming: devSSD1331commandBegin() asserts /CS once, bytes are
+ *	collected in payloadBytes[] and sent as one SPI transfer per full
+ *	buffer, and devSSD1331commandFlush() sends the rest and releases /CS.
+ *	A whole primitive or glyph thus costs one /CS cycle and a few
+ *	transfers instead of one of each per byte.
+ */
 static int
-writeCommand(uint8_t commandByte)
+transferCommandBuffer(void)
 {
 	spi_status_t status;
 
+	if (commandBufferLength == 0)
+	{
+		return kStatus_SPI_Success;
+	}
+
+	status = warpSPIMasterTransferBlocking(0	/* master instance */,
+					NULL		/* spi_master_user_config_t */,
+					(const uint8_t * restrict)&payloadBytes[0],
+					(uint8_t * restrict)&inBuffer[0],
+					commandBufferLength	/* transfer size */,
+					1000		/* timeout in microseconds (unlike I2C which is ms) */);
+	commandBufferLength = 0;
+
+	return status;
+}
+
+int
+devSSD1331commandBegin(void)
+{
+	if (commandBufferOpen)
+	{
+		return transferCommandBuffer();
+	}
+
 	/*
 	 *	Drive /CS low.
 	 *
-	 *	Make sure there is a high-to-low transition by first driving high, delay, then drive low.
+	 *	Make sure there is a high-to-low transition by first driving high, then drive low.
+	 *	The panel needs only tens of nanoseconds of /CS high time, which the two GPIO
+	 *	writes already take, so there is no delay between them.
 	 */
 	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
-	OSA_TimeDelay(10);
 	GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
 
 	/*
@@ -43,13 +89,33 @@ writeCommand(uint8_t commandByte)
 	 */
 	GPIO_DRV_ClearPinOutput(kSSD1331PinDC);
 
-	payloadBytes[0] = commandByte;
-	status = SPI_DRV_MasterTransferBlocking(0	/* master instance */,
-					NULL		/* spi_master_user_config_t */,
-					(const uint8_t * restrict)&payloadBytes[0],
-					(uint8_t * restrict)&inBuffer[0],
-					1		/* transfer size */,
-					1000		/* timeout in microseconds (unlike I2C which is ms) */);
+	commandBufferLength = 0;
+	commandBufferOpen = true;
+
+	return kStatus_SPI_Success;
+}
+
+int
+devSSD1331commandAppend(uint8_t commandByte)
+{
+	int	status = kStatus_SPI_Success;
+
+	if (commandBufferLength == sizeof(payloadBytes))
+	{
+		status = transferCommandBuffer();
+	}
+	payloadBytes[commandBufferLength++] = commandByte;
+
+	return status;
+}
+
+int
+devSSD1331commandFlush(void)
+{
+	int	status;
+
+	status = transferCommandBuffer();
+	commandBufferOpen = false;
 
 	/*
 	 *	Drive /CS high
@@ -59,6 +125,23 @@ writeCommand(uint8_t commandByte)
 	return status;
 }
 
+static int
+writeCommand(uint8_t commandByte)
+{
+	int	status;
+
+	if (commandBufferOpen)
+	{
+		return devSSD1331commandAppend(commandByte);
+	}
+
+	devSSD1331commandBegin();
+	devSSD1331commandAppend(commandByte);
+	status = devSSD1331commandFlush();
+
+	return status;
+}
+
 
 
 int
@@ -97,6 +180,7 @@ devSSD1331init(void)
 	/*
 	 *	Initialization sequence, borrowed from https://github.com/adafruit/Adafruit-SSD1331-OLED-Driver-Library-for-Arduino
 	 */
+	devSSD1331commandBegin();
 	writeCommand(kSSD1331CommandDISPLAYOFF);	// 0xAE
 	writeCommand(kSSD1331CommandSETREMAP);		// 0xA0
 	writeCommand(0x72);				// RGB Color
@@ -151,6 +235,7 @@ devSSD1331init(void)
 	writeCommand(0x00);
 	writeCommand(0x5F);
 	writeCommand(0x3F);
+	devSSD1331commandFlush();
 //	SEGGER_RTT_WriteString(0, "\r\n\tDone with screen clear...\n");
 
 
@@ -293,1479 +378,328 @@ devSSD1331init(void)
 }
 
 
+/*
+ *	Seven-segment glyphs in 8x16 character cells. Each glyph is a bitmask
+ *	over the rectangles in segmentRectangles[], so rendering is one loop
+ *	and every glyph lives in a couple of bytes of flash. The last three
+ *	segments extend into the next cell, for 'm'; such glyphs take two
+ *	cells.
+ *
+ *		 aaa
+ *		f   b
+ *		 ggg
+ *		e   c
+ *		 ddd
+ */
+typedef struct
+{
+	uint8_t		startColumn;
+	uint8_t		startRow;
+	uint8_t		endColumn;
+	uint8_t		endRow;
+} SSD1331Rectangle;
+
+enum
+{
+	kSSD1331SegmentA	= 1 << 0,
+	kSSD1331SegmentB	= 1 << 1,
+	kSSD1331SegmentC	= 1 << 2,
+	kSSD1331SegmentD	= 1 << 3,
+	kSSD1331SegmentE	= 1 << 4,
+	kSSD1331SegmentF	= 1 << 5,
+	kSSD1331SegmentG	= 1 << 6,
+	kSSD1331SegmentWideA	= 1 << 7,
+	kSSD1331SegmentWideB	= 1 << 8,
+	kSSD1331SegmentWideC	= 1 << 9,
+	kSSD1331SegmentsWide	= kSSD1331SegmentWideA | kSSD1331SegmentWideB | kSSD1331SegmentWideC,
+};
+
+static const SSD1331Rectangle	segmentRectangles[] =
+{
+	{1,	0,	5,	1},	/*	a: top			*/
+	{5,	2,	6,	5},	/*	b: right top		*/
+	{5,	8,	6,	11},	/*	c: right bottom		*/
+	{1,	12,	5,	13},	/*	d: bottom		*/
+	{0,	8,	1,	11},	/*	e: left bottom		*/
+	{0,	2,	1,	5},	/*	f: left top		*/
+	{1,	6,	5,	7},	/*	g: middle		*/
+	{6,	0,	10,	1},	/*	a, one segment right	*/
+	{10,	2,	11,	5},	/*	b, one segment right	*/
+	{10,	8,	11,	11},	/*	c, one segment right	*/
+};
+
+/*
+ *	Indexed by symbol number: 0-9 are the digits, 10-35 the letters 'a'-'z'
+ *	and kSSD1331SymbolMinus is '-'. Letters the UI does not use are blank.
+ */
+static const uint16_t		glyphSegments[] =
+{
+	[0]	= kSSD1331SegmentA | kSSD1331SegmentB | kSSD1331SegmentC | kSSD1331SegmentD | kSSD1331SegmentE | kSSD1331SegmentF,
+	[1]	= kSSD1331SegmentB | kSSD1331SegmentC,
+	[2]	= kSSD1331SegmentA | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentE | kSSD1331SegmentD,
+	[3]	= kSSD1331SegmentA | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentC | kSSD1331SegmentD,
+	[4]	= kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentC,
+	[5]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentG | kSSD1331SegmentC | kSSD1331SegmentD,
+	[6]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentG | kSSD1331SegmentE | kSSD1331SegmentC | kSSD1331SegmentD,
+	[7]	= kSSD1331SegmentA | kSSD1331SegmentB | kSSD1331SegmentC,
+	[8]	= kSSD1331SegmentA | kSSD1331SegmentB | kSSD1331SegmentC | kSSD1331SegmentD | kSSD1331SegmentE | kSSD1331SegmentF | kSSD1331SegmentG,
+	[9]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentC | kSSD1331SegmentD,
+
+	['a' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentE | kSSD1331SegmentC,
+	['e' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentG | kSSD1331SegmentE | kSSD1331SegmentD,
+	['g' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentE | kSSD1331SegmentC | kSSD1331SegmentD,
+	['i' - 'a' + 10]	= kSSD1331SegmentF | kSSD1331SegmentE,
+	['m' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentE | kSSD1331SegmentC
+				| kSSD1331SegmentWideA | kSSD1331SegmentWideB | kSSD1331SegmentWideC,
+	['p' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentG | kSSD1331SegmentE,
+	['s' - 'a' + 10]	= kSSD1331SegmentA | kSSD1331SegmentF | kSSD1331SegmentG | kSSD1331SegmentC | kSSD1331SegmentD,
+	['t' - 'a' + 10]	= kSSD1331SegmentF | kSSD1331SegmentG | kSSD1331SegmentE | kSSD1331SegmentD,
+	['v' - 'a' + 10]	= kSSD1331SegmentF | kSSD1331SegmentB | kSSD1331SegmentE | kSSD1331SegmentC | kSSD1331SegmentD,
+
+	[kSSD1331SymbolMinus]	= kSSD1331SegmentG,
+};
+
+static int
+symbolForCharacter(char character)
+{
+	if (character >= '0' && character <= '9')
+	{
+		return character - '0';
+	}
+
+	if (character >= 'a' && character <= 'z')
+	{
+		return character - 'a' + 10;
+	}
+
+	if (character >= 'A' && character <= 'Z')
+	{
+		return character - 'A' + 10;
+	}
+
+	if (character == '-')
+	{
+		return kSSD1331SymbolMinus;
+	}
+
+	return -1;
+}
+
+/*
+ *	Queue the commands for one glyph (or a cell clear) into the open
+ *	command batch. The caller brackets it with begin/flush.
+ */
+static void
+appendSymbol(int symbolno, int xco, int yco)
+{
+	int		shiftx = xco * kSSD1331GlyphWidth;
+	int		shifty = yco * kSSD1331GlyphHeight;
+	uint16_t	segments;
+	int		segment;
+
+	if (symbolno == kSSD1331SymbolClear)
+	{
+		writeCommand(kSSD1331CommandCLEAR);
+		writeCommand(0+shiftx);
+		writeCommand(0+shifty);
+		writeCommand(kSSD1331GlyphWidth+shiftx);
+		writeCommand(kSSD1331GlyphHeight+shifty);
+	}
+	else if (symbolno >= 0 && symbolno < (int)(sizeof(glyphSegments)/sizeof(glyphSegments[0])))
+	{
+		segments = glyphSegments[symbolno];
+		for (segment = 0; segments != 0; segment++, segments >>= 1)
+		{
+			if (segments & 1)
+			{
+				writeCommand(kSSD1331CommandDRAWRECT);
+				writeCommand(segmentRectangles[segment].startColumn + shiftx);
+				writeCommand(segmentRectangles[segment].startRow + shifty);
+				writeCommand(segmentRectangles[segment].endColumn + shiftx);
+				writeCommand(segmentRectangles[segment].endRow + shifty);
+
+				/*
+				 *	Outline and fill colour: green
+				 */
+				writeCommand(0x00);
+				writeCommand(0xFF);
+				writeCommand(0x00);
+				writeCommand(0x00);
+				writeCommand(0xFF);
+				writeCommand(0x00);
+			}
+		}
+	}
+}
+
 int
 devSSD1331symbols(int symbolno, int xco, int yco)
 {
-//Segments are 8x16
-//symbolnos = numbers from 1 to 9 then 10 - 35 are the letters abc and 6969 is clear.
-//Not all letters are included
-int shiftx;
-int shifty;
-	
-shiftx = xco * 8;
-shifty = yco * 16;
-	
-//clear
-if (symbolno == 6969)
+	/*
+	 *	Send the whole glyph with /CS held low
+	 */
+	devSSD1331commandBegin();
+	appendSymbol(symbolno, xco, yco);
+
+	return devSSD1331commandFlush();
+}
+
+/*
+ *	Draw a string starting at cell (xco, yco), clearing each cell first.
+ *	Characters without a glyph (e.g., ' ') leave the cell blank. Returns
+ *	the number of cells used.
+ */
+int
+devSSD1331drawString(const char *  string, int xco, int yco)
+{
+	int	symbol;
+	int	cells = 0;
+
+	for (; *string != '\0'; string++)
 	{
-	writeCommand(kSSD1331CommandCLEAR);
-	writeCommand(0+shiftx);
-	writeCommand(0+shifty);
-	writeCommand(8+shiftx);
-	writeCommand(16+shifty);
+		symbol = symbolForCharacter(*string);
+
+		/*
+		 *	Clear and draw the cell in one /CS assertion
+		 */
+		devSSD1331commandBegin();
+		appendSymbol(kSSD1331SymbolClear, xco + cells, yco);
+		if (symbol >= 0 && (glyphSegments[symbol] & kSSD1331SegmentsWide))
+		{
+			appendSymbol(kSSD1331SymbolClear, xco + cells + 1, yco);
+			appendSymbol(symbol, xco + cells, yco);
+			cells += 2;
+		}
+		else
+		{
+			if (symbol >= 0)
+			{
+				appendSymbol(symbol, xco + cells, yco);
+			}
+			cells += 1;
+		}
+		devSSD1331commandFlush();
 	}
-/*	
-//test 
-	writeCommand(0X22);
-	writeCommand(88); // start cols
-        writeCommand(56); // start rows
-        writeCommand(95); // end cols
-        writeCommand(63); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-*/
-	
-//full seven segments
-/*	
-if (symbolno == 0)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
 
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
+	return cells;
+}
 
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+/*
+ *	Format value in decimal at the end of digits[], returning the start.
+ */
+static const char *
+formatInteger(int value, char digits[kSSD1331IntegerDigits])
+{
+	int		index = kSSD1331IntegerDigits - 1;
+	unsigned int	magnitude = (value < 0) ? -(unsigned int)value : (unsigned int)value;
 
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+	digits[index] = '\0';
+	do
+	{
+		digits[--index] = '0' + (magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+
+	if (value < 0)
+	{
+		digits[--index] = '-';
 	}
 
-	*/
+	return &digits[index];
+}
+
+/*
+ *	Draw a decimal integer right-aligned so that its last digit is in cell
+ *	(xco, yco). Returns the number of cells used.
+ */
+int
+devSSD1331drawInteger(int value, int xco, int yco)
+{
+	char		digits[kSSD1331IntegerDigits];
+	const char *	string = formatInteger(value, digits);
+	int		length = &digits[kSSD1331IntegerDigits - 1] - string;
+
+	return devSSD1331drawString(string, xco - (length - 1), yco);
+}
+
+/*
+ *	Retained text fields. A field remembers the characters it last put
+ *	on the panel and only clears and redraws the cells whose character
+ *	changed, so refreshing a mostly-unchanged value (a clock, a counter)
+ *	costs a cell or two of SPI traffic rather than the whole field. Text
+ *	is right-aligned and padded with blanks; one cell per character, so
+ *	wide glyphs are not supported.
+ */
+void
+devSSD1331fieldInit(SSD1331TextField *  field, int xco, int yco, int width)
+{
+	int	i;
+
+	field->xco = xco;
+	field->yco = yco;
+	field->width = (width > kSSD1331TextFieldMaxWidth) ? kSSD1331TextFieldMaxWidth : width;
 
-if (symbolno == 0)
+	/*
+	 *	'\0' never matches a displayed character, so the first update
+	 *	draws every cell regardless of what is on the panel.
+	 */
+	for (i = 0; i < kSSD1331TextFieldMaxWidth; i++)
 	{
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-       	writeCommand(0+shifty); // start rows
-       	writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+		field->shown[i] = '\0';
+	}
+}
 
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+/*
+ *	Returns the number of cells redrawn. Text longer than the field
+ *	keeps its rightmost characters.
+ */
+int
+devSSD1331fieldSetString(SSD1331TextField *  field, const char *  string)
+{
+	int	length = 0;
+	int	redrawn = 0;
+	int	i;
+	char	character;
 
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+	while (string[length] != '\0')
+	{
+		length++;
+	}
 
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
+	for (i = 0; i < field->width; i++)
+	{
+		character = (i < field->width - length) ? ' ' : string[length - field->width + i];
+		if (character == field->shown[i])
+		{
+			continue;
+		}
+
+		devSSD1331commandBegin();
+		appendSymbol(kSSD1331SymbolClear, field->xco + i, field->yco);
+		if (character != ' ')
+		{
+			appendSymbol(symbolForCharacter(character), field->xco + i, field->yco);
+		}
+		devSSD1331commandFlush();
+		field->shown[i] = character;
+		redrawn++;
+	}
 
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}	
-	
-else if (symbolno == 1)
-	{	
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}	
-	
-else if (symbolno == 2)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-	
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-else if (symbolno == 3)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-else if (symbolno == 4)
-	{	
-
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	}
-
-	
-	
-else if (symbolno == 5)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-else if (symbolno == 6)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-else if (symbolno == 7)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-else if (symbolno == 8)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-else if (symbolno == 9)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-else if (symbolno == 10)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	}
-else if (symbolno == 31)
-	{	
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-else if (symbolno == 16)
-	{	
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-else if (symbolno == 28)
-	{	
-//s
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-	else if (symbolno == 29)
-	{	
-//t
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-	else if (symbolno == 14)
-	{	
-//e
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);	
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//7 bottom segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(12+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(13+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-	else if (symbolno == 25)
-	{	
-//p
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-		
-	//4 middle segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(6+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(7+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);		
-	
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	}
-	if (symbolno == 22)
-	{
-	//m
-	//1 top segment	
-	writeCommand(0X22);
-	writeCommand(1+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-		
-	//1 top segment	2
-	writeCommand(0X22);
-	writeCommand(1+5+shiftx); // start cols
-        writeCommand(0+shifty); // start rows
-        writeCommand(5+5+shiftx); // end cols
-        writeCommand(1+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-		
-	//3 right top segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//3 right top segment 2	
-	writeCommand(0X22);
-	writeCommand(5+5+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(6+5+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-	//6 right bottom segment	
-	writeCommand(0X22);
-	writeCommand(5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	
-
-	//6 right bottom segment 2	
-	writeCommand(0X22);
-	writeCommand(5+5+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(6+5+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-	
-	
-else if (symbolno == 18)
-	{
-	//i
-	//2 left top segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(2+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(5+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-
-	//5 left bottom segment	
-	writeCommand(0X22);
-	writeCommand(0+shiftx); // start cols
-        writeCommand(8+shifty); // start rows
-        writeCommand(1+shiftx); // end cols
-        writeCommand(11+shifty); // end rows
-	writeCommand(0x00);
-        writeCommand(0xFF);
-        writeCommand(0x00);
-        writeCommand(0x00);
-	writeCommand(0xFF);
-        writeCommand(0x00);
-	}
-
-else{
-	/*writeCommand(kSSD1331CommandCLEAR);
-	writeCommand(0+shiftx);
-	writeCommand(0+shifty);
-	writeCommand(8+shiftx);
-	writeCommand(16+shifty);*/
-
-    }
-	return 0;	
+	return redrawn;
 }
 
-
 int
-devSSD1331write(int input,int xco, int yco)
-	{
-int aut = input;
-int d1;
-int d2;
-int d3;
-int d4;
-int df;
-df = 0;
-d4 = aut/1000;
-
-if (d4 != 0)
-{
-	df=1;
-	devSSD1331symbols(6969,xco-3,yco);
-	devSSD1331symbols(d4,xco-3,yco);
-}
-d3 = (aut-d4*1000)/100;		
-if (df!=0 || d4!=0)
+devSSD1331fieldSetInteger(SSD1331TextField *  field, int value)
 {
-	df=1;
-	devSSD1331symbols(6969,xco-2,yco);
-	devSSD1331symbols(d3,xco-2,yco);
+	char	digits[kSSD1331IntegerDigits];
+
+	return devSSD1331fieldSetString(field, formatInteger(value, digits));
 }
-d2 = (aut-d4*1000-d3*100)/10;
-SEGGER_RTT_printf(0, " %d,", d2);	
-if (df!=0 || d2!=0)
+
+int
+devSSD1331write(int input, int xco, int yco)
 {
-	df=1;
-	devSSD1331symbols(6969,xco-1,yco);
-	devSSD1331symbols(d2,xco-1,yco);	
-}
-d1 = (aut-d4*1000-d3*100-d2*10);	
-devSSD1331symbols(d1,xco,yco);
-	
+	devSSD1331drawInteger(input, xco, yco);
+
 	return 0;
-	}
+}
@@ -7,6 +7,12 @@ typedef enum
 	kSSD1331ColororderRGB		= 1,
 	kSSD1331DelaysHWFILL		= 3,
 	kSSD1331DelaysHWLINE		= 1,
+	kSSD1331GlyphWidth		= 8,
+	kSSD1331GlyphHeight		= 16,
+	kSSD1331SymbolMinus		= 36,
+	kSSD1331SymbolClear		= 6969,
+	kSSD1331IntegerDigits		= 12,
+	kSSD1331TextFieldMaxWidth	= 12,
 } SSD1331Constants;
 
 typedef enum
@@ -42,6 +48,22 @@ typedef enum
 	kSSD1331CommandVCOMH		= 0xBE,
 } SSD1331Commands;
 
+typedef struct
+{
+	uint8_t		xco;
+	uint8_t		yco;
+	uint8_t		width;
+	char		shown[kSSD1331TextFieldMaxWidth];
+} SSD1331TextField;
+
 int	devSSD1331init(void);
+int	devSSD1331commandBegin(void);
+int	devSSD1331commandAppend(uint8_t commandByte);
+int	devSSD1331commandFlush(void);
 int	devSSD1331symbols(int symbolno, int xco, int yco);
 int	devSSD1331write(int input,int xco, int yco);
+int	devSSD1331drawString(const char *  string, int xco, int yco);
+int	devSSD1331drawInteger(int value, int xco, int yco);
+void	devSSD1331fieldInit(SSD1331TextField *  field, int xco, int yco, int width);
+int	devSSD1331fieldSetString(SSD1331TextField *  field, const char *  string);
+int	devSSD1331fieldSetInteger(SSD1331TextField *  field, int value);
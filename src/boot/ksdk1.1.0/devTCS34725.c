@@ -82,7 +82,7 @@ readSensorRegisterTCS34725(uint8_t deviceRegister)
 	i2c_device_t slave =
 	{
 		.address = deviceTCS34725State.i2cAddress,
-		.baudRate_kbps = gWarpI2cBaudRateKbps
+		.baudRate_kbps = warpI2cBaudRateKbps(deviceTCS34725State.i2cAddress)
 	};
 
 
@@ -98,7 +98,7 @@ readSensorRegisterTCS34725(uint8_t deviceRegister)
 	 */
 	cmdBuf[0] = 0x80;
 
-	status1 = I2C_DRV_MasterSendDataBlocking(
+	status1 = warpI2CMasterSendDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							cmdBuf,
@@ -108,7 +108,7 @@ readSensorRegisterTCS34725(uint8_t deviceRegister)
 							gWarpI2cTimeoutMilliseconds);
 
 	cmdBuf[0] = deviceRegister;
-	status2 = I2C_DRV_MasterReceiveDataBlocking(
+	status2 = warpI2CMasterReceiveDataBlocking(
 							0 /* I2C peripheral instance */,
 							&slave,
 							cmdBuf,
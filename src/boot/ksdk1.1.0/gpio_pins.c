@@ -18,7 +18,7 @@
  *
  *	Here, we configure all pins that we ever use as general-purpose output.
  *
- *	Currently, this excludes kWarpPinKL03_VDD_ADC which we configure in inputPins
+ *	Currently, this excludes kWarpPinKL03_VDD_ADC and kWarpPinADXL362_CS which we configure in inputPins
  *
  */
 
@@ -108,12 +108,6 @@ gpio_output_pin_user_config_t	outputPins[] = {
 		.config.driveStrength = kPortLowDriveStrength,
 	},
 #endif
-	{
-		.pinName = kWarpPinADXL362_CS,				/*	Was kWarpPinADXL362_CS_PAN1326_nSHUTD in Warp v2	*/
-		.config.outputLogic = 1,
-		.config.slewRate = kPortSlowSlewRate,
-		.config.driveStrength = kPortLowDriveStrength,
-	},
 	{
 		.pinName = kWarpPinI2C0_SCL,
 		.config.outputLogic = 1,
@@ -231,6 +225,19 @@ gpio_input_pin_user_config_t	inputPins[] = {
 		.config.isPassiveFilterEnabled = false,
 		.config.interrupt = kPortIntDisabled,
 	},
+	/*
+	 *	PTB2 is the ADXL362 chip select on Warp but the (jumpered) MMA8451Q
+	 *	INT1 on the FRDM-KL03, a push-pull output that an output here would
+	 *	fight. Leave it an input, pulled up so that the ADXL362 stays
+	 *	deselected; initADXL362() turns it into an output.
+	 */
+	{
+		.pinName = kWarpPinADXL362_CS,				/*	Was kWarpPinADXL362_CS_PAN1326_nSHUTD in Warp v2	*/
+		.config.isPullEnable = true,
+		.config.pullSelect = kPortPullUp,
+		.config.isPassiveFilterEnabled = false,
+		.config.interrupt = kPortIntDisabled,
+	},
 	{
 		.pinName = GPIO_PINS_OUT_OF_RANGE,
 	}
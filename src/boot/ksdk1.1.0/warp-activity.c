@@ -0,0 +1,262 @@
+/*
+	Cadence and activity classification for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arm_math.h"
+#include "warp-activity.h"
+
+
+
+static const char *	activityNames[] =
+{
+	[kWarpActivityStill]	= "still",
+	[kWarpActivityWalk]	= "walk",
+	[kWarpActivityRun]	= "run",
+	[kWarpActivityOther]	= "other",
+};
+
+
+
+/*
+ *	Integer square root, one result bit per iteration (no divides).
+ */
+static uint16_t
+squareRoot(uint32_t value)
+{
+	uint32_t	root = 0;
+	uint32_t	bit = 1u << 30;
+
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
+
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (root > 0x7FFF) ? 0x7FFF : (uint16_t)root;
+}
+
+/*
+ *	Autocorrelation of the (zero-mean) window at lag, normalised by the
+ *	number of overlapping samples and by the window power: Q15, 1.0 for a
+ *	signal that repeats exactly every lag samples.
+ */
+static int16_t
+autocorrelation(WarpActivityEngine *  engine, uint16_t lag, q63_t power)
+{
+	q63_t	sum;
+	q63_t	normalised;
+
+	arm_dot_prod_q15(engine->window, &engine->window[lag], kWarpActivityWindowSamples - lag, &sum);
+	normalised = (sum * kWarpActivityWindowSamples * 32768) / ((q63_t)(kWarpActivityWindowSamples - lag) * power);
+
+	if (normalised > 32767)
+	{
+		return 32767;
+	}
+	else if (normalised < -32768)
+	{
+		return -32768;
+	}
+
+	return (int16_t)normalised;
+}
+
+static void
+classifyWindow(WarpActivityEngine *  engine)
+{
+	q15_t		mean;
+	q63_t		power;
+	int16_t		previous, current, next;
+	int16_t		peak = 0, peakPrevious = 0, peakNext = 0;
+	int32_t		curvature, lagQ4;
+	uint16_t	minimumLag, maximumLag, lag, peakLag = 0;
+
+	engine->windows++;
+	engine->cadence = 0;
+	engine->periodicity = 0;
+
+	arm_mean_q15(engine->window, kWarpActivityWindowSamples, &mean);
+	arm_offset_q15(engine->window, -mean, engine->window, kWarpActivityWindowSamples);
+	arm_power_q15(engine->window, kWarpActivityWindowSamples, &power);
+
+	if (power * kWarpActivityStillRatio * kWarpActivityStillRatio <= (q63_t)mean * mean * kWarpActivityWindowSamples)
+	{
+		engine->activity = kWarpActivityStill;
+
+		return;
+	}
+
+	minimumLag = (uint16_t)(engine->windowRateHz * 60 / kWarpActivityMaximumCadence);
+	maximumLag = (uint16_t)(engine->windowRateHz * 60 / kWarpActivityMinimumCadence);
+	if (minimumLag < 2)
+	{
+		minimumLag = 2;
+	}
+	if (maximumLag > kWarpActivityWindowSamples / 2)
+	{
+		maximumLag = kWarpActivityWindowSamples / 2;
+	}
+
+	/*
+	 *	Highest local maximum over the cadence range.
+	 */
+	previous = autocorrelation(engine, minimumLag - 1, power);
+	current = autocorrelation(engine, minimumLag, power);
+	for (lag = minimumLag; lag <= maximumLag; lag++)
+	{
+		next = autocorrelation(engine, lag + 1, power);
+		if (current > previous && current >= next && current > peak)
+		{
+			peak = current;
+			peakPrevious = previous;
+			peakNext = next;
+			peakLag = lag;
+		}
+		previous = current;
+		current = next;
+	}
+
+	engine->periodicity = peak;
+	if (peak < kWarpActivityPeriodicThreshold)
+	{
+		engine->activity = kWarpActivityOther;
+
+		return;
+	}
+
+	/*
+	 *	A left/right difference in gait can make the stride (two steps)
+	 *	the stronger period; prefer a peak near half the lag.
+	 */
+	lag = (peakLag + 1) / 2 - 1;
+	for (lag = (lag < minimumLag) ? minimumLag : lag; lag <= (peakLag + 1) / 2 + 1; lag++)
+	{
+		previous = autocorrelation(engine, lag - 1, power);
+		current = autocorrelation(engine, lag, power);
+		next = autocorrelation(engine, lag + 1, power);
+		if (current > previous && current >= next && (int32_t)current * 32768 >= (int32_t)peak * kWarpActivityHalfLagThreshold)
+		{
+			peakPrevious = previous;
+			peakNext = next;
+			peakLag = lag;
+			engine->periodicity = current;
+			break;
+		}
+	}
+
+	/*
+	 *	Vertex of the parabola through the peak and its neighbours, in
+	 *	sixteenths of a lag.
+	 */
+	lagQ4 = 16 * peakLag;
+	curvature = (int32_t)peakPrevious - 2 * (int32_t)engine->periodicity + peakNext;
+	if (curvature < 0)
+	{
+		lagQ4 += 8 * ((int32_t)peakPrevious - peakNext) / curvature;
+	}
+
+	engine->cadence = (uint16_t)((engine->windowRateHz * 60 * 16 + lagQ4 / 2) / lagQ4);
+	engine->activity = (engine->cadence >= kWarpActivityRunCadence) ? kWarpActivityRun : kWarpActivityWalk;
+}
+
+void
+warpActivityEngineInit(WarpActivityEngine *  engine, uint16_t sampleRateHz, uint8_t decimation)
+{
+	engine->decimation = (decimation == 0) ? 1 : decimation;
+	engine->windowRateHz = sampleRateHz / engine->decimation;
+	engine->accumulator = 0;
+	engine->accumulated = 0;
+	engine->count = 0;
+	engine->activity = kWarpActivityStill;
+	engine->cadence = 0;
+	engine->periodicity = 0;
+	engine->windows = 0;
+}
+
+/*
+ *	Returns true when this sample completes a window; the label and
+ *	cadence of that window are then in the engine until the next one.
+ */
+bool
+warpActivityEnginePush(WarpActivityEngine *  engine, const int16_t *  xyz)
+{
+	uint32_t	sumOfSquares = 0;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		sumOfSquares += (uint32_t)((int32_t)xyz[axis] * xyz[axis]);
+	}
+
+	engine->accumulator += squareRoot(sumOfSquares);
+	if (++engine->accumulated < engine->decimation)
+	{
+		return false;
+	}
+
+	engine->window[engine->count++] = (int16_t)(engine->accumulator / engine->decimation);
+	engine->accumulator = 0;
+	engine->accumulated = 0;
+	if (engine->count < kWarpActivityWindowSamples)
+	{
+		return false;
+	}
+
+	engine->count = 0;
+	classifyWindow(engine);
+
+	return true;
+}
+
+const char *
+warpActivityName(WarpActivity activity)
+{
+	return (activity <= kWarpActivityOther) ? activityNames[activity] : "?";
+}
@@ -0,0 +1,93 @@
+/*
+	Cadence and activity classification for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Activity engine: the accelerometer magnitude (orientation-independent,
+ *	in the caller's counts) is averaged over `decimation` samples and
+ *	collected into windows of kWarpActivityWindowSamples. Each full window
+ *	is reduced, with the CMSIS-DSP q15 kernels, to one label (still, walk,
+ *	run, or other for aperiodic motion) and a cadence in steps per minute,
+ *	so a log keeps one result per window instead of the raw samples.
+ *
+ *	A window is still when its standard deviation is below
+ *	1/kWarpActivityStillRatio of its mean (the mean being 1g in whatever
+ *	range). Otherwise the cadence comes from the highest local maximum of
+ *	the normalised autocorrelation over the lags of kWarpActivity*Cadence
+ *	steps per minute, halved when the half lag (the step, rather than the
+ *	stride) correlates nearly as well, and refined by a parabola through
+ *	the neighbouring lags. A peak below kWarpActivityPeriodicThreshold
+ *	(Q15) is other; a cadence from kWarpActivityRunCadence up is run.
+ *
+ *	The defaults (50Hz ODR, decimation 2) give 2.56s windows at 25Hz.
+ */
+typedef enum
+{
+	kWarpActivityStill			= 0,
+	kWarpActivityWalk			= 1,
+	kWarpActivityRun			= 2,
+	kWarpActivityOther			= 3,
+} WarpActivity;
+
+typedef enum
+{
+	kWarpActivityWindowSamples		= 64,
+	kWarpActivityDecimation			= 2,
+	kWarpActivityMinimumCadence		= 60,		/*	steps per minute		*/
+	kWarpActivityMaximumCadence		= 240,		/*	steps per minute		*/
+	kWarpActivityRunCadence			= 145,		/*	steps per minute		*/
+	kWarpActivityStillRatio			= 20,		/*	standard deviation < 0.05g	*/
+	kWarpActivityPeriodicThreshold		= 9830,		/*	0.3 in Q15			*/
+	kWarpActivityHalfLagThreshold		= 26214,	/*	0.8 of the peak in Q15		*/
+} WarpActivityConstants;
+
+typedef struct
+{
+	int16_t		window[kWarpActivityWindowSamples];
+	int32_t		accumulator;
+	uint16_t	windowRateHz;
+	uint8_t		decimation;
+	uint8_t		accumulated;
+	uint8_t		count;
+	uint8_t		activity;		/*	WarpActivity of the last window		*/
+	uint16_t	cadence;		/*	steps per minute; 0 unless walk or run	*/
+	int16_t		periodicity;		/*	autocorrelation peak; Q15		*/
+	uint32_t	windows;
+} WarpActivityEngine;
+
+void		warpActivityEngineInit(WarpActivityEngine *  engine, uint16_t sampleRateHz, uint8_t decimation);
+bool		warpActivityEnginePush(WarpActivityEngine *  engine, const int16_t *  xyz);
+const char *	warpActivityName(WarpActivity activity);
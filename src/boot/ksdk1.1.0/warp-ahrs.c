@@ -0,0 +1,278 @@
+/*
+	Fixed-point orientation filter for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "warp-ahrs.h"
+
+
+#define	kWarpAhrsOne	((int32_t)1 << kWarpAhrsFractionBits)
+#define	kWarpAhrsHalf	((int32_t)1 << (kWarpAhrsFractionBits - 1))
+
+
+
+static inline int32_t
+multiplyQ30(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b) >> kWarpAhrsFractionBits);
+}
+
+/*
+ *	1/sqrt(sumOfSquares), as a Q30 factor y and a shift such that
+ *	(v * y) >> shift is v/sqrt(sumOfSquares) in Q30. The argument is first
+ *	scaled by powers of four into r in [0.25, 1) (Q30), where a linear
+ *	first guess is within 20% of 1/sqrt(r), and Newton-Raphson
+ *
+ *		y' = y * (3 - r * y * y) / 2
+ *
+ *	roughly squares the error each iteration.
+ */
+static uint32_t
+inverseSqrt(uint64_t sumOfSquares, int *  shift)
+{
+	uint32_t	r, y;
+	uint64_t	rySquared;
+	int		exponent = 0;
+
+	while (sumOfSquares >= ((uint64_t)1 << kWarpAhrsFractionBits))
+	{
+		sumOfSquares >>= 2;
+		exponent++;
+	}
+	while (sumOfSquares < ((uint64_t)1 << (kWarpAhrsFractionBits - 2)))
+	{
+		sumOfSquares <<= 2;
+		exponent--;
+	}
+	r = (uint32_t)sumOfSquares;
+
+	/*
+	 *	y = 2 - 1.25 * (r - 0.25)
+	 */
+	y = (2u << kWarpAhrsFractionBits) - ((r - (1u << (kWarpAhrsFractionBits - 2))) + ((r - (1u << (kWarpAhrsFractionBits - 2))) >> 2));
+
+	for (int i = 0; i < kWarpAhrsNewtonIterations; i++)
+	{
+		rySquared = ((uint64_t)r * (((uint64_t)y * y) >> kWarpAhrsFractionBits)) >> kWarpAhrsFractionBits;
+		y = (uint32_t)(((uint64_t)y * ((3u << kWarpAhrsFractionBits) - (uint32_t)rySquared)) >> (kWarpAhrsFractionBits + 1));
+	}
+
+	*shift = (kWarpAhrsFractionBits / 2) + exponent;
+
+	return y;
+}
+
+/*
+ *	Scale v to unit length in Q30. Returns false, leaving v alone, for a
+ *	zero vector.
+ */
+static bool
+normalise(int32_t *  v, int count)
+{
+	uint64_t	sumOfSquares = 0;
+	uint32_t	y;
+	int		shift;
+
+	for (int i = 0; i < count; i++)
+	{
+		sumOfSquares += (uint64_t)((int64_t)v[i] * v[i]);
+	}
+
+	if (sumOfSquares == 0)
+	{
+		return false;
+	}
+
+	y = inverseSqrt(sumOfSquares, &shift);
+	for (int i = 0; i < count; i++)
+	{
+		v[i] = (int32_t)(((int64_t)v[i] * y) >> shift);
+	}
+
+	return true;
+}
+
+void
+warpAhrsInit(WarpAhrsState *  state, uint16_t sampleRateHz, int32_t gyroScale, int32_t twoKp, int32_t twoKi)
+{
+	state->quaternion[0] = kWarpAhrsOne;
+	state->quaternion[1] = 0;
+	state->quaternion[2] = 0;
+	state->quaternion[3] = 0;
+
+	state->integralFeedback[0] = 0;
+	state->integralFeedback[1] = 0;
+	state->integralFeedback[2] = 0;
+
+	state->period = kWarpAhrsOne / sampleRateHz;
+	state->halfPeriod = state->period / 2;
+	state->gyroScale = gyroScale;
+	state->twoKp = twoKp;
+	state->twoKi = twoKi;
+}
+
+void
+warpAhrsUpdate(WarpAhrsState *  state, const int16_t *  gyro, const int16_t *  accel, const int16_t *  mag)
+{
+	int32_t *	q = state->quaternion;
+	int32_t		g[3], a[3], m[3];
+	int32_t		halfError[3] = {0, 0, 0};
+	int32_t		halfV[3], halfW[3];
+	int32_t		q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+	int32_t		hx, hy, bx, bz, qa, qb, qc;
+	uint32_t	y;
+	int		shift;
+
+
+	/*
+	 *	Gyro counts to Q16 rad/s.
+	 */
+	for (int i = 0; i < 3; i++)
+	{
+		g[i] = (int32_t)(((int64_t)gyro[i] * state->gyroScale) >> (kWarpAhrsFractionBits - kWarpAhrsRateFractionBits));
+		a[i] = accel[i];
+		m[i] = (mag != NULL) ? mag[i] : 0;
+	}
+
+	/*
+	 *	Feedback only when the accelerometer gives a direction for gravity.
+	 */
+	if (normalise(a, 3))
+	{
+		q0q0 = multiplyQ30(q[0], q[0]);
+		q0q1 = multiplyQ30(q[0], q[1]);
+		q0q2 = multiplyQ30(q[0], q[2]);
+		q0q3 = multiplyQ30(q[0], q[3]);
+		q1q1 = multiplyQ30(q[1], q[1]);
+		q1q2 = multiplyQ30(q[1], q[2]);
+		q1q3 = multiplyQ30(q[1], q[3]);
+		q2q2 = multiplyQ30(q[2], q[2]);
+		q2q3 = multiplyQ30(q[2], q[3]);
+		q3q3 = multiplyQ30(q[3], q[3]);
+
+		/*
+		 *	Estimated direction of gravity in the sensor frame, halved.
+		 */
+		halfV[0] = q1q3 - q0q2;
+		halfV[1] = q0q1 + q2q3;
+		halfV[2] = q0q0 - kWarpAhrsHalf + q3q3;
+
+		halfError[0] = multiplyQ30(a[1], halfV[2]) - multiplyQ30(a[2], halfV[1]);
+		halfError[1] = multiplyQ30(a[2], halfV[0]) - multiplyQ30(a[0], halfV[2]);
+		halfError[2] = multiplyQ30(a[0], halfV[1]) - multiplyQ30(a[1], halfV[0]);
+
+		if (normalise(m, 3))
+		{
+			/*
+			 *	Earth-frame field, flattened onto the x-z plane so
+			 *	that yaw is referenced to magnetic north alone.
+			 */
+			hx = 2 * (multiplyQ30(m[0], kWarpAhrsHalf - q2q2 - q3q3) + multiplyQ30(m[1], q1q2 - q0q3) + multiplyQ30(m[2], q1q3 + q0q2));
+			hy = 2 * (multiplyQ30(m[0], q1q2 + q0q3) + multiplyQ30(m[1], kWarpAhrsHalf - q1q1 - q3q3) + multiplyQ30(m[2], q2q3 - q0q1));
+			bz = 2 * (multiplyQ30(m[0], q1q3 - q0q2) + multiplyQ30(m[1], q2q3 + q0q1) + multiplyQ30(m[2], kWarpAhrsHalf - q1q1 - q2q2));
+
+			bx = 0;
+			if ((hx | hy) != 0)
+			{
+				y = inverseSqrt((uint64_t)((int64_t)hx * hx) + (uint64_t)((int64_t)hy * hy), &shift);
+				bx = multiplyQ30(hx, (int32_t)(((int64_t)hx * y) >> shift)) + multiplyQ30(hy, (int32_t)(((int64_t)hy * y) >> shift));
+			}
+
+			/*
+			 *	Estimated direction of the field in the sensor frame, halved.
+			 */
+			halfW[0] = multiplyQ30(bx, kWarpAhrsHalf - q2q2 - q3q3) + multiplyQ30(bz, q1q3 - q0q2);
+			halfW[1] = multiplyQ30(bx, q1q2 - q0q3) + multiplyQ30(bz, q0q1 + q2q3);
+			halfW[2] = multiplyQ30(bx, q0q2 + q1q3) + multiplyQ30(bz, kWarpAhrsHalf - q1q1 - q2q2);
+
+			halfError[0] += multiplyQ30(m[1], halfW[2]) - multiplyQ30(m[2], halfW[1]);
+			halfError[1] += multiplyQ30(m[2], halfW[0]) - multiplyQ30(m[0], halfW[2]);
+			halfError[2] += multiplyQ30(m[0], halfW[1]) - multiplyQ30(m[1], halfW[0]);
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (state->twoKi != 0)
+			{
+				state->integralFeedback[i] += multiplyQ30((int32_t)(((int64_t)halfError[i] * state->twoKi) >> kWarpAhrsGainFractionBits), state->period);
+				g[i] += state->integralFeedback[i] >> (kWarpAhrsFractionBits - kWarpAhrsRateFractionBits);
+			}
+
+			g[i] += (int32_t)(((int64_t)halfError[i] * state->twoKp) >> (kWarpAhrsFractionBits + kWarpAhrsGainFractionBits - kWarpAhrsRateFractionBits));
+		}
+	}
+
+	/*
+	 *	Integrate q' = q * (0, g) / 2 over one period: g becomes the Q30
+	 *	half-angle step.
+	 */
+	for (int i = 0; i < 3; i++)
+	{
+		g[i] = (int32_t)(((int64_t)g[i] * state->halfPeriod) >> kWarpAhrsRateFractionBits);
+	}
+
+	qa = q[0];
+	qb = q[1];
+	qc = q[2];
+	q[0] += -multiplyQ30(qb, g[0]) - multiplyQ30(qc, g[1]) - multiplyQ30(q[3], g[2]);
+	q[1] += multiplyQ30(qa, g[0]) + multiplyQ30(qc, g[2]) - multiplyQ30(q[3], g[1]);
+	q[2] += multiplyQ30(qa, g[1]) - multiplyQ30(qb, g[2]) + multiplyQ30(q[3], g[0]);
+	q[3] += multiplyQ30(qa, g[2]) + multiplyQ30(qb, g[1]) - multiplyQ30(qc, g[0]);
+
+	normalise(q, 4);
+}
+
+/*
+ *	The quaternion in Q15 for output: four int16_t instead of nine raw
+ *	channels. +1.0 saturates to 32767.
+ */
+void
+warpAhrsQuaternionQ15(const WarpAhrsState *  state, int16_t *  quaternion)
+{
+	int32_t		component;
+
+	for (int i = 0; i < 4; i++)
+	{
+		component = state->quaternion[i] >> (kWarpAhrsFractionBits - 15);
+		if (component > INT16_MAX)
+		{
+			component = INT16_MAX;
+		}
+		quaternion[i] = (int16_t)component;
+	}
+}
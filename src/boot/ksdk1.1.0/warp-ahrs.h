@@ -0,0 +1,73 @@
+/*
+	Fixed-point orientation filter for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Mahony complementary filter (attitude and heading reference system)
+ *	in fixed point, for the BMX055 (or any gyro/accelerometer/magnetometer
+ *	triple). The KL03 has no FPU, so the state is kept in Q30: quaternion
+ *	components and unit vectors in [-2, 2), angular rates in Q16 rad/s.
+ *	Products go through 64-bit intermediates and the normalisations use a
+ *	Newton-Raphson inverse square root, so there are no divides per update.
+ *
+ *	warpAhrsUpdate() takes raw sensor counts: accelerometer and
+ *	magnetometer scale does not matter (both are normalised) and the gyro
+ *	is scaled by gyroScale. A zero magnetometer vector (or a NULL mag)
+ *	runs the accelerometer-only update, which leaves yaw to drift.
+ */
+
+typedef enum
+{
+	kWarpAhrsFractionBits		= 30,
+	kWarpAhrsRateFractionBits	= 16,
+	kWarpAhrsGainFractionBits	= 16,
+	kWarpAhrsNewtonIterations	= 4,
+} WarpAhrsConstants;
+
+typedef struct
+{
+	int32_t		quaternion[4];		/*	w, x, y, z; Q30			*/
+	int32_t		integralFeedback[3];	/*	gyro bias estimate; Q30 rad/s	*/
+	int32_t		halfPeriod;		/*	1/(2 * sample rate); Q30 s	*/
+	int32_t		period;			/*	1/sample rate; Q30 s		*/
+	int32_t		gyroScale;		/*	rad/s per gyro count; Q30	*/
+	int32_t		twoKp;			/*	proportional gain * 2; Q16	*/
+	int32_t		twoKi;			/*	integral gain * 2; Q16		*/
+} WarpAhrsState;
+
+void	warpAhrsInit(WarpAhrsState *  state, uint16_t sampleRateHz, int32_t gyroScale, int32_t twoKp, int32_t twoKi);
+void	warpAhrsUpdate(WarpAhrsState *  state, const int16_t *  gyro, const int16_t *  accel, const int16_t *  mag);
+void	warpAhrsQuaternionQ15(const WarpAhrsState *  state, int16_t *  quaternion);
@@ -0,0 +1,251 @@
+/*
+	INA219 current transient capture for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+#include "fsl_gpio_driver.h"
+
+#include "warp.h"
+#include "devINA219.h"
+#include "warp-capture.h"
+
+
+
+static void
+resetRing(WarpCaptureRing *  ring)
+{
+	ring->firstSample		= 0;
+	ring->samples			= 0;
+	ring->triggerSample		= UINT32_MAX;
+	ring->triggerMicroseconds	= 0;
+	ring->lastMicroseconds		= 0;
+	ring->last			= 0;
+	ring->oldest			= 0;
+	ring->used			= 0;
+}
+
+/*
+ *	Append one sample as a delta on the newest block, or as the first
+ *	sample of a new one, dropping the oldest block if the ring is full.
+ *	Only a new block takes a timestamp.
+ */
+static void
+appendSample(WarpCaptureRing *  ring, int16_t value)
+{
+	WarpCaptureBlock *	block;
+	int32_t			delta = (int32_t)value - ring->last;
+	uint8_t			newest;
+
+
+	if (ring->used != 0)
+	{
+		block = &ring->blocks[(ring->oldest + ring->used - 1) % kWarpCaptureBlocks];
+		if ((block->count <= kWarpCaptureBlockDeltas) && (delta >= INT8_MIN) && (delta <= INT8_MAX))
+		{
+			block->deltas[block->count - 1] = (int8_t)delta;
+			block->count++;
+			ring->last = value;
+			ring->samples++;
+
+			return;
+		}
+	}
+
+	if (ring->used == kWarpCaptureBlocks)
+	{
+		ring->firstSample += ring->blocks[ring->oldest].count;
+		ring->oldest = (ring->oldest + 1) % kWarpCaptureBlocks;
+		ring->used--;
+	}
+
+	newest = (ring->oldest + ring->used) % kWarpCaptureBlocks;
+	ring->used++;
+
+	block = &ring->blocks[newest];
+	block->microseconds	= warpTimestampMicroseconds();
+	block->first		= value;
+	block->count		= 1;
+	ring->last		= value;
+	ring->samples++;
+}
+
+WarpStatus
+warpCaptureCurrent(WarpCaptureRing *  ring, const WarpCaptureSettings *  settings)
+{
+	WarpStatus		status;
+	WarpStatus		restoreStatus;
+	int16_t			value;
+	uint32_t		initialPinLevel = 0;
+	uint32_t		portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(settings->pin)];
+	uint32_t		pin = GPIO_EXTRACT_PIN(settings->pin);
+	uint32_t		savedPinControl = 0;
+	gpio_pin_direction_t	savedPinDirection = kGpioDigitalInput;
+	bool			triggered = false;
+	gpio_input_pin_user_config_t	triggerPin =
+	{
+		.pinName = settings->pin,
+		.config.isPullEnable = false,
+		.config.pullSelect = kPortPullUp,
+		.config.isPassiveFilterEnabled = false,
+		.config.interrupt = kPortIntDisabled,
+	};
+
+
+	resetRing(ring);
+
+	if (settings->trigger == kWarpCaptureTriggerPin)
+	{
+		/*
+		 *	The pin may still be an output from GPIO_DRV_Init(), and
+		 *	would then only ever read back its own level. Its direction
+		 *	and port control (pull, interrupt) are put back afterwards.
+		 */
+		savedPinControl = HW_PORT_PCRn_RD(portBaseAddr, pin) & ~PORT_PCR_ISF_MASK;
+		savedPinDirection = GPIO_DRV_GetPinDir(settings->pin);
+		GPIO_DRV_InputPinInit(&triggerPin);
+		initialPinLevel = GPIO_DRV_ReadPinInput(settings->pin);
+	}
+
+	/*
+	 *	Any failure (or an unknown trigger) ends the loop with status
+	 *	set, so every exit goes through the restore below.
+	 */
+	status = startCurrentCaptureINA219();
+	while (status == kWarpStatusOK)
+	{
+		status = readCurrentCaptureINA219(&value);
+		if (status != kWarpStatusOK)
+		{
+			break;
+		}
+		appendSample(ring, value);
+
+		if (ring->triggerSample != UINT32_MAX)
+		{
+			if (ring->samples - ring->triggerSample >= settings->postTriggerSamples)
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		switch (settings->trigger)
+		{
+			case kWarpCaptureTriggerSoftware:
+			{
+				triggered = (ring->samples >= settings->preTriggerSamples);
+				break;
+			}
+
+			case kWarpCaptureTriggerPin:
+			{
+				triggered = (GPIO_DRV_ReadPinInput(settings->pin) != initialPinLevel);
+				break;
+			}
+
+			case kWarpCaptureTriggerLevel:
+			{
+				triggered = (value >= settings->level);
+				break;
+			}
+
+			default:
+			{
+				status = kWarpStatusBadDeviceCommand;
+				triggered = false;
+				break;
+			}
+		}
+
+		if (triggered)
+		{
+			ring->triggerSample = ring->samples;
+			ring->triggerMicroseconds = warpTimestampMicroseconds();
+			if ((settings->trigger == kWarpCaptureTriggerSoftware) && (settings->action != NULL))
+			{
+				settings->action();
+			}
+		}
+		else if (ring->samples >= settings->maximumSamples)
+		{
+			break;
+		}
+	}
+
+	ring->lastMicroseconds = warpTimestampMicroseconds();
+
+	if (settings->trigger == kWarpCaptureTriggerPin)
+	{
+		HW_PORT_PCRn_WR(portBaseAddr, pin, savedPinControl);
+		GPIO_DRV_SetPinDir(settings->pin, savedPinDirection);
+	}
+
+	/*
+	 *	Back to the power-on configuration (continuous shunt and bus),
+	 *	also after a failed start or read. The first failure is the one
+	 *	reported.
+	 */
+	restoreStatus = writeSensorRegisterINA219(kWarpSensorConfigurationRegisterINA219_Configuration, kWarpINA219ConfigurationDefault, 0 /* menuI2cPullupValue */);
+
+	return (status != kWarpStatusOK) ? status : restoreStatus;
+}
+
+/*
+ *	Mean time between the samples held, which are read back to back.
+ */
+uint32_t
+warpCaptureSamplePeriodMicroseconds(const WarpCaptureRing *  ring)
+{
+	uint32_t	held = ring->samples - ring->firstSample;
+
+	if (held < 2)
+	{
+		return 0;
+	}
+
+	return (ring->lastMicroseconds - ring->blocks[ring->oldest].microseconds) / (held - 1);
+}
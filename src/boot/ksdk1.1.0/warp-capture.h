@@ -0,0 +1,132 @@
+/*
+	INA219 current transient capture for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	A poor man's power analyser: the INA219 converts the shunt
+ *	continuously at its fastest setting (9 bits, 84us) and the current
+ *	register is read back to back, as fast as the I2C bus allows, into a
+ *	RAM ring around a trigger:
+ *
+ *	-	kWarpCaptureTriggerSoftware calls the settings' action (the
+ *		event to look at) once preTriggerSamples have been taken;
+ *
+ *	-	kWarpCaptureTriggerPin fires when pin (made an input, without
+ *		interrupt) changes from the level it had at the start;
+ *
+ *	-	kWarpCaptureTriggerLevel fires on the first sample at or above
+ *		level counts.
+ *
+ *	Capture ends postTriggerSamples after the trigger, or after
+ *	maximumSamples without one. The ring drops its oldest block when it
+ *	is full, so it always holds the most recent samples, with as many
+ *	from before the trigger as fit.
+ *
+ *	Samples are delta encoded in 16-byte blocks: a timestamp, the first
+ *	sample and up to kWarpCaptureBlockDeltas signed 8-bit differences. A
+ *	difference that does not fit (a step of more than 12.7mA at 100uA a
+ *	count) starts a new block, so a quiet supply packs ten samples in
+ *	16 bytes and the 256-byte ring holds 160 of them.
+ *
+ *	The dump is a sequence of records, each 0xA5 0xC3, a payload length,
+ *	a record type, the payload and a CRC-16/CCITT over everything from
+ *	the length on (as for the binary sample frames); all fields are
+ *	little-endian. A summary record (first sample number held, number of
+ *	the first sample after the trigger or 0xFFFFFFFF, trigger timestamp,
+ *	samples held, mean sample period in us, uA per count, blocks) is
+ *	followed by one record per block, oldest first (number of its first
+ *	sample, then the block as stored). warp-host decode turns a dump
+ *	into CSV.
+ */
+typedef enum
+{
+	kWarpCaptureBlocks			= 16,
+	kWarpCaptureBlockDeltas			= 9,
+
+	kWarpCaptureDumpSync0			= 0xA5,
+	kWarpCaptureDumpSync1			= 0xC3,
+	kWarpCaptureDumpOffsetLength		= 2,
+	kWarpCaptureDumpOffsetType		= 3,
+	kWarpCaptureDumpHeaderBytes		= 4,
+	kWarpCaptureDumpCrcBytes		= 2,
+	kWarpCaptureDumpSummaryBytes		= 19,
+	kWarpCaptureDumpBlockBytes		= 20,
+	kWarpCaptureDumpRecordSummary		= 0,
+	kWarpCaptureDumpRecordBlock		= 1,
+	kWarpCaptureDumpWriteAttempts		= 100,
+} WarpCaptureConstants;
+
+typedef enum
+{
+	kWarpCaptureTriggerSoftware		= 0,
+	kWarpCaptureTriggerPin			= 1,
+	kWarpCaptureTriggerLevel		= 2,
+} WarpCaptureTrigger;
+
+typedef struct
+{
+	uint32_t	microseconds;		/*	warpTimestampMicroseconds() at the first sample		*/
+	int16_t		first;
+	uint8_t		count;			/*	samples in the block, the first included		*/
+	int8_t		deltas[kWarpCaptureBlockDeltas];
+} WarpCaptureBlock;
+
+typedef struct
+{
+	WarpCaptureBlock	blocks[kWarpCaptureBlocks];
+	uint32_t		firstSample;		/*	number of the oldest sample held			*/
+	uint32_t		samples;		/*	samples taken, i.e., the number of the next one		*/
+	uint32_t		triggerSample;		/*	first sample after the trigger, or UINT32_MAX		*/
+	uint32_t		triggerMicroseconds;
+	uint32_t		lastMicroseconds;
+	int16_t			last;
+	uint8_t			oldest;
+	uint8_t			used;
+} WarpCaptureRing;
+
+typedef struct
+{
+	WarpCaptureTrigger	trigger;
+	void			(* action)(void);	/*	kWarpCaptureTriggerSoftware			*/
+	uint32_t		pin;			/*	kWarpCaptureTriggerPin, a GPIO_MAKE_PIN() value	*/
+	int16_t			level;			/*	kWarpCaptureTriggerLevel, in counts		*/
+	uint16_t		preTriggerSamples;
+	uint16_t		postTriggerSamples;
+	uint32_t		maximumSamples;
+} WarpCaptureSettings;
+
+WarpStatus	warpCaptureCurrent(WarpCaptureRing *  ring, const WarpCaptureSettings *  settings);
+uint32_t	warpCaptureSamplePeriodMicroseconds(const WarpCaptureRing *  ring);
@@ -0,0 +1,182 @@
+/*
+	Energy-per-operation profiling on the INA219 for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+
+#include "warp.h"
+#include "devINA219.h"
+#include "warp-energy.h"
+
+
+
+static uint32_t
+windowMicroseconds(uint8_t shuntAdcCode)
+{
+	return (uint32_t)kWarpINA219SampleMicroseconds << (shuntAdcCode - 8);
+}
+
+/*
+ *	One averaged shunt conversion with workload (if not NULL) run as it
+ *	starts. The conversion runs from the end of the configuration
+ *	write, so the window is timed from there.
+ */
+static WarpStatus
+measureWindow(uint8_t shuntAdcCode, WarpEnergyWorkload workload, int16_t *  shuntCounts, uint32_t *  elapsedMicroseconds)
+{
+	WarpStatus	status;
+	uint32_t	start, elapsed;
+
+
+	status = startShuntConversionINA219(shuntAdcCode);
+	if (status != kWarpStatusOK)
+	{
+		return status;
+	}
+
+	start = warpTimestampMicroseconds();
+	if (workload != NULL)
+	{
+		workload();
+	}
+	elapsed = warpTimestampMicroseconds() - start;
+
+	while (warpTimestampMicroseconds() - start < windowMicroseconds(shuntAdcCode))
+	{
+		OSA_TimeDelay(1);
+	}
+
+	*elapsedMicroseconds = elapsed;
+
+	return readShuntConversionINA219(shuntCounts);
+}
+
+WarpStatus
+warpEnergyProfile(WarpEnergyWorkload workload, uint8_t runs, WarpEnergyProfile *  profile)
+{
+	WarpStatus	status;
+	uint8_t		shuntAdcCode;
+	uint32_t	window, elapsed, idleElapsed;
+	uint32_t	totalMicroseconds = 0;
+	int16_t		idleCounts, workloadCounts;
+	int32_t		charge;
+	int64_t		microcharge, totalCharge = 0;
+
+
+	if (runs == 0)
+	{
+		return kWarpStatusBadDeviceCommand;
+	}
+
+	/*
+	 *	The first run also takes any one-off costs (device wake-up,
+	 *	display setup) out of the measured ones.
+	 */
+	elapsed = warpTimestampMicroseconds();
+	workload();
+	elapsed = warpTimestampMicroseconds() - elapsed;
+
+	shuntAdcCode = kWarpINA219SadcAverage2;
+	while ((shuntAdcCode < kWarpINA219SadcAverage128) && (windowMicroseconds(shuntAdcCode) < elapsed + elapsed / 4))
+	{
+		shuntAdcCode++;
+	}
+	window = windowMicroseconds(shuntAdcCode);
+
+	profile->windowMicroseconds	= window;
+	profile->runs			= runs;
+	profile->extrapolated		= false;
+	profile->minimumNanocoulombs	= INT32_MAX;
+	profile->maximumNanocoulombs	= INT32_MIN;
+
+	for (uint8_t i = 0; i < runs; i++)
+	{
+		status = measureWindow(shuntAdcCode, NULL, &idleCounts, &idleElapsed);
+		if (status != kWarpStatusOK)
+		{
+			return status;
+		}
+
+		status = measureWindow(shuntAdcCode, workload, &workloadCounts, &elapsed);
+		if (status != kWarpStatusOK)
+		{
+			return status;
+		}
+
+		/*
+		 *	counts x 10uV / R mR is in mA, and mA x us is nC.
+		 */
+		if (elapsed > window)
+		{
+			microcharge = (int64_t)workloadCounts * elapsed;
+			profile->extrapolated = true;
+		}
+		else
+		{
+			microcharge = (int64_t)workloadCounts * window - (int64_t)idleCounts * (window - elapsed);
+		}
+		charge = (int32_t)((microcharge * kWarpINA219MicrovoltsPerShuntCount) / kWarpINA219ShuntMilliohms);
+
+		if (charge < profile->minimumNanocoulombs)
+		{
+			profile->minimumNanocoulombs = charge;
+		}
+		if (charge > profile->maximumNanocoulombs)
+		{
+			profile->maximumNanocoulombs = charge;
+		}
+		totalCharge += charge;
+		totalMicroseconds += elapsed;
+	}
+
+	profile->meanNanocoulombs	= (int32_t)(totalCharge / runs);
+	profile->meanMicroseconds	= totalMicroseconds / runs;
+
+	/*
+	 *	Back to the power-on configuration (continuous shunt and bus).
+	 */
+	return writeSensorRegisterINA219(kWarpSensorConfigurationRegisterINA219_Configuration, kWarpINA219ConfigurationDefault, 0 /* menuI2cPullupValue */);
+}
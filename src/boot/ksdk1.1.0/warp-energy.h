@@ -0,0 +1,74 @@
+/*
+	Energy-per-operation profiling on the INA219 for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Charge drawn from the supply by one run of a workload, measured with
+ *	the INA219 shunt ADC. The workload owns the CPU and usually the I2C
+ *	bus the INA219 sits on, so it cannot be sampled while it runs;
+ *	instead the INA219 averages over a hardware window (one triggered
+ *	conversion, up to 128 samples) that the workload runs inside:
+ *
+ *	-	an idle window, with the CPU waiting in OSA_TimeDelay(),
+ *		gives the baseline current;
+ *
+ *	-	a workload window, starting the workload as the conversion
+ *		starts and waiting out the rest of it, gives the average
+ *		over the workload plus the idle remainder.
+ *
+ *	The charge of one run is then workload average x window minus
+ *	baseline x (window - run time). The window is the shortest that
+ *	covers a first, untimed run with a quarter to spare. A workload
+ *	longer than the 68ms maximum fills the whole window, and its charge
+ *	is the window's average current times its run time (flagged
+ *	extrapolated: right for steady loads such as a display redraw). One
+ *	shunt count is 100uA through the 100mR shunt, so short workloads
+ *	need several runs for a useful mean.
+ */
+typedef void	(* WarpEnergyWorkload)(void);
+
+typedef struct
+{
+	int32_t		minimumNanocoulombs;
+	int32_t		meanNanocoulombs;
+	int32_t		maximumNanocoulombs;
+	uint32_t	meanMicroseconds;
+	uint32_t	windowMicroseconds;
+	uint8_t		runs;
+	bool		extrapolated;
+} WarpEnergyProfile;
+
+WarpStatus	warpEnergyProfile(WarpEnergyWorkload workload, uint8_t runs, WarpEnergyProfile *  profile);
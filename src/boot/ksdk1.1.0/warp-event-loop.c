@@ -0,0 +1,306 @@
+/*
+	Cooperative low-power event loop for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_interrupt_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+
+#include "SEGGER_RTT.h"
+#include "warp.h"
+#include "warp-event-loop.h"
+
+
+/*
+ *	One flag per source rather than a mask: interrupt handlers only ever
+ *	set a flag and the loop only ever clears one, each a single byte
+ *	store, so neither needs the other to be masked.
+ */
+static volatile bool	gWarpEventPending[kWarpEventSourceCount];
+
+
+
+void
+warpEventLoopInit(WarpEventLoop *  loop, WarpEventTimer *  timers, uint8_t numberOfTimers, void *  context)
+{
+	for (uint8_t i = 0; i < kWarpEventSourceCount; i++)
+	{
+		loop->sourceHandlers[i]	= NULL;
+		gWarpEventPending[i]	= false;
+	}
+
+	for (uint8_t i = 0; i < numberOfTimers; i++)
+	{
+		timers[i].armed = false;
+	}
+
+	loop->timers			= timers;
+	loop->numberOfTimers		= numberOfTimers;
+	loop->context			= context;
+	loop->keyPollMicroseconds	= kWarpEventLoopKeyPollMicroseconds;
+	loop->sleeps			= 0;
+	loop->holdClocks		= false;
+	loop->stopped			= false;
+}
+
+void
+warpEventLoopSetHandler(WarpEventLoop *  loop, WarpEventSource source, WarpEventHandler handler)
+{
+	loop->sourceHandlers[source] = handler;
+}
+
+void
+warpEventLoopStartTimer(WarpEventLoop *  loop, uint8_t timer, uint32_t delayMicroseconds)
+{
+	loop->timers[timer].dueMicroseconds	= warpTimestampMicroseconds() + delayMicroseconds;
+	loop->timers[timer].armed		= true;
+}
+
+void
+warpEventLoopStopTimer(WarpEventLoop *  loop, uint8_t timer)
+{
+	loop->timers[timer].armed = false;
+}
+
+/*
+ *	Safe to call from interrupt handlers.
+ */
+void
+warpEventLoopSignal(WarpEventSource source)
+{
+	gWarpEventPending[source] = true;
+}
+
+void
+warpEventLoopStop(WarpEventLoop *  loop)
+{
+	loop->stopped = true;
+}
+
+static bool
+anySourcePending(void)
+{
+	for (uint8_t i = 0; i < kWarpEventSourceCount; i++)
+	{
+		if (gWarpEventPending[i])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void
+dispatchSources(WarpEventLoop *  loop)
+{
+	if (loop->sourceHandlers[kWarpEventSourceRttKey] != NULL && SEGGER_RTT_HasKey())
+	{
+		gWarpEventPending[kWarpEventSourceRttKey] = true;
+	}
+
+	for (uint8_t i = 0; i < kWarpEventSourceCount && !loop->stopped; i++)
+	{
+		if (!gWarpEventPending[i])
+		{
+			continue;
+		}
+
+		/*
+		 *	Cleared before the handler runs, so that a signal raised
+		 *	while it runs gets it called again rather than lost.
+		 */
+		gWarpEventPending[i] = false;
+		if (loop->sourceHandlers[i] != NULL)
+		{
+			loop->sourceHandlers[i](loop);
+		}
+	}
+}
+
+/*
+ *	Run the timers that are due and return the time to the earliest
+ *	deadline still armed, or INT32_MAX if there is none.
+ */
+static int32_t
+dispatchTimers(WarpEventLoop *  loop)
+{
+	WarpEventTimer *	timer;
+	uint32_t		nowMicroseconds;
+	uint32_t		late;
+	int32_t			untilDue, earliest = INT32_MAX;
+
+
+	for (uint8_t i = 0; i < loop->numberOfTimers && !loop->stopped; i++)
+	{
+		timer = &loop->timers[i];
+		nowMicroseconds = warpTimestampMicroseconds();
+		untilDue = (int32_t)(timer->dueMicroseconds - nowMicroseconds);
+
+		if (timer->armed && untilDue <= 0)
+		{
+			if (timer->periodMicroseconds == 0)
+			{
+				timer->armed = false;
+			}
+			else
+			{
+				late = nowMicroseconds - timer->dueMicroseconds;
+				timer->dueMicroseconds += timer->periodMicroseconds;
+				if (late >= timer->periodMicroseconds)
+				{
+					timer->dueMicroseconds += (late / timer->periodMicroseconds) * timer->periodMicroseconds;
+				}
+			}
+
+			timer->handler(loop);
+
+			/*
+			 *	The handler may have restarted or stopped any timer,
+			 *	so work the deadline out afresh.
+			 */
+			untilDue = (int32_t)(timer->dueMicroseconds - warpTimestampMicroseconds());
+		}
+
+		if (timer->armed && untilDue < earliest)
+		{
+			earliest = untilDue;
+		}
+	}
+
+	return earliest;
+}
+
+/*
+ *	Interrupts are masked from the last look at the pending flags until
+ *	after the sleep, so that a signal raised in between cannot leave us
+ *	asleep until the next deadline: WFI still wakes on an interrupt that
+ *	is pending but masked, and its handler runs once they are unmasked.
+ *	A handler that holds the clocks gets VLPW (or WAIT from RUN, where
+ *	VLPW is not a legal transition) instead of VLPS. warpSetLowPowerMode()
+ *	leaves the clocks at their VLPR configuration after any sleep, so a
+ *	loop entered in RUN (menu item 'r') switches back to it.
+ */
+static void
+sleepFor(WarpEventLoop *  loop, int32_t waitMicroseconds)
+{
+	WarpPowerMode	powerMode = kWarpPowerModeVLPS;
+	uint32_t	sleepMilliseconds = ((uint32_t)waitMicroseconds + 999) / 1000;
+	bool		inRunMode = (POWER_SYS_GetCurrentMode() == kPowerManagerRun);
+
+
+	if (loop->holdClocks)
+	{
+		powerMode = inRunMode ? kWarpPowerModeWAIT : kWarpPowerModeVLPW;
+	}
+
+	INT_SYS_DisableIRQGlobal();
+	if (!anySourcePending())
+	{
+		warpSetLowPowerModeMilliseconds(powerMode, min(sleepMilliseconds, kWarpLowPowerMaxLptmrMilliseconds));
+		loop->sleeps++;
+	}
+	INT_SYS_EnableIRQGlobal();
+
+	if (inRunMode)
+	{
+		warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
+	}
+}
+
+void
+warpEventLoopRun(WarpEventLoop *  loop)
+{
+	int32_t		waitMicroseconds;
+
+
+	loop->stopped = false;
+	while (!loop->stopped)
+	{
+		dispatchSources(loop);
+		waitMicroseconds = dispatchTimers(loop);
+
+		if (loop->stopped || anySourcePending() || waitMicroseconds <= 0)
+		{
+			continue;
+		}
+
+		if (loop->sourceHandlers[kWarpEventSourceRttKey] != NULL && waitMicroseconds > (int32_t)loop->keyPollMicroseconds)
+		{
+			waitMicroseconds = loop->keyPollMicroseconds;
+		}
+
+		sleepFor(loop, waitMicroseconds);
+	}
+}
+
+
+
+static void
+storeKey(WarpEventLoop *  loop)
+{
+	*(int *)loop->context = SEGGER_RTT_GetKey();
+	warpEventLoopStop(loop);
+}
+
+/*
+ *	SEGGER_RTT_WaitKey(), but asleep between polls instead of spinning.
+ */
+int
+warpEventLoopWaitKey(void)
+{
+	WarpEventLoop	loop;
+	int		key = -1;
+
+
+	warpEventLoopInit(&loop, NULL, 0, &key);
+	warpEventLoopSetHandler(&loop, kWarpEventSourceRttKey, storeKey);
+	while (key < 0)
+	{
+		warpEventLoopRun(&loop);
+	}
+
+	return key;
+}
@@ -0,0 +1,107 @@
+/*
+	Cooperative low-power event loop for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	A single-threaded event loop that sleeps whenever it has nothing to do.
+ *	Work arrives from three kinds of sources:
+ *
+ *	-	Interrupt sources. The interrupt handler does the minimum (e.g.,
+ *		the MMA8451Q sampler queues the sample) and calls
+ *		warpEventLoopSignal(); the loop then runs the source's handler
+ *		from thread context.
+ *
+ *	-	The RTT key. RTT has no interrupt, since the debugger writes the
+ *		down buffer behind the CPU's back, so while a key handler is
+ *		installed the loop wakes every keyPollMicroseconds to look.
+ *
+ *	-	Timers, one-shot (periodMicroseconds 0) or periodic. Periodic
+ *		deadlines advance by whole periods, skipping any that have
+ *		already gone by, as in warp-scheduler.c.
+ *
+ *	When no source is pending the loop sleeps until the earliest timer
+ *	deadline or key poll, woken by the LPTMR compare (or earlier by any
+ *	interrupt), in VLPS, or in VLPW/WAIT while a handler has set
+ *	holdClocks because it left a peripheral running off the bus clock.
+ *	Handlers run to completion and must not block; a handler calls
+ *	warpEventLoopStop() to make warpEventLoopRun() return. Times are
+ *	warpTimestampMicroseconds() values and are only compared as
+ *	differences.
+ */
+typedef enum
+{
+	kWarpEventSourceAcceleration		= 0,	/*	MMA8451Q INT1, PORTB		*/
+	kWarpEventSourceRtcAlarm		= 1,
+	kWarpEventSourceRttKey			= 2,	/*	polled				*/
+	kWarpEventSourceCount			= 3,
+} WarpEventSource;
+
+typedef enum
+{
+	kWarpEventLoopKeyPollMicroseconds	= 50000,
+} WarpEventLoopConstants;
+
+typedef struct WarpEventLoop	WarpEventLoop;
+typedef void			(* WarpEventHandler)(WarpEventLoop *  loop);
+
+typedef struct
+{
+	WarpEventHandler	handler;
+	uint32_t		periodMicroseconds;	/*	0 for a one-shot timer	*/
+	uint32_t		dueMicroseconds;
+	bool			armed;
+} WarpEventTimer;
+
+struct WarpEventLoop
+{
+	WarpEventHandler	sourceHandlers[kWarpEventSourceCount];
+	WarpEventTimer *	timers;
+	void *			context;
+	uint32_t		keyPollMicroseconds;
+	uint32_t		sleeps;
+	uint8_t			numberOfTimers;
+	bool			holdClocks;
+	bool			stopped;
+};
+
+void	warpEventLoopInit(WarpEventLoop *  loop, WarpEventTimer *  timers, uint8_t numberOfTimers, void *  context);
+void	warpEventLoopSetHandler(WarpEventLoop *  loop, WarpEventSource source, WarpEventHandler handler);
+void	warpEventLoopStartTimer(WarpEventLoop *  loop, uint8_t timer, uint32_t delayMicroseconds);
+void	warpEventLoopStopTimer(WarpEventLoop *  loop, uint8_t timer);
+void	warpEventLoopSignal(WarpEventSource source);
+void	warpEventLoopStop(WarpEventLoop *  loop);
+void	warpEventLoopRun(WarpEventLoop *  loop);
+int	warpEventLoopWaitKey(void);
@@ -0,0 +1,245 @@
+/*
+	I2C bus clock and pull-up tuning for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <string.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+
+#include "warp.h"
+#include "warp-i2c-tuning.h"
+
+
+extern volatile uint32_t	gWarpI2cBaudRateKbps;
+
+/*
+ *	Slowest first: the reference read is made at the first, and each
+ *	probe stops at its maximumBaudRateKbps. Every sensor in the tree
+ *	tops out at the 400 kb/s of fast mode, so the list ends there.
+ */
+static const uint16_t		candidateBaudRatesKbps[] = {50, 100, 200, 300, 400};
+
+typedef struct
+{
+	uint8_t		address;
+	uint16_t	baudRateKbps;
+} WarpI2cTuningEntry;
+
+static WarpI2cTuningEntry	tuningTable[kWarpI2cTuningMaxDevices];
+static uint8_t			tuningEntries;
+
+
+
+uint32_t
+warpI2cBaudRateKbps(uint8_t address)
+{
+	for (uint8_t i = 0; i < tuningEntries; i++)
+	{
+		if (tuningTable[i].address == address)
+		{
+			return tuningTable[i].baudRateKbps;
+		}
+	}
+
+	return gWarpI2cBaudRateKbps;
+}
+
+void
+warpI2cTuningReset(void)
+{
+	tuningEntries = 0;
+}
+
+/*
+ *	kWarpI2cTuningAttempts reads of the probe register at the device's
+ *	current table rate; returns the mean time per read.
+ */
+static uint32_t
+measureProbe(const WarpI2cTuningProbe *  probe, const uint8_t *  reference, uint8_t *  successes)
+{
+	uint32_t	start = warpTimestampMicroseconds();
+
+	*successes = 0;
+	for (int attempt = 0; attempt < kWarpI2cTuningAttempts; attempt++)
+	{
+		if ((probe->readSensorRegisterFunction(probe->deviceRegister, probe->numberOfBytes) == kWarpStatusOK)
+			&& (memcmp((const uint8_t *)probe->deviceState->i2cBuffer, reference, probe->numberOfBytes) == 0))
+		{
+			(*successes)++;
+		}
+	}
+
+	return (warpTimestampMicroseconds() - start) / kWarpI2cTuningAttempts;
+}
+
+/*
+ *	Returns the fastest reliable rate for the probe's device at the
+ *	current pull-up, or 0 if it has none, and adds its mean read time to
+ *	*totalMicroseconds. The device's table entry is left at the last
+ *	rate tried.
+ */
+static uint16_t
+tuneProbe(const WarpI2cTuningProbe *  probe, WarpI2cTuningEntry *  entry, uint8_t pullupValue,
+	WarpI2cTuningReport report, uint32_t *  totalMicroseconds)
+{
+	WarpI2cTuningResult	result;
+	uint8_t			reference[kWarpSizesI2cBufferBytes];
+	uint32_t		bestMicroseconds = UINT32_MAX;
+	uint16_t		bestBaudRateKbps = 0;
+
+
+	result.address		= entry->address;
+	result.pullupValue	= pullupValue;
+	result.attempts		= kWarpI2cTuningAttempts;
+
+	entry->baudRateKbps = candidateBaudRatesKbps[0];
+	if (probe->readSensorRegisterFunction(probe->deviceRegister, probe->numberOfBytes) != kWarpStatusOK)
+	{
+		result.baudRateKbps	= entry->baudRateKbps;
+		result.successes	= 0;
+		result.attempts		= 1;
+		result.meanMicroseconds	= 0;
+		report(&result);
+
+		return 0;
+	}
+	memcpy(reference, (const uint8_t *)probe->deviceState->i2cBuffer, probe->numberOfBytes);
+
+	for (size_t i = 0; i < sizeof(candidateBaudRatesKbps)/sizeof(candidateBaudRatesKbps[0]); i++)
+	{
+		if (candidateBaudRatesKbps[i] > probe->maximumBaudRateKbps)
+		{
+			break;
+		}
+
+		entry->baudRateKbps = candidateBaudRatesKbps[i];
+		result.baudRateKbps = entry->baudRateKbps;
+		result.meanMicroseconds = measureProbe(probe, reference, &result.successes);
+		report(&result);
+
+		if ((result.successes == kWarpI2cTuningAttempts) && (result.meanMicroseconds < bestMicroseconds))
+		{
+			bestMicroseconds = result.meanMicroseconds;
+			bestBaudRateKbps = entry->baudRateKbps;
+		}
+	}
+
+	if (bestBaudRateKbps != 0)
+	{
+		*totalMicroseconds += bestMicroseconds;
+	}
+
+	return bestBaudRateKbps;
+}
+
+WarpStatus
+warpI2cTune(const WarpI2cTuningProbe *  probes, uint8_t numberOfProbes,
+	const uint8_t *  pullupValues, uint8_t numberOfPullupValues,
+	WarpI2cTuningReport report, uint8_t *  pullupValue)
+{
+	uint16_t	baudRatesKbps[kWarpI2cTuningMaxDevices];
+	uint16_t	chosenBaudRatesKbps[kWarpI2cTuningMaxDevices];
+	uint32_t	totalMicroseconds;
+	uint32_t	chosenTotalMicroseconds = UINT32_MAX;
+	uint8_t		reliable;
+	uint8_t		chosenReliable = 0;
+	uint8_t		chosenPullup = 0;
+	uint8_t		d;
+
+
+	if ((numberOfProbes > kWarpI2cTuningMaxDevices) || (numberOfPullupValues == 0))
+	{
+		return kWarpStatusBadDeviceCommand;
+	}
+
+	/*
+	 *	Entry d belongs to probe d while tuning.
+	 */
+	for (d = 0; d < numberOfProbes; d++)
+	{
+		tuningTable[d].address = probes[d].deviceState->i2cAddress;
+		chosenBaudRatesKbps[d] = 0;
+	}
+	tuningEntries = numberOfProbes;
+
+	for (uint8_t p = 0; p < numberOfPullupValues; p++)
+	{
+		configureI2Cpins(pullupValues[p]);
+
+		totalMicroseconds = 0;
+		reliable = 0;
+		for (d = 0; d < numberOfProbes; d++)
+		{
+			baudRatesKbps[d] = tuneProbe(&probes[d], &tuningTable[d], pullupValues[p], report, &totalMicroseconds);
+			reliable += (baudRatesKbps[d] != 0);
+		}
+
+		if ((reliable > chosenReliable) || ((reliable == chosenReliable) && (totalMicroseconds < chosenTotalMicroseconds)))
+		{
+			chosenReliable = reliable;
+			chosenTotalMicroseconds = totalMicroseconds;
+			chosenPullup = p;
+			memcpy(chosenBaudRatesKbps, baudRatesKbps, numberOfProbes * sizeof(baudRatesKbps[0]));
+		}
+	}
+
+	/*
+	 *	Devices without a reliable rate go back to gWarpI2cBaudRateKbps.
+	 */
+	tuningEntries = 0;
+	for (d = 0; d < numberOfProbes; d++)
+	{
+		if (chosenBaudRatesKbps[d] != 0)
+		{
+			tuningTable[tuningEntries].address = probes[d].deviceState->i2cAddress;
+			tuningTable[tuningEntries].baudRateKbps = chosenBaudRatesKbps[d];
+			tuningEntries++;
+		}
+	}
+
+	configureI2Cpins(pullupValues[chosenPullup]);
+	*pullupValue = pullupValues[chosenPullup];
+
+	return (chosenReliable == 0) ? kWarpStatusDeviceCommunicationFailed : kWarpStatusOK;
+}
@@ -0,0 +1,90 @@
+/*
+	I2C bus clock and pull-up tuning for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Per-device I2C bus clock. Every driver builds its i2c_device_t with
+ *	warpI2cBaudRateKbps(address) (declared in warp.h): the device's
+ *	entry in the table kept here, or gWarpI2cBaudRateKbps for devices
+ *	without one.
+ *
+ *	warpI2cTune() fills the table. For each pull-up value (ISL23415
+ *	DCP setting) and each device it reads the device's probe register
+ *	once at the slowest candidate rate as a reference, then
+ *	kWarpI2cTuningAttempts times at each candidate rate up to the
+ *	device's datasheet maximum, counting the reads that succeed and
+ *	return the reference bytes (so that a rate at which bits are misread
+ *	counts as a failure, not only a rate at which the device NAKs) and
+ *	timing them. Rates beyond the datasheet are never tried: a device
+ *	clocked past them can hold SDA low mid-byte and wedge the bus for
+ *	every other device. A device's setting is the rate with the shortest
+ *	mean read time at which every read succeeded; the slower of two
+ *	rates that the I2C clock divider makes equally fast. The pull-ups
+ *	are on the shared bus, so the pull-up value chosen is the one that
+ *	gives the shortest sum of those times over all devices, among those
+ *	at which every device that answers at all has a reliable rate.
+ */
+typedef enum
+{
+	kWarpI2cTuningMaxDevices	= 10,
+	kWarpI2cTuningAttempts		= 16,
+} WarpI2cTuningConstants;
+
+typedef struct
+{
+	WarpStatus			(* readSensorRegisterFunction)(uint8_t deviceRegister, int numberOfBytes);
+	volatile WarpI2CDeviceState *	deviceState;
+	uint8_t				deviceRegister;	/*	one whose contents do not change, e.g., an ID		*/
+	uint8_t				numberOfBytes;
+	uint16_t			maximumBaudRateKbps;	/*	datasheet SCL maximum, without high-speed mode		*/
+} WarpI2cTuningProbe;
+
+typedef struct
+{
+	uint8_t		address;
+	uint8_t		pullupValue;
+	uint16_t	baudRateKbps;
+	uint8_t		successes;
+	uint8_t		attempts;
+	uint32_t	meanMicroseconds;
+} WarpI2cTuningResult;
+
+typedef void	(* WarpI2cTuningReport)(const WarpI2cTuningResult *  result);
+
+void		warpI2cTuningReset(void);
+WarpStatus	warpI2cTune(const WarpI2cTuningProbe *  probes, uint8_t numberOfProbes,
+			const uint8_t *  pullupValues, uint8_t numberOfPullupValues,
+			WarpI2cTuningReport report, uint8_t *  pullupValue);
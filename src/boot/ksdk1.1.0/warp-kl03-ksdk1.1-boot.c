@@ -55,6 +55,15 @@
 #include "gpio_pins.h"
 #include "SEGGER_RTT.h"
 #include "warp.h"
+#include "warp-log.h"
+#include "warp-ahrs.h"
+#include "warp-pedometer.h"
+#include "warp-activity.h"
+#include "warp-scheduler.h"
+#include "warp-event-loop.h"
+#include "warp-energy.h"
+#include "warp-capture.h"
+#include "warp-i2c-tuning.h"
 
 
 #define WARP_FRDMKL03
@@ -90,9 +99,18 @@
 #	include "devINA219.h"
 #endif
 
+/*
+ *	The MMA8451Q INT1 line is jumpered to PTB2, which is the ADXL362 chip
+ *	select on Warp. The two cannot be enabled together.
+ */
+#if defined(WARP_BUILD_ENABLE_DEVMMA8451Q) && defined(WARP_BUILD_ENABLE_DEVADXL362)
+#	error "MMA8451Q INT1 and ADXL362_CS share PTB2"
+#endif
+
 
 #define WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
 //#define WARP_BUILD_BOOT_TO_CSVSTREAM
+//#define WARP_BUILD_BOOT_TO_BINARYSTREAM
 
 
 /*
@@ -214,6 +232,30 @@ volatile uint32_t			gWarpI2cTimeoutMilliseconds	= 5;
 volatile uint32_t			gWarpSpiTimeoutMicroseconds	= 5;
 volatile uint32_t			gWarpMenuPrintDelayMilliseconds	= 10;
 volatile uint32_t			gWarpSupplySettlingDelayMilliseconds = 1;
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+volatile uint32_t			gWarpAccelerationWakeupTimeoutSeconds = 5;
+volatile bool				gWarpAccelerationInterruptPending;
+WarpAccelerationRing * volatile		gWarpAccelerationSamplerRing;
+#endif
+
+/*
+ *	Working storage for the menu commands that would not fit on the
+ *	512-byte stack. Only one of them runs at a time (runPedometer() at
+ *	boot returns before the menu starts), so they share it, and the
+ *	union costs the 280 bytes of its largest member instead of the 620
+ *	bytes of all three out of the KL03's 2 KB of RAM. A command that
+ *	needs more than a few tens of bytes of static storage belongs here.
+ */
+static union
+{
+	WarpActivityEngine	activityEngine;					/*	runPedometer(), 148 bytes					*/
+#if defined(WARP_BUILD_ENABLE_DEVMMA8451Q) || defined(WARP_BUILD_ENABLE_DEVL3GD20H) || defined(WARP_BUILD_ENABLE_DEVBMX055)
+	int16_t			fifoSamples[kWarpMMA8451QFifoDepth * 3];	/*	the FIFO streamers, all 32 samples deep, 192 bytes		*/
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+	WarpCaptureRing		currentCapture;					/*	runCurrentCapture(), 280 bytes					*/
+#endif
+} gWarpMenuScratch;
 
 void					sleepUntilReset(void);
 void					lowPowerPinStates(void);
@@ -226,6 +268,17 @@ void					printPinDirections(void);
 void					dumpProcessorState(void);
 //added runPedometer function
 void					runPedometer(void);
+void					runAccelerationFifoStream(int batches);
+void					runGyroFifoStream(int batches);
+void					runImuFifoStream(int batches);
+void					runOrientationFilter(uint16_t sampleRateHz, uint16_t outputDivider, int numberOfOutputs);
+void					runEnergyProfiles(uint8_t runs, uint16_t menuI2cPullupValue);
+void					runCurrentCapture(WarpCaptureTrigger trigger, int16_t level, uint16_t menuI2cPullupValue);
+uint16_t				runI2cTuning(uint16_t menuI2cPullupValue);
+WarpStatus				enableAccelerationFifoStream(uint8_t watermark, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue);
+WarpStatus				enableAccelerationSampler(WarpAccelerationRing *  ring, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue);
+void					disableAccelerationInterrupts(uint16_t menuI2cPullupValue);
+WarpStatus				warpSleepUntilAccelerationFifo(WarpAccelerationRing *  ring, uint8_t *  samplesRead);
 void					repeatRegisterReadForDeviceAndAddress(WarpSensorDevice warpSensorDevice, uint8_t baseAddress, 
 								uint8_t pullupValue, bool autoIncrement, int chunkReadsPerAddress, bool chatty,
 								int spinDelay, int repetitionsPerAddress, uint16_t sssupplyMillivolts,
@@ -238,6 +291,8 @@ void					powerupAllSensors(void);
 uint8_t					readHexByte(void);
 int					read4digits(void);
 void					printAllSensors(bool printHeadersAndCalibration, bool hexModeFlag, int menuDelayBetweenEachRun, int i2cPullupValue);
+void					streamAllSensorsBinary(int menuDelayBetweenEachRun, int i2cPullupValue, uint32_t numberOfFrames);
+void					printScheduledSensors(bool hexModeFlag, int i2cPullupValue, uint32_t numberOfRecords);
 
 
 /*
@@ -248,6 +303,7 @@ WarpStatus				writeBytesToSpi(uint8_t *  payloadBytes, int payloadLength);
 
 
 void					warpLowPowerSecondsSleep(uint32_t sleepSeconds, bool forceAllPinsIntoLowPowerState);
+void					warpLowPowerMillisecondsSleep(uint32_t sleepMilliseconds, bool forceAllPinsIntoLowPowerState);
 
 
 
@@ -302,6 +358,7 @@ RTC_IRQHandler(void)
 	if (RTC_DRV_IsAlarmPending(0))
 	{
 		RTC_DRV_SetAlarmIntCmd(0, false);
+		warpEventLoopSignal(kWarpEventSourceRtcAlarm);
 	}
 }
 
@@ -314,6 +371,73 @@ RTC_Seconds_IRQHandler(void)
 	gWarpSleeptimeSeconds++;
 }
 
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+static void
+sampleAccelerationFromInterrupt(WarpAccelerationRing *  ring)
+{
+	uint32_t	timestamp = warpTimestampMicroseconds();
+	int16_t		xyz[3];
+	uint16_t	index;
+
+	/*
+	 *	Always read, even into a full ring: reading OUT_X_MSB..OUT_Z_LSB
+	 *	is what clears SRC_DRDY and releases INT1 for the next sample.
+	 */
+	if (readSensorXYZMMA8451Q(xyz) != kWarpStatusOK)
+	{
+		return;
+	}
+
+	if ((uint16_t)(ring->head - ring->tail) >= ring->capacity)
+	{
+		ring->overruns++;
+
+		return;
+	}
+
+	index = ring->head & (ring->capacity - 1);
+	ring->samples[3*index]		= xyz[0];
+	ring->samples[3*index + 1]	= xyz[1];
+	ring->samples[3*index + 2]	= xyz[2];
+	ring->timestamps[index]		= timestamp;
+	ring->head++;
+}
+
+/*
+ *	Override the PORTB pin detect IRQ handler: MMA8451Q INT1. In sampler
+ *	mode the handler reads the sample itself; otherwise (FIFO streaming)
+ *	it only flags the wakeup.
+ */
+void
+PORTB_IRQHandler(void)
+{
+	GPIO_DRV_ClearPinIntFlag(kWarpPinMMA8451Q_INT1);
+
+	if (gWarpAccelerationSamplerRing != NULL)
+	{
+		sampleAccelerationFromInterrupt(gWarpAccelerationSamplerRing);
+	}
+
+	gWarpAccelerationInterruptPending = true;
+	warpEventLoopSignal(kWarpEventSourceAcceleration);
+}
+
+/*
+ *	sampleAccelerationFromInterrupt() from thread context. PORTB is
+ *	masked so that the INT1 handler cannot start a second I2C transfer,
+ *	or write the ring, in the middle of this one; an edge meanwhile is
+ *	taken once it is unmasked. The I2C0 interrupt that completes the
+ *	transfer stays enabled.
+ */
+static void
+sampleAccelerationMasked(WarpAccelerationRing *  ring)
+{
+	INT_SYS_DisableIRQ(PORTB_IRQn);
+	sampleAccelerationFromInterrupt(ring);
+	INT_SYS_EnableIRQ(PORTB_IRQn);
+}
+#endif
+
 /*
  *	Power manager user callback
  */
@@ -946,6 +1070,31 @@ warpLowPowerSecondsSleep(uint32_t sleepSeconds, bool forceAllPinsIntoLowPowerSta
 	warpSetLowPowerMode(kWarpPowerModeVLPS, sleepSeconds);
 }
 
+/*
+ *	As warpLowPowerSecondsSleep(), but woken by the LPTMR instead of the
+ *	RTC alarm, for duty cycles faster than 1Hz. Sleeps longer than the
+ *	16-bit LPTMR compare are split. As with the RTC alarm, any other
+ *	enabled interrupt ends the current sleep early.
+ */
+void
+warpLowPowerMillisecondsSleep(uint32_t sleepMilliseconds, bool forceAllPinsIntoLowPowerState)
+{
+	uint32_t	chunkMilliseconds;
+
+	if (forceAllPinsIntoLowPowerState)
+	{
+		lowPowerPinStates();
+	}
+
+	warpSetLowPowerMode(kWarpPowerModeVLPR, 0);
+	while (sleepMilliseconds > 0)
+	{
+		chunkMilliseconds = min(sleepMilliseconds, kWarpLowPowerMaxLptmrMilliseconds);
+		warpSetLowPowerModeMilliseconds(kWarpPowerModeVLPS, chunkMilliseconds);
+		sleepMilliseconds -= chunkMilliseconds;
+	}
+}
+
 
 
 void
@@ -1065,1941 +1214,3449 @@ SEGGER_RTT_printf(0, "\r\tRTC clock: %d\n", RTC->TSR);
 	
 */
 }
-// runPedometer function defined here
-
-void
-runPedometer(void)
-{	
-SEGGER_RTT_printf(0, "\r\tRTC clock: %d\n", RTC->TSR);
-//int for clock
-int start_time = RTC->TSR;
-int current_time;
-int disp_time;
-
-int td1;
-int td2;
-int td3;
-int td4;
-int td5;
-int td6;
-	
-int td1s = 0;
-int td2s = 0;
-int td3s = 0;
-int td4s = 0;
-int td5s = 0;
-int td6s = 0;	
-
-int disp_time_stored = 0;
-	
-//for reading	
-int16_t		xreading;
-int16_t		yreading;
-int16_t		zreading;
-int		xyz = 0;
-int16_t reading[3];
-int16_t largestxyz = 0;
-int16_t storedxyz = 0;	
-int length = 400;
-int16_t accdata[400];
-bool hexModeFlag = 1;
-	
-//For step count	
-int step_count=0;
-int up;
-int down;
-int avg_count;
-//Configure accelerometer
-	
-uint16_t	menuI2cPullupValue = 32768;	
-enableI2Cpins(menuI2cPullupValue);
-#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-		configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
-		0x01,/* Normal read 8bit, 800Hz, normal, active mode */
-		menuI2cPullupValue
-		);
-#endif
+typedef enum
+{
+	kWarpPedometerTimerDisplay		= 0,
+	kWarpPedometerTimerWatchdog		= 1,
+	kWarpPedometerTimers			= 2,
+	kWarpPedometerDisplaySeconds		= 5,
+} WarpPedometerConstants;
 
+typedef struct
+{
+	WarpAccelerationRing		ring;
+	WarpMagnitudeStepDetector	detector;
+	SSD1331TextField		timeField;
+	SSD1331TextField		stepsField;
+	SSD1331TextField		averageField;
+	uint32_t			startSeconds;
+	bool				started;
+} WarpPedometerSession;
 
-//for filter
-int16_t filtdata[400];
-	
-for(int q=0; q<400; q++)
+/*
+ *	Everything queued by the INT1 handler since the last call. The first
+ *	sample starts the clock, and with it the display timer; every batch
+ *	pushes the watchdog back. The clock is the RTC seconds counter: the
+ *	microsecond timestamps wrap after about 71 minutes.
+ */
+static void
+pedometerSamples(WarpEventLoop *  loop)
 {
-	//need to loop through
-	
-	//get time in seconds
-	current_time = RTC->TSR;
-	disp_time = current_time - start_time;
-	//SEGGER_RTT_printf(0, "\r\tdisplay time: %d\n", disp_time);
-
-	//read from accelerometer all
-				xyz = 0;
-				xreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-				xyz = 1;
-				yreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-				xyz = 2;
-				zreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-	
-	
-	reading[0] = xreading;
-	reading[1] = yreading;
-	reading[2] = zreading;
-		
-	//choose largest
-	for(int d=0; d<3; d++)
-		{
-			//SEGGER_RTT_printf(0, "\r\td reading HERE %d\n", d);
-			if(reading[d]*reading[d]>largestxyz*largestxyz)
-				{
-				largestxyz = reading[d];
-				}
-		}
-	
-	// add to array and filter
-	//filter - descrete low pass filter with a 5Hz frequency cut off at 0.02 sec -> alpha = 0.4
-	
-	//SEGGER_RTT_printf(0, "\r\tlargest acc %d\n", largestxyz);
-	accdata[q] = largestxyz;
-	filtdata[q] = 2*largestxyz/5 + 3*storedxyz/5;
-	storedxyz = accdata[q];
-	//SEGGER_RTT_printf(0, "\r\t %d\n", accdata[q]);
-	largestxyz = 0;
-	//SEGGER_RTT_printf(0, "\r\t %d\n", filtdata[q]);
-	if(filtdata[q]>4400)
-		{
-		up = 1;
-		}
-	if(filtdata[q]<3900)
-		{
-		down = 1;
-		}
-	if(up!=0 && down!=0)
+	WarpPedometerSession *	session = (WarpPedometerSession *)loop->context;
+	WarpAccelerationRing *	ring = &session->ring;
+	uint16_t		index;
+
+	while (ring->head != ring->tail)
+	{
+		index = ring->tail & (ring->capacity - 1);
+		if (!session->started)
 		{
-		step_count+=1;
-		up=0;
-		down=0;
+			session->startSeconds = RTC->TSR;
+			session->started = true;
+			warpEventLoopStartTimer(loop, kWarpPedometerTimerDisplay, kWarpPedometerDisplaySeconds * 1000000u);
 		}
-	//convert to minutes
-	OSA_TimeDelay(20);
-	if (disp_time != disp_time_stored && disp_time%5 ==0)
-		{
-		
-		//display time		
-		td6 = disp_time/60;
-		td4 = td6/10;
-		
-		if(td6!=td6s)
-			{
-				devSSD1331symbols(6969,7,2);	
-				devSSD1331symbols(td4,7,2);
-			}
-	
-		td4s = td4;
-		td3 = td6 - td4*10;
-		if(td6!=td6s)
-			{			
-				devSSD1331symbols(6969,8,2);			
-				devSSD1331symbols(td3,8,2);
-				td3s = td3;
-			}
-		
-		
 
-		td5=disp_time-td6*60;
-		td2= td5/10;
-		if(td2!=td2s)
-			{
-				devSSD1331symbols(6969,10,2);			
-				devSSD1331symbols(td2,10,2);
-				//devSSD1331write(step_count/2,11,0);
-				td2s = td2;
-			}
-		
-		td1 = td5-td2*10;
-		devSSD1331symbols(6969,11,2);
-		devSSD1331symbols(td1,11,2);			
-		td1s = td1;
-		disp_time_stored = disp_time;	
-		
+		warpMagnitudeStepDetectorPush(&session->detector, &ring->samples[3*index]);
+		if (warpActivityEnginePush(&gWarpMenuScratch.activityEngine, &ring->samples[3*index]))
+		{
+			SEGGER_RTT_printf(0, "\r\t activity %s cadence %d\n",
+				warpActivityName(gWarpMenuScratch.activityEngine.activity), gWarpMenuScratch.activityEngine.cadence);
 		}
-} // end of for
-step_count = step_count/2;
-SEGGER_RTT_printf(0, "\r\t steps %d\n", step_count);
-devSSD1331write(step_count,11,0);	
-avg_count = step_count*60/disp_time_stored;
-devSSD1331write(avg_count,11,1);	
-disableI2Cpins();
-SEGGER_RTT_printf(0, "\r\t-------------------- %d\n", 1);
-/*
-for(int h=0; h<400; h++)
-	{
-	//SEGGER_RTT_printf(0, "\r\t %d\n", accdata[h]); // this function crashes
+		ring->tail++;
 	}
-*/
-} //end of function
-
 
-
-#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
-void
-addAndMultiplicationBusyLoop(long iterations)
-{
-	int value;
-	for (volatile long i = 0; i < iterations; i++)
-	{
-		value = kWarpThermalChamberBusyLoopAdder + value * kWarpThermalChamberBusyLoopMutiplier;
-	}
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	warpEventLoopStartTimer(loop, kWarpPedometerTimerWatchdog, gWarpAccelerationWakeupTimeoutSeconds * 1000000u);
+#endif
 }
 
-uint8_t
-checkSum(uint8_t *  pointer, uint16_t length) /*	Adapted from https://stackoverflow.com/questions/31151032/writing-an-8-bit-checksum-in-c	*/
+static void
+pedometerDisplay(WarpEventLoop *  loop)
 {
-	unsigned int sum;
-	for ( sum = 0 ; length != 0 ; length-- )
-	{
-		sum += *(pointer++);
-	}
-	return (uint8_t)sum;
+	WarpPedometerSession *	session = (WarpPedometerSession *)loop->context;
+	uint32_t		elapsedSeconds = RTC->TSR - session->startSeconds;
+	uint32_t		steps = session->detector.steps;
+	char			timeText[6];
+
+	/*
+	 *	Display time as "mm ss"
+	 */
+	timeText[0] = '0' + ((elapsedSeconds / 60) % 100) / 10;
+	timeText[1] = '0' + ((elapsedSeconds / 60) % 100) % 10;
+	timeText[2] = ' ';
+	timeText[3] = '0' + (elapsedSeconds % 60) / 10;
+	timeText[4] = '0' + (elapsedSeconds % 60) % 10;
+	timeText[5] = '\0';
+	devSSD1331fieldSetString(&session->timeField, timeText);
+
+	devSSD1331fieldSetInteger(&session->stepsField, steps);
+	devSSD1331fieldSetInteger(&session->averageField, (elapsedSeconds != 0) ? steps * 60 / elapsedSeconds : 0);
+	SEGGER_RTT_printf(0, "\r\t steps %d\n", steps);
 }
-#endif
 
-int
-main(void)
+/*
+ *	No sample for gWarpAccelerationWakeupTimeoutSeconds: a missed edge
+ *	leaves INT1 asserted with no further edges, and taking the sample by
+ *	hand restarts the stream.
+ */
+static void
+pedometerWatchdog(WarpEventLoop *  loop)
 {
-	uint8_t					key;
-	WarpSensorDevice			menuTargetSensor = kWarpSensorBMX055accel;
-	volatile WarpI2CDeviceState *		menuI2cDevice = NULL;
-	uint16_t				menuI2cPullupValue = 32768;
-	uint8_t					menuRegisterAddress = 0x00;
-	uint16_t				menuSupplyVoltage = 0;
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	WarpPedometerSession *	session = (WarpPedometerSession *)loop->context;
 
+	sampleAccelerationMasked(&session->ring);
+#endif
+	warpEventLoopSignal(kWarpEventSourceAcceleration);
+}
 
-	rtc_datetime_t				warpBootDate;
+/*
+ *	The key is left for the menu.
+ */
+static void
+pedometerKey(WarpEventLoop *  loop)
+{
+	warpEventLoopStop(loop);
+}
 
-	power_manager_user_config_t		warpPowerModeWaitConfig;
-	power_manager_user_config_t		warpPowerModeStopConfig;
-	power_manager_user_config_t		warpPowerModeVlpwConfig;
-	power_manager_user_config_t		warpPowerModeVlpsConfig;
-	power_manager_user_config_t		warpPowerModeVlls0Config;
-	power_manager_user_config_t		warpPowerModeVlls1Config;
-	power_manager_user_config_t		warpPowerModeVlls3Config;
-	power_manager_user_config_t		warpPowerModeRunConfig;
+/*
+ *	Samples arrive from the INT1 handler at the accelerometer's own 50Hz
+ *	and go through the constant-memory magnitude step detector of
+ *	warp-pedometer.c, which does not depend on how the board is worn or
+ *	on the accelerometer range. The activity engine of warp-activity.c
+ *	labels each 2.56s window of the same samples (still, walk, run or
+ *	other, with its cadence), and only that label and the step count go
+ *	out on RTT. The time, step count and steps per minute on the display
+ *	are refreshed every five seconds by a timer of their own; the
+ *	retained fields only redraw the digits that changed. All of it runs
+ *	from the event loop of warp-event-loop.c, asleep in VLPS between
+ *	samples, until a key arrives on RTT.
+ */
+void
+runPedometer(void)
+{
+	int16_t				ringSamples[16*3];
+	uint32_t			ringTimestamps[16];
+	WarpPedometerSession		session =
+	{
+		.ring =
+		{
+			.samples = ringSamples,
+			.timestamps = ringTimestamps,
+			.capacity = 16,
+			.head = 0,
+			.tail = 0,
+			.overruns = 0,
+		},
+		.started = false,
+	};
+	WarpEventTimer			timers[kWarpPedometerTimers] =
+	{
+		[kWarpPedometerTimerDisplay]	= {.handler = pedometerDisplay, .periodMicroseconds = kWarpPedometerDisplaySeconds * 1000000u},
+		[kWarpPedometerTimerWatchdog]	= {.handler = pedometerWatchdog, .periodMicroseconds = 0},
+	};
+	WarpEventLoop			loop;
+	uint16_t			menuI2cPullupValue = 32768;
 
-	const power_manager_user_config_t	warpPowerModeVlprConfig = {
-							.mode			= kPowerManagerVlpr,
-							.sleepOnExitValue	= false,
-							.sleepOnExitOption	= false
-						};
+	SEGGER_RTT_printf(0, "\r\tRTC clock: %d\n", RTC->TSR);
 
-	power_manager_user_config_t const *	powerConfigs[] = {
-							/*
-							 *	NOTE: This order is depended on by POWER_SYS_SetMode()
-							 *
-							 *	See KSDK13APIRM.pdf Section 55.5.3
-							 */
-							&warpPowerModeWaitConfig,
-							&warpPowerModeStopConfig,
-							&warpPowerModeVlprConfig,
-							&warpPowerModeVlpwConfig,
-							&warpPowerModeVlpsConfig,
-							&warpPowerModeVlls0Config,
-							&warpPowerModeVlls1Config,
-							&warpPowerModeVlls3Config,
-							&warpPowerModeRunConfig,
-						};
+	devSSD1331fieldInit(&session.timeField, 7, 2, 5);
+	devSSD1331fieldInit(&session.stepsField, 8, 0, 4);
+	devSSD1331fieldInit(&session.averageField, 8, 1, 4);
+	warpMagnitudeStepDetectorInit(&session.detector, kWarpMagnitudeStepDetectorMinimumInterval);
+	warpActivityEngineInit(&gWarpMenuScratch.activityEngine, 50 /* sampleRateHz */, kWarpActivityDecimation);
 
-	WarpPowerManagerCallbackStructure			powerManagerCallbackStructure;
+	warpEventLoopInit(&loop, timers, kWarpPedometerTimers, &session);
+	warpEventLoopSetHandler(&loop, kWarpEventSourceAcceleration, pedometerSamples);
+	warpEventLoopSetHandler(&loop, kWarpEventSourceRttKey, pedometerKey);
 
-	/*
-	 *	Callback configuration structure for power manager
-	 */
-	const power_manager_callback_user_config_t callbackCfg0 = {
-							callback0,
-							kPowerManagerCallbackBeforeAfter,
-							(power_manager_callback_data_t *) &powerManagerCallbackStructure};
+	enableI2Cpins(menuI2cPullupValue);
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	enableAccelerationSampler(&session.ring, 0x21 /* 50Hz ODR, active mode */, menuI2cPullupValue);
+#endif
 
 	/*
-	 *	Pointers to power manager callbacks.
+	 *	Run the sample handler once: enableAccelerationSampler() may
+	 *	have queued a sample already, and the handler arms the watchdog.
 	 */
-	power_manager_callback_user_config_t const *	callbacks[] = {
-								&callbackCfg0
-						};
+	warpEventLoopSignal(kWarpEventSourceAcceleration);
+	warpEventLoopRun(&loop);
 
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	disableAccelerationInterrupts(menuI2cPullupValue);
+#endif
+	disableI2Cpins();
+}
 
 
-	/*
-	 *	Enable clock for I/O PORT A and PORT B
-	 */
-	CLOCK_SYS_EnablePortClock(0);
-	CLOCK_SYS_EnablePortClock(1);
 
+/*
+ *	Microseconds from the RTC seconds and 32.768kHz prescaler registers;
+ *	wraps every ~71 minutes, so only differences are meaningful. TSR is
+ *	re-read in case the prescaler rolled over between the two reads.
+ */
+uint32_t
+warpTimestampMicroseconds(void)
+{
+	uint32_t	seconds, prescaler;
 
+	do
+	{
+		seconds = RTC->TSR;
+		prescaler = RTC->TPR;
+	} while (seconds != RTC->TSR);
 
-	/*
-	 *	Setup board clock source.
-	 */
-	g_xtal0ClkFreq = 32768U;
+	return seconds * 1000000u + ((prescaler * 15625u) >> 9);
+}
 
+#ifdef WARP_BUILD_ENABLE_BUS_STATISTICS
+static WarpBusStatistics		gWarpBusStatistics[kWarpBusStatisticsMaxDevices];
+static uint32_t				gWarpBusStatisticsUnrecorded;
 
+static void
+recordBusTransaction(uint8_t address, uint32_t bytes, uint8_t status, uint8_t timeoutStatus, uint32_t startMicroseconds)
+{
+	uint32_t		elapsed = warpTimestampMicroseconds() - startMicroseconds;
+	uint32_t		binLimit = kWarpBusStatisticsFirstBinMicroseconds;
+	WarpBusStatistics *	statistics = NULL;
+	int			bin = 0;
 
 	/*
-	 *	Initialize KSDK Operating System Abstraction layer (OSA) layer.
+	 *	Slots are claimed in order of first use and never released
+	 *	until resetBusStatistics().
 	 */
-	OSA_Init();
+	for (int i = 0; i < kWarpBusStatisticsMaxDevices; i++)
+	{
+		if (gWarpBusStatistics[i].transactions == 0 || gWarpBusStatistics[i].address == address)
+		{
+			statistics = &gWarpBusStatistics[i];
+			break;
+		}
+	}
 
+	if (statistics == NULL)
+	{
+		gWarpBusStatisticsUnrecorded++;
+		return;
+	}
 
+	statistics->address = address;
+	statistics->transactions++;
+	statistics->bytes += bytes;
+	statistics->busMicroseconds += elapsed;
+	if (statistics->previousFailed)
+	{
+		statistics->retries++;
+	}
+	statistics->previousFailed = (status != 0);
+	if (status != 0)
+	{
+		statistics->failures++;
+		statistics->lastError = status;
+		if (status == timeoutStatus)
+		{
+			statistics->timeouts++;
+		}
+		else if (status == kStatus_I2C_ReceivedNak && address != kWarpBusStatisticsSpiAddress)
+		{
+			statistics->naks++;
+		}
+	}
 
-	/*
-	 *	Setup SEGGER RTT to output as much as fits in buffers.
-	 *
-	 *	Using SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL can lead to deadlock, since
-	 *	we might have SWD disabled at time of blockage.
-	 */
-	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+	while (bin < kWarpBusStatisticsLatencyBins - 1 && elapsed >= binLimit)
+	{
+		bin++;
+		binLimit <<= 1;
+	}
+	if (statistics->latencyHistogram[bin] != 0xFFFF)
+	{
+		statistics->latencyHistogram[bin]++;
+	}
+}
 
+i2c_status_t
+warpI2CMasterSendDataBlocking(uint32_t instance, const i2c_device_t *  device,
+	const uint8_t *  cmdBuff, uint32_t cmdSize, const uint8_t *  txBuff, uint32_t txSize, uint32_t timeout_ms)
+{
+	uint32_t	start = warpTimestampMicroseconds();
+	i2c_status_t	status;
 
-	SEGGER_RTT_WriteString(0, "\n\n\n\rBooting Warp, in 3... ");
-	OSA_TimeDelay(200);
-	SEGGER_RTT_WriteString(0, "2... ");
-	OSA_TimeDelay(200);
-	SEGGER_RTT_WriteString(0, "1...\n\r");
-	OSA_TimeDelay(200);
-
+	status = I2C_DRV_MasterSendDataBlocking(instance, device, cmdBuff, cmdSize, txBuff, txSize, timeout_ms);
+	recordBusTransaction(device->address, cmdSize + txSize, status, kStatus_I2C_Timeout, start);
 
+	return status;
+}
 
-	/*
-	 *	Configure Clock Manager to default, and set callback for Clock Manager mode transition.
-	 *
-	 *	See "Clocks and Low Power modes with KSDK and Processor Expert" document (Low_Power_KSDK_PEx.pdf)
-	 */
-	CLOCK_SYS_Init(	g_defaultClockConfigurations,
-			CLOCK_CONFIG_NUM,
-			&clockCallbackTable,
-			ARRAY_SIZE(clockCallbackTable)
-			);
-	CLOCK_SYS_UpdateConfiguration(CLOCK_CONFIG_INDEX_FOR_RUN, kClockManagerPolicyForcible);
-
+i2c_status_t
+warpI2CMasterReceiveDataBlocking(uint32_t instance, const i2c_device_t *  device,
+	const uint8_t *  cmdBuff, uint32_t cmdSize, uint8_t *  rxBuff, uint32_t rxSize, uint32_t timeout_ms)
+{
+	uint32_t	start = warpTimestampMicroseconds();
+	i2c_status_t	status;
 
+	status = I2C_DRV_MasterReceiveDataBlocking(instance, device, cmdBuff, cmdSize, rxBuff, rxSize, timeout_ms);
+	recordBusTransaction(device->address, cmdSize + rxSize, status, kStatus_I2C_Timeout, start);
 
-	/*
-	 *	Initialize RTC Driver
-	 */
-	RTC_DRV_Init(0);
+	return status;
+}
 
+/*
+ *	SPI devices are selected by GPIO chip selects the driver never sees,
+ *	so all SPI traffic shares one entry.
+ */
+spi_status_t
+warpSPIMasterTransferBlocking(uint32_t instance, const spi_master_user_config_t *  device,
+	const uint8_t *  sendBuffer, uint8_t *  receiveBuffer, size_t transferByteCount, uint32_t timeout)
+{
+	uint32_t	start = warpTimestampMicroseconds();
+	spi_status_t	status;
 
+	status = SPI_DRV_MasterTransferBlocking(instance, device, sendBuffer, receiveBuffer, transferByteCount, timeout);
+	recordBusTransaction(kWarpBusStatisticsSpiAddress, transferByteCount, status, kStatus_SPI_Timeout, start);
 
-	/*
-	 *	Set initial date to 1st January 2016 00:00, and set date via RTC driver
-	 */
-	warpBootDate.year	= 2016U;
-	warpBootDate.month	= 1U;
-	warpBootDate.day	= 1U;
-	warpBootDate.hour	= 0U;
-	warpBootDate.minute	= 0U;
-	warpBootDate.second	= 0U;
-	RTC_DRV_SetDatetime(0, &warpBootDate);
+	return status;
+}
 
-	RTC_DRV_GetAlarm(0, &warpBootDate);
-	
-	//attempt at using the rtc and low power mode clocks
-	/*
-	//LPTMR_DRV_Start(LPTMR_INSTANCE);	
-	//SEGGER_RTT_printf(0, "\r\tRTC clocklp: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
-	SEGGER_RTT_printf(0, "\r\tRTC clockrtc: %d\n",warpBootDate);
-	RTC_DRV_SetSecsIntCmd(0,1);
-	OSA_TimeDelay(5000);
-	//SEGGER_RTT_printf(0, "\r\tRTC clock: %d\n", CLOCK_SYS_GetRtcGateCmd(0));
-	//SEGGER_RTT_printf(0, "\r\tRTC clocklpm: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
-	RTC_DRV_SetSecsIntCmd(0,1);
-	SEGGER_RTT_printf(0, "\r\tRTC clockrtc2: %d\n", warpBootDate);	
-	//LPTMR_DRV_Stop(LPTMR_INSTANCE);
-	//SEGGER_RTT_printf(0, "\r\tRTC clock33: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
-	*/
-	/*
-	 *	Setup Power Manager Driver
-	 */
-	memset(&powerManagerCallbackStructure, 0, sizeof(WarpPowerManagerCallbackStructure));
+void
+resetBusStatistics(void)
+{
+	memset(gWarpBusStatistics, 0, sizeof(gWarpBusStatistics));
+	gWarpBusStatisticsUnrecorded = 0;
+}
 
+void
+printBusStatistics(void)
+{
+	SEGGER_RTT_printf(0, "\r\n\tLatency bins (us): <%d, then doubling, last is >=%d\n",
+		kWarpBusStatisticsFirstBinMicroseconds, kWarpBusStatisticsFirstBinMicroseconds << (kWarpBusStatisticsLatencyBins - 2));
+	OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-	warpPowerModeVlpwConfig = warpPowerModeVlprConfig;
-	warpPowerModeVlpwConfig.mode = kPowerManagerVlpw;
+	for (int i = 0; i < kWarpBusStatisticsMaxDevices && gWarpBusStatistics[i].transactions != 0; i++)
+	{
+		WarpBusStatistics *	statistics = &gWarpBusStatistics[i];
 
-	warpPowerModeVlpsConfig = warpPowerModeVlprConfig;
-	warpPowerModeVlpsConfig.mode = kPowerManagerVlps;
+		if (statistics->address == kWarpBusStatisticsSpiAddress)
+		{
+			SEGGER_RTT_WriteString(0, "\r\tSPI: ");
+		}
+		else
+		{
+			SEGGER_RTT_printf(0, "\r\t0x%02x: ", statistics->address);
+		}
+		SEGGER_RTT_printf(0, "%u transactions, %u bytes, %u us, %u failures (%u timeouts, %u NAKs, last 0x%02x), %u retries\n",
+			statistics->transactions, statistics->bytes, statistics->busMicroseconds,
+			statistics->failures, statistics->timeouts, statistics->naks, statistics->lastError,
+			statistics->retries);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-	warpPowerModeWaitConfig = warpPowerModeVlprConfig;
-	warpPowerModeWaitConfig.mode = kPowerManagerWait;
+		SEGGER_RTT_WriteString(0, "\r\t      latency:");
+		for (int bin = 0; bin < kWarpBusStatisticsLatencyBins; bin++)
+		{
+			SEGGER_RTT_printf(0, " %u", statistics->latencyHistogram[bin]);
+		}
+		SEGGER_RTT_WriteString(0, "\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	}
 
-	warpPowerModeStopConfig = warpPowerModeVlprConfig;
-	warpPowerModeStopConfig.mode = kPowerManagerStop;
+	if (gWarpBusStatisticsUnrecorded != 0)
+	{
+		SEGGER_RTT_printf(0, "\r\t%u transactions to further devices not recorded\n", gWarpBusStatisticsUnrecorded);
+	}
+}
+#endif
 
-	warpPowerModeVlls0Config = warpPowerModeVlprConfig;
-	warpPowerModeVlls0Config.mode = kPowerManagerVlls0;
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+/*
+ *	MMA8451Q INT1 as a falling-edge interrupt. The handler may run I2C
+ *	transfers, which complete in the I2C0 interrupt, so PORTB is put at
+ *	the lowest of the four Cortex-M0+ priority levels.
+ */
+static void
+enableAccelerationInterruptPin(void)
+{
+	gpio_input_pin_user_config_t	interruptPin =
+	{
+		.pinName = kWarpPinMMA8451Q_INT1,
+		.config.isPullEnable = false,
+		.config.pullSelect = kPortPullUp,
+		.config.isPassiveFilterEnabled = false,
+		.config.interrupt = kPortIntFallingEdge,
+	};
 
-	warpPowerModeVlls1Config = warpPowerModeVlprConfig;
-	warpPowerModeVlls1Config.mode = kPowerManagerVlls1;
+	gWarpAccelerationInterruptPending = false;
+	NVIC_SetPriority(PORTB_IRQn, 3);
+	GPIO_DRV_InputPinInit(&interruptPin);
+}
 
-	warpPowerModeVlls3Config = warpPowerModeVlprConfig;
-	warpPowerModeVlls3Config.mode = kPowerManagerVlls3;
+/*
+ *	MMA8451Q FIFO streaming. The accelerometer samples into its 32-entry
+ *	FIFO on its own and pulls INT1 low once the watermark is reached, so
+ *	the KL03 wakes from VLPS once per batch instead of once per sample.
+ *	The RTC alarm (gWarpAccelerationWakeupTimeoutSeconds) is only a
+ *	backstop in case an edge is missed.
+ */
+WarpStatus
+enableAccelerationFifoStream(uint8_t watermark, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue)
+{
+	gWarpAccelerationSamplerRing = NULL;
+	enableAccelerationInterruptPin();
 
-	warpPowerModeRunConfig.mode = kPowerManagerRun;
+	return configureSensorMMA8451QInterrupts(kWarpMMA8451QF_SETUPModeCircular | (watermark & kWarpMMA8451QF_SETUPWatermarkMask) /* payloadF_SETUP */,
+						kWarpMMA8451QInterruptFifo /* payloadCTRL_REG4 */,
+						payloadCTRL_REG1,
+						menuI2cPullupValue);
+}
 
-	POWER_SYS_Init(	&powerConfigs,
-			sizeof(powerConfigs)/sizeof(power_manager_user_config_t *),
-			&callbacks,
-			sizeof(callbacks)/sizeof(power_manager_callback_user_config_t *)
-			);
+/*
+ *	Data-ready sampling. The MMA8451Q's own output data rate paces the
+ *	samples: each DRDY pulse on INT1 is timestamped and the sample read
+ *	in the interrupt handler, then queued in the caller's ring (which
+ *	must have timestamps). The consumer can therefore take arbitrarily
+ *	long between samples (e.g., redrawing the display) without the
+ *	sample instants moving, as long as the ring does not fill up.
+ *
+ *	The LPTMR is not an option for this: the bare-metal OSA uses it as
+ *	the free-running millisecond counter behind OSA_TimeDelay().
+ *
+ *	While the sampler runs, the interrupt handler owns the I2C bus.
+ */
+WarpStatus
+enableAccelerationSampler(WarpAccelerationRing *  ring, uint8_t payloadCTRL_REG1, uint16_t menuI2cPullupValue)
+{
+	WarpStatus	status;
 
+	gWarpAccelerationSamplerRing = NULL;
+	enableAccelerationInterruptPin();
 
+	status = configureSensorMMA8451QInterrupts(0x00 /* payloadF_SETUP: Disable FIFO */,
+						kWarpMMA8451QInterruptDataReady /* payloadCTRL_REG4 */,
+						payloadCTRL_REG1,
+						menuI2cPullupValue);
 
 	/*
-	 *	Switch CPU to Very Low Power Run (VLPR) mode
+	 *	A sample may have become ready before the ring was installed;
+	 *	reading it releases INT1 so that the next one gives an edge.
 	 */
-	warpSetLowPowerMode(kWarpPowerModeVLPR, 0);
+	gWarpAccelerationSamplerRing = ring;
+	sampleAccelerationMasked(ring);
 
+	return status;
+}
 
+void
+disableAccelerationInterrupts(uint16_t menuI2cPullupValue)
+{
+	PORT_HAL_SetPinIntMode(PORTB_BASE, GPIO_EXTRACT_PIN(kWarpPinMMA8451Q_INT1), kPortIntDisabled);
+	gWarpAccelerationSamplerRing = NULL;
+	configureSensorMMA8451QInterrupts(0x00 /* payloadF_SETUP: Disable FIFO */,
+					0x00 /* payloadCTRL_REG4: no interrupts */,
+					0x01 /* payloadCTRL_REG1: 800Hz, active */,
+					menuI2cPullupValue);
+}
 
-	/*
-	 *	Initialize the GPIO pins with the appropriate pull-up, etc.,
-	 *	defined in the inputPins and outputPins arrays (gpio_pins.c).
-	 *
-	 *	See also Section 30.3.3 GPIO Initialization of KSDK13APIRM.pdf
-	 */
-	GPIO_DRV_Init(inputPins  /* input pins */, outputPins  /* output pins */);
+WarpStatus
+warpSleepUntilAccelerationFifo(WarpAccelerationRing *  ring, uint8_t *  samplesRead)
+{
+	while (!gWarpAccelerationInterruptPending)
+	{
+		/*
+		 *	Re-check with interrupts masked so that an INT1 edge between
+		 *	the test and the WFI is not slept through: a pending (masked)
+		 *	interrupt still ends the sleep, and the handler runs once
+		 *	interrupts are re-enabled.
+		 */
+		INT_SYS_DisableIRQGlobal();
+		if (!gWarpAccelerationInterruptPending)
+		{
+			warpSetLowPowerMode(kWarpPowerModeVLPS, gWarpAccelerationWakeupTimeoutSeconds);
+		}
+		INT_SYS_EnableIRQGlobal();
 
-	/*
-	 *	Note that it is lowPowerPinStates() that sets the pin mux mode,
-	 *	so until we call it pins are in their default state.
-	 */
-	lowPowerPinStates();
+		if (RTC_DRV_IsAlarmPending(0))
+		{
+			break;
+		}
+	}
+	gWarpAccelerationInterruptPending = false;
+
+	return drainSensorFifoMMA8451Q(ring, samplesRead);
+}
 
+void
+runAccelerationFifoStream(int batches)
+{
+	WarpAccelerationRing	ring = {.samples = gWarpMenuScratch.fifoSamples, .capacity = kWarpMMA8451QFifoDepth};
+	uint8_t			samplesRead;
+	uint16_t		last;
+	uint16_t		menuI2cPullupValue = 32768;
 
+	enableI2Cpins(menuI2cPullupValue);
 
 	/*
-	 *	Toggle LED3 (kWarpPinSI4705_nRST)
+	 *	50Hz (0x21) with a watermark of 25 leaves 7 samples (140ms) of
+	 *	slack for the wakeup and the drain before the circular FIFO
+	 *	starts overwriting.
 	 */
-	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
-	OSA_TimeDelay(200);
-	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
-	OSA_TimeDelay(200);
-	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
-	OSA_TimeDelay(200);
-	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
-	OSA_TimeDelay(200);
-	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
-	OSA_TimeDelay(200);
-	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
+	if (enableAccelerationFifoStream(25 /* watermark */, 0x21 /* 50Hz, active */, menuI2cPullupValue) != kWarpStatusOK)
+	{
+		SEGGER_RTT_WriteString(0, "\r\tMMA8451Q FIFO configuration failed\n");
+		disableI2Cpins();
 
+		return;
+	}
 
+	for (int batch = 0; batch < batches; batch++)
+	{
+		if (warpSleepUntilAccelerationFifo(&ring, &samplesRead) != kWarpStatusOK)
+		{
+			SEGGER_RTT_WriteString(0, "\r\tMMA8451Q FIFO read failed\n");
+			break;
+		}
 
-	/*
-	 *	Initialize all the sensors
-	 */
-#ifdef WARP_BUILD_ENABLE_DEVBMX055
-	initBMX055accel(0x18	/* i2cAddress */,	&deviceBMX055accelState	);
-	initBMX055gyro(	0x68	/* i2cAddress */,	&deviceBMX055gyroState	);
-	initBMX055mag(	0x10	/* i2cAddress */,	&deviceBMX055magState	);
-#endif
+		if (samplesRead == 0)
+		{
+			SEGGER_RTT_printf(0, "\r\tbatch %d: 0 samples\n", batch);
+			continue;
+		}
 
-#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-	initMMA8451Q(	0x1D	/* i2cAddress */,	&deviceMMA8451QState	);
-#endif
-// added
-	
-#ifdef WARP_BUILD_ENABLE_DEVINA219	
-	initINA219(	0x40	/* i2cAddress */,	&deviceINA219State	);
-#endif	
-	
-	
-	
-	
+		last = (ring.head - 1) & (ring.capacity - 1);
+		SEGGER_RTT_printf(0, "\r\tbatch %d: %d samples, last %d, %d, %d, overruns %d\n",
+				batch, samplesRead,
+				ring.samples[3*last], ring.samples[3*last + 1], ring.samples[3*last + 2],
+				ring.overruns);
 
-#ifdef WARP_BUILD_ENABLE_DEVLPS25H
-	initLPS25H(	0x5C	/* i2cAddress */,	&deviceLPS25HState	);
-#endif
+		/*
+		 *	Consume the batch.
+		 */
+		ring.tail = ring.head;
+	}
 
-#ifdef WARP_BUILD_ENABLE_DEVHDC1000
-	initHDC1000(	0x43	/* i2cAddress */,	&deviceHDC1000State	);
+	disableAccelerationInterrupts(menuI2cPullupValue);
+	disableI2Cpins();
+}
 #endif
 
-#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-	initMAG3110(	0x0E	/* i2cAddress */,	&deviceMAG3110State	);
-#endif
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+void
+runGyroFifoStream(int batches)
+{
+	int16_t *	samples = gWarpMenuScratch.fifoSamples;
+	uint8_t		samplesRead;
+	uint16_t	overruns = 0;
+	uint16_t	menuI2cPullupValue = 32768;
+	int		last;
 
-#ifdef WARP_BUILD_ENABLE_DEVSI7021
-	initSI7021(	0x40	/* i2cAddress */,	&deviceSI7021State	);
-#endif
+	enableI2Cpins(menuI2cPullupValue);
 
-#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-	initL3GD20H(	0x6A	/* i2cAddress */,	&deviceL3GD20HState	);
-#endif
+	/*
+	 *	At 800Hz, a watermark of 16 fills in 20ms, leaving the other half
+	 *	of the FIFO (another 20ms) for the drain and the print before the
+	 *	stream starts overwriting.
+	 */
+	if (configureSensorL3GD20HFifo(0b11111111 /* ODR 800Hz, Cut-off 100Hz, normal mode, x,y,z enable */,
+					16 /* watermark */,
+					menuI2cPullupValue) != kWarpStatusOK)
+	{
+		SEGGER_RTT_WriteString(0, "\r\tL3GD20H FIFO configuration failed\n");
+		disableI2Cpins();
 
-#ifdef WARP_BUILD_ENABLE_DEVBME680
-	initBME680(	0x77	/* i2cAddress */,	&deviceBME680State	);
-#endif
+		return;
+	}
 
-#ifdef WARP_BUILD_ENABLE_DEVTCS34725
-	initTCS34725(	0x29	/* i2cAddress */,	&deviceTCS34725State	);
-#endif
+	/*
+	 *	The L3GD20H's watermark interrupt (DRDY/INT2) is not wired to the
+	 *	KL03, so sleep in VLPS for the time a batch takes to fill rather
+	 *	than spin in OSA_TimeDelay().
+	 */
+	for (int batch = 0; batch < batches; batch++)
+	{
+		warpLowPowerMillisecondsSleep(20, false /* forceAllPinsIntoLowPowerState */);
 
-#ifdef WARP_BUILD_ENABLE_DEVSI4705
-	initSI4705(	0x11	/* i2cAddress */,	&deviceSI4705State	);
-#endif
+		if (drainSensorFifoL3GD20H(samples, kWarpL3GD20HFifoDepth, &samplesRead, &overruns) != kWarpStatusOK)
+		{
+			SEGGER_RTT_WriteString(0, "\r\tL3GD20H FIFO read failed\n");
+			break;
+		}
 
-#ifdef WARP_BUILD_ENABLE_DEVCCS811
-	initCCS811(	0x5A	/* i2cAddress */,	&deviceCCS811State	);
-#endif
+		if (samplesRead == 0)
+		{
+			SEGGER_RTT_printf(0, "\r\tbatch %d: 0 samples\n", batch);
+			continue;
+		}
 
-#ifdef WARP_BUILD_ENABLE_DEVAMG8834
-	initAMG8834(	0x68	/* i2cAddress */,	&deviceAMG8834State	);
-#endif
+		last = samplesRead - 1;
+		SEGGER_RTT_printf(0, "\r\tbatch %d: %d samples, last %d, %d, %d, overruns %d\n",
+				batch, samplesRead,
+				samples[3*last], samples[3*last + 1], samples[3*last + 2],
+				overruns);
+	}
 
-#ifdef WARP_BUILD_ENABLE_DEVAS7262
-	initAS7262(	0x49	/* i2cAddress */,	&deviceAS7262State	);
+	/*
+	 *	Back to bypass mode with the FIFO off, as configureAllSensors() sets it.
+	 */
+	writeSensorRegisterL3GD20H(kWarpSensorConfigurationRegisterL3GD20HFIFO_CTRL, kWarpL3GD20HFIFO_CTRLModeBypass, menuI2cPullupValue);
+	writeSensorRegisterL3GD20H(kWarpSensorConfigurationRegisterL3GD20HCTRL5, 0x00, menuI2cPullupValue);
+	disableI2Cpins();
+}
 #endif
 
-#ifdef WARP_BUILD_ENABLE_DEVAS7263
-	initAS7263(	0x49	/* i2cAddress */,	&deviceAS7263State	);
-#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+void
+runImuFifoStream(int batches)
+{
+	int16_t *	samples = gWarpMenuScratch.fifoSamples;
+	uint8_t		samplesRead;
+	uint16_t	accelOverruns = 0;
+	uint16_t	gyroOverruns = 0;
+	uint16_t	menuI2cPullupValue = 32768;
+	WarpStatus	status;
+	int		last;
 
-#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
-  initRV8803C7(0x32 /* i2cAddress */, &deviceRV8803C7State);
-  enableI2Cpins(menuI2cPullupValue);
-  setRTCCountdownRV8803C7(0, TD_1HZ, false);
-  disableI2Cpins();
-#endif
+	enableI2Cpins(menuI2cPullupValue);
 
 	/*
-	 *	Initialization: Devices hanging off SPI
+	 *	The FIFOs only buffer filtered data, so drop the high-bandwidth
+	 *	(unfiltered) setting from configureAllSensors() for the duration.
+	 *	At 250Hz (accel) and 200Hz (gyro), a 50ms batch is 10--13 frames,
+	 *	well inside the 32-frame accel FIFO.
 	 */
-#ifdef WARP_BUILD_ENABLE_DEVADXL362
-	initADXL362(&deviceADXL362State);
-#endif
-
+	status = writeSensorRegisterBMX055accel(kWarpSensorConfigurationRegisterBMX055accelACCD_HBW, 0x00 /* filtered, shadowing enabled */, menuI2cPullupValue);
+	status |= writeSensorRegisterBMX055accel(kWarpSensorConfigurationRegisterBMX055accelPMU_BW, 0x0C /* 125Hz bandwidth, 250Hz data rate */, menuI2cPullupValue);
+	status |= writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW, 0x00 /* filtered, shadowing enabled */, menuI2cPullupValue);
+	status |= writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroBW, 0x04 /* ODR 200Hz, filter 23Hz */, menuI2cPullupValue);
+	status |= configureSensorBMX055accelFifo(true, menuI2cPullupValue);
+	status |= configureSensorBMX055gyroFifo(true, menuI2cPullupValue);
+	if (status != kWarpStatusOK)
+	{
+		SEGGER_RTT_WriteString(0, "\r\tBMX055 FIFO configuration failed\n");
+		batches = 0;
+	}
 
 	/*
-	 *	Initialization: the PAN1326, generating its 32k clock
+	 *	As for the L3GD20H, the BMX055 interrupt pins are not wired to the
+	 *	KL03, so sleep in VLPS between batches.
 	 */
-#ifdef WARP_BUILD_ENABLE_DEVPAN1326
-	initPAN1326B(&devicePAN1326BState);
-#endif
+	for (int batch = 0; batch < batches; batch++)
+	{
+		warpLowPowerMillisecondsSleep(50, false /* forceAllPinsIntoLowPowerState */);
 
-#ifdef WARP_BUILD_ENABLE_DEVISL23415
-	initISL23415(&deviceISL23415State);
-#endif
+		if (drainSensorFifoBMX055accel(samples, kWarpBMX055accelFifoDepth, &samplesRead, &accelOverruns) != kWarpStatusOK)
+		{
+			SEGGER_RTT_WriteString(0, "\r\tBMX055accel FIFO read failed\n");
+			break;
+		}
 
-	/*
-	 *	Make sure SCALED_SENSOR_SUPPLY is off.
-	 *
-	 *	(There's no point in calling activateAllLowPowerSensorModes())
-	 */
-	disableSssupply();
+		last = (samplesRead == 0) ? 0 : samplesRead - 1;
+		SEGGER_RTT_printf(0, "\r\tbatch %d: accel %d samples, last %d, %d, %d, overruns %d\n",
+				batch, samplesRead,
+				samples[3*last], samples[3*last + 1], samples[3*last + 2],
+				accelOverruns);
+
+		/*
+		 *	Frames beyond the buffer stay in the 100-frame gyro FIFO for the
+		 *	next batch.
+		 */
+		if (drainSensorFifoBMX055gyro(samples, kWarpBMX055accelFifoDepth, &samplesRead, &gyroOverruns) != kWarpStatusOK)
+		{
+			SEGGER_RTT_WriteString(0, "\r\tBMX055gyro FIFO read failed\n");
+			break;
+		}
 
+		last = (samplesRead == 0) ? 0 : samplesRead - 1;
+		SEGGER_RTT_printf(0, "\r\tbatch %d: gyro %d samples, last %d, %d, %d, overruns %d\n",
+				batch, samplesRead,
+				samples[3*last], samples[3*last + 1], samples[3*last + 2],
+				gyroOverruns);
+	}
 
 	/*
-	 *	TODO: initialize the kWarpPinKL03_VDD_ADC, write routines to read the VDD and temperature
+	 *	Back to bypass mode and the configureAllSensors() settings.
 	 */
+	configureSensorBMX055accelFifo(false, menuI2cPullupValue);
+	configureSensorBMX055gyroFifo(false, menuI2cPullupValue);
+	writeSensorRegisterBMX055accel(kWarpSensorConfigurationRegisterBMX055accelPMU_BW, 0x0F /* reset value */, menuI2cPullupValue);
+	writeSensorRegisterBMX055accel(kWarpSensorConfigurationRegisterBMX055accelACCD_HBW, 0x80 /* unfiltered, shadowing enabled */, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroBW, 0x00 /* ODR 2000Hz, unfiltered */, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW, 0x80 /* unfiltered, shadowing enabled */, menuI2cPullupValue);
+	disableI2Cpins();
+}
 
+/*
+ *	Poll the BMX055 at sampleRateHz, run each sample through the
+ *	fixed-point orientation filter, and print every outputDivider'th
+ *	quaternion (Q15, w x y z) instead of the nine raw channels. The gains
+ *	(2Kp = 4, 2Ki = 1) are the ones warp-host ahrs checks against the
+ *	double-precision filter. Afterwards, 64 updates on the last sample
+ *	are timed to give the cost per update on this core.
+ *
+ *	Without a BMX055 (or with it wedged) no sample ever arrives, so the
+ *	run gives up after kWarpOrientationMaxConsecutiveFailures reads in a
+ *	row fail instead of waiting for outputs that will not come.
+ */
+typedef enum
+{
+	kWarpOrientationMaxConsecutiveFailures	= 8,
+} WarpOrientationConstants;
 
+void
+runOrientationFilter(uint16_t sampleRateHz, uint16_t outputDivider, int numberOfOutputs)
+{
+	WarpAhrsState	ahrs;
+	int16_t		accel[3], gyro[3], mag[3], quaternion[4];
+	uint32_t	periodMicroseconds = 1000000u / sampleRateHz;
+	uint32_t	deadline, now, start, elapsed, coreClockHz;
+	uint16_t	menuI2cPullupValue = 32768;
+	uint16_t	updates = 0;
+	uint16_t	failures = 0;
+	uint16_t	consecutiveFailures = 0;
 
+	enableI2Cpins(menuI2cPullupValue);
 
-#ifdef WARP_BUILD_BOOT_TO_CSVSTREAM
 	/*
-	 *	Force to printAllSensors
+	 *	Magnetometer into normal mode (10Hz), gyro filtered at 200Hz so a
+	 *	polled sample is not aliased from the 2kHz unfiltered stream.
 	 */
-	gWarpI2cBaudRateKbps = 300;
-	warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
-	enableSssupply(3000);
-	enableI2Cpins(menuI2cPullupValue);
-	printAllSensors(false /* printHeadersAndCalibration */, true /* hexModeFlag */, 0 /* menuDelayBetweenEachRun */, menuI2cPullupValue);
+	writeSensorRegisterBMX055mag(kWarpSensorConfigurationRegisterBMX055magOpMode, 0x00 /* normal mode, 10Hz */, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroBW, 0x04 /* ODR 200Hz, filter 23Hz */, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW, 0x00 /* filtered, shadowing enabled */, menuI2cPullupValue);
+
 	/*
-	 *	Notreached
+	 *	+-125 deg/s gyro range from configureAllSensors(): 262.4 LSB per
+	 *	deg/s, i.e. 6.65e-5 rad/s per LSB.
+	 */
+	warpAhrsInit(&ahrs, sampleRateHz, 71420 /* rad/s per LSB, Q30 */, 4 << kWarpAhrsGainFractionBits, 1 << kWarpAhrsGainFractionBits);
+
+	deadline = warpTimestampMicroseconds();
+	while (numberOfOutputs > 0)
+	{
+		if (readSensorAxesBMX055(accel, gyro, mag) != kWarpStatusOK)
+		{
+			failures++;
+			if (++consecutiveFailures >= kWarpOrientationMaxConsecutiveFailures)
+			{
+				SEGGER_RTT_printf(0, "\r\tBMX055 read failed %d times in a row, giving up\n", consecutiveFailures);
+				break;
+			}
+		}
+		else
+		{
+			consecutiveFailures = 0;
+			warpAhrsUpdate(&ahrs, gyro, accel, mag);
+			if (++updates % outputDivider == 0)
+			{
+				warpAhrsQuaternionQ15(&ahrs, quaternion);
+				SEGGER_RTT_printf(0, "\r\t%d, %d, %d, %d\n", quaternion[0], quaternion[1], quaternion[2], quaternion[3]);
+				numberOfOutputs--;
+			}
+		}
+
+		deadline += periodMicroseconds;
+		now = warpTimestampMicroseconds();
+		if ((int32_t)(deadline - now) >= 1000)
+		{
+			warpLowPowerMillisecondsSleep((deadline - now) / 1000, false /* forceAllPinsIntoLowPowerState */);
+		}
+	}
+
+	/*
+	 *	The timing needs a real sample to update on.
 	 */
+	if (updates > 0)
+	{
+		start = warpTimestampMicroseconds();
+		for (int i = 0; i < 64; i++)
+		{
+			warpAhrsUpdate(&ahrs, gyro, accel, mag);
+		}
+		elapsed = warpTimestampMicroseconds() - start;
+		CLOCK_SYS_GetFreq(kCoreClock, &coreClockHz);
+		SEGGER_RTT_printf(0, "\r\t%d updates, %d read failures, %d us (%d cycles) per update\n",
+				updates, failures, elapsed / 64, (elapsed / 64) * (coreClockHz / 1000000));
+	}
+
+	writeSensorRegisterBMX055mag(kWarpSensorConfigurationRegisterBMX055magOpMode, 0x01, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroBW, 0x00 /* ODR 2000Hz, unfiltered */, menuI2cPullupValue);
+	writeSensorRegisterBMX055gyro(kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW, 0x80 /* unfiltered, shadowing enabled */, menuI2cPullupValue);
+	disableI2Cpins();
+}
 #endif
-	devSSD1331init();
-	int number = 0;
-	int xco = 0;
-	int yco = 0;
-/*
-//test
-	devSSD1331symbols(0,0,0);
-	devSSD1331symbols(1,1,1);	
-	devSSD1331symbols(2,2,2);
-	devSSD1331symbols(3,3,3);
-	devSSD1331symbols(4,4,2);
-	devSSD1331symbols(5,5,1);
-	devSSD1331symbols(6,6,0);
-	devSSD1331symbols(7,7,0);
-	devSSD1331symbols(8,8,0);
-	devSSD1331symbols(9,9,0);	
-*/
-//steps on line 1
-	devSSD1331symbols(28,0,0);	
-	devSSD1331symbols(29,1,0);
-	devSSD1331symbols(14,2,0);
-	devSSD1331symbols(25,3,0);
-	devSSD1331symbols(28,4,0);
-//avg steps on line 2 
-	devSSD1331symbols(10,0,1);	
-	devSSD1331symbols(31,1,1);
-	devSSD1331symbols(16,2,1);
-	
-	devSSD1331symbols(28,3,1);	
-	devSSD1331symbols(29,4,1);
-	devSSD1331symbols(14,5,1);
-	devSSD1331symbols(25,6,1);
-	devSSD1331symbols(28,7,1);
-//time on line 3
-	devSSD1331symbols(29,0,2);	
-	devSSD1331symbols(18,1,2);
-	devSSD1331symbols(22,2,2);
-	devSSD1331symbols(14,4,2);
 
-	
-//runPedometer function
-runPedometer();
-	
 
-//test autoprint function
-//devSSD1331write(806,11,0);
-//test autoprint numbers on the top line
-/*	
-int aut = 806;
-int d1;
-int d2;
-int d3;
-int d4;
-int df = 0;
-d4 = aut/1000;
-	
-if (d4 != 0)
+
+#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
+void
+addAndMultiplicationBusyLoop(long iterations)
 {
-	df=1;
-	devSSD1331symbols(d4,8,0);
+	int value;
+	for (volatile long i = 0; i < iterations; i++)
+	{
+		value = kWarpThermalChamberBusyLoopAdder + value * kWarpThermalChamberBusyLoopMutiplier;
+	}
 }
-d3 = (aut-d4*1000)/100;		
-if (df=1 || d3!=0)
+
+uint8_t
+checkSum(uint8_t *  pointer, uint16_t length) /*	Adapted from https://stackoverflow.com/questions/31151032/writing-an-8-bit-checksum-in-c	*/
 {
-	df=1;
-	devSSD1331symbols(d3,9,0);
+	unsigned int sum;
+	for ( sum = 0 ; length != 0 ; length-- )
+	{
+		sum += *(pointer++);
+	}
+	return (uint8_t)sum;
 }
-d2 = (aut-d4*1000-d3*100)/10;
-//SEGGER_RTT_printf(0, " %d,", 696969);	
-SEGGER_RTT_printf(0, " %d,", d2);	
-if (df=1|| d2!=0)
+#endif
+
+int
+main(void)
 {
-	df=1;
-	devSSD1331symbols(d2,10,0);	
-}
-d1 = (aut-d4*1000-d3*100-d2*10);	
-devSSD1331symbols(d1,11,0);
-*/		
-	while (1)
-	{
-		/*
-		 *	Do not, e.g., lowPowerPinStates() on each iteration, because we actually
-		 *	want to use menu to progressiveley change the machine state with various
-		 *	commands.
-		 */
+	uint8_t					key;
+	WarpSensorDevice			menuTargetSensor = kWarpSensorBMX055accel;
+	volatile WarpI2CDeviceState *		menuI2cDevice = NULL;
+	uint16_t				menuI2cPullupValue = 32768;
+	uint8_t					menuRegisterAddress = 0x00;
+	uint16_t				menuSupplyVoltage = 0;
 
-		/*
-		 *	We break up the prints with small delays to allow us to use small RTT print
-		 *	buffers without overrunning them when at max CPU speed.
-		 */
-		SEGGER_RTT_WriteString(0, "\r\n\n\n\n[ *\t\t\t\tW\ta\tr\tp\t(rev. b)\t\t\t* ]\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r[  \t\t\t\t      Cambridge / Physcomplab   \t\t\t\t  ]\n\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-		SEGGER_RTT_printf(0, "\r\tSupply=%dmV,\tDefault Target Read Register=0x%02x\n",
-								menuSupplyVoltage, menuRegisterAddress);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tI2C=%dkb/s,\tSPI=%dkb/s,\tUART=%dkb/s,\tI2C Pull-Up=%d\n\n",
-								gWarpI2cBaudRateKbps, gWarpSpiBaudRateKbps, gWarpUartBaudRateKbps, menuI2cPullupValue);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tSIM->SCGC6=0x%02x\t\tRTC->SR=0x%02x\t\tRTC->TSR=0x%02x\n", SIM->SCGC6, RTC->SR, RTC->TSR);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tMCG_C1=0x%02x\t\t\tMCG_C2=0x%02x\t\tMCG_S=0x%02x\n", MCG_C1, MCG_C2, MCG_S);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tMCG_SC=0x%02x\t\t\tMCG_MC=0x%02x\t\tOSC_CR=0x%02x\n", MCG_SC, MCG_MC, OSC_CR);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tSMC_PMPROT=0x%02x\t\t\tSMC_PMCTRL=0x%02x\t\tSCB->SCR=0x%02x\n", SMC_PMPROT, SMC_PMCTRL, SCB->SCR);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_printf(0, "\r\tPMC_REGSC=0x%02x\t\t\tSIM_SCGC4=0x%02x\tRTC->TPR=0x%02x\n\n", PMC_REGSC, SIM_SCGC4, RTC->TPR);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	rtc_datetime_t				warpBootDate;
 
-		SEGGER_RTT_printf(0, "\r\t%ds in RTC Handler to-date,\t%d Pmgr Errors\n", gWarpSleeptimeSeconds, powerManagerCallbackStructure.errorCount);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#else
-		SEGGER_RTT_WriteString(0, "\r\n\n\t\tWARNING: SEGGER_RTT_printf disabled in this firmware build.\n\t\tOnly showing output that does not require value formatting.\n\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#endif
+	power_manager_user_config_t		warpPowerModeWaitConfig;
+	power_manager_user_config_t		warpPowerModeStopConfig;
+	power_manager_user_config_t		warpPowerModeVlpwConfig;
+	power_manager_user_config_t		warpPowerModeVlpsConfig;
+	power_manager_user_config_t		warpPowerModeVlls0Config;
+	power_manager_user_config_t		warpPowerModeVlls1Config;
+	power_manager_user_config_t		warpPowerModeVlls3Config;
+	power_manager_user_config_t		warpPowerModeRunConfig;
 
-		SEGGER_RTT_WriteString(0, "\rSelect:\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'a': set default sensor.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'b': set I2C baud rate.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'c': set SPI baud rate.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'd': set UART baud rate.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'e': set default register address.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'f': write byte to sensor.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'g': set default SSSUPPLY.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'h': powerdown command to all sensors.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'i': set pull-up enable value.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	const power_manager_user_config_t	warpPowerModeVlprConfig = {
+							.mode			= kPowerManagerVlpr,
+							.sleepOnExitValue	= false,
+							.sleepOnExitOption	= false
+						};
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-		SEGGER_RTT_printf(0, "\r- 'j': repeat read reg 0x%02x on sensor #%d.\n", menuRegisterAddress, menuTargetSensor);
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#endif
+	power_manager_user_config_t const *	powerConfigs[] = {
+							/*
+							 *	NOTE: This order is depended on by POWER_SYS_SetMode()
+							 *
+							 *	See KSDK13APIRM.pdf Section 55.5.3
+							 */
+							&warpPowerModeWaitConfig,
+							&warpPowerModeStopConfig,
+							&warpPowerModeVlprConfig,
+							&warpPowerModeVlpwConfig,
+							&warpPowerModeVlpsConfig,
+							&warpPowerModeVlls0Config,
+							&warpPowerModeVlls1Config,
+							&warpPowerModeVlls3Config,
+							&warpPowerModeRunConfig,
+						};
 
-		SEGGER_RTT_WriteString(0, "\r- 'k': sleep until reset.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'l': send repeated byte on I2C.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'm': send repeated byte on SPI.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'n': enable SSSUPPLY.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'o': disable SSSUPPLY.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'p': switch to VLPR mode.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	WarpPowerManagerCallbackStructure			powerManagerCallbackStructure;
 
-#ifdef WARP_BUILD_ENABLE_DEVMAX11300
-		SEGGER_RTT_WriteString(0, "\r- 'q': MAX11300.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#endif
+	/*
+	 *	Callback configuration structure for power manager
+	 */
+	const power_manager_callback_user_config_t callbackCfg0 = {
+							callback0,
+							kPowerManagerCallbackBeforeAfter,
+							(power_manager_callback_data_t *) &powerManagerCallbackStructure};
 
-		SEGGER_RTT_WriteString(0, "\r- 'r': switch to RUN mode.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 's': power up all sensors.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 't': dump processor state.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\r- 'u': set I2C address.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
-		SEGGER_RTT_WriteString(0, "\r- 'v': Enter VLLS0 low-power mode for 3s, then reset\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#endif
-		
-		SEGGER_RTT_WriteString(0, "\r- 'w': Read INA219.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		
-				
-		SEGGER_RTT_WriteString(0, "\r- 'x': disable SWD and spin for 10 secs.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Pointers to power manager callbacks.
+	 */
+	power_manager_callback_user_config_t const *	callbacks[] = {
+								&callbackCfg0
+						};
 
-#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
-		SEGGER_RTT_WriteString(0, "\r- 'y': stress test (need a force quit)\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-#endif
 
-		SEGGER_RTT_WriteString(0, "\r- 'z': dump all sensors data.\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-		SEGGER_RTT_WriteString(0, "\rEnter selection> ");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		key = SEGGER_RTT_WaitKey();
-		
-		switch (key)
-		{
-			/*
-			 *		Select sensor
-			 */
-			case 'a':
-			{
-				SEGGER_RTT_WriteString(0, "\r\tSelect:\n");
-#ifdef WARP_BUILD_ENABLE_DEVADXL362
-				SEGGER_RTT_WriteString(0, "\r\t- '1' ADXL362			(0x00--0x2D): 1.6V -- 3.5V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '1' ADXL362			(0x00--0x2D): 1.6V -- 3.5V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Enable clock for I/O PORT A and PORT B
+	 */
+	CLOCK_SYS_EnablePortClock(0);
+	CLOCK_SYS_EnablePortClock(1);
 
-#ifdef WARP_BUILD_ENABLE_DEVBMX055
-				SEGGER_RTT_WriteString(0, "\r\t- '2' BMX055accel		(0x00--0x3F): 2.4V -- 3.6V\n");
-				SEGGER_RTT_WriteString(0, "\r\t- '3' BMX055gyro			(0x00--0x3F): 2.4V -- 3.6V\n");
-				SEGGER_RTT_WriteString(0, "\r\t- '4' BMX055mag			(0x40--0x52): 2.4V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '2' BMX055accel 		(0x00--0x3F): 2.4V -- 3.6V (compiled out) \n");
-				SEGGER_RTT_WriteString(0, "\r\t- '3' BMX055gyro			(0x00--0x3F): 2.4V -- 3.6V (compiled out) \n");
-				SEGGER_RTT_WriteString(0, "\r\t- '4' BMX055mag			(0x40--0x52): 2.4V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-				SEGGER_RTT_WriteString(0, "\r\t- '5' MMA8451Q			(0x00--0x31): 1.95V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '5' MMA8451Q			(0x00--0x31): 1.95V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-//added
 
-#ifdef WARP_BUILD_ENABLE_DEVINA219
-				SEGGER_RTT_WriteString(0, "\r\t- 'l' INA219			(0x00--0x31): 1.95V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'l' INA219			(0x00--0x31): 1.95V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-				
-				
-				
-		
-				
-				
-				
-				
-				
-				
-				
-				
-#ifdef WARP_BUILD_ENABLE_DEVLPS25H
-				SEGGER_RTT_WriteString(0, "\r\t- '6' LPS25H			(0x08--0x24): 1.7V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '6' LPS25H			(0x08--0x24): 1.7V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Setup board clock source.
+	 */
+	g_xtal0ClkFreq = 32768U;
 
-#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-				SEGGER_RTT_WriteString(0, "\r\t- '7' MAG3110			(0x00--0x11): 1.95V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '7' MAG3110			(0x00--0x11): 1.95V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVHDC1000
-				SEGGER_RTT_WriteString(0, "\r\t- '8' HDC1000			(0x00--0x1F): 3.0V -- 5.0V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '8' HDC1000			(0x00--0x1F): 3.0V -- 5.0V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVSI7021
-				SEGGER_RTT_WriteString(0, "\r\t- '9' SI7021			(0x00--0x0F): 1.9V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- '9' SI7021			(0x00--0x0F): 1.9V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Initialize KSDK Operating System Abstraction layer (OSA) layer.
+	 */
+	OSA_Init();
 
-#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-				SEGGER_RTT_WriteString(0, "\r\t- 'a' L3GD20H			(0x0F--0x39): 2.2V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'a' L3GD20H			(0x0F--0x39): 2.2V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVBME680
-				SEGGER_RTT_WriteString(0, "\r\t- 'b' BME680			(0xAA--0xF8): 1.6V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'b' BME680			(0xAA--0xF8): 1.6V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVTCS34725
-				SEGGER_RTT_WriteString(0, "\r\t- 'd' TCS34725			(0x00--0x1D): 2.7V -- 3.3V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'd' TCS34725			(0x00--0x1D): 2.7V -- 3.3V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Setup SEGGER RTT to output as much as fits in buffers.
+	 *
+	 *	Using SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL can lead to deadlock, since
+	 *	we might have SWD disabled at time of blockage.
+	 */
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+	warpLogInit();
 
-#ifdef WARP_BUILD_ENABLE_DEVSI4705
-				SEGGER_RTT_WriteString(0, "\r\t- 'e' SI4705			(n/a):        2.7V -- 5.5V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'e' SI4705			(n/a):        2.7V -- 5.5V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVPAN1326
-				SEGGER_RTT_WriteString(0, "\r\t- 'f' PAN1326			(n/a)\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'f' PAN1326			(n/a) (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	SEGGER_RTT_WriteString(0, "\n\n\n\rBooting Warp, in 3... ");
+	OSA_TimeDelay(200);
+	SEGGER_RTT_WriteString(0, "2... ");
+	OSA_TimeDelay(200);
+	SEGGER_RTT_WriteString(0, "1...\n\r");
+	OSA_TimeDelay(200);
 
-#ifdef WARP_BUILD_ENABLE_DEVCCS811
-				SEGGER_RTT_WriteString(0, "\r\t- 'g' CCS811			(0x00--0xFF): 1.8V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'g' CCS811			(0x00--0xFF): 1.8V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVAMG8834
-				SEGGER_RTT_WriteString(0, "\r\t- 'h' AMG8834			(0x00--?): ?V -- ?V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'h' AMG8834			(0x00--?): ?V -- ?V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_DEVAS7262
-				SEGGER_RTT_WriteString(0, "\r\t- 'j' AS7262			(0x00--0x2B): 2.7V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'j' AS7262			(0x00--0x2B): 2.7V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	/*
+	 *	Configure Clock Manager to default, and set callback for Clock Manager mode transition.
+	 *
+	 *	See "Clocks and Low Power modes with KSDK and Processor Expert" document (Low_Power_KSDK_PEx.pdf)
+	 */
+	CLOCK_SYS_Init(	g_defaultClockConfigurations,
+			CLOCK_CONFIG_NUM,
+			&clockCallbackTable,
+			ARRAY_SIZE(clockCallbackTable)
+			);
+	CLOCK_SYS_UpdateConfiguration(CLOCK_CONFIG_INDEX_FOR_RUN, kClockManagerPolicyForcible);
 
-#ifdef WARP_BUILD_ENABLE_DEVAS7263
-				SEGGER_RTT_WriteString(0, "\r\t- 'k' AS7263			(0x00--0x2B): 2.7V -- 3.6V\n");
-				#else
-				SEGGER_RTT_WriteString(0, "\r\t- 'k' AS7263			(0x00--0x2B): 2.7V -- 3.6V (compiled out) \n");
-#endif
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\tEnter selection> ");
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				key = SEGGER_RTT_WaitKey();
+	/*
+	 *	Initialize RTC Driver
+	 */
+	RTC_DRV_Init(0);
 
-				switch(key)
-				{
-#ifdef WARP_BUILD_ENABLE_DEVADXL362
-					case '1':
-					{
-						menuTargetSensor = kWarpSensorADXL362;
 
-						break;
-					}
-#endif
-#ifdef WARP_BUILD_ENABLE_DEVBMX055
-					case '2':
-					{
-						menuTargetSensor = kWarpSensorBMX055accel;
-						menuI2cDevice = &deviceBMX055accelState;
-						break;
-					}
-#endif
-#ifdef WARP_BUILD_ENABLE_DEVBMX055
-					case '3':
-					{
-						menuTargetSensor = kWarpSensorBMX055gyro;
-						menuI2cDevice = &deviceBMX055gyroState;
-						break;
-					}
-#endif
-#ifdef WARP_BUILD_ENABLE_DEVBMX055
-					case '4':
-					{
-						menuTargetSensor = kWarpSensorBMX055mag;
-						menuI2cDevice = &deviceBMX055magState;
-						break;
-					}
+
+	/*
+	 *	Set initial date to 1st January 2016 00:00, and set date via RTC driver
+	 */
+	warpBootDate.year	= 2016U;
+	warpBootDate.month	= 1U;
+	warpBootDate.day	= 1U;
+	warpBootDate.hour	= 0U;
+	warpBootDate.minute	= 0U;
+	warpBootDate.second	= 0U;
+	RTC_DRV_SetDatetime(0, &warpBootDate);
+
+	RTC_DRV_GetAlarm(0, &warpBootDate);
+	
+	//attempt at using the rtc and low power mode clocks
+	/*
+	//LPTMR_DRV_Start(LPTMR_INSTANCE);	
+	//SEGGER_RTT_printf(0, "\r\tRTC clocklp: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
+	SEGGER_RTT_printf(0, "\r\tRTC clockrtc: %d\n",warpBootDate);
+	RTC_DRV_SetSecsIntCmd(0,1);
+	OSA_TimeDelay(5000);
+	//SEGGER_RTT_printf(0, "\r\tRTC clock: %d\n", CLOCK_SYS_GetRtcGateCmd(0));
+	//SEGGER_RTT_printf(0, "\r\tRTC clocklpm: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
+	RTC_DRV_SetSecsIntCmd(0,1);
+	SEGGER_RTT_printf(0, "\r\tRTC clockrtc2: %d\n", warpBootDate);	
+	//LPTMR_DRV_Stop(LPTMR_INSTANCE);
+	//SEGGER_RTT_printf(0, "\r\tRTC clock33: %d\n", LPTMR_DRV_GetCurrentTimeUs(LPTMR_INSTANCE));
+	*/
+	/*
+	 *	Setup Power Manager Driver
+	 */
+	memset(&powerManagerCallbackStructure, 0, sizeof(WarpPowerManagerCallbackStructure));
+
+
+	warpPowerModeVlpwConfig = warpPowerModeVlprConfig;
+	warpPowerModeVlpwConfig.mode = kPowerManagerVlpw;
+
+	warpPowerModeVlpsConfig = warpPowerModeVlprConfig;
+	warpPowerModeVlpsConfig.mode = kPowerManagerVlps;
+
+	warpPowerModeWaitConfig = warpPowerModeVlprConfig;
+	warpPowerModeWaitConfig.mode = kPowerManagerWait;
+
+	warpPowerModeStopConfig = warpPowerModeVlprConfig;
+	warpPowerModeStopConfig.mode = kPowerManagerStop;
+
+	warpPowerModeVlls0Config = warpPowerModeVlprConfig;
+	warpPowerModeVlls0Config.mode = kPowerManagerVlls0;
+
+	warpPowerModeVlls1Config = warpPowerModeVlprConfig;
+	warpPowerModeVlls1Config.mode = kPowerManagerVlls1;
+
+	warpPowerModeVlls3Config = warpPowerModeVlprConfig;
+	warpPowerModeVlls3Config.mode = kPowerManagerVlls3;
+
+	warpPowerModeRunConfig.mode = kPowerManagerRun;
+
+	POWER_SYS_Init(	&powerConfigs,
+			sizeof(powerConfigs)/sizeof(power_manager_user_config_t *),
+			&callbacks,
+			sizeof(callbacks)/sizeof(power_manager_callback_user_config_t *)
+			);
+
+
+
+	/*
+	 *	Switch CPU to Very Low Power Run (VLPR) mode
+	 */
+	warpSetLowPowerMode(kWarpPowerModeVLPR, 0);
+
+
+
+	/*
+	 *	Initialize the GPIO pins with the appropriate pull-up, etc.,
+	 *	defined in the inputPins and outputPins arrays (gpio_pins.c).
+	 *
+	 *	See also Section 30.3.3 GPIO Initialization of KSDK13APIRM.pdf
+	 */
+	GPIO_DRV_Init(inputPins  /* input pins */, outputPins  /* output pins */);
+
+	/*
+	 *	Note that it is lowPowerPinStates() that sets the pin mux mode,
+	 *	so until we call it pins are in their default state.
+	 */
+	lowPowerPinStates();
+
+
+
+	/*
+	 *	Toggle LED3 (kWarpPinSI4705_nRST)
+	 */
+	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
+	OSA_TimeDelay(200);
+	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
+	OSA_TimeDelay(200);
+	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
+	OSA_TimeDelay(200);
+	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
+	OSA_TimeDelay(200);
+	GPIO_DRV_SetPinOutput(kWarpPinSI4705_nRST);
+	OSA_TimeDelay(200);
+	GPIO_DRV_ClearPinOutput(kWarpPinSI4705_nRST);
+
+
+
+	/*
+	 *	Initialize all the sensors
+	 */
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	initBMX055accel(0x18	/* i2cAddress */,	&deviceBMX055accelState	);
+	initBMX055gyro(	0x68	/* i2cAddress */,	&deviceBMX055gyroState	);
+	initBMX055mag(	0x10	/* i2cAddress */,	&deviceBMX055magState	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-					case '5':
-					{
-						menuTargetSensor = kWarpSensorMMA8451Q;
-						menuI2cDevice = &deviceMMA8451QState;
-						break;
-					}					
-#endif						
-//added		
-#ifdef WARP_BUILD_ENABLE_DEVINA219
-					case 'l':
-					{
-						menuTargetSensor = kWarpSensorINA219;
-						menuI2cDevice = &deviceINA219State;
-						break;
-					}					
+	initMMA8451Q(	0x1D	/* i2cAddress */,	&deviceMMA8451QState	);
 #endif
+// added
 	
-						
-						
-						
-						
-						
-						
-						
-						
+#ifdef WARP_BUILD_ENABLE_DEVINA219	
+	initINA219(	0x40	/* i2cAddress */,	&deviceINA219State	);
+#endif	
+	
+	
+	
+	
+
 #ifdef WARP_BUILD_ENABLE_DEVLPS25H
-					case '6':
-					{
-						menuTargetSensor = kWarpSensorLPS25H;
-						menuI2cDevice = &deviceLPS25HState;
-						break;
-					}
-#endif
-#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-					case '7':
-					{
-						menuTargetSensor = kWarpSensorMAG3110;
-						menuI2cDevice = &deviceMAG3110State;
-						break;
-					}
+	initLPS25H(	0x5C	/* i2cAddress */,	&deviceLPS25HState	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVHDC1000
-					case '8':
-					{
-						menuTargetSensor = kWarpSensorHDC1000;
-						menuI2cDevice = &deviceHDC1000State;
-						break;
-					}
+	initHDC1000(	0x43	/* i2cAddress */,	&deviceHDC1000State	);
+#endif
+
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	initMAG3110(	0x0E	/* i2cAddress */,	&deviceMAG3110State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVSI7021
-					case '9':
-					{
-						menuTargetSensor = kWarpSensorSI7021;
-						menuI2cDevice = &deviceSI7021State;
-						break;
-					}
+	initSI7021(	0x40	/* i2cAddress */,	&deviceSI7021State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-					case 'a':
-					{
-						menuTargetSensor = kWarpSensorL3GD20H;
-						menuI2cDevice = &deviceL3GD20HState;
-						break;
-					}
+	initL3GD20H(	0x6A	/* i2cAddress */,	&deviceL3GD20HState	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVBME680
-					case 'b':
-					{
-						menuTargetSensor = kWarpSensorBME680;
-						menuI2cDevice = &deviceBME680State;
-						break;
-					}
+	initBME680(	0x77	/* i2cAddress */,	&deviceBME680State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVTCS34725
-					case 'd':
-					{
-						menuTargetSensor = kWarpSensorTCS34725;
-						menuI2cDevice = &deviceTCS34725State;
-						break;
-					}
+	initTCS34725(	0x29	/* i2cAddress */,	&deviceTCS34725State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVSI4705
-					case 'e':
-					{
-						menuTargetSensor = kWarpSensorSI4705;
-						menuI2cDevice = &deviceSI4705State;
-						break;
-					}
+	initSI4705(	0x11	/* i2cAddress */,	&deviceSI4705State	);
 #endif
-#ifdef WARP_BUILD_ENABLE_DEVPAN1326
-					case 'f':
-					{
-						menuTargetSensor = kWarpSensorPAN1326;
 
-						break;
-					}
-#endif
 #ifdef WARP_BUILD_ENABLE_DEVCCS811
-					case 'g':
-					{
-						menuTargetSensor = kWarpSensorCCS811;
-						menuI2cDevice = &deviceCCS811State;
-						break;
-					}
+	initCCS811(	0x5A	/* i2cAddress */,	&deviceCCS811State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVAMG8834
-					case 'h':
-					{
-						menuTargetSensor = kWarpSensorAMG8834;
-						menuI2cDevice = &deviceAMG8834State;
-						break;
-					}
+	initAMG8834(	0x68	/* i2cAddress */,	&deviceAMG8834State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVAS7262
-					case 'j':
-					{
-						menuTargetSensor = kWarpSensorAS7262;
-						menuI2cDevice = &deviceAS7262State;
-						break;
-					}
+	initAS7262(	0x49	/* i2cAddress */,	&deviceAS7262State	);
 #endif
+
 #ifdef WARP_BUILD_ENABLE_DEVAS7263
-					case 'k':
-					{
-						menuTargetSensor = kWarpSensorAS7263;
-						menuI2cDevice = &deviceAS7263State;
-						break;
-					}
-#endif
-					default:
-					{
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-						SEGGER_RTT_printf(0, "\r\tInvalid selection '%c' !\n", key);
+	initAS7263(	0x49	/* i2cAddress */,	&deviceAS7263State	);
 #endif
-					}
-				}
 
-				break;
-			}
+#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
+  initRV8803C7(0x32 /* i2cAddress */, &deviceRV8803C7State);
+  enableI2Cpins(menuI2cPullupValue);
+  setRTCCountdownRV8803C7(0, TD_1HZ, false);
+  disableI2Cpins();
+#endif
 
-			/*
-			 *	Change default I2C baud rate
-			 */
-			case 'b':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tSet I2C baud rate in kbps (e.g., '0001')> ");
-				gWarpI2cBaudRateKbps = read4digits();
+	/*
+	 *	Initialization: Devices hanging off SPI
+	 */
+#ifdef WARP_BUILD_ENABLE_DEVADXL362
+	initADXL362(&deviceADXL362State);
+#endif
 
-				/*
-				 *	Round 9999kbps to 10Mbps
-				 */
-				if (gWarpI2cBaudRateKbps == 9999)
-				{
-					gWarpI2cBaudRateKbps = 10000;
-				}
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tI2C baud rate set to %d kb/s", gWarpI2cBaudRateKbps);
+	/*
+	 *	Initialization: the PAN1326, generating its 32k clock
+	 */
+#ifdef WARP_BUILD_ENABLE_DEVPAN1326
+	initPAN1326B(&devicePAN1326BState);
 #endif
 
-				break;
-			}
+#ifdef WARP_BUILD_ENABLE_DEVISL23415
+	initISL23415(&deviceISL23415State);
+#endif
 
-			/*
-			 *	Change default SPI baud rate
-			 */
-			case 'c':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tSet SPI baud rate in kbps (e.g., '0001')> ");
-				gWarpSpiBaudRateKbps = read4digits();
+	/*
+	 *	Make sure SCALED_SENSOR_SUPPLY is off.
+	 *
+	 *	(There's no point in calling activateAllLowPowerSensorModes())
+	 */
+	disableSssupply();
 
-				/*
-				 *	Round 9999kbps to 10Mbps
-				 */
-				if (gWarpSpiBaudRateKbps == 9999)
-				{
-					gWarpSpiBaudRateKbps = 10000;
-				}
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tSPI baud rate: %d kb/s", gWarpSpiBaudRateKbps);
-#endif
+	/*
+	 *	TODO: initialize the kWarpPinKL03_VDD_ADC, write routines to read the VDD and temperature
+	 */
 
-				break;
-			}
 
-			/*
-			 *	Change default UART baud rate
-			 */
-			case 'd':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tSet UART baud rate in kbps (e.g., '0001')> ");
-				gWarpUartBaudRateKbps = read4digits();
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tUART baud rate: %d kb/s", gWarpUartBaudRateKbps);
-#endif
 
-				break;
-			}
 
-			/*
-			 *	Set register address for subsequent operations
-			 */
-			case 'e':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tEnter 2-nybble register hex address (e.g., '3e')> ");
-				menuRegisterAddress = readHexByte();
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n\n", menuRegisterAddress);
+#ifdef WARP_BUILD_BOOT_TO_CSVSTREAM
+	/*
+	 *	Force to printAllSensors
+	 */
+	gWarpI2cBaudRateKbps = 300;
+	warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
+	enableSssupply(3000);
+	enableI2Cpins(menuI2cPullupValue);
+	printAllSensors(false /* printHeadersAndCalibration */, true /* hexModeFlag */, 0 /* menuDelayBetweenEachRun */, menuI2cPullupValue);
+	/*
+	 *	Notreached
+	 */
+#endif
+#ifdef WARP_BUILD_BOOT_TO_BINARYSTREAM
+	/*
+	 *	Force to streamAllSensorsBinary; decode on the host with 'warp-host decode'
+	 */
+	gWarpI2cBaudRateKbps = 300;
+	warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
+	enableSssupply(3000);
+	enableI2Cpins(menuI2cPullupValue);
+	streamAllSensorsBinary(0 /* menuDelayBetweenEachRun */, menuI2cPullupValue, 0 /* numberOfFrames: forever */);
+	/*
+	 *	Notreached
+	 */
 #endif
+	devSSD1331init();
+	int number = 0;
+	int xco = 0;
+	int yco = 0;
+/*
+//test
+	devSSD1331symbols(0,0,0);
+	devSSD1331symbols(1,1,1);	
+	devSSD1331symbols(2,2,2);
+	devSSD1331symbols(3,3,3);
+	devSSD1331symbols(4,4,2);
+	devSSD1331symbols(5,5,1);
+	devSSD1331symbols(6,6,0);
+	devSSD1331symbols(7,7,0);
+	devSSD1331symbols(8,8,0);
+	devSSD1331symbols(9,9,0);	
+*/
+//steps on line 1
+	devSSD1331drawString("steps",0,0);
+//avg steps on line 2 
+	devSSD1331drawString("avgsteps",0,1);
+//time on line 3
+	devSSD1331drawString("time",0,2);
 
-				break;
-			}
+	
+//runPedometer function
+runPedometer();
+	
 
-			/*
-			 *	Write byte to sensor
-			 */
-			case 'f':
-			{
-				uint8_t		i2cAddress, payloadByte[1], commandByte[1];
-				i2c_status_t	i2cStatus;
-				WarpStatus	status;
+//test autoprint function
+//devSSD1331write(806,11,0);
+//test autoprint numbers on the top line
+/*	
+int aut = 806;
+int d1;
+int d2;
+int d3;
+int d4;
+int df = 0;
+d4 = aut/1000;
+	
+if (d4 != 0)
+{
+	df=1;
+	devSSD1331symbols(d4,8,0);
+}
+d3 = (aut-d4*1000)/100;		
+if (df=1 || d3!=0)
+{
+	df=1;
+	devSSD1331symbols(d3,9,0);
+}
+d2 = (aut-d4*1000-d3*100)/10;
+//SEGGER_RTT_printf(0, " %d,", 696969);	
+SEGGER_RTT_printf(0, " %d,", d2);	
+if (df=1|| d2!=0)
+{
+	df=1;
+	devSSD1331symbols(d2,10,0);	
+}
+d1 = (aut-d4*1000-d3*100-d2*10);	
+devSSD1331symbols(d1,11,0);
+*/		
+	while (1)
+	{
+		/*
+		 *	Do not, e.g., lowPowerPinStates() on each iteration, because we actually
+		 *	want to use menu to progressiveley change the machine state with various
+		 *	commands.
+		 */
 
+		/*
+		 *	We break up the prints with small delays to allow us to use small RTT print
+		 *	buffers without overrunning them when at max CPU speed.
+		 */
+		SEGGER_RTT_WriteString(0, "\r\n\n\n\n[ *\t\t\t\tW\ta\tr\tp\t(rev. b)\t\t\t* ]\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r[  \t\t\t\t      Cambridge / Physcomplab   \t\t\t\t  ]\n\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				USED(status);
-				SEGGER_RTT_WriteString(0, "\r\n\tEnter I2C addr. (e.g., '0f') or '99' for SPI > ");
-				i2cAddress = readHexByte();
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n", i2cAddress);
-#endif
+		SEGGER_RTT_printf(0, "\r\tSupply=%dmV,\tDefault Target Read Register=0x%02x\n",
+								menuSupplyVoltage, menuRegisterAddress);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tI2C=%dkb/s,\tSPI=%dkb/s,\tUART=%dkb/s,\tI2C Pull-Up=%d\n\n",
+								gWarpI2cBaudRateKbps, gWarpSpiBaudRateKbps, gWarpUartBaudRateKbps, menuI2cPullupValue);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tSIM->SCGC6=0x%02x\t\tRTC->SR=0x%02x\t\tRTC->TSR=0x%02x\n", SIM->SCGC6, RTC->SR, RTC->TSR);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tMCG_C1=0x%02x\t\t\tMCG_C2=0x%02x\t\tMCG_S=0x%02x\n", MCG_C1, MCG_C2, MCG_S);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tMCG_SC=0x%02x\t\t\tMCG_MC=0x%02x\t\tOSC_CR=0x%02x\n", MCG_SC, MCG_MC, OSC_CR);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tSMC_PMPROT=0x%02x\t\t\tSMC_PMCTRL=0x%02x\t\tSCB->SCR=0x%02x\n", SMC_PMPROT, SMC_PMCTRL, SCB->SCR);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_printf(0, "\r\tPMC_REGSC=0x%02x\t\t\tSIM_SCGC4=0x%02x\tRTC->TPR=0x%02x\n\n", PMC_REGSC, SIM_SCGC4, RTC->TPR);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tEnter hex byte to send (e.g., '0f')> ");
-				payloadByte[0] = readHexByte();
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n", payloadByte[0]);
+		SEGGER_RTT_printf(0, "\r\t%ds in RTC Handler to-date,\t%d Pmgr Errors\n", gWarpSleeptimeSeconds, powerManagerCallbackStructure.errorCount);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#else
+		SEGGER_RTT_WriteString(0, "\r\n\n\t\tWARNING: SEGGER_RTT_printf disabled in this firmware build.\n\t\tOnly showing output that does not require value formatting.\n\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
 
-				if (i2cAddress == 0x99)
-				{
-#ifdef WARP_BUILD_ENABLE_DEVADXL362
+		SEGGER_RTT_WriteString(0, "\rSelect:\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'a': set default sensor.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'b': set I2C baud rate (clears the per-device rates of 'T').\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'c': set SPI baud rate.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'd': set UART baud rate.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'e': set default register address.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'f': write byte to sensor.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'g': set default SSSUPPLY.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'h': powerdown command to all sensors.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'i': set pull-up enable value.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-					SEGGER_RTT_printf(0, "\r\n\tWriting [0x%02x] to SPI register [0x%02x]...\n", payloadByte[0], menuRegisterAddress);
+		SEGGER_RTT_printf(0, "\r- 'j': repeat read reg 0x%02x on sensor #%d.\n", menuRegisterAddress, menuTargetSensor);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
-					status = writeSensorRegisterADXL362(	0x0A			/* command == write register	*/,
-										menuRegisterAddress,
-										payloadByte[0]		/* writeValue			*/
-									);
-					if (status != kWarpStatusOK)
-					{
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-						SEGGER_RTT_printf(0, "\r\n\tSPI write failed, error %d.\n\n", status);
-#endif
-					}
-					#else
-					SEGGER_RTT_WriteString(0, "\r\n\tSPI write failed. ADXL362 Disabled");
+
+		SEGGER_RTT_WriteString(0, "\r- 'k': sleep until reset.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'l': send repeated byte on I2C.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'm': send repeated byte on SPI.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'n': enable SSSUPPLY.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'o': disable SSSUPPLY.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'p': switch to VLPR mode.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVMAX11300
+		SEGGER_RTT_WriteString(0, "\r- 'q': MAX11300.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
-				}
-				else
-				{
-					i2c_device_t slave =
-					{
-						.address = i2cAddress,
-						.baudRate_kbps = gWarpI2cBaudRateKbps
-					};
 
-					enableSssupply(menuSupplyVoltage);
-					enableI2Cpins(menuI2cPullupValue);
+		SEGGER_RTT_WriteString(0, "\r- 'r': switch to RUN mode.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 's': power up all sensors.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 't': dump processor state.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'u': set I2C address.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
+		SEGGER_RTT_WriteString(0, "\r- 'v': Enter VLLS0 low-power mode for 3s, then reset\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#endif
+		
+		SEGGER_RTT_WriteString(0, "\r- 'w': Read INA219.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		
+				
+		SEGGER_RTT_WriteString(0, "\r- 'x': disable SWD and spin for 10 secs.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-					commandByte[0] = menuRegisterAddress;
-					i2cStatus = I2C_DRV_MasterSendDataBlocking(
-											0 /* I2C instance */,
-											&slave,
-											commandByte,
-											1,
-											payloadByte,
-											1,
-											gWarpI2cTimeoutMilliseconds);
-					if (i2cStatus != kStatus_I2C_Success)
-					{
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-						SEGGER_RTT_printf(0, "\r\n\tI2C write failed, error %d.\n\n", i2cStatus);
+#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
+		SEGGER_RTT_WriteString(0, "\r- 'y': stress test (need a force quit)\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
-					}
-					disableI2Cpins();
-				}
 
-				/*
-				 *	NOTE: do not disable the supply here, because we typically want to build on the effect of this register write command.
-				 */
+		SEGGER_RTT_WriteString(0, "\r- 'z': dump all sensors data.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				break;
-			}
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+		SEGGER_RTT_WriteString(0, "\r- 'F': stream MMA8451Q FIFO batches, sleeping in VLPS between watermarks.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#endif
 
-			/*
-			 *	Configure default TPS82740 voltage
-			 */
-			case 'g':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tOverride SSSUPPLY in mV (e.g., '1800')> ");
-				menuSupplyVoltage = read4digits();
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tOverride SSSUPPLY set to %d mV", menuSupplyVoltage);
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+		SEGGER_RTT_WriteString(0, "\r- 'G': stream L3GD20H FIFO batches at 800Hz, one burst read per batch.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
 
-				break;
-			}
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+		SEGGER_RTT_WriteString(0, "\r- 'I': stream BMX055 accel and gyro FIFO batches, one burst read per FIFO.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\r- 'Q': BMX055 orientation quaternions at 10Hz from a 100Hz fixed-point filter.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#endif
 
-			/*
-			 *	Activate low-power modes in all sensors.
-			 */
-			case 'h':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
-				activateAllLowPowerSensorModes(true /* verbose */);
+#ifdef WARP_BUILD_ENABLE_BUS_STATISTICS
+		SEGGER_RTT_WriteString(0, "\r- 'B': print and clear per-device I2C/SPI bus statistics.\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+#endif
 
-				break;
-			}
+		SEGGER_RTT_WriteString(0, "\r- 'T': tune the I2C rate of each sensor (and the pull-ups, with the ISL23415).\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-			/*
-			 *	Configure default pullup enable value
-			 */
-			case 'i':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tDefault pullup enable value in kiloOhms (e.g., '0000')> ");
-				menuI2cPullupValue = read4digits();
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+		SEGGER_RTT_WriteString(0, "\r- 'E': INA219 charge per operation (sensor pass, display redraw, MMA8451Q read).\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tI2cPullupValue set to %d\n", menuI2cPullupValue);
+		SEGGER_RTT_WriteString(0, "\r- 'C': INA219 current capture around a trigger (binary dump for 'warp-host decode').\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 #endif
 
-				break;
-			}
+		SEGGER_RTT_WriteString(0, "\rEnter selection> ");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
+		/*
+		 *	Asleep in VLPS between polls for the selection, rather than
+		 *	spinning in SEGGER_RTT_WaitKey() at full clock.
+		 */
+		key = warpEventLoopWaitKey();
+		
+		switch (key)
+		{
 			/*
-			 *	Start repeated read
+			 *		Select sensor
 			 */
-			case 'j':
+			case 'a':
 			{
-				bool		autoIncrement, chatty;
-				int		spinDelay, repetitionsPerAddress, chunkReadsPerAddress;
-				int		adaptiveSssupplyMaxMillivolts;
-				uint8_t		referenceByte;
-
-SEGGER_RTT_WriteString(0, "\r\n\tMade a difference\n\n");				
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tAuto-increment from base address 0x%02x? ['0' | '1']> ", menuRegisterAddress);
+				SEGGER_RTT_WriteString(0, "\r\tSelect:\n");
+#ifdef WARP_BUILD_ENABLE_DEVADXL362
+				SEGGER_RTT_WriteString(0, "\r\t- '1' ADXL362			(0x00--0x2D): 1.6V -- 3.5V\n");
 				#else
-				SEGGER_RTT_WriteString(0, "\r\n\tChunk reads per address (e.g., '1')> ");
+				SEGGER_RTT_WriteString(0, "\r\t- '1' ADXL362			(0x00--0x2D): 1.6V -- 3.5V (compiled out) \n");
 #endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				autoIncrement = SEGGER_RTT_WaitKey() - '0';
-
-				SEGGER_RTT_WriteString(0, "\r\n\tChunk reads per address (e.g., '1')> ");
-				chunkReadsPerAddress = SEGGER_RTT_WaitKey() - '0';
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+				SEGGER_RTT_WriteString(0, "\r\t- '2' BMX055accel		(0x00--0x3F): 2.4V -- 3.6V\n");
+				SEGGER_RTT_WriteString(0, "\r\t- '3' BMX055gyro			(0x00--0x3F): 2.4V -- 3.6V\n");
+				SEGGER_RTT_WriteString(0, "\r\t- '4' BMX055mag			(0x40--0x52): 2.4V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '2' BMX055accel 		(0x00--0x3F): 2.4V -- 3.6V (compiled out) \n");
+				SEGGER_RTT_WriteString(0, "\r\t- '3' BMX055gyro			(0x00--0x3F): 2.4V -- 3.6V (compiled out) \n");
+				SEGGER_RTT_WriteString(0, "\r\t- '4' BMX055mag			(0x40--0x52): 2.4V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tChatty? ['0' | '1']> ");
-				chatty = SEGGER_RTT_WaitKey() - '0';
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+				SEGGER_RTT_WriteString(0, "\r\t- '5' MMA8451Q			(0x00--0x31): 1.95V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '5' MMA8451Q			(0x00--0x31): 1.95V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+//added
 
-				SEGGER_RTT_WriteString(0, "\r\n\tInter-operation spin delay in milliseconds (e.g., '0000')> ");
-				spinDelay = read4digits();
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+				SEGGER_RTT_WriteString(0, "\r\t- 'l' INA219			(0x00--0x31): 1.95V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'l' INA219			(0x00--0x31): 1.95V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+				
+				
+				
+		
+				
+				
+				
+				
+				
+				
+				
+				
+#ifdef WARP_BUILD_ENABLE_DEVLPS25H
+				SEGGER_RTT_WriteString(0, "\r\t- '6' LPS25H			(0x08--0x24): 1.7V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '6' LPS25H			(0x08--0x24): 1.7V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tRepetitions per address (e.g., '0000')> ");
-				repetitionsPerAddress = read4digits();
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+				SEGGER_RTT_WriteString(0, "\r\t- '7' MAG3110			(0x00--0x11): 1.95V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '7' MAG3110			(0x00--0x11): 1.95V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tMaximum voltage for adaptive supply (e.g., '0000')> ");
-				adaptiveSssupplyMaxMillivolts = read4digits();
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+				SEGGER_RTT_WriteString(0, "\r\t- '8' HDC1000			(0x00--0x1F): 3.0V -- 5.0V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '8' HDC1000			(0x00--0x1F): 3.0V -- 5.0V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tReference byte for comparisons (e.g., '3e')> ");
-				referenceByte = readHexByte();
+#ifdef WARP_BUILD_ENABLE_DEVSI7021
+				SEGGER_RTT_WriteString(0, "\r\t- '9' SI7021			(0x00--0x0F): 1.9V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- '9' SI7021			(0x00--0x0F): 1.9V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\n\tRepeating dev%d @ 0x%02x, reps=%d, pull=%d, delay=%dms:\n\n",
-					menuTargetSensor, menuRegisterAddress, repetitionsPerAddress, menuI2cPullupValue, spinDelay);
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+				SEGGER_RTT_WriteString(0, "\r\t- 'a' L3GD20H			(0x0F--0x39): 2.2V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'a' L3GD20H			(0x0F--0x39): 2.2V -- 3.6V (compiled out) \n");
 #endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				repeatRegisterReadForDeviceAndAddress(	menuTargetSensor /*warpSensorDevice*/,
-									menuRegisterAddress /*baseAddress */,
-									menuI2cPullupValue,
-									autoIncrement /*autoIncrement*/,
-									chunkReadsPerAddress,
-									chatty,
-									spinDelay,
-									repetitionsPerAddress,
-									menuSupplyVoltage,
-									adaptiveSssupplyMaxMillivolts,
-									referenceByte
-								);
+#ifdef WARP_BUILD_ENABLE_DEVBME680
+				SEGGER_RTT_WriteString(0, "\r\t- 'b' BME680			(0xAA--0xF8): 1.6V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'b' BME680			(0xAA--0xF8): 1.6V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
 
-				break;
-			}
+#ifdef WARP_BUILD_ENABLE_DEVTCS34725
+				SEGGER_RTT_WriteString(0, "\r\t- 'd' TCS34725			(0x00--0x1D): 2.7V -- 3.3V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'd' TCS34725			(0x00--0x1D): 2.7V -- 3.3V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVSI4705
+				SEGGER_RTT_WriteString(0, "\r\t- 'e' SI4705			(n/a):        2.7V -- 5.5V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'e' SI4705			(n/a):        2.7V -- 5.5V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVPAN1326
+				SEGGER_RTT_WriteString(0, "\r\t- 'f' PAN1326			(n/a)\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'f' PAN1326			(n/a) (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVCCS811
+				SEGGER_RTT_WriteString(0, "\r\t- 'g' CCS811			(0x00--0xFF): 1.8V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'g' CCS811			(0x00--0xFF): 1.8V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVAMG8834
+				SEGGER_RTT_WriteString(0, "\r\t- 'h' AMG8834			(0x00--?): ?V -- ?V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'h' AMG8834			(0x00--?): ?V -- ?V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVAS7262
+				SEGGER_RTT_WriteString(0, "\r\t- 'j' AS7262			(0x00--0x2B): 2.7V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'j' AS7262			(0x00--0x2B): 2.7V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+#ifdef WARP_BUILD_ENABLE_DEVAS7263
+				SEGGER_RTT_WriteString(0, "\r\t- 'k' AS7263			(0x00--0x2B): 2.7V -- 3.6V\n");
+				#else
+				SEGGER_RTT_WriteString(0, "\r\t- 'k' AS7263			(0x00--0x2B): 2.7V -- 3.6V (compiled out) \n");
+#endif
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+				SEGGER_RTT_WriteString(0, "\r\tEnter selection> ");
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+				key = SEGGER_RTT_WaitKey();
+
+				switch(key)
+				{
+#ifdef WARP_BUILD_ENABLE_DEVADXL362
+					case '1':
+					{
+						menuTargetSensor = kWarpSensorADXL362;
+
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+					case '2':
+					{
+						menuTargetSensor = kWarpSensorBMX055accel;
+						menuI2cDevice = &deviceBMX055accelState;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+					case '3':
+					{
+						menuTargetSensor = kWarpSensorBMX055gyro;
+						menuI2cDevice = &deviceBMX055gyroState;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+					case '4':
+					{
+						menuTargetSensor = kWarpSensorBMX055mag;
+						menuI2cDevice = &deviceBMX055magState;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+					case '5':
+					{
+						menuTargetSensor = kWarpSensorMMA8451Q;
+						menuI2cDevice = &deviceMMA8451QState;
+						break;
+					}					
+#endif						
+//added		
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+					case 'l':
+					{
+						menuTargetSensor = kWarpSensorINA219;
+						menuI2cDevice = &deviceINA219State;
+						break;
+					}					
+#endif
+	
+						
+						
+						
+						
+						
+						
+						
+						
+#ifdef WARP_BUILD_ENABLE_DEVLPS25H
+					case '6':
+					{
+						menuTargetSensor = kWarpSensorLPS25H;
+						menuI2cDevice = &deviceLPS25HState;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+					case '7':
+					{
+						menuTargetSensor = kWarpSensorMAG3110;
+						menuI2cDevice = &deviceMAG3110State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+					case '8':
+					{
+						menuTargetSensor = kWarpSensorHDC1000;
+						menuI2cDevice = &deviceHDC1000State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVSI7021
+					case '9':
+					{
+						menuTargetSensor = kWarpSensorSI7021;
+						menuI2cDevice = &deviceSI7021State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+					case 'a':
+					{
+						menuTargetSensor = kWarpSensorL3GD20H;
+						menuI2cDevice = &deviceL3GD20HState;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBME680
+					case 'b':
+					{
+						menuTargetSensor = kWarpSensorBME680;
+						menuI2cDevice = &deviceBME680State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVTCS34725
+					case 'd':
+					{
+						menuTargetSensor = kWarpSensorTCS34725;
+						menuI2cDevice = &deviceTCS34725State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVSI4705
+					case 'e':
+					{
+						menuTargetSensor = kWarpSensorSI4705;
+						menuI2cDevice = &deviceSI4705State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVPAN1326
+					case 'f':
+					{
+						menuTargetSensor = kWarpSensorPAN1326;
+
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVCCS811
+					case 'g':
+					{
+						menuTargetSensor = kWarpSensorCCS811;
+						menuI2cDevice = &deviceCCS811State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVAMG8834
+					case 'h':
+					{
+						menuTargetSensor = kWarpSensorAMG8834;
+						menuI2cDevice = &deviceAMG8834State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVAS7262
+					case 'j':
+					{
+						menuTargetSensor = kWarpSensorAS7262;
+						menuI2cDevice = &deviceAS7262State;
+						break;
+					}
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVAS7263
+					case 'k':
+					{
+						menuTargetSensor = kWarpSensorAS7263;
+						menuI2cDevice = &deviceAS7263State;
+						break;
+					}
+#endif
+					default:
+					{
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+						SEGGER_RTT_printf(0, "\r\tInvalid selection '%c' !\n", key);
+#endif
+					}
+				}
+
+				break;
+			}
+
+			/*
+			 *	Change default I2C baud rate
+			 */
+			case 'b':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tSet I2C baud rate in kbps (e.g., '0001')> ");
+				gWarpI2cBaudRateKbps = read4digits();
+
+				/*
+				 *	Round 9999kbps to 10Mbps
+				 */
+				if (gWarpI2cBaudRateKbps == 9999)
+				{
+					gWarpI2cBaudRateKbps = 10000;
+				}
+
+				/*
+				 *	A rate set by hand applies to all devices
+				 */
+				warpI2cTuningReset();
+
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tI2C baud rate set to %d kb/s", gWarpI2cBaudRateKbps);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Change default SPI baud rate
+			 */
+			case 'c':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tSet SPI baud rate in kbps (e.g., '0001')> ");
+				gWarpSpiBaudRateKbps = read4digits();
+
+				/*
+				 *	Round 9999kbps to 10Mbps
+				 */
+				if (gWarpSpiBaudRateKbps == 9999)
+				{
+					gWarpSpiBaudRateKbps = 10000;
+				}
+
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tSPI baud rate: %d kb/s", gWarpSpiBaudRateKbps);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Change default UART baud rate
+			 */
+			case 'd':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tSet UART baud rate in kbps (e.g., '0001')> ");
+				gWarpUartBaudRateKbps = read4digits();
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tUART baud rate: %d kb/s", gWarpUartBaudRateKbps);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Set register address for subsequent operations
+			 */
+			case 'e':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tEnter 2-nybble register hex address (e.g., '3e')> ");
+				menuRegisterAddress = readHexByte();
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n\n", menuRegisterAddress);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Write byte to sensor
+			 */
+			case 'f':
+			{
+				uint8_t		i2cAddress, payloadByte[1], commandByte[1];
+				i2c_status_t	i2cStatus;
+				WarpStatus	status;
+
+
+				USED(status);
+				SEGGER_RTT_WriteString(0, "\r\n\tEnter I2C addr. (e.g., '0f') or '99' for SPI > ");
+				i2cAddress = readHexByte();
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n", i2cAddress);
+#endif
+
+				SEGGER_RTT_WriteString(0, "\r\n\tEnter hex byte to send (e.g., '0f')> ");
+				payloadByte[0] = readHexByte();
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tEntered [0x%02x].\n", payloadByte[0]);
+#endif
+
+				if (i2cAddress == 0x99)
+				{
+#ifdef WARP_BUILD_ENABLE_DEVADXL362
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+					SEGGER_RTT_printf(0, "\r\n\tWriting [0x%02x] to SPI register [0x%02x]...\n", payloadByte[0], menuRegisterAddress);
+#endif
+					status = writeSensorRegisterADXL362(	0x0A			/* command == write register	*/,
+										menuRegisterAddress,
+										payloadByte[0]		/* writeValue			*/
+									);
+					if (status != kWarpStatusOK)
+					{
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+						SEGGER_RTT_printf(0, "\r\n\tSPI write failed, error %d.\n\n", status);
+#endif
+					}
+					#else
+					SEGGER_RTT_WriteString(0, "\r\n\tSPI write failed. ADXL362 Disabled");
+#endif
+				}
+				else
+				{
+					i2c_device_t slave =
+					{
+						.address = i2cAddress,
+						.baudRate_kbps = warpI2cBaudRateKbps(i2cAddress)
+					};
+
+					enableSssupply(menuSupplyVoltage);
+					enableI2Cpins(menuI2cPullupValue);
+
+					commandByte[0] = menuRegisterAddress;
+					i2cStatus = warpI2CMasterSendDataBlocking(
+											0 /* I2C instance */,
+											&slave,
+											commandByte,
+											1,
+											payloadByte,
+											1,
+											gWarpI2cTimeoutMilliseconds);
+					if (i2cStatus != kStatus_I2C_Success)
+					{
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+						SEGGER_RTT_printf(0, "\r\n\tI2C write failed, error %d.\n\n", i2cStatus);
+#endif
+					}
+					disableI2Cpins();
+				}
+
+				/*
+				 *	NOTE: do not disable the supply here, because we typically want to build on the effect of this register write command.
+				 */
+
+				break;
+			}
+
+			/*
+			 *	Configure default TPS82740 voltage
+			 */
+			case 'g':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tOverride SSSUPPLY in mV (e.g., '1800')> ");
+				menuSupplyVoltage = read4digits();
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tOverride SSSUPPLY set to %d mV", menuSupplyVoltage);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Activate low-power modes in all sensors.
+			 */
+			case 'h':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
+				activateAllLowPowerSensorModes(true /* verbose */);
+
+				break;
+			}
+
+			/*
+			 *	Configure default pullup enable value
+			 */
+			case 'i':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tDefault pullup enable value in kiloOhms (e.g., '0000')> ");
+				menuI2cPullupValue = read4digits();
+
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tI2cPullupValue set to %d\n", menuI2cPullupValue);
+#endif
+
+				break;
+			}
+
+			/*
+			 *	Start repeated read
+			 */
+			case 'j':
+			{
+				bool		autoIncrement, chatty;
+				int		spinDelay, repetitionsPerAddress, chunkReadsPerAddress;
+				int		adaptiveSssupplyMaxMillivolts;
+				uint8_t		referenceByte;
+
+SEGGER_RTT_WriteString(0, "\r\n\tMade a difference\n\n");				
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tAuto-increment from base address 0x%02x? ['0' | '1']> ", menuRegisterAddress);
+				#else
+				SEGGER_RTT_WriteString(0, "\r\n\tChunk reads per address (e.g., '1')> ");
+#endif
+
+				autoIncrement = SEGGER_RTT_WaitKey() - '0';
+
+				SEGGER_RTT_WriteString(0, "\r\n\tChunk reads per address (e.g., '1')> ");
+				chunkReadsPerAddress = SEGGER_RTT_WaitKey() - '0';
+
+				SEGGER_RTT_WriteString(0, "\r\n\tChatty? ['0' | '1']> ");
+				chatty = SEGGER_RTT_WaitKey() - '0';
+
+				SEGGER_RTT_WriteString(0, "\r\n\tInter-operation spin delay in milliseconds (e.g., '0000')> ");
+				spinDelay = read4digits();
+
+				SEGGER_RTT_WriteString(0, "\r\n\tRepetitions per address (e.g., '0000')> ");
+				repetitionsPerAddress = read4digits();
+
+				SEGGER_RTT_WriteString(0, "\r\n\tMaximum voltage for adaptive supply (e.g., '0000')> ");
+				adaptiveSssupplyMaxMillivolts = read4digits();
+
+				SEGGER_RTT_WriteString(0, "\r\n\tReference byte for comparisons (e.g., '3e')> ");
+				referenceByte = readHexByte();
+
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\n\tRepeating dev%d @ 0x%02x, reps=%d, pull=%d, delay=%dms:\n\n",
+					menuTargetSensor, menuRegisterAddress, repetitionsPerAddress, menuI2cPullupValue, spinDelay);
+#endif
+
+				repeatRegisterReadForDeviceAndAddress(	menuTargetSensor /*warpSensorDevice*/,
+									menuRegisterAddress /*baseAddress */,
+									menuI2cPullupValue,
+									autoIncrement /*autoIncrement*/,
+									chunkReadsPerAddress,
+									chatty,
+									spinDelay,
+									repetitionsPerAddress,
+									menuSupplyVoltage,
+									adaptiveSssupplyMaxMillivolts,
+									referenceByte
+								);
+
+				break;
+			}
+
+			/*
+			 *	Sleep for 30 seconds.
+			 */
+			case 'k':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tSleeping until system reset...\n");
+				sleepUntilReset();
+
+				break;
+			}
+
+
+			/*
+			 *	Send repeated byte on I2C or SPI
+			 */
+						
+				
+			case 'l':			
+			case 'm':
+			{
+				uint8_t		outBuffer[1];
+				int		repetitions;
+
+				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
+				SEGGER_RTT_WriteString(0, "\r\n\tByte to send (e.g., 'F0')> ");
+				outBuffer[0] = readHexByte();
+
+				SEGGER_RTT_WriteString(0, "\r\n\tRepetitions (e.g., '0000')> ");
+				repetitions = read4digits();
+
+				if (key == 'l')
+				{
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+					SEGGER_RTT_printf(0, "\r\n\tSending %d repetitions of [0x%02x] on I2C, i2cPullupEnable=%d, SSSUPPLY=%dmV\n\n",
+						repetitions, outBuffer[0], menuI2cPullupValue, menuSupplyVoltage);
+#endif
+					for (int i = 0; i < repetitions; i++)
+					{
+						writeByteToI2cDeviceRegister(0xFF, true /* sedCommandByte */, outBuffer[0] /* commandByte */, false /* sendPayloadByte */, 0 /* payloadByte */);
+					}
+				}
+				else
+				{
+#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+					SEGGER_RTT_printf(0, "\r\n\tSending %d repetitions of [0x%02x] on SPI, SSSUPPLY=%dmV\n\n",
+						repetitions, outBuffer[0], menuSupplyVoltage);
+#endif
+					for (int i = 0; i < repetitions; i++)
+					{
+						writeBytesToSpi(outBuffer /* payloadByte */, 1 /* payloadLength */);
+					}
+				}
+
+				break;
+			}
+
+
+			/*
+			 *	enable SSSUPPLY
+			 */
+			case 'n':
+			{
+				enableSssupply(menuSupplyVoltage);
+				break;
+			}
+
+			/*
+			 *	disable SSSUPPLY
+			 */
+			case 'o':
+			{
+				disableSssupply();
+				break;
+			}
+
+			/*
+			 *	Switch to VLPR
+			 */
+			case 'p':
+			{
+				warpSetLowPowerMode(kWarpPowerModeVLPR, 0 /* sleep seconds : irrelevant here */);
+				break;
+			}
+#ifdef WARP_BUILD_ENABLE_DEVMAX11300
+			case 'q':
+			{
+				SEGGER_RTT_printf(0, "\r\tMAX11300 Configuration\n");
+				devMAX11300();
+				break;
+			}
+#endif
+
+			/*
+			 *	Switch to RUN
+			 */
+			case 'r':
+			{
+				warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
+				break;
+			}
+
+			/*
+			 *	Power up all sensors
+			 */
+			case 's':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
+				powerupAllSensors();
+				break;
+			}
+
+			/*
+			 *	Dump processor state
+			 */
+			case 't':
+			{
+				//dumpProcessorState();
+				runPedometer();
+				break;
+			}
+
+			case 'u':
+			{
+				if (menuI2cDevice == NULL)
+				{
+					SEGGER_RTT_WriteString(0, "\r\n\tCannot set I2C address: First set the default I2C device.\n");
+				}
+				else
+				{
+					SEGGER_RTT_WriteString(0, "\r\n\tSet I2C address of the selected sensor(e.g., '1C')> ");
+					uint8_t address = readHexByte();
+					menuI2cDevice->i2cAddress = address;
+				}
+
+				break;
+			}
+#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
+			case 'v':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tEnabling I2C pins\n");
+				enableI2Cpins(menuI2cPullupValue);
+				SEGGER_RTT_WriteString(0, "\r\n\tSleeping for 3 seconds, then resetting\n");
+				warpSetLowPowerMode(kWarpPowerModeVLLS0, 3 /* sleep seconds */);
+				SEGGER_RTT_WriteString(0, "\r\n\tThis should never happen...\n");
+			}
+#endif
+				
+
+				
+				
+//Added					
+				
+			case 'w':
+			{			
+				enableI2Cpins(menuI2cPullupValue);
+				
+				SEGGER_RTT_WriteString(0, "\r\n\tConfig\n");
+				
+				                //write to config register
+                		writeSensorRegisterINA219(0x00, 0x019F, menuI2cPullupValue);
+                
+                		//write to calibration register
+               			writeSensorRegisterINA219(0x05, 0x2000, menuI2cPullupValue);
+				
+				SEGGER_RTT_WriteString(0, "\r\n\tStarting read\n");		
+								
+				int k;
+				bool hexModeFlag;
+				k = 0;
+				hexModeFlag = 1;
+	
+				/*
+				while( k < 10 ) 
+				{		
+
+				k++;
+				printSensorDataINA219(hexModeFlag);
+					
+				SEGGER_RTT_WriteString(0, "\r\n\t \n");
+					
+				}
+				*/
+				//configure accelerometer
+				
+				#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+				configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
+				0x01,/* Normal read 8bit, 800Hz, normal, active mode */
+				menuI2cPullupValue
+				);
+				#endif
+				
+				int16_t		readings[3];
+				
+				SEGGER_RTT_WriteString(0, "\r\n\treadings from print \n");
+							
+				printSensorDataMMA8451Q(0);
+				
+				SEGGER_RTT_WriteString(0, "\r\n\treadings from burst read \n");
+				
+				if (readSensorXYZMMA8451Q(readings) != kWarpStatusOK)
+				{
+					SEGGER_RTT_WriteString(0, " ----, ----, ----,");
+				}
+				else
+				{
+					SEGGER_RTT_printf(0, " %d,", readings[0]);
+					SEGGER_RTT_printf(0, " %d,", readings[1]);
+					SEGGER_RTT_printf(0, " %d,", readings[2]);
+				}
+				disableI2Cpins();
+		
+				//writeSensorRegisterINA219(0x05,2000,menuI2cPullupValue);
+				//writeSensorRegisterINA219(0x00,)
+				/*
+				int k;
+				int p;
+				k=0;
+				p=0;
+				int shunt;
+				int bus;
+				int power;
+				int current;
+				SEGGER_RTT_printf(0, "\r\n\Shunt voltage\n"); 
+				while( k < 3 ) 
+				{
+				k++;
+				
+				//OSA_TimeDelay(1);
+				
+				shunt = readSensorRegisterINA219(0x01,2);
+				bus = readSensorRegisterINA219(0x02,2);
+				power = readSensorRegisterINA219(0x03,2);
+				current = readSensorRegisterINA219(0x04,2);
+				
+				//SEGGER_RTT_printf(0, "\r\n\tread\n");
+				
+				SEGGER_RTT_printf(0, "\r\n\Current\n");	
+				SEGGER_RTT_printf(0," %d,", shunt);				
+				SEGGER_RTT_printf(0," %d,", current);
+				
+				SEGGER_RTT_printf(0, "\r\n\ \n");
+				}
+				
+				
+				
+				SEGGER_RTT_printf(0, "\r\n\Current\n");
+				
+				*/
+				/*
+				while (p<1001)
+				{
+				p++;
+				shunt = readSensorRegisterINA219(0x01,2);
+				bus = readSensorRegisterINA219(0x02,2);
+				power = readSensorRegisterINA219(0x03,2);
+				current = readSensorRegisterINA219(0x04,2);
+				SEGGER_RTT_printf(0," %d,", current);
+				//SEGGER_RTT_printf(0, "\r\n\tread\n");
+				//SEGGER_RTT_printf(0, "\r\n\Shunt voltage\n");
+				//SEGGER_RTT_printf(0, "\r\n\Current\n");	
+				//SEGGER_RTT_printf(0," %d,", shunt);				
+				
+				
+				SEGGER_RTT_printf(0, "\r\n\ \n");	
+					
+				}	
+				*/
+					/*
+				
+				bool		autoIncrement, chatty;
+				int		spinDelay, repetitionsPerAddress, chunkReadsPerAddress;
+				int		adaptiveSssupplyMaxMillivolts;
+				uint8_t		referenceByte;
+				
+				repeatRegisterReadForDeviceAndAddress(	menuTargetSensor ,
+									menuRegisterAddress ,
+									menuI2cPullupValue,
+									autoIncrement ,
+									chunkReadsPerAddress,
+									chatty,
+									spinDelay,
+									repetitionsPerAddress,
+									menuSupplyVoltage,
+									adaptiveSssupplyMaxMillivolts,
+									referenceByte
+								)
+				
+				#ifdef WARP_BUILD_ENABLE_DEVINA219
+				//printSensorDataINA219(hexModeFlag);
+				#endif	
+				
+				*/
+					/*warpSensorDevice*/
+					/*baseAddress */
+					/*autoIncrement*/
+					
+				//disableI2Cpins();
+				
+				//OSA_TimeDelay(10000);
+				//SEGGER_RTT_WriteString(0, "\r\tDone.\n\n");
+
+				break;
+			}	
+				
+						
+				
+			/*
+			 *	Simply spin for 10 seconds. Since the SWD pins should only be enabled when we are waiting for key at top of loop (or toggling after printf), during this time there should be no interference from the SWD.
+			 */
+			case 'x':
+			{
+				SEGGER_RTT_WriteString(0, "\r\n\tSpinning for 10 seconds...\n");
+				OSA_TimeDelay(10000);
+				SEGGER_RTT_WriteString(0, "\r\tDone.\n\n");
+
+				break;
+			}
+
+			/*
+			 *	Stress test, including bit-wise toggling and checksum, as well as extensive add and mul, with continous read and write to I2C MMA8451Q
+			 */
+#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
+			case 'y':
+			{
+				break;
+			}
+#endif	
+				
+				/*
+			 *	Dump all the sensor data in one go
+			 */
+			case 'z':
+			{
+				bool		hexModeFlag;
+				bool		binaryModeFlag;
+
+				SEGGER_RTT_WriteString(0, "\r\n\tEnabling I2C pins...\n");
+				enableI2Cpins(menuI2cPullupValue);
+
+				SEGGER_RTT_WriteString(0, "\r\n\tHex, converted, binary framed or scheduled mode? ('h', 'c', 'b' or 's')> ");
+				key = SEGGER_RTT_WaitKey();
+				hexModeFlag = (key == 'h' ? 1 : 0);
+				binaryModeFlag = (key == 'b');
+
+				if (key == 's')
+				{
+					printScheduledSensors(false /* hexModeFlag */, menuI2cPullupValue, 0 /* numberOfRecords: forever */);
+				}
+
+				SEGGER_RTT_WriteString(0, "\r\n\tSet the time delay between each run in milliseconds (e.g., '1234')> ");
+				uint16_t	menuDelayBetweenEachRun = read4digits();
+				SEGGER_RTT_printf(0, "\r\n\tDelay between read batches set to %d milliseconds.\n\n", menuDelayBetweenEachRun);
+				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+				if (binaryModeFlag)
+				{
+					streamAllSensorsBinary(menuDelayBetweenEachRun, menuI2cPullupValue, 0 /* numberOfFrames: forever */);
+				}
+
+				printAllSensors(true /* printHeadersAndCalibration */, hexModeFlag, menuDelayBetweenEachRun, menuI2cPullupValue);
+
+				/*
+				 *	Not reached (printAllSensors() does not return)
+				 */
+				disableI2Cpins();
+
+				break;
+			}
+
+
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+			/*
+			 *	Stream eight FIFO watermark batches from the MMA8451Q
+			 */
+			case 'F':
+			{
+				runAccelerationFifoStream(8 /* batches */);
+
+				break;
+			}
+#endif
+
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+			/*
+			 *	Stream eight FIFO watermark batches from the L3GD20H
+			 */
+			case 'G':
+			{
+				runGyroFifoStream(8 /* batches */);
+
+				break;
+			}
+#endif
+
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+			/*
+			 *	Stream eight 50ms FIFO batches from the BMX055 accel and gyro
+			 */
+			case 'I':
+			{
+				runImuFifoStream(8 /* batches */);
+
+				break;
+			}
+
+			/*
+			 *	Ten seconds of BMX055 orientation quaternions
+			 */
+			case 'Q':
+			{
+				runOrientationFilter(100 /* sampleRateHz */, 10 /* outputDivider */, 100 /* numberOfOutputs */);
+
+				break;
+			}
+#endif
+
+#ifdef WARP_BUILD_ENABLE_BUS_STATISTICS
+			/*
+			 *	Bus statistics since boot or the last 'B'
+			 */
+			case 'B':
+			{
+				printBusStatistics();
+				resetBusStatistics();
+
+				break;
+			}
+#endif
+
+			/*
+			 *	Per-device I2C rates (and pull-ups)
+			 */
+			case 'T':
+			{
+				menuI2cPullupValue = runI2cTuning(menuI2cPullupValue);
+
+				break;
+			}
+
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+			/*
+			 *	Charge per operation, ten runs each
+			 */
+			case 'E':
+			{
+				runEnergyProfiles(10 /* runs */, menuI2cPullupValue);
+
+				break;
+			}
+
+			/*
+			 *	Current capture
+			 */
+			case 'C':
+			{
+				int16_t		level = 0;
+
+				SEGGER_RTT_WriteString(0, "\r\n\tTrigger on a RUN/VLPR switch, the MMA8451Q INT1 pin or a current level? ('s', 'p' or 'l')> ");
+				key = SEGGER_RTT_WaitKey();
+
+				if (key == 'l')
+				{
+					SEGGER_RTT_WriteString(0, "\r\n\tEnter the trigger level in 100uA counts (e.g., '0100')> ");
+					level = read4digits();
+				}
+
+				SEGGER_RTT_WriteString(0, "\r\n");
+				runCurrentCapture((key == 'p') ? kWarpCaptureTriggerPin : ((key == 'l') ? kWarpCaptureTriggerLevel : kWarpCaptureTriggerSoftware),
+							level, menuI2cPullupValue);
+
+				break;
+			}
+#endif
 
 			/*
-			 *	Sleep for 30 seconds.
+			 *	Ignore naked returns.
 			 */
-			case 'k':
+			case '\n':
 			{
-				SEGGER_RTT_WriteString(0, "\r\n\tSleeping until system reset...\n");
-				sleepUntilReset();
+				SEGGER_RTT_WriteString(0, "\r\tPayloads make rockets more than just fireworks.");
+				break;
+			}
+
+			default:
+			{
+				#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				SEGGER_RTT_printf(0, "\r\tInvalid selection '%c' !\n", key);
+				#endif
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+/*
+ *	Configure every enabled sensor for printAllSensors() and
+ *	streamAllSensorsBinary(); returns the number of configuration errors.
+ */
+static uint32_t
+configureAllSensors(bool printCalibration, int i2cPullupValue)
+{
+	uint32_t	numberOfConfigErrors = 0;
+
+
+	#ifdef WARP_BUILD_ENABLE_DEVAMG8834
+	numberOfConfigErrors += configureSensorAMG8834(	0x3F,/* Initial reset */
+					0x01,/* Frame rate 1 FPS */
+					i2cPullupValue
+					);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	numberOfConfigErrors += configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
+					0x01,/* Normal read 8bit, 800Hz, normal, active mode */
+					i2cPullupValue
+					);
+	#endif
+
+	
+//added	
+//	#ifdef WARP_BUILD_ENABLE_DEVINA219
+//	numberOfConfigErrors += configureSensorINA219(0x199,
+//					i2cPullupValue
+//					);
+
+//	#endif
+	
+	
+	
+	
+	#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	numberOfConfigErrors += configureSensorMAG3110(	0x00,/*	Payload: DR 000, OS 00, 80Hz, ADC 1280, Full 16bit, standby mode to set up register*/
+					0xA0,/*	Payload: AUTO_MRST_EN enable, RAW value without offset */
+					i2cPullupValue
+					);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+	numberOfConfigErrors += configureSensorL3GD20H(	0b11111111,/* ODR 800Hz, Cut-off 100Hz, see table 21, normal mode, x,y,z enable */
+					0b00100000,
+					0b00000000,/* normal mode, disable FIFO, disable high pass filter */
+					i2cPullupValue
+					);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVBME680
+	numberOfConfigErrors += configureSensorBME680(	0b00000001,	/*	Humidity oversampling (OSRS) to 1x				*/
+							0b00100100,	/*	Temperature oversample 1x, pressure overdsample 1x, mode 00	*/
+							0b00001000,	/*	Turn off heater							*/
+							i2cPullupValue
+					);
+
+	if (printCalibration)
+	{
+		SEGGER_RTT_WriteString(0, "\r\n\nBME680 Calibration Data: ");
+		for (uint8_t i = 0; i < kWarpSizesBME680CalibrationValuesCount; i++)
+		{
+			#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+			SEGGER_RTT_printf(0, "0x%02x", deviceBME680CalibrationValues[i]);
+			if (i < kWarpSizesBME680CalibrationValuesCount - 1)
+			{
+				SEGGER_RTT_WriteString(0, ", ");
+			}
+			else
+			{
+				SEGGER_RTT_WriteString(0, "\n\n");
+			}
+
+			OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+			#endif
+		}
+	}
+	#endif
+
+	#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	numberOfConfigErrors += writeSensorRegisterHDC1000(kWarpSensorConfigurationRegisterHDC1000Configuration,/* Configuration register	*/
+					kWarpHDC1000ConfigurationSequential,/* 14-bit temperature and humidity from one trigger */
+					i2cPullupValue
+					);
+	#endif
+
+	#ifdef WARP_BUILD_ENABLE_DEVCCS811
+	uint8_t		payloadCCS811[1];
+	payloadCCS811[0] = 0b01000000;/* Constant power, measurement every 250ms */
+	numberOfConfigErrors += configureSensorCCS811(payloadCCS811,
+					i2cPullupValue
+					);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	numberOfConfigErrors += configureSensorBMX055accel(0b00000011,/* Payload:+-2g range */
+					0b10000000,/* Payload:unfiltered data, shadowing enabled */
+					i2cPullupValue
+					);
+	numberOfConfigErrors += configureSensorBMX055mag(0b00000001,/* Payload:from suspend mode to sleep mode*/
+					0b00000001,/* Default 10Hz data rate, forced mode*/
+					i2cPullupValue
+					);
+	numberOfConfigErrors += configureSensorBMX055gyro(0b00000100,/* +- 125degrees/s */
+					0b00000000,/* ODR 2000 Hz, unfiltered */
+					0b00000000,/* normal mode */
+					0b10000000,/* unfiltered data, shadowing enabled */
+					i2cPullupValue
+					);
+	#endif
+
+
+	return numberOfConfigErrors;
+}
+
+#ifdef WARP_BUILD_ENABLE_DEFERRED_LOG
+static uint8_t		gWarpLogBuffer[kWarpLogRttBufferSize];
+static uint32_t		gWarpLogDroppedRecords;
+
+static bool
+writeLogRecord(const uint32_t *  words, size_t argumentCount)
+{
+	uint8_t		record[kWarpLogRecordHeaderBytes + kWarpLogMaxArguments*sizeof(uint32_t)];
+	uint8_t *	cursor = record;
+
+	argumentCount = min(argumentCount, kWarpLogMaxArguments);
+	*cursor++ = words[0];
+	*cursor++ = argumentCount;
+	for (size_t i = 1; i <= argumentCount; i++)
+	{
+		*cursor++ = words[i];
+		*cursor++ = words[i] >> 8;
+		*cursor++ = words[i] >> 16;
+		*cursor++ = words[i] >> 24;
+	}
+
+	/*
+	 *	In SEGGER_RTT_MODE_NO_BLOCK_SKIP the record goes in whole or not at all.
+	 */
+	return SEGGER_RTT_Write(kWarpLogRttChannel, record, cursor - record) == (unsigned)(cursor - record);
+}
+
+void
+warpLogInit(void)
+{
+	SEGGER_RTT_ConfigUpBuffer(kWarpLogRttChannel, "WarpLog", gWarpLogBuffer, sizeof(gWarpLogBuffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+}
+
+void
+warpLogRecord(const uint32_t *  words, size_t argumentCount)
+{
+	if (gWarpLogDroppedRecords > 0)
+	{
+		uint32_t	dropped[] = {kWarpLogDropped, gWarpLogDroppedRecords};
+
+		if (!writeLogRecord(dropped, 1))
+		{
+			gWarpLogDroppedRecords++;
+			return;
+		}
+		gWarpLogDroppedRecords = 0;
+	}
+
+	if (!writeLogRecord(words, argumentCount))
+	{
+		gWarpLogDroppedRecords++;
+	}
+}
+#else
+static const char * const	gWarpLogFormats[] =
+{
+#define WARP_LOG_MESSAGE(name, format)	[name] = format,
+#include "warp-log-messages.h"
+#undef WARP_LOG_MESSAGE
+};
+
+void
+warpLogInit(void)
+{
+}
+
+void
+warpLogPrint(unsigned message, ...)
+{
+	va_list		arguments;
+
+	va_start(arguments, message);
+	SEGGER_RTT_vprintf(0, gWarpLogFormats[message], &arguments);
+	va_end(arguments);
+}
+#endif
+
+/*
+ *	One pass over the sensors of printAllSensors(): their columns of one
+ *	CSV row, without the row start and end.
+ */
+static void
+printAllSensorsPass(bool hexModeFlag)
+{
+	#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	/*
+	 *	Start the HDC1000 first and collect it last, so that its
+	 *	conversion runs while the other sensors are read.
+	 */
+	uint32_t	hdc1000TriggerMicroseconds = warpTimestampMicroseconds();
+	triggerSensorHDC1000();
+	#endif
+
+	#ifdef WARP_BUILD_ENABLE_DEVAMG8834
+	printSensorDataAMG8834(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	printSensorDataMMA8451Q(hexModeFlag);
+	#endif
+//added				
+	#ifdef WARP_BUILD_ENABLE_DEVINA219
+	printSensorDataINA219(hexModeFlag);
+	#endif		
+	#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	printSensorDataMAG3110(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+	printSensorDataL3GD20H(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVBME680
+	triggerSensorBME680();
+	printSensorDataBME680(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	printSensorDataBMX055accel(hexModeFlag);
+	printSensorDataBMX055mag(hexModeFlag);
+	printSensorDataBMX055gyro(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVCCS811
+	printSensorDataCCS811(hexModeFlag);
+	#endif
+	#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	uint32_t	hdc1000ElapsedMicroseconds = warpTimestampMicroseconds() - hdc1000TriggerMicroseconds;
+	if (hdc1000ElapsedMicroseconds < kWarpHDC1000ConversionMicroseconds)
+	{
+		OSA_TimeDelay((kWarpHDC1000ConversionMicroseconds - hdc1000ElapsedMicroseconds + 999) / 1000);
+	}
+	printSensorDataHDC1000(hexModeFlag);
+	#endif
+}
+
+void
+printAllSensors(bool printHeadersAndCalibration, bool hexModeFlag, int menuDelayBetweenEachRun, int i2cPullupValue)
+{
+	/*
+	 *	A 32-bit counter gives us > 2 years of before it wraps, even if sampling at 60fps
+	 */
+	uint32_t	readingCount = 0;
+	uint32_t	numberOfConfigErrors;
+
+
+	numberOfConfigErrors = configureAllSensors(printHeadersAndCalibration, i2cPullupValue);
+
+	if (printHeadersAndCalibration)
+	{
+		SEGGER_RTT_WriteString(0, "Measurement number, RTC->TSR, RTC->TPR,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+
+		#ifdef WARP_BUILD_ENABLE_DEVAMG8834
+		for (uint8_t i = 0; i < 64; i++)
+		{
+			#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+			SEGGER_RTT_printf(0, " AMG8834 %d,", i);
+			OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+			#endif
+		}
+		SEGGER_RTT_WriteString(0, " AMG8834 Temp,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+
+		#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+		SEGGER_RTT_WriteString(0, " MMA8451 x, MMA8451 y, MMA8451 z,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+//added		
+		#ifdef WARP_BUILD_ENABLE_DEVINA219
+		SEGGER_RTT_WriteString(0, " INA219 Power, INA219 Current,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		
+		
+		
+		
+		
+		
+		
+		
+		#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+		SEGGER_RTT_WriteString(0, " MAG3110 x, MAG3110 y, MAG3110 z, MAG3110 Temp,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+		SEGGER_RTT_WriteString(0, " L3GD20H x, L3GD20H y, L3GD20H z, L3GD20H Temp,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		#ifdef WARP_BUILD_ENABLE_DEVBME680
+		SEGGER_RTT_WriteString(0, " BME680 Press, BME680 Temp, BME680 Hum,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		#ifdef WARP_BUILD_ENABLE_DEVBMX055
+		SEGGER_RTT_WriteString(0, " BMX055acc x, BMX055acc y, BMX055acc z, BMX055acc Temp,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, " BMX055mag x, BMX055mag y, BMX055mag z, BMX055mag RHALL,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, " BMX055gyro x, BMX055gyro y, BMX055gyro z,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		#ifdef WARP_BUILD_ENABLE_DEVCCS811
+		SEGGER_RTT_WriteString(0, " CCS811 ECO2, CCS811 TVOC, CCS811 RAW ADC value, CCS811 RAW R_REF value, CCS811 RAW R_NTC value,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+		SEGGER_RTT_WriteString(0, " HDC1000 Temp, HDC1000 Hum,");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		#endif
+		SEGGER_RTT_WriteString(0, " RTC->TSR, RTC->TPR, # Config Errors");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_WriteString(0, "\n\n");
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	}
 
-				break;
-			}
 
+	while(1)
+	{
+		#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+		WARP_LOG(kWarpLogCsvRowStart, readingCount, RTC->TSR, RTC->TPR);
+		#endif
 
-			/*
-			 *	Send repeated byte on I2C or SPI
-			 */
-						
-				
-			case 'l':			
-			case 'm':
-			{
-				uint8_t		outBuffer[1];
-				int		repetitions;
+		printAllSensorsPass(hexModeFlag);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
-				SEGGER_RTT_WriteString(0, "\r\n\tByte to send (e.g., 'F0')> ");
-				outBuffer[0] = readHexByte();
 
-				SEGGER_RTT_WriteString(0, "\r\n\tRepetitions (e.g., '0000')> ");
-				repetitions = read4digits();
+		#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+		WARP_LOG(kWarpLogCsvRowEnd, RTC->TSR, RTC->TPR, numberOfConfigErrors);
+		#endif
 
-				if (key == 'l')
-				{
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-					SEGGER_RTT_printf(0, "\r\n\tSending %d repetitions of [0x%02x] on I2C, i2cPullupEnable=%d, SSSUPPLY=%dmV\n\n",
-						repetitions, outBuffer[0], menuI2cPullupValue, menuSupplyVoltage);
+		if (menuDelayBetweenEachRun > 0)
+		{
+			OSA_TimeDelay(menuDelayBetweenEachRun);
+		}
+
+		readingCount++;
+	}
+}
+
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+/*
+ *	Workloads for runEnergyProfiles(), each one operation as the rest of
+ *	the firmware does it.
+ */
+static void
+energyWorkloadSensors(void)
+{
+	#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+	WARP_LOG(kWarpLogCsvRowStart, 0, RTC->TSR, RTC->TPR);
+	#endif
+
+	printAllSensorsPass(false /* hexModeFlag */);
+
+	#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+	WARP_LOG(kWarpLogCsvRowEnd, RTC->TSR, RTC->TPR, 0);
+	#endif
+}
+
+/*
+ *	The whole runPedometer() screen, with every segment of every field lit.
+ */
+static void
+energyWorkloadDisplay(void)
+{
+	devSSD1331drawString("steps", 0, 0);
+	devSSD1331drawString("avgsteps", 0, 1);
+	devSSD1331drawString("time", 0, 2);
+	devSSD1331drawInteger(8888, 8, 0);
+	devSSD1331drawInteger(8888, 8, 1);
+	devSSD1331drawInteger(88888, 7, 2);
+}
+
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+static void
+energyWorkloadAcceleration(void)
+{
+	int16_t		readings[3];
+
+	readSensorXYZMMA8451Q(readings);
+}
 #endif
-					for (int i = 0; i < repetitions; i++)
-					{
-						writeByteToI2cDeviceRegister(0xFF, true /* sedCommandByte */, outBuffer[0] /* commandByte */, false /* sendPayloadByte */, 0 /* payloadByte */);
-					}
-				}
-				else
-				{
-#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-					SEGGER_RTT_printf(0, "\r\n\tSending %d repetitions of [0x%02x] on SPI, SSSUPPLY=%dmV\n\n",
-						repetitions, outBuffer[0], menuSupplyVoltage);
+
+static void
+printMicrocoulombs(const char *  label, int32_t nanocoulombs)
+{
+	SEGGER_RTT_printf(0, " %s %s%d.%03d", label, (nanocoulombs < 0) ? "-" : "", abs(nanocoulombs) / 1000, abs(nanocoulombs) % 1000);
+}
+
+static void
+printEnergyProfile(const char *  name, WarpEnergyWorkload workload, uint8_t runs)
+{
+	WarpEnergyProfile	profile;
+	WarpStatus		status;
+
+
+	status = warpEnergyProfile(workload, runs, &profile);
+	if (status != kWarpStatusOK)
+	{
+		SEGGER_RTT_printf(0, "\r\t%s: INA219 conversion failed (status %d)\n", name, status);
+
+		return;
+	}
+
+	SEGGER_RTT_printf(0, "\r\t%s: %d runs, %d us each, %d us window%s\n\r\t\tuC",
+			name, profile.runs, profile.meanMicroseconds, profile.windowMicroseconds,
+			profile.extrapolated ? " (extrapolated from the window)" : "");
+	printMicrocoulombs("min", profile.minimumNanocoulombs);
+	printMicrocoulombs("mean", profile.meanNanocoulombs);
+	printMicrocoulombs("max", profile.maximumNanocoulombs);
+	SEGGER_RTT_WriteString(0, "\n");
+}
+
+/*
+ *	Charge per operation, over runs runs of each workload (see
+ *	warp-energy.h). Workloads print to RTT as they normally would, so
+ *	their output appears between the results.
+ */
+void
+runEnergyProfiles(uint8_t runs, uint16_t menuI2cPullupValue)
+{
+	enableI2Cpins(menuI2cPullupValue);
+
+	#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
+				0x01,/* Normal read 8bit, 800Hz, normal, active mode */
+				menuI2cPullupValue
+				);
+	printEnergyProfile("MMA8451Q x/y/z burst", energyWorkloadAcceleration, runs);
+	#endif
+
+	printEnergyProfile("SSD1331 pedometer screen", energyWorkloadDisplay, runs);
+	printEnergyProfile("printAllSensors pass", energyWorkloadSensors, runs);
+
+	disableI2Cpins();
+}
 #endif
-					for (int i = 0; i < repetitions; i++)
-					{
-						writeBytesToSpi(outBuffer /* payloadByte */, 1 /* payloadLength */);
-					}
-				}
 
-				break;
-			}
 
+/*
+ *	The sensors of printAllSensors(), each read at its own output data
+ *	rate by warp-scheduler.c rather than all of them once per pass. The
+ *	periods follow the configuration in configureAllSensors(). The
+ *	BME680 and HDC1000 are triggered and collected after their
+ *	conversions, with the fast sensors serviced in between. The AMG8834
+ *	(no frame sensor number) stays on printAllSensors().
+ */
+static const WarpSchedulerTask	scheduledSensorTasks[] =
+{
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	{NULL,			printSensorDataMMA8451Q,	" MMA8451 x, MMA8451 y, MMA8451 z,",				1250	/* 800Hz */,		0,	kWarpBinaryFrameSensorMMA8451Q},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+	{NULL,			printSensorDataINA219,		" INA219 Shunt,",						1064	/* 12-bit shunt and bus conversions */,	0,	kWarpBinaryFrameSensorINA219},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	{NULL,			printSensorDataMAG3110,		" MAG3110 x, MAG3110 y, MAG3110 z, MAG3110 Temp,",		12500	/* 80Hz */,		0,	kWarpBinaryFrameSensorMAG3110},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+	{NULL,			printSensorDataL3GD20H,		" L3GD20H x, L3GD20H y, L3GD20H z, L3GD20H Temp,",		1250	/* 800Hz */,		0,	kWarpBinaryFrameSensorL3GD20H},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBME680
+	{triggerSensorBME680,	printSensorDataBME680,		" BME680 Press, BME680 Temp, BME680 Hum,",			1000000	/* 1Hz */,		kWarpBME680ConversionMicroseconds,	kWarpBinaryFrameSensorBME680},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	{NULL,			printSensorDataBMX055accel,	" BMX055acc x, BMX055acc y, BMX055acc z, BMX055acc Temp,",	500	/* 2kHz unfiltered */,	0,	kWarpBinaryFrameSensorBMX055accel},
+	{NULL,			printSensorDataBMX055mag,	" BMX055mag x, BMX055mag y, BMX055mag z, BMX055mag RHALL,",	100000	/* 10Hz */,		0,	kWarpBinaryFrameSensorBMX055mag},
+	{NULL,			printSensorDataBMX055gyro,	" BMX055gyro x, BMX055gyro y, BMX055gyro z,",			500	/* 2kHz unfiltered */,	0,	kWarpBinaryFrameSensorBMX055gyro},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVCCS811
+	{NULL,			printSensorDataCCS811,		" CCS811 ECO2, CCS811 TVOC, CCS811 RAW ADC value, CCS811 RAW R_REF value, CCS811 RAW R_NTC value,",
+														250000	/* drive mode 4 */,	0,	kWarpBinaryFrameSensorCCS811},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	{triggerSensorHDC1000,	printSensorDataHDC1000,		" HDC1000 Temp, HDC1000 Hum,",					1000000	/* 1Hz */,		kWarpHDC1000ConversionMicroseconds,	kWarpBinaryFrameSensorHDC1000},
+#endif
+};
+
+static WarpSchedulerState	scheduledSensorStates[sizeof(scheduledSensorTasks)/sizeof(scheduledSensorTasks[0])];
 
-			/*
-			 *	enable SSSUPPLY
-			 */
-			case 'n':
-			{
-				enableSssupply(menuSupplyVoltage);
-				break;
-			}
+/*
+ *	One CSV record per sample: the RTC timestamp in microseconds, the
+ *	sensor number (WarpBinaryFrameSensor), that sensor's columns as in
+ *	printAllSensors(), and the microseconds from data ready to the read.
+ *	numberOfRecords 0 runs forever.
+ */
+void
+printScheduledSensors(bool hexModeFlag, int i2cPullupValue, uint32_t numberOfRecords)
+{
+	const uint8_t	numberOfTasks = sizeof(scheduledSensorTasks)/sizeof(scheduledSensorTasks[0]);
+	uint32_t	numberOfConfigErrors, records = 0;
+	uint32_t	now, waitMicroseconds;
+	uint8_t		task;
 
-			/*
-			 *	disable SSSUPPLY
-			 */
-			case 'o':
+
+	numberOfConfigErrors = configureAllSensors(false /* printCalibration */, i2cPullupValue);
+
+	#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+	SEGGER_RTT_printf(0, "\r\n%d config errors; records are Timestamp (us), Sensor, columns, Data age (us):\n", numberOfConfigErrors);
+	OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	for (uint8_t i = 0; i < numberOfTasks; i++)
+	{
+		SEGGER_RTT_printf(0, "\tSensor %d:%s every %u us\n", scheduledSensorTasks[i].sensor, scheduledSensorTasks[i].header, scheduledSensorTasks[i].periodMicroseconds);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	}
+	SEGGER_RTT_WriteString(0, "\n");
+	#endif
+
+	if (numberOfTasks == 0)
+	{
+		return;
+	}
+
+	warpSchedulerInit(scheduledSensorStates, numberOfTasks, warpTimestampMicroseconds());
+	while ((numberOfRecords == 0) || (records < numberOfRecords))
+	{
+		now = warpTimestampMicroseconds();
+		switch (warpSchedulerNext(scheduledSensorTasks, scheduledSensorStates, numberOfTasks, now, &task, &waitMicroseconds))
+		{
+			case kWarpSchedulerTrigger:
 			{
-				disableSssupply();
+				/*
+				 *	A failed trigger shows up as a stale or failed read
+				 *	when the conversion is collected.
+				 */
+				scheduledSensorTasks[task].trigger();
 				break;
 			}
 
-			/*
-			 *	Switch to VLPR
-			 */
-			case 'p':
+			case kWarpSchedulerCollect:
 			{
-				warpSetLowPowerMode(kWarpPowerModeVLPR, 0 /* sleep seconds : irrelevant here */);
+				#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				WARP_LOG(kWarpLogScheduledRecordStart, now, scheduledSensorTasks[task].sensor);
+				#endif
+				scheduledSensorTasks[task].collect(hexModeFlag);
+				#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+				WARP_LOG(kWarpLogScheduledRecordEnd, now - scheduledSensorStates[task].readyMicroseconds);
+				#endif
+				records++;
 				break;
 			}
-#ifdef WARP_BUILD_ENABLE_DEVMAX11300
-			case 'q':
+
+			default:
 			{
-				SEGGER_RTT_printf(0, "\r\tMAX11300 Configuration\n");
-				devMAX11300();
+				/*
+				 *	Sleep rather than spin in OSA_TimeDelay(). Round up:
+				 *	the LPTMR counts whole milliseconds, and no read may
+				 *	come before its data.
+				 */
+				warpLowPowerMillisecondsSleep((waitMicroseconds + 999) / 1000, false /* forceAllPinsIntoLowPowerState */);
 				break;
 			}
+		}
+	}
+
+	#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
+	for (uint8_t i = 0; i < numberOfTasks; i++)
+	{
+		SEGGER_RTT_printf(0, "\r\tSensor %d: %u records, %u missed periods\n", scheduledSensorTasks[i].sensor,
+				scheduledSensorStates[i].records, scheduledSensorStates[i].missedPeriods);
+		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+	}
+	#endif
+}
+
+
+/*
+ *	Binary sample frames: the raw register bytes that printAllSensors()
+ *	would format, packed into one fixed-layout frame per reading (see
+ *	WarpBinaryFrameConstants) and written with a single SEGGER_RTT_Write.
+ *	The up-buffer is switched to NO_BLOCK_SKIP so that a frame is either
+ *	written whole or dropped; dropped frames show up as gaps in the
+ *	sequence number and corrupted ones fail the CRC. The host decoder
+ *	(warp-host decode) turns the stream back into the hex-mode CSV.
+ *
+ *	Each entry is one register read as done by the sensor's
+ *	printSensorData function, in the same order. The AMG8834's 64-pixel
+ *	array alone would not fit the 200-byte up-buffer, so it stays on the
+ *	text path.
+ *
+ *	The BME680 and HDC1000 convert only when triggered. Both are started
+ *	at the top of each frame and collected once conversionMicroseconds
+ *	have passed, so that the fast sensors are read in the meantime.
+ */
+typedef struct
+{
+	WarpStatus			(* triggerFunction)(void);
+	uint32_t			conversionMicroseconds;
+	WarpStatus			(* readSensorRegisterFunction)(uint8_t deviceRegister, int numberOfBytes);
+	volatile WarpI2CDeviceState *	deviceState;
+	uint8_t				sensor;
+	uint8_t				deviceRegister;
+	uint8_t				numberOfBytes;
+} WarpBinaryFrameField;
+
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+/*
+ *	A register read would write the pointer and thereby restart the
+ *	conversion that triggerSensorHDC1000() started.
+ */
+static WarpStatus
+collectBinaryFrameHDC1000(uint8_t deviceRegister, int numberOfBytes)
+{
+	return collectSensorDataHDC1000();
+}
 #endif
 
-			/*
-			 *	Switch to RUN
-			 */
-			case 'r':
-			{
-				warpSetLowPowerMode(kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
-				break;
-			}
+static const WarpBinaryFrameField	binaryFrameFields[] =
+{
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	{NULL,			0,					readSensorRegisterMMA8451Q,	&deviceMMA8451QState,	kWarpBinaryFrameSensorMMA8451Q,	kWarpSensorOutputRegisterMMA8451QOUT_X_MSB,	6},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+	{NULL,			0,					readSensorRegisterINA219,	&deviceINA219State,	kWarpBinaryFrameSensorINA219,	kWarpSensorOutputRegisterINA219ShuntVoltage,	2},
+	{NULL,			0,					readSensorRegisterINA219,	&deviceINA219State,	kWarpBinaryFrameSensorINA219,	kWarpSensorOutputRegisterINA219Current,		2},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	{NULL,			0,					readSensorRegisterMAG3110,	&deviceMAG3110State,	kWarpBinaryFrameSensorMAG3110,	kWarpSensorOutputRegisterMAG3110OUT_X_MSB,	2},
+	{NULL,			0,					readSensorRegisterMAG3110,	&deviceMAG3110State,	kWarpBinaryFrameSensorMAG3110,	kWarpSensorOutputRegisterMAG3110OUT_Y_MSB,	2},
+	{NULL,			0,					readSensorRegisterMAG3110,	&deviceMAG3110State,	kWarpBinaryFrameSensorMAG3110,	kWarpSensorOutputRegisterMAG3110OUT_Z_MSB,	2},
+	{NULL,			0,					readSensorRegisterMAG3110,	&deviceMAG3110State,	kWarpBinaryFrameSensorMAG3110,	kWarpSensorOutputRegisterMAG3110DIE_TEMP,	1},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+	{NULL,			0,					readSensorRegisterL3GD20H,	&deviceL3GD20HState,	kWarpBinaryFrameSensorL3GD20H,	kWarpSensorOutputRegisterL3GD20HOUT_X_L,	6},
+	{NULL,			0,					readSensorRegisterL3GD20H,	&deviceL3GD20HState,	kWarpBinaryFrameSensorL3GD20H,	kWarpSensorOutputRegisterL3GD20HOUT_TEMP,	1},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBME680
+	{triggerSensorBME680,	kWarpBME680ConversionMicroseconds,	readSensorRegisterBME680,	&deviceBME680State,	kWarpBinaryFrameSensorBME680,	kWarpSensorOutputRegisterBME680press_msb,	kWarpBME680OutputBytes},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	{NULL,			0,					readSensorRegisterBMX055accel,	&deviceBMX055accelState,	kWarpBinaryFrameSensorBMX055accel,	kWarpSensorOutputRegisterBMX055accelACCD_X_LSB,	kWarpBMX055accelBurstBytes},
+	{NULL,			0,					readSensorRegisterBMX055mag,	&deviceBMX055magState,		kWarpBinaryFrameSensorBMX055mag,	kWarpSensorOutputRegisterBMX055magX_LSB,	kWarpBMX055magBurstBytes},
+	{NULL,			0,					readSensorRegisterBMX055gyro,	&deviceBMX055gyroState,		kWarpBinaryFrameSensorBMX055gyro,	kWarpSensorOutputRegisterBMX055gyroRATE_X_LSB,	kWarpBMX055gyroBurstBytes},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVCCS811
+	{NULL,			0,					readSensorRegisterCCS811,	&deviceCCS811State,	kWarpBinaryFrameSensorCCS811,	kWarpSensorOutputRegisterCCS811ALG_DATA,	4},
+	{NULL,			0,					readSensorRegisterCCS811,	&deviceCCS811State,	kWarpBinaryFrameSensorCCS811,	kWarpSensorOutputRegisterCCS811RAW_DATA,	2},
+	{NULL,			0,					readSensorRegisterCCS811,	&deviceCCS811State,	kWarpBinaryFrameSensorCCS811,	kWarpSensorOutputRegisterCCS811RAW_REF_NTC,	4},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	{triggerSensorHDC1000,	kWarpHDC1000ConversionMicroseconds,	collectBinaryFrameHDC1000,	&deviceHDC1000State,	kWarpBinaryFrameSensorHDC1000,	kWarpSensorOutputRegisterHDC1000Temperature,	kWarpHDC1000ResultBytes},
+#endif
+};
+
+static uint16_t
+crc16Ccitt(const uint8_t *  bytes, size_t count)
+{
+	uint16_t	crc = 0xFFFF;
+
+	while (count-- > 0)
+	{
+		crc ^= (uint16_t)(*bytes++) << 8;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+static uint8_t *
+putLittleEndian(uint8_t *  destination, uint32_t value, int numberOfBytes)
+{
+	while (numberOfBytes-- > 0)
+	{
+		*destination++ = value & 0xFF;
+		value >>= 8;
+	}
+
+	return destination;
+}
+
+void
+streamAllSensorsBinary(int menuDelayBetweenEachRun, int i2cPullupValue, uint32_t numberOfFrames)
+{
+	uint8_t		frame[kWarpBinaryFrameHeaderBytes + kWarpBinaryFramePayloadMaxBytes + kWarpBinaryFrameCrcBytes];
+	uint32_t	sequence = 0;
+	uint16_t	sensorsPresent = 0;
+	uint16_t	sensorsFailed;
+	uint8_t *	payload;
+	uint8_t *	cursor;
+	uint16_t	crc;
+	uint32_t	triggerMicroseconds;
+	uint32_t	elapsedMicroseconds;
+	size_t		i;
+
+
+	configureAllSensors(false /* printCalibration */, i2cPullupValue);
+
+	for (i = 0; i < sizeof(binaryFrameFields)/sizeof(binaryFrameFields[0]); i++)
+	{
+		sensorsPresent |= 1u << binaryFrameFields[i].sensor;
+	}
 
-			/*
-			 *	Power up all sensors
-			 */
-			case 's':
-			{
-				SEGGER_RTT_WriteString(0, "\r\n\tNOTE: First power sensors and enable I2C\n\n");
-				powerupAllSensors();
-				break;
-			}
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
 
-			/*
-			 *	Dump processor state
-			 */
-			case 't':
-			{
-				//dumpProcessorState();
-				runPedometer();
-				break;
-			}
+	while (numberOfFrames == 0 || sequence < numberOfFrames)
+	{
+		sensorsFailed = 0;
+		payload = &frame[kWarpBinaryFrameHeaderBytes];
+		cursor = payload;
 
-			case 'u':
-			{
-				if (menuI2cDevice == NULL)
-				{
-					SEGGER_RTT_WriteString(0, "\r\n\tCannot set I2C address: First set the default I2C device.\n");
-				}
-				else
-				{
-					SEGGER_RTT_WriteString(0, "\r\n\tSet I2C address of the selected sensor(e.g., '1C')> ");
-					uint8_t address = readHexByte();
-					menuI2cDevice->i2cAddress = address;
-				}
+		/*
+		 *	Timestamp at the start of the reading, as the CSV does.
+		 */
+		putLittleEndian(&frame[kWarpBinaryFrameOffsetSequence], sequence, 4);
+		putLittleEndian(&frame[kWarpBinaryFrameOffsetTSR], RTC->TSR, 4);
+		putLittleEndian(&frame[kWarpBinaryFrameOffsetTPR], RTC->TPR, 2);
 
-				break;
-			}
-#ifdef WARP_BUILD_ENABLE_DEVRV8803C7
-			case 'v':
+		for (i = 0; i < sizeof(binaryFrameFields)/sizeof(binaryFrameFields[0]); i++)
+		{
+			if (binaryFrameFields[i].triggerFunction != NULL && binaryFrameFields[i].triggerFunction() != kWarpStatusOK)
 			{
-				SEGGER_RTT_WriteString(0, "\r\n\tEnabling I2C pins\n");
-				enableI2Cpins(menuI2cPullupValue);
-				SEGGER_RTT_WriteString(0, "\r\n\tSleeping for 3 seconds, then resetting\n");
-				warpSetLowPowerMode(kWarpPowerModeVLLS0, 3 /* sleep seconds */);
-				SEGGER_RTT_WriteString(0, "\r\n\tThis should never happen...\n");
+				sensorsFailed |= 1u << binaryFrameFields[i].sensor;
 			}
-#endif
-				
-
-				
-				
-//Added					
-				
-			case 'w':
-			{			
-				enableI2Cpins(menuI2cPullupValue);
-				
-				SEGGER_RTT_WriteString(0, "\r\n\tConfig\n");
-				
-				                //write to config register
-                		writeSensorRegisterINA219(0x00, 0x019F, menuI2cPullupValue);
-                
-                		//write to calibration register
-               			writeSensorRegisterINA219(0x05, 0x2000, menuI2cPullupValue);
-				
-				SEGGER_RTT_WriteString(0, "\r\n\tStarting read\n");		
-								
-				int k;
-				bool hexModeFlag;
-				k = 0;
-				hexModeFlag = 1;
-	
-				/*
-				while( k < 10 ) 
-				{		
+		}
+		triggerMicroseconds = warpTimestampMicroseconds();
 
-				k++;
-				printSensorDataINA219(hexModeFlag);
-					
-				SEGGER_RTT_WriteString(0, "\r\n\t \n");
-					
-				}
-				*/
-				//configure accelerometer
-				
-				#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-				configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
-				0x01,/* Normal read 8bit, 800Hz, normal, active mode */
-				menuI2cPullupValue
-				);
-				#endif
-				
-				int16_t		xreading;
-				int16_t		yreading;
-				int16_t		zreading;
-				int		xyz = 0;
-				
-				SEGGER_RTT_WriteString(0, "\r\n\treadings from print \n");
-							
-				printSensorDataMMA8451Q(0);
-				
-				SEGGER_RTT_WriteString(0, "\r\n\treadings from get \n");
-				
-				xyz = 0;
-				xreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-				xyz = 1;
-				yreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-				xyz = 2;
-				zreading = getSensorDataMMA8451Q(hexModeFlag,xyz);
-				
-				SEGGER_RTT_WriteString(0, "\r\n\treadings from get \n");
-				
-				SEGGER_RTT_printf(0, " %d,", xreading);				      
-				SEGGER_RTT_printf(0, " %d,", yreading);	
-				SEGGER_RTT_printf(0, " %d,", zreading);	
-				disableI2Cpins();
-		
-				//writeSensorRegisterINA219(0x05,2000,menuI2cPullupValue);
-				//writeSensorRegisterINA219(0x00,)
-				/*
-				int k;
-				int p;
-				k=0;
-				p=0;
-				int shunt;
-				int bus;
-				int power;
-				int current;
-				SEGGER_RTT_printf(0, "\r\n\Shunt voltage\n"); 
-				while( k < 3 ) 
-				{
-				k++;
-				
-				//OSA_TimeDelay(1);
-				
-				shunt = readSensorRegisterINA219(0x01,2);
-				bus = readSensorRegisterINA219(0x02,2);
-				power = readSensorRegisterINA219(0x03,2);
-				current = readSensorRegisterINA219(0x04,2);
-				
-				//SEGGER_RTT_printf(0, "\r\n\tread\n");
-				
-				SEGGER_RTT_printf(0, "\r\n\Current\n");	
-				SEGGER_RTT_printf(0," %d,", shunt);				
-				SEGGER_RTT_printf(0," %d,", current);
-				
-				SEGGER_RTT_printf(0, "\r\n\ \n");
-				}
-				
-				
-				
-				SEGGER_RTT_printf(0, "\r\n\Current\n");
-				
-				*/
-				/*
-				while (p<1001)
-				{
-				p++;
-				shunt = readSensorRegisterINA219(0x01,2);
-				bus = readSensorRegisterINA219(0x02,2);
-				power = readSensorRegisterINA219(0x03,2);
-				current = readSensorRegisterINA219(0x04,2);
-				SEGGER_RTT_printf(0," %d,", current);
-				//SEGGER_RTT_printf(0, "\r\n\tread\n");
-				//SEGGER_RTT_printf(0, "\r\n\Shunt voltage\n");
-				//SEGGER_RTT_printf(0, "\r\n\Current\n");	
-				//SEGGER_RTT_printf(0," %d,", shunt);				
-				
-				
-				SEGGER_RTT_printf(0, "\r\n\ \n");	
-					
-				}	
-				*/
-					/*
-				
-				bool		autoIncrement, chatty;
-				int		spinDelay, repetitionsPerAddress, chunkReadsPerAddress;
-				int		adaptiveSssupplyMaxMillivolts;
-				uint8_t		referenceByte;
-				
-				repeatRegisterReadForDeviceAndAddress(	menuTargetSensor ,
-									menuRegisterAddress ,
-									menuI2cPullupValue,
-									autoIncrement ,
-									chunkReadsPerAddress,
-									chatty,
-									spinDelay,
-									repetitionsPerAddress,
-									menuSupplyVoltage,
-									adaptiveSssupplyMaxMillivolts,
-									referenceByte
-								)
-				
-				#ifdef WARP_BUILD_ENABLE_DEVINA219
-				//printSensorDataINA219(hexModeFlag);
-				#endif	
-				
-				*/
-					/*warpSensorDevice*/
-					/*baseAddress */
-					/*autoIncrement*/
-					
-				//disableI2Cpins();
-				
-				//OSA_TimeDelay(10000);
-				//SEGGER_RTT_WriteString(0, "\r\tDone.\n\n");
+		for (i = 0; i < sizeof(binaryFrameFields)/sizeof(binaryFrameFields[0]); i++)
+		{
+			const WarpBinaryFrameField *	field = &binaryFrameFields[i];
 
-				break;
-			}	
-				
-						
-				
-			/*
-			 *	Simply spin for 10 seconds. Since the SWD pins should only be enabled when we are waiting for key at top of loop (or toggling after printf), during this time there should be no interference from the SWD.
-			 */
-			case 'x':
+			elapsedMicroseconds = warpTimestampMicroseconds() - triggerMicroseconds;
+			if (elapsedMicroseconds < field->conversionMicroseconds)
 			{
-				SEGGER_RTT_WriteString(0, "\r\n\tSpinning for 10 seconds...\n");
-				OSA_TimeDelay(10000);
-				SEGGER_RTT_WriteString(0, "\r\tDone.\n\n");
-
-				break;
+				OSA_TimeDelay((field->conversionMicroseconds - elapsedMicroseconds + 999) / 1000);
 			}
 
-			/*
-			 *	Stress test, including bit-wise toggling and checksum, as well as extensive add and mul, with continous read and write to I2C MMA8451Q
-			 */
-#ifdef WARP_BUILD_ENABLE_THERMALCHAMBERANALYSIS
-			case 'y':
+			if (field->readSensorRegisterFunction(field->deviceRegister, field->numberOfBytes) != kWarpStatusOK)
 			{
-				break;
+				sensorsFailed |= 1u << field->sensor;
 			}
-#endif	
-				
-				/*
-			 *	Dump all the sensor data in one go
-			 */
-			case 'z':
+
+			for (int byte = 0; byte < field->numberOfBytes; byte++)
 			{
-				bool		hexModeFlag;
+				*cursor++ = (sensorsFailed & (1u << field->sensor)) ? 0 : field->deviceState->i2cBuffer[byte];
+			}
+		}
 
-				SEGGER_RTT_WriteString(0, "\r\n\tEnabling I2C pins...\n");
-				enableI2Cpins(menuI2cPullupValue);
+		frame[0] = kWarpBinaryFrameSync0;
+		frame[1] = kWarpBinaryFrameSync1;
+		frame[kWarpBinaryFrameOffsetLength] = cursor - payload;
+		putLittleEndian(&frame[kWarpBinaryFrameOffsetSensorsPresent], sensorsPresent, 2);
+		putLittleEndian(&frame[kWarpBinaryFrameOffsetSensorsFailed], sensorsFailed, 2);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tHex or converted mode? ('h' or 'c')> ");
-				key = SEGGER_RTT_WaitKey();
-				hexModeFlag = (key == 'h' ? 1 : 0);
+		crc = crc16Ccitt(&frame[kWarpBinaryFrameOffsetLength], cursor - &frame[kWarpBinaryFrameOffsetLength]);
+		cursor = putLittleEndian(cursor, crc, 2);
 
-				SEGGER_RTT_WriteString(0, "\r\n\tSet the time delay between each run in milliseconds (e.g., '1234')> ");
-				uint16_t	menuDelayBetweenEachRun = read4digits();
-				SEGGER_RTT_printf(0, "\r\n\tDelay between read batches set to %d milliseconds.\n\n", menuDelayBetweenEachRun);
-				OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+		SEGGER_RTT_Write(0, frame, cursor - frame);
 
-				printAllSensors(true /* printHeadersAndCalibration */, hexModeFlag, menuDelayBetweenEachRun, menuI2cPullupValue);
+		if (menuDelayBetweenEachRun > 0)
+		{
+			OSA_TimeDelay(menuDelayBetweenEachRun);
+		}
 
-				/*
-				 *	Not reached (printAllSensors() does not return)
-				 */
-				disableI2Cpins();
+		sequence++;
+	}
 
-				break;
-			}
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+}
 
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+/*
+ *	The software trigger's event: a switch between RUN and VLPR, a step
+ *	of a few mA on the supply.
+ */
+static void
+captureActionSwitchPowerMode(void)
+{
+	warpSetLowPowerMode((POWER_SYS_GetCurrentMode() == kPowerManagerRun) ? kWarpPowerModeVLPR : kWarpPowerModeRUN, 0 /* sleep seconds : irrelevant here */);
+}
 
-			/*
-			 *	Ignore naked returns.
-			 */
-			case '\n':
-			{
-				SEGGER_RTT_WriteString(0, "\r\tPayloads make rockets more than just fireworks.");
-				break;
-			}
+/*
+ *	Complete a capture dump record whose payload is already in place and
+ *	write it. Unlike the sample frames, records are not dropped: the
+ *	write is retried, for up to kWarpCaptureDumpWriteAttempts ms, until
+ *	the host has drained enough of the up-buffer.
+ */
+static void
+writeCaptureRecord(uint8_t *  record, uint8_t type, uint8_t payloadBytes)
+{
+	uint8_t *	cursor = &record[kWarpCaptureDumpHeaderBytes + payloadBytes];
+	uint16_t	crc;
+	int		attempts;
 
-			default:
-			{
-				#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\tInvalid selection '%c' !\n", key);
-				#endif
-			}
+
+	record[0] = kWarpCaptureDumpSync0;
+	record[1] = kWarpCaptureDumpSync1;
+	record[kWarpCaptureDumpOffsetLength] = payloadBytes;
+	record[kWarpCaptureDumpOffsetType] = type;
+
+	crc = crc16Ccitt(&record[kWarpCaptureDumpOffsetLength], cursor - &record[kWarpCaptureDumpOffsetLength]);
+	cursor = putLittleEndian(cursor, crc, 2);
+
+	for (attempts = 0; attempts < kWarpCaptureDumpWriteAttempts; attempts++)
+	{
+		if (SEGGER_RTT_Write(0, record, cursor - record) != 0)
+		{
+			break;
 		}
+		OSA_TimeDelay(1);
 	}
-
-	return 0;
 }
 
+static void
+dumpCurrentCapture(const WarpCaptureRing *  ring)
+{
+	uint8_t				record[kWarpCaptureDumpHeaderBytes + kWarpCaptureDumpBlockBytes + kWarpCaptureDumpCrcBytes];
+	uint8_t *			cursor;
+	const WarpCaptureBlock *	block;
+	uint32_t			sample = ring->firstSample;
+	uint8_t				i;
+
+
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+	cursor = &record[kWarpCaptureDumpHeaderBytes];
+	cursor = putLittleEndian(cursor, ring->firstSample, 4);
+	cursor = putLittleEndian(cursor, ring->triggerSample, 4);
+	cursor = putLittleEndian(cursor, ring->triggerMicroseconds, 4);
+	cursor = putLittleEndian(cursor, ring->samples - ring->firstSample, 2);
+	cursor = putLittleEndian(cursor, warpCaptureSamplePeriodMicroseconds(ring), 2);
+	cursor = putLittleEndian(cursor, (kWarpINA219MicrovoltsPerShuntCount*1000)/kWarpINA219ShuntMilliohms, 2);
+	*cursor++ = ring->used;
+	writeCaptureRecord(record, kWarpCaptureDumpRecordSummary, cursor - &record[kWarpCaptureDumpHeaderBytes]);
+
+	for (i = 0; i < ring->used; i++)
+	{
+		block = &ring->blocks[(ring->oldest + i) % kWarpCaptureBlocks];
+
+		cursor = &record[kWarpCaptureDumpHeaderBytes];
+		cursor = putLittleEndian(cursor, sample, 4);
+		cursor = putLittleEndian(cursor, block->microseconds, 4);
+		cursor = putLittleEndian(cursor, (uint16_t)block->first, 2);
+		*cursor++ = block->count;
+		memcpy(cursor, block->deltas, kWarpCaptureBlockDeltas);
+		cursor += kWarpCaptureBlockDeltas;
+		writeCaptureRecord(record, kWarpCaptureDumpRecordBlock, cursor - &record[kWarpCaptureDumpHeaderBytes]);
+
+		sample += block->count;
+	}
 
+	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+}
 
+/*
+ *	One capture of 32 samples before the trigger and 96 after (as many of
+ *	the 32 as the ring keeps), giving up after 20000 samples without a
+ *	trigger, then the dump. The software trigger's power mode switch is
+ *	undone afterwards.
+ */
 void
-printAllSensors(bool printHeadersAndCalibration, bool hexModeFlag, int menuDelayBetweenEachRun, int i2cPullupValue)
+runCurrentCapture(WarpCaptureTrigger trigger, int16_t level, uint16_t menuI2cPullupValue)
 {
-	/*
-	 *	A 32-bit counter gives us > 2 years of before it wraps, even if sampling at 60fps
-	 */
-	uint32_t	readingCount = 0;
-	uint32_t	numberOfConfigErrors = 0;
-
+	WarpCaptureSettings	settings =
+	{
+		.trigger		= trigger,
+		.action			= captureActionSwitchPowerMode,
+		.pin			= kWarpPinMMA8451Q_INT1,
+		.level			= level,
+		.preTriggerSamples	= 32,
+		.postTriggerSamples	= 96,
+		.maximumSamples		= 20000,
+	};
+	power_manager_modes_t	initialMode = POWER_SYS_GetCurrentMode();
+	WarpCaptureRing *	ring = &gWarpMenuScratch.currentCapture;
+	WarpStatus		status;
 
-	#ifdef WARP_BUILD_ENABLE_DEVAMG8834
-	numberOfConfigErrors += configureSensorAMG8834(	0x3F,/* Initial reset */
-					0x01,/* Frame rate 1 FPS */
-					i2cPullupValue
-					);
-	#endif
-	#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-	numberOfConfigErrors += configureSensorMMA8451Q(0x00,/* Payload: Disable FIFO */
-					0x01,/* Normal read 8bit, 800Hz, normal, active mode */
-					i2cPullupValue
-					);
-	#endif
 
-	
-//added	
-//	#ifdef WARP_BUILD_ENABLE_DEVINA219
-//	numberOfConfigErrors += configureSensorINA219(0x199,
-//					i2cPullupValue
-//					);
+	enableI2Cpins(menuI2cPullupValue);
+	status = warpCaptureCurrent(ring, &settings);
+	disableI2Cpins();
 
-//	#endif
-	
-	
-	
-	
-	#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-	numberOfConfigErrors += configureSensorMAG3110(	0x00,/*	Payload: DR 000, OS 00, 80Hz, ADC 1280, Full 16bit, standby mode to set up register*/
-					0xA0,/*	Payload: AUTO_MRST_EN enable, RAW value without offset */
-					i2cPullupValue
-					);
-	#endif
-	#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-	numberOfConfigErrors += configureSensorL3GD20H(	0b11111111,/* ODR 800Hz, Cut-off 100Hz, see table 21, normal mode, x,y,z enable */
-					0b00100000,
-					0b00000000,/* normal mode, disable FIFO, disable high pass filter */
-					i2cPullupValue
-					);
-	#endif
-	#ifdef WARP_BUILD_ENABLE_DEVBME680
-	numberOfConfigErrors += configureSensorBME680(	0b00000001,	/*	Humidity oversampling (OSRS) to 1x				*/
-							0b00100100,	/*	Temperature oversample 1x, pressure overdsample 1x, mode 00	*/
-							0b00001000,	/*	Turn off heater							*/
-							i2cPullupValue
-					);
+	if (POWER_SYS_GetCurrentMode() != initialMode)
+	{
+		captureActionSwitchPowerMode();
+	}
 
-	if (printHeadersAndCalibration)
+	if (status != kWarpStatusOK)
 	{
-		SEGGER_RTT_WriteString(0, "\r\n\nBME680 Calibration Data: ");
-		for (uint8_t i = 0; i < kWarpSizesBME680CalibrationValuesCount; i++)
-		{
-			#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-			SEGGER_RTT_printf(0, "0x%02x", deviceBME680CalibrationValues[i]);
-			if (i < kWarpSizesBME680CalibrationValuesCount - 1)
-			{
-				SEGGER_RTT_WriteString(0, ", ");
-			}
-			else
-			{
-				SEGGER_RTT_WriteString(0, "\n\n");
-			}
+		SEGGER_RTT_printf(0, "\r\tINA219 capture failed (status %d)\n", status);
 
-			OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-			#endif
-		}
+		return;
 	}
-	#endif
 
-	#ifdef WARP_BUILD_ENABLE_DEVHDC1000
-	numberOfConfigErrors += writeSensorRegisterHDC1000(kWarpSensorConfigurationRegisterHDC1000Configuration,/* Configuration register	*/
-					(0b1000000<<8),
-					i2cPullupValue
-					);
-	#endif
+	SEGGER_RTT_printf(0, "\r\tINA219 capture: %d samples held, %d us apart, %s\n",
+			ring->samples - ring->firstSample,
+			warpCaptureSamplePeriodMicroseconds(ring),
+			(ring->triggerSample == UINT32_MAX) ? "no trigger" : "triggered");
 
-	#ifdef WARP_BUILD_ENABLE_DEVCCS811
-	uint8_t		payloadCCS811[1];
-	payloadCCS811[0] = 0b01000000;/* Constant power, measurement every 250ms */
-	numberOfConfigErrors += configureSensorCCS811(payloadCCS811,
-					i2cPullupValue
-					);
-	#endif
-	#ifdef WARP_BUILD_ENABLE_DEVBMX055
-	numberOfConfigErrors += configureSensorBMX055accel(0b00000011,/* Payload:+-2g range */
-					0b10000000,/* Payload:unfiltered data, shadowing enabled */
-					i2cPullupValue
-					);
-	numberOfConfigErrors += configureSensorBMX055mag(0b00000001,/* Payload:from suspend mode to sleep mode*/
-					0b00000001,/* Default 10Hz data rate, forced mode*/
-					i2cPullupValue
-					);
-	numberOfConfigErrors += configureSensorBMX055gyro(0b00000100,/* +- 125degrees/s */
-					0b00000000,/* ODR 2000 Hz, unfiltered */
-					0b00000000,/* normal mode */
-					0b10000000,/* unfiltered data, shadowing enabled */
-					i2cPullupValue
-					);
-	#endif
+	dumpCurrentCapture(ring);
+}
+#endif
 
 
-	if (printHeadersAndCalibration)
-	{
-		SEGGER_RTT_WriteString(0, "Measurement number, RTC->TSR, RTC->TPR,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
+/*
+ *	One probe per sensor for warpI2cTune(): a configuration register,
+ *	which nothing changes while the tuning runs, and the sensor's
+ *	datasheet clock limit. The BME680 and INA219 go faster only in
+ *	high-speed mode, which the KSDK I2C driver does not do.
+ */
+static const WarpI2cTuningProbe	i2cTuningProbes[] =
+{
+#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
+	{readSensorRegisterMMA8451Q,	&deviceMMA8451QState,		kWarpSensorConfigurationRegisterMMA8451QCTRL_REG1,	1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVINA219
+	{readSensorRegisterINA219,	&deviceINA219State,		kWarpSensorConfigurationRegisterINA219_Configuration,	2,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVMAG3110
+	{readSensorRegisterMAG3110,	&deviceMAG3110State,		kWarpSensorConfigurationRegisterMAG3110CTRL_REG1,	1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
+	{readSensorRegisterL3GD20H,	&deviceL3GD20HState,		kWarpSensorConfigurationRegisterL3GD20HCTRL1,		1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBME680
+	{readSensorRegisterBME680,	&deviceBME680State,		kWarpSensorConfigurationRegisterBME680Config,		1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVBMX055
+	{readSensorRegisterBMX055accel,	&deviceBMX055accelState,	kWarpSensorConfigurationRegisterBMX055accelPMU_RANGE,	1,	400 /* fast mode */},
+	{readSensorRegisterBMX055mag,	&deviceBMX055magState,		kWarpSensorConfigurationRegisterBMX055magPowerCtrl,	1,	400 /* fast mode */},
+	{readSensorRegisterBMX055gyro,	&deviceBMX055gyroState,		kWarpSensorConfigurationRegisterBMX055gyroRANGE,	1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVCCS811
+	{readSensorRegisterCCS811,	&deviceCCS811State,		kWarpSensorConfigurationRegisterCCS811MEAS_MODE,	1,	400 /* fast mode */},
+#endif
+#ifdef WARP_BUILD_ENABLE_DEVHDC1000
+	{readSensorRegisterHDC1000,	&deviceHDC1000State,		kWarpSensorConfigurationRegisterHDC1000Configuration,	2,	400 /* fast mode */},
+#endif
+};
 
-		#ifdef WARP_BUILD_ENABLE_DEVAMG8834
-		for (uint8_t i = 0; i < 64; i++)
-		{
-			#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-			SEGGER_RTT_printf(0, " AMG8834 %d,", i);
-			OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-			#endif
-		}
-		SEGGER_RTT_WriteString(0, " AMG8834 Temp,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
+static void
+printI2cTuningResult(const WarpI2cTuningResult *  result)
+{
+	SEGGER_RTT_printf(0, "\r\t0x%02x, pull-up %3d, %4d kb/s: %2d/%d reads, %d us each\n",
+			result->address, result->pullupValue, result->baudRateKbps,
+			result->successes, result->attempts, result->meanMicroseconds);
+}
 
-		#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-		SEGGER_RTT_WriteString(0, " MMA8451 x, MMA8451 y, MMA8451 z,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-//added		
-		#ifdef WARP_BUILD_ENABLE_DEVINA219
-		SEGGER_RTT_WriteString(0, " INA219 Power, INA219 Current,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		
-		
-		
-		
-		
-		
-		
-		
-		#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-		SEGGER_RTT_WriteString(0, " MAG3110 x, MAG3110 y, MAG3110 z, MAG3110 Temp,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-		SEGGER_RTT_WriteString(0, " L3GD20H x, L3GD20H y, L3GD20H z, L3GD20H Temp,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVBME680
-		SEGGER_RTT_WriteString(0, " BME680 Press, BME680 Temp, BME680 Hum,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVBMX055
-		SEGGER_RTT_WriteString(0, " BMX055acc x, BMX055acc y, BMX055acc z, BMX055acc Temp,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, " BMX055mag x, BMX055mag y, BMX055mag z, BMX055mag RHALL,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, " BMX055gyro x, BMX055gyro y, BMX055gyro z,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVCCS811
-		SEGGER_RTT_WriteString(0, " CCS811 ECO2, CCS811 TVOC, CCS811 RAW ADC value, CCS811 RAW R_REF value, CCS811 RAW R_NTC value,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVHDC1000
-		SEGGER_RTT_WriteString(0, " HDC1000 Temp, HDC1000 Hum,");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		#endif
-		SEGGER_RTT_WriteString(0, " RTC->TSR, RTC->TPR, # Config Errors");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-		SEGGER_RTT_WriteString(0, "\n\n");
-		OSA_TimeDelay(gWarpMenuPrintDelayMilliseconds);
-	}
+/*
+ *	Sweeps the I2C rate of each sensor in i2cTuningProbes[] (see
+ *	warp-i2c-tuning.h) and, with the ISL23415, the pull-ups. Returns the
+ *	pull-up value to use from now on.
+ */
+uint16_t
+runI2cTuning(uint16_t menuI2cPullupValue)
+{
+#ifdef WARP_BUILD_ENABLE_DEVISL23415
+	static const uint8_t	pullupValues[] = {0x00, 0x40, 0x80, 0xC0, 0xFF};
+#else
+	uint8_t			pullupValues[] = {menuI2cPullupValue};
+#endif
+	uint8_t			pullupValue;
+	WarpStatus		status;
 
 
-	while(1)
-	{
-		#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-		SEGGER_RTT_printf(0, "%u, %d, %d,", readingCount, RTC->TSR, RTC->TPR);
-		#endif
+	enableI2Cpins(menuI2cPullupValue);
+	status = warpI2cTune(i2cTuningProbes, sizeof(i2cTuningProbes)/sizeof(i2cTuningProbes[0]),
+				pullupValues, sizeof(pullupValues)/sizeof(pullupValues[0]),
+				printI2cTuningResult, &pullupValue);
+	disableI2Cpins();
 
-		#ifdef WARP_BUILD_ENABLE_DEVAMG8834
-		printSensorDataAMG8834(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVMMA8451Q
-		printSensorDataMMA8451Q(hexModeFlag);
-		#endif
-//added				
-		#ifdef WARP_BUILD_ENABLE_DEVINA219
-		printSensorDataINA219(hexModeFlag);
-		#endif		
-		#ifdef WARP_BUILD_ENABLE_DEVMAG3110
-		printSensorDataMAG3110(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVL3GD20H
-		printSensorDataL3GD20H(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVBME680
-		printSensorDataBME680(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVBMX055
-		printSensorDataBMX055accel(hexModeFlag);
-		printSensorDataBMX055mag(hexModeFlag);
-		printSensorDataBMX055gyro(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVCCS811
-		printSensorDataCCS811(hexModeFlag);
-		#endif
-		#ifdef WARP_BUILD_ENABLE_DEVHDC1000
-		printSensorDataHDC1000(hexModeFlag);
-		#endif
+	if (status != kWarpStatusOK)
+	{
+		SEGGER_RTT_printf(0, "\r\tI2C tuning failed (status %d); all devices at %d kb/s\n", status, gWarpI2cBaudRateKbps);
 
+		return menuI2cPullupValue;
+	}
 
-		#ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-		SEGGER_RTT_printf(0, " %d, %d, %d\n", RTC->TSR, RTC->TPR, numberOfConfigErrors);
-		#endif
+	for (size_t i = 0; i < sizeof(i2cTuningProbes)/sizeof(i2cTuningProbes[0]); i++)
+	{
+		SEGGER_RTT_printf(0, "\r\t0x%02x: %d kb/s\n", i2cTuningProbes[i].deviceState->i2cAddress,
+				warpI2cBaudRateKbps(i2cTuningProbes[i].deviceState->i2cAddress));
+	}
 
-		if (menuDelayBetweenEachRun > 0)
-		{
-			OSA_TimeDelay(menuDelayBetweenEachRun);
-		}
+#ifdef WARP_BUILD_ENABLE_DEVISL23415
+	SEGGER_RTT_printf(0, "\r\tI2C pull-up value %d\n", pullupValue);
 
-		readingCount++;
-	}
+	return pullupValue;
+#else
+	return menuI2cPullupValue;
+#endif
 }
 
 
@@ -3078,7 +4735,7 @@ loopForSensor(	const char *  tagString,
 					if (chatty)
 					{
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-						SEGGER_RTT_printf(0, "\r\t0x%02x --> [0x%02x 0x%02x 0x%02x]\n",
+						WARP_LOG(kWarpLogRegisterSpi,
 							address+j,
 							spiDeviceState->spiSinkBuffer[0],
 							spiDeviceState->spiSinkBuffer[1],
@@ -3096,7 +4753,7 @@ loopForSensor(	const char *  tagString,
 					if (chatty)
 					{
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-						SEGGER_RTT_printf(0, "\r\t0x%02x --> 0x%02x\n",
+						WARP_LOG(kWarpLogRegisterI2c,
 							address+j,
 							i2cDeviceState->i2cBuffer[0]);
 #endif
@@ -3106,7 +4763,7 @@ loopForSensor(	const char *  tagString,
 			else if (status == kWarpStatusDeviceCommunicationFailed)
 			{
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-				SEGGER_RTT_printf(0, "\r\t0x%02x --> ----\n",
+				WARP_LOG(kWarpLogRegisterFailed,
 					address+j);
 #endif
 
@@ -3148,11 +4805,11 @@ loopForSensor(	const char *  tagString,
 	 *	print buffers even in RUN mode.
 	 */
 #ifdef WARP_BUILD_ENABLE_SEGGER_RTT_PRINTF
-	SEGGER_RTT_printf(0, "\r\n\t%d/%d success rate.\n", nSuccesses, (nSuccesses + nFailures));
+	WARP_LOG(kWarpLogLoopSuccessRate, nSuccesses, (nSuccesses + nFailures));
 	OSA_TimeDelay(50);
-	SEGGER_RTT_printf(0, "\r\t%d/%d successes matched ref. value of 0x%02x.\n", nCorrects, nSuccesses, referenceByte);
+	WARP_LOG(kWarpLogLoopMatchedReference, nCorrects, nSuccesses, referenceByte);
 	OSA_TimeDelay(50);
-	SEGGER_RTT_printf(0, "\r\t%d bad commands.\n\n", nBadCommands);
+	WARP_LOG(kWarpLogLoopBadCommands, nBadCommands);
 	OSA_TimeDelay(50);
 #endif
 
@@ -3335,13 +4992,13 @@ writeByteToI2cDeviceRegister(uint8_t i2cAddress, bool sendCommandByte, uint8_t c
 	i2c_device_t	i2cSlaveConfig =
 			{
 				.address = i2cAddress,
-				.baudRate_kbps = gWarpI2cBaudRateKbps
+				.baudRate_kbps = warpI2cBaudRateKbps(i2cAddress)
 			};
 
 	commandBuffer[0] = commandByte;
 	payloadBuffer[0] = payloadByte;
 
-	status = I2C_DRV_MasterSendDataBlocking(
+	status = warpI2CMasterSendDataBlocking(
 						0	/* instance */,
 						&i2cSlaveConfig,
 						commandBuffer,
@@ -3362,7 +5019,7 @@ writeBytesToSpi(uint8_t *  payloadBytes, int payloadLength)
 	spi_status_t	status;
 
 	enableSPIpins();
-	status = SPI_DRV_MasterTransferBlocking(0		/* master instance */,
+	status = warpSPIMasterTransferBlocking(0		/* master instance */,
 						NULL		/* spi_master_user_config_t */,
 						payloadBytes,
 						inBuffer,
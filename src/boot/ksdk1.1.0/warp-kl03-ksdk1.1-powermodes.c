@@ -13,6 +13,7 @@
 #include "fsl_misc_utilities.h"
 #include "fsl_rtc_driver.h"
 #include "fsl_spi_master_driver.h"
+#include "fsl_lptmr_hal.h"
 
 #include "warp.h"
 
@@ -58,7 +59,11 @@ gpioDisableWakeUp(void)
 	
 	// disables interrupt
 	PORT_HAL_SetPinIntMode(BOARD_SW_LLWU_BASE, BOARD_SW_LLWU_PIN, kPortIntDisabled);
-	INT_SYS_DisableIRQ(BOARD_SW_LLWU_IRQ_NUM);
+
+	/*
+	 *	Only the pin's own interrupt: the MMA8451Q INT1 on PTB2 shares
+	 *	BOARD_SW_LLWU_IRQ_NUM and must stay able to wake us from sleep.
+	 */
 }
 
 void
@@ -102,8 +107,71 @@ update_clock_mode(uint8_t cmConfigMode)
 
 
 
-WarpStatus
-warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
+/*
+ *	Millisecond wakeups come from the LPTMR compare. The LPTMR belongs to
+ *	the bare-metal OSA, which runs it free from the 1kHz LPO as the
+ *	counter behind OSA_TimeDelay() and never enables its interrupt.
+ *	CMR may only change while the timer is disabled, and disabling it
+ *	resets the counter, so OSA_TimeGetMsec() restarts from zero at each
+ *	such sleep. OSA_TimeDelay() only ever measures within one call, and
+ *	the firmware's timestamps come from the RTC, so neither notices.
+ *	The timer stays in free-running mode, so TCF is set (after the
+ *	counter passes CMR) exactly sleepMilliseconds after it is enabled.
+ */
+static void
+setSleepLptmrCompare(uint32_t sleepMilliseconds)
+{
+	if (sleepMilliseconds > kWarpLowPowerMaxLptmrMilliseconds)
+	{
+		sleepMilliseconds = kWarpLowPowerMaxLptmrMilliseconds;
+	}
+
+	LPTMR_HAL_Disable(LPTMR0_BASE);
+	LPTMR_HAL_SetCompareValue(LPTMR0_BASE, sleepMilliseconds - 1);
+	LPTMR_HAL_SetIntCmd(LPTMR0_BASE, true);
+	INT_SYS_EnableIRQ(LPTMR0_IRQn);
+	LPTMR_HAL_Enable(LPTMR0_BASE);
+}
+
+static void
+clearSleepLptmrCompare(void)
+{
+	LPTMR_HAL_SetIntCmd(LPTMR0_BASE, false);
+	LPTMR_HAL_ClearIntFlag(LPTMR0_BASE);
+}
+
+static void
+setSleepWakeup(uint32_t sleepSeconds, uint32_t sleepMilliseconds)
+{
+	if (sleepMilliseconds != 0)
+	{
+		setSleepLptmrCompare(sleepMilliseconds);
+	}
+	else
+	{
+		setSleepRtcAlarm(sleepSeconds);
+	}
+}
+
+/*
+ *	Override the LPTMR IRQ handler: the compare has done its job once it
+ *	has woken us up. The OSA never enables this interrupt itself.
+ */
+void
+LPTMR0_IRQHandler(void)
+{
+	clearSleepLptmrCompare();
+}
+
+
+
+/*
+ *	Sleeps wake on the RTC alarm after sleepSeconds or, when
+ *	sleepMilliseconds is not zero, on the LPTMR compare after
+ *	sleepMilliseconds (at most kWarpLowPowerMaxLptmrMilliseconds).
+ */
+static WarpStatus
+setLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds, uint32_t sleepMilliseconds)
 {
 	uint8_t				cmConfigMode = CLOCK_CONFIG_INDEX_FOR_RUN;
 	power_manager_error_code_t	status;
@@ -119,8 +187,9 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 			}
 
 			gpioDisableWakeUp();
-			setSleepRtcAlarm(sleepSeconds);
+			setSleepWakeup(sleepSeconds, sleepMilliseconds);
 			status = POWER_SYS_SetMode(powerMode, kPowerManagerPolicyAgreement);
+			clearSleepLptmrCompare();
 
 
 			/*
@@ -147,9 +216,10 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 			}
 
 			gpioDisableWakeUp();
-			setSleepRtcAlarm(sleepSeconds);
+			setSleepWakeup(sleepSeconds, sleepMilliseconds);
 
 			status = POWER_SYS_SetMode(powerMode, kPowerManagerPolicyAgreement);
+			clearSleepLptmrCompare();
 
 			// for now, always go to VLPR upon completion of prior mode
 			CLOCK_SYS_UpdateConfiguration(CLOCK_CONFIG_INDEX_FOR_VLPR, kClockManagerPolicyForcible);
@@ -195,9 +265,10 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 			}
 
 			gpioDisableWakeUp();
-			setSleepRtcAlarm(sleepSeconds);
+			setSleepWakeup(sleepSeconds, sleepMilliseconds);
 
 			status = POWER_SYS_SetMode(powerMode, kPowerManagerPolicyAgreement);
+			clearSleepLptmrCompare();
 
 			if (POWER_SYS_GetCurrentMode() == kPowerManagerRun)
 			{
@@ -216,9 +287,10 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 		case kWarpPowerModeVLPS:
 		{
 			gpioDisableWakeUp();
-			setSleepRtcAlarm(sleepSeconds);
+			setSleepWakeup(sleepSeconds, sleepMilliseconds);
 
 			status = POWER_SYS_SetMode(powerMode, kPowerManagerPolicyAgreement);
+			clearSleepLptmrCompare();
 
 			/*
 			 *	After returning from RTC handler...
@@ -261,6 +333,14 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 
 		case kWarpPowerModeVLLS0:
 		{
+			/*
+			 *	The LPO, and with it the LPTMR, is off in VLLS0.
+			 */
+			if (sleepMilliseconds != 0)
+			{
+				return kWarpStatusBadPowerModeSpecified;
+			}
+
 #ifdef WARP_BUILD_ENABLE_DEVRV8803C7
 			/*
 			 *	program RV8803 external interrupt
@@ -288,6 +368,16 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 			/*
 			 *	TODO: this can be replaced using the internal RTC
 			 */
+			if (sleepMilliseconds != 0)
+			{
+				/*
+				 *	LLWU internal module 0 is the LPTMR on the KL03. The
+				 *	KSDK feature table lists no internal modules for the
+				 *	KL03, so there is no LLWU_HAL call for it.
+				 */
+				setSleepLptmrCompare(sleepMilliseconds);
+				BW_LLWU_ME_WUME0(LLWU_BASE, true);
+			}
 #ifdef WARP_BUILD_ENABLE_DEVRV8803C7
 			/*
 			 *	program RV8803 external interrupt
@@ -315,6 +405,16 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 			/*
 			 *	TODO: this can be replaced using the internal RTC
 			 */
+			if (sleepMilliseconds != 0)
+			{
+				/*
+				 *	LLWU internal module 0 is the LPTMR on the KL03. The
+				 *	KSDK feature table lists no internal modules for the
+				 *	KL03, so there is no LLWU_HAL call for it.
+				 */
+				setSleepLptmrCompare(sleepMilliseconds);
+				BW_LLWU_ME_WUME0(LLWU_BASE, true);
+			}
 #ifdef WARP_BUILD_ENABLE_DEVRV8803C7
 			/*
 			 *	program RV8803 external interrupt
@@ -345,3 +445,20 @@ warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
 
 	return kWarpStatusOK;
 }
+
+WarpStatus
+warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds)
+{
+	return setLowPowerMode(powerMode, sleepSeconds, 0 /* sleepMilliseconds */);
+}
+
+WarpStatus
+warpSetLowPowerModeMilliseconds(WarpPowerMode powerMode, uint32_t sleepMilliseconds)
+{
+	if (sleepMilliseconds == 0)
+	{
+		return kWarpStatusOK;
+	}
+
+	return setLowPowerMode(powerMode, 0 /* sleepSeconds */, sleepMilliseconds);
+}
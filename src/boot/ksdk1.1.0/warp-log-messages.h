@@ -0,0 +1,68 @@
+/*
+	Deferred-format log messages for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	The table of log messages, included by warp-log.h to build the
+ *	WarpLogMessage enum and, on the host, by the record renderer to build
+ *	the matching table of format strings. There is deliberately no include
+ *	guard: define WARP_LOG_MESSAGE(name, format) before including it.
+ *
+ *	Record IDs are the position in this list, so only ever append: reordering
+ *	breaks captures taken with an earlier firmware. Formats may use only the
+ *	integer conversions (%d, %u, %x, with width and zero-pad); records carry
+ *	32-bit words, never strings.
+ */
+WARP_LOG_MESSAGE(kWarpLogDropped,		"\r\n[%u log records dropped]\n")
+WARP_LOG_MESSAGE(kWarpLogCsvFailed,		" ----,")
+WARP_LOG_MESSAGE(kWarpLogCsvFailedPair,		" ----, ----,")
+WARP_LOG_MESSAGE(kWarpLogCsvDecimal,		" %d,")
+WARP_LOG_MESSAGE(kWarpLogCsvDecimalPair,	" %d, %d,")
+WARP_LOG_MESSAGE(kWarpLogCsvUnsigned,		" %u,")
+WARP_LOG_MESSAGE(kWarpLogCsvHexByte,		" 0x%02x,")
+WARP_LOG_MESSAGE(kWarpLogCsvHexPair,		" 0x%02x 0x%02x,")
+WARP_LOG_MESSAGE(kWarpLogCsvHexPairPair,	" 0x%02x 0x%02x, 0x%02x 0x%02x,")
+WARP_LOG_MESSAGE(kWarpLogCsvHexTriple,		" 0x%02x 0x%02x 0x%02x,")
+WARP_LOG_MESSAGE(kWarpLogCsvRowStart,		"%u, %d, %d,")
+WARP_LOG_MESSAGE(kWarpLogCsvRowEnd,		" %d, %d, %d\n")
+WARP_LOG_MESSAGE(kWarpLogRegisterSpi,		"\r\t0x%02x --> [0x%02x 0x%02x 0x%02x]\n")
+WARP_LOG_MESSAGE(kWarpLogRegisterI2c,		"\r\t0x%02x --> 0x%02x\n")
+WARP_LOG_MESSAGE(kWarpLogRegisterFailed,	"\r\t0x%02x --> ----\n")
+WARP_LOG_MESSAGE(kWarpLogLoopSuccessRate,	"\r\n\t%d/%d success rate.\n")
+WARP_LOG_MESSAGE(kWarpLogLoopMatchedReference,	"\r\t%d/%d successes matched ref. value of 0x%02x.\n")
+WARP_LOG_MESSAGE(kWarpLogLoopBadCommands,	"\r\t%d bad commands.\n\n")
+WARP_LOG_MESSAGE(kWarpLogScheduledRecordStart,	"%u, %u,")
+WARP_LOG_MESSAGE(kWarpLogScheduledRecordEnd,	" %u\n")
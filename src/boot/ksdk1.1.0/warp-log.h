@@ -0,0 +1,86 @@
+/*
+	Deferred-format logging for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	WARP_LOG(message, args...) replaces SEGGER_RTT_printf() for the lines
+ *	the firmware prints over and over (the sensor CSV rows and the register
+ *	loop dumps). By default it still formats on the target, into RTT up
+ *	channel 0, exactly as before.
+ *
+ *	With WARP_BUILD_ENABLE_DEFERRED_LOG, nothing is formatted on the target
+ *	and the format strings are not linked in. Each call instead writes one
+ *	record to RTT up channel 1:
+ *
+ *		[message ID, u8][argument count, u8][arguments, u32 little-endian]...
+ *
+ *	and the host turns the records back into text with the same message
+ *	table (warp-host render, see README). A record that does not fit in the
+ *	channel is dropped whole and counted; the count goes out as a
+ *	kWarpLogDropped record as soon as there is room again.
+ *
+ *	Deferred mode changes what comes out of RTT, so it is off by default.
+ */
+#ifndef WARP_BUILD_ENABLE_DEFERRED_LOG
+//#define WARP_BUILD_ENABLE_DEFERRED_LOG
+#endif
+
+typedef enum
+{
+#define WARP_LOG_MESSAGE(name, format)	name,
+#include "warp-log-messages.h"
+#undef WARP_LOG_MESSAGE
+	kWarpLogMessageCount,
+} WarpLogMessage;
+
+typedef enum
+{
+	kWarpLogRttChannel		= 1,
+	kWarpLogRttBufferSize		= 64,
+	kWarpLogMaxArguments		= 6,
+	kWarpLogRecordHeaderBytes	= 2,
+} WarpLogConstants;
+
+#ifdef WARP_BUILD_ENABLE_DEFERRED_LOG
+#define WARP_LOG(...)	warpLogRecord((const uint32_t[]){__VA_ARGS__},				\
+				sizeof((const uint32_t[]){__VA_ARGS__}) / sizeof(uint32_t) - 1)
+#else
+#define WARP_LOG(...)	warpLogPrint(__VA_ARGS__)
+#endif
+
+void	warpLogInit(void);
+void	warpLogRecord(const uint32_t * words, size_t argumentCount);
+void	warpLogPrint(unsigned message, ...);
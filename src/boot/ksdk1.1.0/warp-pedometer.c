@@ -0,0 +1,183 @@
+/*
+	Streaming step detector for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "warp-pedometer.h"
+
+
+
+void
+warpStepDetectorInit(WarpStepDetector *  detector, int16_t upperThreshold, int16_t lowerThreshold)
+{
+	detector->upperThreshold = upperThreshold;
+	detector->lowerThreshold = lowerThreshold;
+	detector->previous = 0;
+	detector->filtered = 0;
+	detector->above = false;
+	detector->below = false;
+	detector->crossings = 0;
+	detector->samples = 0;
+}
+
+/*
+ *	Returns true when this sample completes a step.
+ */
+bool
+warpStepDetectorPush(WarpStepDetector *  detector, const int16_t *  xyz)
+{
+	int16_t		largest = 0;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if ((int32_t)xyz[axis] * xyz[axis] > (int32_t)largest * largest)
+		{
+			largest = xyz[axis];
+		}
+	}
+
+	detector->filtered = 2*largest/5 + 3*detector->previous/5;
+	detector->previous = largest;
+	detector->samples++;
+
+	if (detector->filtered > detector->upperThreshold)
+	{
+		detector->above = true;
+	}
+	if (detector->filtered < detector->lowerThreshold)
+	{
+		detector->below = true;
+	}
+
+	if (detector->above && detector->below)
+	{
+		detector->above = false;
+		detector->below = false;
+		detector->crossings++;
+
+		return (detector->crossings % kWarpStepDetectorCrossingsPerStep) == 0;
+	}
+
+	return false;
+}
+
+uint32_t
+warpStepDetectorSteps(const WarpStepDetector *  detector)
+{
+	return detector->crossings / kWarpStepDetectorCrossingsPerStep;
+}
+
+void
+warpMagnitudeStepDetectorInit(WarpMagnitudeStepDetector *  detector, uint16_t minimumInterval)
+{
+	detector->filtered = 0;
+	detector->mean = 0;
+	detector->peak = 0;
+	detector->trough = 0;
+	detector->minimumInterval = minimumInterval;
+	detector->samplesSinceStep = minimumInterval;
+	detector->armed = false;
+	detector->steps = 0;
+	detector->samples = 0;
+}
+
+/*
+ *	Returns true when this sample completes a step.
+ */
+bool
+warpMagnitudeStepDetectorPush(WarpMagnitudeStepDetector *  detector, const int16_t *  xyz)
+{
+	int32_t		magnitudeSquared = 0;
+	int32_t		midpoint, hysteresis;
+	bool		step = false;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		magnitudeSquared += ((int32_t)xyz[axis] * xyz[axis]) >> kWarpMagnitudeStepDetectorShift;
+	}
+
+	if (detector->samples++ == 0)
+	{
+		detector->filtered = magnitudeSquared;
+		detector->mean = magnitudeSquared;
+		detector->peak = magnitudeSquared;
+		detector->trough = magnitudeSquared;
+	}
+
+	detector->filtered += (magnitudeSquared - detector->filtered) >> kWarpMagnitudeStepDetectorFilterShift;
+	detector->mean += (detector->filtered - detector->mean) >> kWarpMagnitudeStepDetectorMeanShift;
+
+	/*
+	 *	Envelopes: jump to a new extreme, otherwise relax towards the mean.
+	 */
+	detector->peak -= (detector->peak - detector->mean) >> kWarpMagnitudeStepDetectorEnvelopeShift;
+	detector->trough += (detector->mean - detector->trough) >> kWarpMagnitudeStepDetectorEnvelopeShift;
+	if (detector->filtered > detector->peak)
+	{
+		detector->peak = detector->filtered;
+	}
+	if (detector->filtered < detector->trough)
+	{
+		detector->trough = detector->filtered;
+	}
+
+	midpoint = detector->trough + ((detector->peak - detector->trough) >> 1);
+	hysteresis = (detector->peak - detector->trough) >> kWarpMagnitudeStepDetectorHysteresisShift;
+
+	if (detector->samplesSinceStep < UINT16_MAX)
+	{
+		detector->samplesSinceStep++;
+	}
+
+	if (detector->filtered < midpoint - hysteresis)
+	{
+		detector->armed = true;
+	}
+	else if (detector->armed && detector->filtered > midpoint + hysteresis)
+	{
+		detector->armed = false;
+		if (detector->samplesSinceStep >= detector->minimumInterval &&
+			(detector->peak - detector->trough) >= (detector->mean >> kWarpMagnitudeStepDetectorMinimumSwingShift))
+		{
+			detector->steps++;
+			detector->samplesSinceStep = 0;
+			step = true;
+		}
+	}
+
+	return step;
+}
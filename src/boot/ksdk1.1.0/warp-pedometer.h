@@ -0,0 +1,114 @@
+/*
+	Streaming step detector for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Step detection, one accelerometer sample at a time in constant memory,
+ *	so the pedometer can run indefinitely.
+ *
+ *	The axis detector is the original runPedometer() algorithm. Each sample
+ *	is reduced to the signed reading of its largest-magnitude axis, passed
+ *	through a two-tap low-pass filter (0.4 * this sample + 0.6 * the
+ *	previous one; about 5Hz at the 50Hz ODR), and compared against a
+ *	hysteresis band: the filtered value must go above the upper threshold
+ *	and below the lower one (in either order) for one crossing, and two
+ *	crossings make a step.
+ *
+ *	The default thresholds are in MMA8451Q +-2g counts (4096 per g), and
+ *	assume the device is worn with one axis vertical.
+ */
+typedef enum
+{
+	kWarpStepDetectorUpperThreshold	= 4400,
+	kWarpStepDetectorLowerThreshold	= 3900,
+	kWarpStepDetectorCrossingsPerStep	= 2,
+} WarpStepDetectorConstants;
+
+typedef struct
+{
+	int16_t		upperThreshold;
+	int16_t		lowerThreshold;
+	int16_t		previous;
+	int16_t		filtered;
+	bool		above;
+	bool		below;
+	uint32_t	crossings;
+	uint32_t	samples;
+} WarpStepDetector;
+
+/*
+ *	Orientation- and range-independent detector, used by runPedometer().
+ *	Each sample is reduced to its squared vector magnitude (no square
+ *	root), scaled down by kWarpMagnitudeStepDetectorShift and low-pass
+ *	filtered. The detector tracks a slow mean (gravity squared, whatever
+ *	the orientation or full-scale range) and peak and trough envelopes that
+ *	jump to each new extreme and decay back towards the mean. A step is an
+ *	upward crossing of the envelope midpoint plus a quarter of the swing,
+ *	after a downward crossing of the midpoint minus a quarter, provided
+ *	that the swing is at least 1/8 of the mean (so a device at rest counts
+ *	nothing) and that minimumInterval samples have passed since the last
+ *	step.
+ */
+typedef enum
+{
+	kWarpMagnitudeStepDetectorShift			= 8,
+	kWarpMagnitudeStepDetectorFilterShift		= 1,
+	kWarpMagnitudeStepDetectorMeanShift		= 6,
+	kWarpMagnitudeStepDetectorEnvelopeShift		= 5,
+	kWarpMagnitudeStepDetectorHysteresisShift	= 2,
+	kWarpMagnitudeStepDetectorMinimumSwingShift	= 3,
+	kWarpMagnitudeStepDetectorMinimumInterval	= 12,		/*	samples: 0.24s at the 50Hz ODR	*/
+} WarpMagnitudeStepDetectorConstants;
+
+typedef struct
+{
+	int32_t		filtered;
+	int32_t		mean;
+	int32_t		peak;
+	int32_t		trough;
+	uint16_t	minimumInterval;
+	uint16_t	samplesSinceStep;
+	bool		armed;
+	uint32_t	steps;
+	uint32_t	samples;
+} WarpMagnitudeStepDetector;
+
+void		warpStepDetectorInit(WarpStepDetector *  detector, int16_t upperThreshold, int16_t lowerThreshold);
+bool		warpStepDetectorPush(WarpStepDetector *  detector, const int16_t *  xyz);
+uint32_t	warpStepDetectorSteps(const WarpStepDetector *  detector);
+
+void		warpMagnitudeStepDetectorInit(WarpMagnitudeStepDetector *  detector, uint16_t minimumInterval);
+bool		warpMagnitudeStepDetectorPush(WarpMagnitudeStepDetector *  detector, const int16_t *  xyz);
@@ -0,0 +1,298 @@
+/*
+	Register-map driver core for the Warp firmware's I2C sensors.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdlib.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+
+#include "gpio_pins.h"
+#include "SEGGER_RTT.h"
+#include "warp.h"
+#include "warp-log.h"
+#include "warp-register-map.h"
+
+
+extern volatile uint32_t		gWarpI2cBaudRateKbps;
+extern volatile uint32_t		gWarpI2cTimeoutMilliseconds;
+
+
+
+/*
+ *	One bit test instead of a switch over the allowed registers.
+ */
+static bool
+registerAllowed(const uint8_t *  bitmap, uint8_t lastRegister, uint8_t deviceRegister)
+{
+	if (deviceRegister > lastRegister)
+	{
+		return false;
+	}
+
+	return (bitmap == NULL) || ((bitmap[deviceRegister >> 3] >> (deviceRegister & 7)) & 1);
+}
+
+WarpStatus
+warpRegisterMapWriteBytes(const WarpRegisterMap *  map, uint8_t deviceRegister, const uint8_t *  payload, uint8_t numberOfBytes)
+{
+	uint8_t		commandByte[1];
+	i2c_status_t	status;
+
+
+	if (!registerAllowed(map->writableRegisters, map->lastWritableRegister, deviceRegister))
+	{
+		return kWarpStatusBadDeviceCommand;
+	}
+
+	i2c_device_t slave =
+	{
+		.address = map->deviceState->i2cAddress,
+		.baudRate_kbps = warpI2cBaudRateKbps(map->deviceState->i2cAddress)
+	};
+
+	commandByte[0] = deviceRegister;
+	status = warpI2CMasterSendDataBlocking(
+							0 /* I2C instance */,
+							&slave,
+							commandByte,
+							1,
+							payload,
+							numberOfBytes,
+							gWarpI2cTimeoutMilliseconds);
+	if (status != kStatus_I2C_Success)
+	{
+		return kWarpStatusDeviceCommunicationFailed;
+	}
+
+	return kWarpStatusOK;
+}
+
+/*
+ *	One register of map->registerBytes, in the device's byte order.
+ */
+WarpStatus
+warpRegisterMapWrite(const WarpRegisterMap *  map, uint8_t deviceRegister, uint16_t payload)
+{
+	uint8_t		payloadBytes[2];
+
+
+	if (map->registerBytes == 2)
+	{
+		payloadBytes[(map->flags & kWarpRegisterMapLittleEndian) ? 1 : 0] = (payload >> 8) & 0xFF;
+		payloadBytes[(map->flags & kWarpRegisterMapLittleEndian) ? 0 : 1] = payload & 0xFF;
+	}
+	else
+	{
+		payloadBytes[0] = payload & 0xFF;
+	}
+
+	return warpRegisterMapWriteBytes(map, deviceRegister, payloadBytes, map->registerBytes);
+}
+
+/*
+ *	numberOfBytes from deviceRegister on into the caller's buffer, for
+ *	FIFO bursts larger than i2cBuffer. Registers that do not
+ *	auto-increment (FIFO data ports) return consecutive entries.
+ */
+WarpStatus
+warpRegisterMapReadBlock(const WarpRegisterMap *  map, uint8_t deviceRegister, uint8_t *  buffer, uint16_t numberOfBytes)
+{
+	uint8_t		cmdBuf[1];
+	i2c_status_t	status;
+
+
+	if (!registerAllowed(map->readableRegisters, map->lastReadableRegister, deviceRegister))
+	{
+		return kWarpStatusBadDeviceCommand;
+	}
+
+	i2c_device_t slave =
+	{
+		.address = map->deviceState->i2cAddress,
+		.baudRate_kbps = warpI2cBaudRateKbps(map->deviceState->i2cAddress)
+	};
+
+	cmdBuf[0] = deviceRegister;
+	if ((map->flags & kWarpRegisterMapAutoIncrementBit) && (numberOfBytes > 1))
+	{
+		cmdBuf[0] |= kWarpRegisterMapAutoIncrementMask;
+	}
+
+	status = warpI2CMasterReceiveDataBlocking(
+							0 /* I2C peripheral instance */,
+							&slave,
+							cmdBuf,
+							1,
+							buffer,
+							numberOfBytes,
+							gWarpI2cTimeoutMilliseconds);
+
+	if (status != kStatus_I2C_Success)
+	{
+		return kWarpStatusDeviceCommunicationFailed;
+	}
+
+	return kWarpStatusOK;
+}
+
+WarpStatus
+warpRegisterMapRead(const WarpRegisterMap *  map, uint8_t deviceRegister, int numberOfBytes)
+{
+	if ((numberOfBytes < 1) || (numberOfBytes > kWarpSizesI2cBufferBytes))
+	{
+		return kWarpStatusBadDeviceCommand;
+	}
+
+	return warpRegisterMapReadBlock(map, deviceRegister, (uint8_t *)map->deviceState->i2cBuffer, numberOfBytes);
+}
+
+/*
+ *	Decode numberOfValues consecutive two-byte output values (axis
+ *	i % sampleAxes for value i). values may alias raw: each int16_t is
+ *	only written after its own two bytes have been read.
+ */
+void
+warpRegisterMapDecode(const WarpRegisterMap *  map, const uint8_t *  raw, int16_t *  values, uint16_t numberOfValues)
+{
+	uint16_t	combined;
+	uint8_t		bits, axis = 0;
+
+
+	for (uint16_t i = 0; i < numberOfValues; i++)
+	{
+		if (map->flags & kWarpRegisterMapLittleEndian)
+		{
+			combined = (raw[2*i + 1] << 8) | raw[2*i];
+		}
+		else
+		{
+			combined = (raw[2*i] << 8) | raw[2*i + 1];
+		}
+
+		/*
+		 *	Drop the padding (or status bits) below the value, then sign
+		 *	extend based on knowledge that the upper (16 - bits) bits are 0:
+		 */
+		bits = map->sampleBits[axis];
+		combined >>= 16 - bits;
+		values[i] = (combined ^ (1 << (bits - 1))) - (1 << (bits - 1));
+
+		if (++axis == map->sampleAxes)
+		{
+			axis = 0;
+		}
+	}
+}
+
+/*
+ *	The output registers into i2cBuffer (kept there for hex printing) and,
+ *	unless axes is NULL, decoded into axes.
+ */
+WarpStatus
+warpRegisterMapReadSample(const WarpRegisterMap *  map, int16_t *  axes)
+{
+	WarpStatus	i2cReadStatus = kWarpStatusOK;
+	uint8_t *	buffer = (uint8_t *)map->deviceState->i2cBuffer;
+
+
+	if (map->flags & kWarpRegisterMapBurst)
+	{
+		i2cReadStatus = warpRegisterMapRead(map, map->sampleRegister, 2 * map->sampleAxes);
+	}
+	else
+	{
+		for (int axis = 0; axis < map->sampleAxes && i2cReadStatus == kWarpStatusOK; axis++)
+		{
+			i2cReadStatus = warpRegisterMapReadBlock(map, map->sampleRegister + 2*axis, &buffer[2*axis], 2 /* numberOfBytes */);
+		}
+	}
+
+	if (i2cReadStatus != kWarpStatusOK)
+	{
+		return i2cReadStatus;
+	}
+
+	if (axes != NULL)
+	{
+		warpRegisterMapDecode(map, buffer, axes, map->sampleAxes);
+	}
+
+	return kWarpStatusOK;
+}
+
+/*
+ *	One CSV field per axis of the sample in i2cBuffer: MSB and LSB in hex
+ *	mode, the decoded value otherwise.
+ */
+void
+warpRegisterMapPrintSample(const WarpRegisterMap *  map, WarpStatus i2cReadStatus, bool hexModeFlag)
+{
+	volatile uint8_t *	buffer = map->deviceState->i2cBuffer;
+	int16_t			axes[kWarpRegisterMapMaxAxes];
+	int			msb = (map->flags & kWarpRegisterMapLittleEndian) ? 1 : 0;
+
+
+	if (i2cReadStatus == kWarpStatusOK)
+	{
+		warpRegisterMapDecode(map, (const uint8_t *)buffer, axes, map->sampleAxes);
+	}
+
+	for (int axis = 0; axis < map->sampleAxes; axis++)
+	{
+		if (i2cReadStatus != kWarpStatusOK)
+		{
+			WARP_LOG(kWarpLogCsvFailed);
+		}
+		else
+		{
+			if (hexModeFlag)
+			{
+				WARP_LOG(kWarpLogCsvHexPair, buffer[2*axis + msb], buffer[2*axis + 1 - msb]);
+			}
+			else
+			{
+				WARP_LOG(kWarpLogCsvDecimal, axes[axis]);
+			}
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/*
+	Register-map driver core for the Warp firmware's I2C sensors.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Most I2C sensors on Warp are a file of 8-bit registers behind one
+ *	address: a write is the register address followed by the payload,
+ *	a read is the register address then (after a repeated start) the
+ *	bytes that follow it. A driver describes its device with a const
+ *	WarpRegisterMap and calls the warpRegisterMap*() functions instead of
+ *	building its own transactions:
+ *
+ *	-	readableRegisters and writableRegisters are bitmaps, bit
+ *		(r & 7) of byte (r >> 3) set when register r may be accessed,
+ *		and must cover every register up to lastReadableRegister /
+ *		lastWritableRegister. A NULL bitmap allows every register up to
+ *		that limit.
+ *
+ *	-	registerBytes is the width of a register write (2 for the
+ *		16-bit register files of the HDC1000 and INA219), sent in the
+ *		device's byte order.
+ *
+ *	-	sampleRegister, sampleAxes and sampleBits describe the output
+ *		registers: sampleAxes two-byte values from sampleRegister up,
+ *		each a left-justified two's complement number of sampleBits.
+ *		With kWarpRegisterMapBurst, they are read in one transaction.
+ */
+typedef enum
+{
+	kWarpRegisterMapLittleEndian		= (1 << 0),	/*	LSB at the lower register address			*/
+	kWarpRegisterMapAutoIncrementBit	= (1 << 1),	/*	set bit 7 of the register for multi-byte reads		*/
+	kWarpRegisterMapBurst			= (1 << 2),	/*	multi-byte reads walk through consecutive registers	*/
+} WarpRegisterMapFlags;
+
+typedef enum
+{
+	kWarpRegisterMapMaxAxes			= 4,
+	kWarpRegisterMapAutoIncrementMask	= 0x80,
+} WarpRegisterMapConstants;
+
+typedef struct
+{
+	volatile WarpI2CDeviceState *	deviceState;
+	const uint8_t *			readableRegisters;
+	const uint8_t *			writableRegisters;
+	uint8_t				lastReadableRegister;
+	uint8_t				lastWritableRegister;
+	uint8_t				registerBytes;
+	uint8_t				flags;
+	uint8_t				sampleRegister;
+	uint8_t				sampleAxes;
+	uint8_t				sampleBits[kWarpRegisterMapMaxAxes];
+} WarpRegisterMap;
+
+WarpStatus	warpRegisterMapWrite(const WarpRegisterMap *  map, uint8_t deviceRegister, uint16_t payload);
+WarpStatus	warpRegisterMapWriteBytes(const WarpRegisterMap *  map, uint8_t deviceRegister, const uint8_t *  payload, uint8_t numberOfBytes);
+WarpStatus	warpRegisterMapRead(const WarpRegisterMap *  map, uint8_t deviceRegister, int numberOfBytes);
+WarpStatus	warpRegisterMapReadBlock(const WarpRegisterMap *  map, uint8_t deviceRegister, uint8_t *  buffer, uint16_t numberOfBytes);
+WarpStatus	warpRegisterMapReadSample(const WarpRegisterMap *  map, int16_t *  axes);
+void		warpRegisterMapDecode(const WarpRegisterMap *  map, const uint8_t *  raw, int16_t *  values, uint16_t numberOfValues);
+void		warpRegisterMapPrintSample(const WarpRegisterMap *  map, WarpStatus i2cReadStatus, bool hexModeFlag);
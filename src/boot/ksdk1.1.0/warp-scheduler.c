@@ -0,0 +1,140 @@
+/*
+	Multi-rate sensor acquisition scheduler for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fsl_misc_utilities.h"
+#include "fsl_device_registers.h"
+#include "fsl_i2c_master_driver.h"
+#include "fsl_spi_master_driver.h"
+#include "fsl_rtc_driver.h"
+#include "fsl_clock_manager.h"
+#include "fsl_power_manager.h"
+#include "fsl_mcglite_hal.h"
+#include "fsl_port_hal.h"
+
+#include "warp.h"
+#include "warp-scheduler.h"
+
+
+
+void
+warpSchedulerInit(WarpSchedulerState *  states, uint8_t numberOfTasks, uint32_t nowMicroseconds)
+{
+	for (uint8_t i = 0; i < numberOfTasks; i++)
+	{
+		states[i].dueMicroseconds	= nowMicroseconds;
+		states[i].readyMicroseconds	= nowMicroseconds;
+		states[i].records		= 0;
+		states[i].missedPeriods		= 0;
+		states[i].converting		= false;
+	}
+}
+
+/*
+ *	Move the deadline on by one period, and past any periods that have
+ *	already gone by.
+ */
+static void
+advanceDeadline(const WarpSchedulerTask *  task, WarpSchedulerState *  state, uint32_t nowMicroseconds)
+{
+	uint32_t	late = nowMicroseconds - state->dueMicroseconds;
+	uint32_t	skipped;
+
+
+	state->dueMicroseconds += task->periodMicroseconds;
+	if (late >= task->periodMicroseconds)
+	{
+		skipped = late / task->periodMicroseconds;
+		state->missedPeriods += skipped;
+		state->dueMicroseconds += skipped * task->periodMicroseconds;
+	}
+}
+
+WarpSchedulerAction
+warpSchedulerNext(const WarpSchedulerTask *  tasks, WarpSchedulerState *  states, uint8_t numberOfTasks,
+			uint32_t nowMicroseconds, uint8_t *  task, uint32_t *  waitMicroseconds)
+{
+	WarpSchedulerState *	state;
+	int32_t			untilEvent, earliest = INT32_MAX;
+	uint8_t			next = 0;
+
+
+	for (uint8_t i = 0; i < numberOfTasks; i++)
+	{
+		untilEvent = (int32_t)((states[i].converting ? states[i].readyMicroseconds : states[i].dueMicroseconds) - nowMicroseconds);
+		if (untilEvent < earliest)
+		{
+			earliest = untilEvent;
+			next = i;
+		}
+	}
+
+	if (earliest > 0)
+	{
+		*waitMicroseconds = (uint32_t)earliest;
+
+		return kWarpSchedulerIdle;
+	}
+
+	*task = next;
+	*waitMicroseconds = 0;
+	state = &states[next];
+
+	if (state->converting)
+	{
+		state->converting = false;
+		state->records++;
+
+		return kWarpSchedulerCollect;
+	}
+
+	if (tasks[next].trigger != NULL)
+	{
+		advanceDeadline(&tasks[next], state, nowMicroseconds);
+		state->readyMicroseconds = nowMicroseconds + tasks[next].conversionMicroseconds;
+		state->converting = true;
+
+		return kWarpSchedulerTrigger;
+	}
+
+	state->readyMicroseconds = state->dueMicroseconds;
+	advanceDeadline(&tasks[next], state, nowMicroseconds);
+	state->records++;
+
+	return kWarpSchedulerCollect;
+}
@@ -0,0 +1,87 @@
+/*
+	Multi-rate sensor acquisition scheduler for the Warp firmware.
+
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ *	Reads each sensor only when it has new data, instead of reading every
+ *	sensor on every pass of a fixed loop. A task describes one device:
+ *
+ *	-	Free-running devices (trigger NULL) produce a sample every
+ *		periodMicroseconds, their output data rate; the task collects
+ *		one sample per period.
+ *
+ *	-	Triggered devices (forced-mode conversions) are started every
+ *		periodMicroseconds and collected conversionMicroseconds later.
+ *		Other tasks run in between, so slow conversions overlap with
+ *		the fast sensors instead of stalling them.
+ *
+ *	warpSchedulerNext() returns the overdue event with the earliest
+ *	deadline, or kWarpSchedulerIdle and the time to the next one. Deadlines
+ *	advance by whole periods from the previous deadline, so a late read
+ *	does not drift the rate; when the caller falls more than a period
+ *	behind, the skipped periods are counted in missedPeriods instead of
+ *	being read back to back. Times are warpTimestampMicroseconds() values
+ *	and are only ever compared as differences, so the wrap is harmless.
+ */
+typedef enum
+{
+	kWarpSchedulerIdle			= 0,
+	kWarpSchedulerTrigger			= 1,
+	kWarpSchedulerCollect			= 2,
+} WarpSchedulerAction;
+
+typedef struct
+{
+	WarpStatus	(* trigger)(void);
+	void		(* collect)(bool hexModeFlag);
+	const char *	header;
+	uint32_t	periodMicroseconds;
+	uint32_t	conversionMicroseconds;
+	uint8_t		sensor;			/*	WarpBinaryFrameSensor, written in each record	*/
+} WarpSchedulerTask;
+
+typedef struct
+{
+	uint32_t	dueMicroseconds;	/*	next trigger, or next sample of a free-running device	*/
+	uint32_t	readyMicroseconds;	/*	when the data for the pending collect is ready		*/
+	uint32_t	records;
+	uint32_t	missedPeriods;
+	bool		converting;
+} WarpSchedulerState;
+
+void			warpSchedulerInit(WarpSchedulerState *  states, uint8_t numberOfTasks, uint32_t nowMicroseconds);
+WarpSchedulerAction	warpSchedulerNext(const WarpSchedulerTask *  tasks, WarpSchedulerState *  states, uint8_t numberOfTasks,
+				uint32_t nowMicroseconds, uint8_t *  task, uint32_t *  waitMicroseconds);
@@ -1,3 +1,4 @@
+#include "fsl_i2c_master_driver.h"
 #include "fsl_spi_master_driver.h"
 
 #define	min(x,y)	((x) < (y) ? (x) : (y))
@@ -139,6 +140,11 @@ typedef enum
 	kWarpPowerModeRUN,
 } WarpPowerMode;
 
+typedef enum
+{
+	kWarpLowPowerMaxLptmrMilliseconds	= 0xFFFF,	/*	16-bit LPTMR compare at the 1kHz LPO	*/
+} WarpLowPowerConstants;
+
 typedef enum
 {
 	kWarpSensorADXL362,
@@ -172,7 +178,7 @@ typedef enum
 
 typedef enum
 {
-	kWarpSizesI2cBufferBytes		= 4,
+	kWarpSizesI2cBufferBytes		= 8, /* BMX055 mag DATAX_LSB..RHALL_MSB burst */
 	kWarpSizesSpiBufferBytes		= 4, /* Was 3 bytes */
 	kWarpSizesBME680CalibrationValuesCount	= 41,
 } WarpSizes;
@@ -190,6 +196,9 @@ typedef enum
 {
 	kWarpSensorConfigurationRegisterMMA8451QF_SETUP			= 0x09,
 	kWarpSensorConfigurationRegisterMMA8451QCTRL_REG1		= 0x2A,
+	kWarpSensorConfigurationRegisterMMA8451QCTRL_REG3		= 0x2C,
+	kWarpSensorConfigurationRegisterMMA8451QCTRL_REG4		= 0x2D,
+	kWarpSensorConfigurationRegisterMMA8451QCTRL_REG5		= 0x2E,
 
 	kWarpSensorConfigurationRegisterMAG3110CTRL_REG1		= 0x10,
 	kWarpSensorConfigurationRegisterMAG3110CTRL_REG2		= 0x11,
@@ -208,16 +217,19 @@ typedef enum
 	kWarpSensorConfigurationRegisterBMX055accelPMU_LPW		= 0x11,
 	kWarpSensorConfigurationRegisterBMX055accelPMU_LOW_POWER	= 0x12,
 	kWarpSensorConfigurationRegisterBMX055accelACCD_HBW		= 0x13,
+	kWarpSensorConfigurationRegisterBMX055accelFIFO_CONFIG_1	= 0x3E,
 	kWarpSensorConfigurationRegisterBMX055magPowerCtrl		= 0x4B,
 	kWarpSensorConfigurationRegisterBMX055magOpMode			= 0x4C,
 	kWarpSensorConfigurationRegisterBMX055gyroRANGE			= 0x0F,
 	kWarpSensorConfigurationRegisterBMX055gyroBW			= 0x10,
 	kWarpSensorConfigurationRegisterBMX055gyroLPM1			= 0x11,
 	kWarpSensorConfigurationRegisterBMX055gyroRATE_HBW		= 0x13,
+	kWarpSensorConfigurationRegisterBMX055gyroFIFO_CONFIG_1		= 0x3E,
 
 	kWarpSensorConfigurationRegisterL3GD20HCTRL1			= 0x20,
 	kWarpSensorConfigurationRegisterL3GD20HCTRL2			= 0x21,
 	kWarpSensorConfigurationRegisterL3GD20HCTRL5			= 0x24,
+	kWarpSensorConfigurationRegisterL3GD20HFIFO_CTRL		= 0x2E,
 
 	kWarpSensorConfigurationRegisterBME680Reset			= 0xE0,
 	kWarpSensorConfigurationRegisterBME680Config			= 0x75,
@@ -237,6 +249,7 @@ typedef enum
 
 typedef enum
 {
+	kWarpSensorOutputRegisterMMA8451QF_STATUS			= 0x00,
 	kWarpSensorOutputRegisterMMA8451QOUT_X_MSB			= 0x01,
 	kWarpSensorOutputRegisterMMA8451QOUT_X_LSB			= 0x02,
 	kWarpSensorOutputRegisterMMA8451QOUT_Y_MSB			= 0x03,
@@ -277,12 +290,16 @@ typedef enum
 	kWarpSensorOutputRegisterBMX055accelACCD_Z_LSB			= 0x06,
 	kWarpSensorOutputRegisterBMX055accelACCD_Z_MSB			= 0x07,
 	kWarpSensorOutputRegisterBMX055accelACCD_TEMP			= 0x08,
+	kWarpSensorOutputRegisterBMX055accelFIFO_STATUS			= 0x0E,
+	kWarpSensorOutputRegisterBMX055accelFIFO_DATA			= 0x3F,
 	kWarpSensorOutputRegisterBMX055gyroRATE_X_LSB			= 0x02,
 	kWarpSensorOutputRegisterBMX055gyroRATE_X_MSB			= 0x03,
 	kWarpSensorOutputRegisterBMX055gyroRATE_Y_LSB			= 0x04,
 	kWarpSensorOutputRegisterBMX055gyroRATE_Y_MSB			= 0x05,
 	kWarpSensorOutputRegisterBMX055gyroRATE_Z_LSB			= 0x06,
 	kWarpSensorOutputRegisterBMX055gyroRATE_Z_MSB			= 0x07,
+	kWarpSensorOutputRegisterBMX055gyroFIFO_STATUS			= 0x0E,
+	kWarpSensorOutputRegisterBMX055gyroFIFO_DATA			= 0x3F,
 	kWarpSensorOutputRegisterBMX055magX_LSB				= 0x42,
 	kWarpSensorOutputRegisterBMX055magX_MSB				= 0x43,
 	kWarpSensorOutputRegisterBMX055magY_LSB				= 0x44,
@@ -299,6 +316,7 @@ typedef enum
 	kWarpSensorOutputRegisterL3GD20HOUT_Y_H				= 0x2B,
 	kWarpSensorOutputRegisterL3GD20HOUT_Z_L				= 0x2C,
 	kWarpSensorOutputRegisterL3GD20HOUT_Z_H				= 0x2D,
+	kWarpSensorOutputRegisterL3GD20HFIFO_SRC			= 0x2F,
 
 	kWarpSensorOutputRegisterBME680press_msb			= 0x1F,
 	kWarpSensorOutputRegisterBME680press_lsb			= 0x20,
@@ -310,6 +328,183 @@ typedef enum
 	kWarpSensorOutputRegisterBME680hum_lsb				= 0x26,
 } WarpSensorOutputRegister;
 
+typedef enum
+{
+	kWarpMMA8451QFifoDepth				= 32,
+	kWarpMMA8451QBytesPerSample			= 6,
+	kWarpMMA8451QF_SETUPModeCircular		= 0x40,
+	kWarpMMA8451QF_SETUPWatermarkMask		= 0x3F,
+	kWarpMMA8451QF_STATUSOverflow			= 0x80,
+	kWarpMMA8451QF_STATUSCountMask			= 0x3F,
+	kWarpMMA8451QCTRL_REG1Active			= 0x01,
+	kWarpMMA8451QInterruptDataReady			= 0x01, /* CTRL_REG4 enable / CTRL_REG5 route-to-INT1 bit */
+	kWarpMMA8451QInterruptFifo			= 0x40, /* CTRL_REG4 enable / CTRL_REG5 route-to-INT1 bit */
+} WarpMMA8451QConstants;
+
+typedef enum
+{
+	kWarpL3GD20HFifoDepth				= 32,
+	kWarpL3GD20HBytesPerSample			= 6,
+	kWarpL3GD20HCTRL5FifoEnable			= 0x40,
+	kWarpL3GD20HFIFO_CTRLModeBypass			= 0x00,
+	kWarpL3GD20HFIFO_CTRLModeStream			= 0x40,
+	kWarpL3GD20HFIFO_CTRLWatermarkMask		= 0x1F,
+	kWarpL3GD20HFIFO_SRCOverrun			= 0x40,
+	kWarpL3GD20HFIFO_SRCCountMask			= 0x1F,
+} WarpL3GD20HConstants;
+
+typedef enum
+{
+	kWarpHDC1000ConfigurationSequential		= 0x1000,	/*	MODE: one trigger converts temperature, then humidity	*/
+	kWarpHDC1000ConversionMicroseconds		= 13000,	/*	14-bit temperature and humidity (Table 7.5)		*/
+	kWarpHDC1000ConversionMilliseconds		= 13,
+	kWarpHDC1000ResultBytes				= 4,
+} WarpHDC1000Constants;
+
+typedef enum
+{
+	kWarpBME680OutputBytes				= 8,	/*	press_msb (0x1F) through hum_lsb (0x26)			*/
+	kWarpBME680ConversionMicroseconds		= 12000,	/*	forced mode, 1x oversampling, heater off		*/
+	kWarpBME680CalibrationRegion1Bytes		= kWarpSensorConfigurationRegisterBME680CalibrationRegion1End - kWarpSensorConfigurationRegisterBME680CalibrationRegion1Start,
+	kWarpBME680CalibrationRegion2Bytes		= kWarpSizesBME680CalibrationValuesCount - kWarpBME680CalibrationRegion1Bytes,	/*	0xE1..0xF0	*/
+	kWarpBME680HumidityMaxMilliPercent		= 100000,
+} WarpBME680Constants;
+
+/*
+ *	Configuration register fields (datasheet Table 3). SADC codes 0x9
+ *	through 0xF average 2 to 128 12-bit shunt samples, each 532us, so
+ *	code c spans kWarpINA219SampleMicroseconds << (c - 8).
+ */
+typedef enum
+{
+	kWarpINA219ShuntMilliohms			= 100,		/*	R100 on the breakout				*/
+	kWarpINA219MicrovoltsPerShuntCount		= 10,
+	kWarpINA219ConfigurationDefault			= 0x399F,	/*	power-on: 32V, /8, 12-bit, continuous		*/
+	kWarpINA219ConfigurationShuntTriggered		= 0x0001,	/*	MODE: one shunt conversion per write		*/
+	kWarpINA219ConfigurationShuntContinuous		= 0x0005,
+	kWarpINA219ConfigurationPga8			= 0x1800,	/*	PG: /8, +/-320mV				*/
+	kWarpINA219ConfigurationBadc12Bit		= 0x0180,
+	kWarpINA219ConfigurationSadcShift		= 3,
+	kWarpINA219SadcAverage2				= 0x9,
+	kWarpINA219SadcAverage128			= 0xF,
+	kWarpINA219SampleMicroseconds			= 532,
+	kWarpINA219Calibration1To1			= 4096,		/*	current register counts = shunt counts		*/
+	kWarpINA219BusVoltageConversionReady		= 0x02,		/*	CNVR in the bus voltage register		*/
+} WarpINA219Constants;
+
+/*
+ *	Burst lengths run from the X LSB through the last output register
+ *	(ACCD_TEMP, RATE_Z_MSB, RHALL_MSB). The accelerometer and gyroscope
+ *	FIFOs hold X/Y/Z frames and share their register layout.
+ */
+typedef enum
+{
+	kWarpBMX055accelBurstBytes			= 7,
+	kWarpBMX055gyroBurstBytes			= 6,
+	kWarpBMX055magBurstBytes			= 8,
+	kWarpBMX055accelBits				= 12,
+	kWarpBMX055gyroBits				= 16,
+	kWarpBMX055accelFifoDepth			= 32,
+	kWarpBMX055gyroFifoDepth			= 100,
+	kWarpBMX055BytesPerFifoFrame			= 6,
+	kWarpBMX055FIFO_CONFIG_1ModeBypass		= 0x00,
+	kWarpBMX055FIFO_CONFIG_1ModeStream		= 0x80,
+	kWarpBMX055FIFO_STATUSOverrun			= 0x80,
+	kWarpBMX055FIFO_STATUSFrameCountMask		= 0x7F,
+} WarpBMX055Constants;
+
+/*
+ *	Caller-provided ring of X/Y/Z acceleration samples (14-bit counts).
+ *	head and tail are free-running; capacity must be a power of two so
+ *	that (head - tail) is the fill level across wraparound. The producer
+ *	only writes head and the consumer only writes tail.
+ */
+typedef struct
+{
+	int16_t *		samples;	/*	capacity x {X, Y, Z}				*/
+	uint32_t *		timestamps;	/*	capacity x microseconds, or NULL if unused	*/
+	uint16_t		capacity;
+	volatile uint16_t	head;
+	volatile uint16_t	tail;
+	uint16_t		overruns;
+} WarpAccelerationRing;
+
+/*
+ *	Binary sample frames written by streamAllSensorsBinary(). All
+ *	multi-byte fields are little-endian; the payload is the raw register
+ *	bytes of each present sensor, in WarpBinaryFrameSensor order, and is
+ *	followed by a CRC-16/CCITT (polynomial 0x1021, initial 0xFFFF) over
+ *	everything from the length byte to the end of the payload.
+ */
+typedef enum
+{
+	kWarpBinaryFrameSync0				= 0xA5,
+	kWarpBinaryFrameSync1				= 0x5A,
+	kWarpBinaryFrameOffsetLength			= 2,	/*	uint8_t, payload bytes			*/
+	kWarpBinaryFrameOffsetSensorsPresent		= 3,	/*	uint16_t, WarpBinaryFrameSensor bits	*/
+	kWarpBinaryFrameOffsetSensorsFailed		= 5,	/*	uint16_t, sensors whose read failed	*/
+	kWarpBinaryFrameOffsetSequence			= 7,	/*	uint32_t				*/
+	kWarpBinaryFrameOffsetTSR			= 11,	/*	uint32_t, RTC->TSR			*/
+	kWarpBinaryFrameOffsetTPR			= 15,	/*	uint16_t, RTC->TPR			*/
+	kWarpBinaryFrameHeaderBytes			= 17,
+	kWarpBinaryFramePayloadMaxBytes			= 96,
+	kWarpBinaryFrameCrcBytes			= 2,
+} WarpBinaryFrameConstants;
+
+typedef enum
+{
+	kWarpBinaryFrameSensorMMA8451Q			= 0,
+	kWarpBinaryFrameSensorINA219			= 1,
+	kWarpBinaryFrameSensorMAG3110			= 2,
+	kWarpBinaryFrameSensorL3GD20H			= 3,
+	kWarpBinaryFrameSensorBME680			= 4,
+	kWarpBinaryFrameSensorBMX055accel		= 5,
+	kWarpBinaryFrameSensorBMX055mag			= 6,
+	kWarpBinaryFrameSensorBMX055gyro		= 7,
+	kWarpBinaryFrameSensorCCS811			= 8,
+	kWarpBinaryFrameSensorHDC1000			= 9,
+	kWarpBinaryFrameSensorCount,
+} WarpBinaryFrameSensor;
+
+/*
+ *	Per-device bus statistics, kept by the warpI2CMaster*() and
+ *	warpSPIMasterTransferBlocking() wrappers that the drivers call in place
+ *	of the KSDK I2C_DRV_* and SPI_DRV_* functions. Latencies come from the
+ *	RTC prescaler (30.5us resolution) and go into power-of-two bins from
+ *	kWarpBusStatisticsFirstBinMicroseconds up; the last bin is open-ended.
+ *	The drivers have no retry loops of their own, so a retry is counted
+ *	whenever a transaction follows a failed one to the same device.
+ *	The table costs RAM, so it is only built with
+ *	WARP_BUILD_ENABLE_BUS_STATISTICS; otherwise the wrappers are the KSDK
+ *	calls themselves.
+ */
+#ifndef WARP_BUILD_ENABLE_BUS_STATISTICS
+//#define WARP_BUILD_ENABLE_BUS_STATISTICS
+#endif
+
+typedef enum
+{
+	kWarpBusStatisticsMaxDevices			= 6,
+	kWarpBusStatisticsLatencyBins			= 8,
+	kWarpBusStatisticsFirstBinMicroseconds		= 64,
+	kWarpBusStatisticsSpiAddress			= 0xFF,
+} WarpBusStatisticsConstants;
+
+typedef struct
+{
+	uint8_t			address;	/*	7-bit I2C address, or kWarpBusStatisticsSpiAddress	*/
+	uint8_t			lastError;	/*	i2c_status_t or spi_status_t of the last failure	*/
+	uint16_t		failures;
+	uint16_t		timeouts;
+	uint16_t		naks;
+	uint16_t		retries;
+	bool			previousFailed;
+	uint32_t		transactions;
+	uint32_t		bytes;
+	uint32_t		busMicroseconds;
+	uint16_t		latencyHistogram[kWarpBusStatisticsLatencyBins];
+} WarpBusStatistics;
+
 typedef struct
 {
 	/*
@@ -358,7 +553,26 @@ typedef struct
 } WarpThermalChamberKL03MemoryFill;
 
 WarpStatus	warpSetLowPowerMode(WarpPowerMode powerMode, uint32_t sleepSeconds);
+WarpStatus	warpSetLowPowerModeMilliseconds(WarpPowerMode powerMode, uint32_t sleepMilliseconds);
+uint32_t	warpTimestampMicroseconds(void);
+uint32_t	warpI2cBaudRateKbps(uint8_t address);
+void		configureI2Cpins(uint8_t pullupValue);
 void		enableI2Cpins(uint8_t pullupValue);
 void		disableI2Cpins(void);
 void		enableSPIpins(void);
 void		disableSPIpins(void);
+
+#ifdef WARP_BUILD_ENABLE_BUS_STATISTICS
+i2c_status_t	warpI2CMasterSendDataBlocking(uint32_t instance, const i2c_device_t *  device,
+			const uint8_t *  cmdBuff, uint32_t cmdSize, const uint8_t *  txBuff, uint32_t txSize, uint32_t timeout_ms);
+i2c_status_t	warpI2CMasterReceiveDataBlocking(uint32_t instance, const i2c_device_t *  device,
+			const uint8_t *  cmdBuff, uint32_t cmdSize, uint8_t *  rxBuff, uint32_t rxSize, uint32_t timeout_ms);
+spi_status_t	warpSPIMasterTransferBlocking(uint32_t instance, const spi_master_user_config_t *  device,
+			const uint8_t *  sendBuffer, uint8_t *  receiveBuffer, size_t transferByteCount, uint32_t timeout);
+void		printBusStatistics(void);
+void		resetBusStatistics(void);
+#else
+#define		warpI2CMasterSendDataBlocking		I2C_DRV_MasterSendDataBlocking
+#define		warpI2CMasterReceiveDataBlocking	I2C_DRV_MasterReceiveDataBlocking
+#define		warpSPIMasterTransferBlocking		SPI_DRV_MasterTransferBlocking
+#endif